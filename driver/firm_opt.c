@@ -20,6 +20,7 @@
 #include "adt/strutil.h"
 #include "adt/util.h"
 #include "driver/timing.h"
+#include "gcj_interface.h"
 
 /* optimization settings */
 struct a_firm_opt {
@@ -359,6 +360,12 @@ static opt_config_t opts[] = {
 	IRG("local",             optimize_graph_df,        "local graph optimizations",                             OPT_FLAG_HIDE_OPTIONS),
 	IRG("lower",             lower_highlevel_graph,    "lowering",                                              OPT_FLAG_HIDE_OPTIONS | OPT_FLAG_ESSENTIAL),
 	IRG("lower-mux",         do_lower_mux,             "mux lowering",                                          OPT_FLAG_NONE),
+	IRG("array-zeroing",     gcji_elide_array_zeroing, "elide zeroing of arrays filled by a copy or loop",      OPT_FLAG_NONE),
+	IRG("card-marking",      gcji_insert_card_marks,   "card marking write barrier",                            OPT_FLAG_HIDE_OPTIONS | OPT_FLAG_ESSENTIAL),
+	IRG("lower-alloc",       gcji_lower_allocations,   "inline allocation fast paths",                          OPT_FLAG_NONE),
+	IRG("lower-monitors",    gcji_lower_monitors,      "inline thin lock fast paths",                           OPT_FLAG_NONE),
+	IRG("safepoints",        gcji_insert_safepoint_polls, "safepoint polls on loop backedges and returns",      OPT_FLAG_NONE),
+	IRG("local-throws",      gcji_lower_local_throws,  "jumps for exceptions caught in the same method",        OPT_FLAG_NONE),
 	IRG("opt-load-store",    optimize_load_store,      "load store optimization",                               OPT_FLAG_NONE),
 	IRG("memcombine",        combine_memops,           "combine adjacent memory operations",                    OPT_FLAG_NONE),
 	IRG("opt-tail-rec",      opt_tail_rec_irg,         "tail-recursion elimination",                            OPT_FLAG_NONE),
@@ -375,6 +382,7 @@ static opt_config_t opts[] = {
 	IRG("vrp",               set_vrp_data,             "value range propagation",                               OPT_FLAG_NONE),
 	IRG("rts",               rts_map,                  "optimization of known library functions",               OPT_FLAG_NONE),
 	IRP("inline",            do_inline,                "inlining",                                              OPT_FLAG_NONE),
+	IRP("escape-analysis",   gcji_escape_analysis,     "stack allocation of objects which do not escape",       OPT_FLAG_NONE),
 	IRP("lower-const",       lower_const_code,         "lowering of constant code",                             OPT_FLAG_HIDE_OPTIONS | OPT_FLAG_NO_DUMP | OPT_FLAG_NO_VERIFY | OPT_FLAG_ESSENTIAL),
 	IRP("local-const",       local_opts_const_code,    "local optimisation of constant initializers",
 	                            OPT_FLAG_HIDE_OPTIONS | OPT_FLAG_NO_DUMP | OPT_FLAG_NO_VERIFY | OPT_FLAG_ESSENTIAL),
@@ -383,6 +391,7 @@ static opt_config_t opts[] = {
 	IRP("opt-proc-clone",    do_cloning,               "procedure cloning",                                     OPT_FLAG_NONE),
 	IRP("remove-unused",     garbage_collect_entities, "removal of unused functions/variables",                 OPT_FLAG_NO_DUMP | OPT_FLAG_NO_VERIFY),
 	IRP("opt-cc",            mark_private_methods,     "calling conventions optimization",                      OPT_FLAG_NONE),
+	IRP("exception-table",   gcji_create_exception_table, "exception table of zero-cost exceptions",            OPT_FLAG_HIDE_OPTIONS | OPT_FLAG_ESSENTIAL),
 #undef IRP
 #undef IRG
 };
@@ -504,6 +513,14 @@ static void enable_safe_defaults(void)
 	set_opt_enabled("rts", true);
 	set_opt_enabled("parallelize-mem", true);
 	set_opt_enabled("opt-cc", true);
+	set_opt_enabled("escape-analysis", true);
+	set_opt_enabled("array-zeroing", true);
+	set_opt_enabled("card-marking", true);
+	set_opt_enabled("lower-alloc", true);
+	set_opt_enabled("lower-monitors", true);
+	set_opt_enabled("safepoints", true);
+	set_opt_enabled("local-throws", true);
+	set_opt_enabled("exception-table", true);
 }
 
 /**
@@ -604,9 +621,14 @@ static void do_firm_optimizations(void)
 
 	do_irp_opt("inline");
 	do_irp_opt("opt-proc-clone");
+	do_irp_opt("escape-analysis");
 
 	for (size_t i = 0; i < get_irp_n_irgs(); i++) {
 		ir_graph *irg = get_irp_irg(i);
+		/* inlining moved throws next to their handlers */
+		do_irg_opt(irg, "local-throws");
+		/* splits up the objects placed in the frame by escape analysis */
+		do_irg_opt(irg, "scalar-replace");
 		do_irg_opt(irg, "local");
 		do_irg_opt(irg, "control-flow");
 		do_irg_opt(irg, "thread-jumps");
@@ -637,6 +659,17 @@ static void do_firm_optimizations(void)
  */
 static void do_firm_lowering(void)
 {
+	/* expand allocations and monitors late so the optimizations above still
+	 * see them as calls */
+	for (size_t i = get_irp_n_irgs(); i-- > 0; ) {
+		ir_graph *irg = get_irp_irg(i);
+		do_irg_opt(irg, "array-zeroing");
+		do_irg_opt(irg, "card-marking");
+		do_irg_opt(irg, "lower-alloc");
+		do_irg_opt(irg, "lower-monitors");
+		do_irg_opt(irg, "safepoints");
+	}
+
 	do_irp_opt("target-lowering");
 
 	for (size_t i = get_irp_n_irgs(); i-- > 0; ) {
@@ -681,6 +714,8 @@ static void do_firm_lowering(void)
 	set_opt_algebraic_simplification(firm_opt.const_folding);
 	do_irp_opt("remove-unused");
 	do_irp_opt("opt-cc");
+	/* labels the final control flow, nothing may change it afterwards */
+	do_irp_opt("exception-table");
 	dump_all("low-opt");
 }
 
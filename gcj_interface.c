@@ -9,6 +9,7 @@
 #include <liboo/rtti.h>
 #include <liboo/dmemory.h>
 #include <liboo/nodes.h>
+#include "adt/array.h"
 #include "adt/cpset.h"
 #include "mangle.h"
 #include "adt/obst.h"
@@ -16,13 +17,21 @@
 #include "adt/error.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <string.h>
 
+/**
+ * Alignment of _Jv_lock_token, the low bits of a thin lock word hold the
+ * recursion count. Must match simplert/c/monitor.h.
+ */
+#define LOCK_TOKEN_ALIGN 128
+
 static ident     *class_dollar_ident;
 static ir_type   *glob;
 static ir_entity *gcj_alloc_entity;
 static ir_entity *gcj_init_entity;
 static ir_entity *gcj_new_string_entity;
+static ir_entity *gcj_new_string_hashed_entity;
 static ir_entity *gcj_new_prim_array_entity;
 static ir_entity *gcj_new_object_array_entity;
 static ir_entity *gcj_abstract_method_entity;
@@ -41,6 +50,33 @@ static ir_entity *gcj_long_rtti_entity;
 static ir_entity *gcj_float_rtti_entity;
 static ir_entity *gcj_double_rtti_entity;
 static ir_entity *gcj_array_length;
+static ir_entity *gcj_class_arrayclass;
+static ir_entity *gcj_class_vtable;
+static ir_entity *gcj_tlab_entity;
+static ir_entity *gcj_tlab_top;
+static ir_entity *gcj_tlab_end;
+static ir_entity *gcj_safepoint_flag_entity;
+static ir_entity *gcj_safepoint_entity;
+static ir_entity *gcj_monitor_enter_entity;
+static ir_entity *gcj_monitor_exit_entity;
+static ir_entity *gcj_lock_token_entity;
+static ir_entity *gcj_object_lock;
+static ir_type   *gcj_compare_swap_type;
+static ir_entity *gcj_card_table_entity;
+static ir_entity *gcj_card_table_base;
+static ir_entity *gcj_card_table_size;
+static ir_entity *gcj_card_table_cards;
+static ir_entity *gcj_new_uninitialized_array_entity;
+static ir_entity *gcj_init_array_copy_entity;
+static ident     *arraycopy_ident;
+static ir_entity *gcj_string_concat_entity;
+static ir_entity *gcj_throw_entity;
+static ir_entity *gcj_throw_arithmetic_entity;
+static ir_entity *gcj_throw_null_pointer_entity;
+static ir_entity *gcj_throw_array_index_entity;
+static ir_entity *gcj_exception_entity;
+static ident     *default_init_ident;
+static ident     *to_string_ident;
 
 static ir_mode *mode_ushort;
 static ir_type *type_ushort;
@@ -50,16 +86,46 @@ static ir_type *type_utf8_const;
 static ir_type *type_java_lang_object;
 static ir_type *type_java_lang_class;
 static ir_type *type_jarray;
+static ir_type *type_card;
+static ir_type *type_lock_word;
 
 static unsigned array_header_size;
 static unsigned array_header_end_align;
 
 ident *superobject_ident;
 bool create_jcr_segment;
+bool inline_allocation;
+bool emit_gc_bitmaps;
+bool emit_gc_roots;
+bool safepoint_polls;
+bool card_marking;
+bool uninitialized_arrays;
+bool stack_allocation;
+bool string_concat_fusion;
+bool string_literal_hashes;
+bool method_hash_tables;
+bool thin_locks;
+bool atomic_intrinsics;
+bool math_intrinsics;
+bool zero_cost_exceptions;
+
+const char *const gcji_implicit_exceptions[] = {
+	"java/lang/NullPointerException",
+	"java/lang/ArrayIndexOutOfBoundsException",
+	"java/lang/ArithmeticException",
+	"java/lang/NoClassDefFoundError",
+	"java/lang/ExceptionInInitializerError",
+	"java/lang/IllegalMonitorStateException",
+	"java/lang/IllegalArgumentException",
+	NULL
+};
 
 extern char* strdup(const char* s);
 static ir_entity *do_emit_utf8_const(const char *bytes, size_t len);
 static ir_entity *emit_type_signature(ir_type *type);
+static void deinit_allocation_lowering(void);
+static void init_atomic_intrinsics(void);
+static void init_math_intrinsics(void);
 
 static unsigned java_style_hash(const char* s)
 {
@@ -173,6 +239,16 @@ ir_entity *gcji_get_abstract_method_entity(void)
 	return gcj_abstract_method_entity;
 }
 
+ir_entity *gcji_get_throw_entity(void)
+{
+	return gcj_throw_entity;
+}
+
+ir_entity *gcji_get_throw_arithmetic_entity(void)
+{
+	return gcj_throw_arithmetic_entity;
+}
+
 void gcji_add_java_lang_class_fields(ir_type *type)
 {
 	assert(type == type_java_lang_class);
@@ -191,7 +267,7 @@ void gcji_add_java_lang_class_fields(ir_type *type)
 	add_compound_member(type, "size_in_bytes", type_int);
 	add_compound_member(type, "field_count", type_short);
 	add_compound_member(type, "static_field_count", type_short);
-	add_compound_member(type, "vtable", type_reference);
+	gcj_class_vtable = add_compound_member(type, "vtable", type_reference);
 	add_compound_member(type, "otable", type_reference);
 	add_compound_member(type, "otable_syms", type_reference);
 	add_compound_member(type, "atable", type_reference);
@@ -207,7 +283,7 @@ void gcji_add_java_lang_class_fields(ir_type *type)
 	add_compound_member(type, "depth", type_short);
 	add_compound_member(type, "ancestors", type_reference);
 	add_compound_member(type, "idt", type_reference);
-	add_compound_member(type, "arrayclass", type_reference);
+	gcj_class_arrayclass = add_compound_member(type, "arrayclass", type_reference);
 	add_compound_member(type, "protectionDomain", type_reference);
 	add_compound_member(type, "assertion_table", type_reference);
 	add_compound_member(type, "hack_signers", type_reference);
@@ -217,6 +293,13 @@ void gcji_add_java_lang_class_fields(ir_type *type)
 	add_compound_member(type, "reflection_data", type_reference);
 }
 
+void gcji_add_java_lang_object_fields(ir_type *type)
+{
+	assert(type == type_java_lang_object);
+	if (thin_locks)
+		gcj_object_lock = add_compound_member(type, "@lock", type_lock_word);
+}
+
 void gcji_create_vtable_entity(ir_type *type)
 {
 	const char *name         = get_compound_name(type);
@@ -239,6 +322,11 @@ void gcji_set_java_lang_object(ir_type *type)
 	type_java_lang_object = type;
 }
 
+ir_entity *gcji_get_class_init_entity(void)
+{
+	return gcj_init_entity;
+}
+
 void gcji_class_init(ir_type *type)
 {
 	assert(is_Class_type(type));
@@ -311,15 +399,86 @@ ir_node *gcji_allocate_array(ir_type *eltype, ir_node *count)
 	return res2;
 }
 
-ir_node *gcji_new_string(ir_entity *bytes)
+/**
+ * Decodes the modified UTF-8 sequence at @p bytes like the simplert runtime
+ * does (see string_from_c_chars) and returns its length.
+ */
+static size_t decode_utf8(const uint8_t *bytes, size_t len, uint32_t *result)
 {
-	ir_node *addr        = new_Address(gcj_new_string_entity);
-	ir_node *string_symc = new_Address(bytes);
-	ir_node *args[]      = { string_symc };
-	ir_node *mem         = get_store();
-	ir_type *call_type   = get_entity_type(gcj_new_string_entity);
-	ir_node *call        = new_Call(mem, addr, ARRAY_SIZE(args), args,
-	                                call_type);
+	uint8_t  c = bytes[0];
+	size_t   n;
+	uint32_t code;
+	if (c >= 0xC0 && c < 0xE0) {
+		n    = 2;
+		code = c & 0x1F;
+	} else if (c >= 0xE0 && c < 0xF0) {
+		n    = 3;
+		code = c & 0x0F;
+	} else if (c >= 0xF0 && c < 0xF8) {
+		n    = 4;
+		code = c & 0x07;
+	} else {
+		*result = c;
+		return 1;
+	}
+	if (n > len) {
+		*result = c;
+		return 1;
+	}
+	for (size_t i = 1; i < n; ++i) {
+		if ((bytes[i] & 0xC0) != 0x80) {
+			*result = c;
+			return 1;
+		}
+		code = (code << 6) | (bytes[i] & 0x3F);
+	}
+	if (code > 0x10FFFF) {
+		*result = c;
+		return 1;
+	}
+	*result = code;
+	return n;
+}
+
+/** Returns String.hashCode of the string literal @p bytes. */
+static int32_t string_literal_hash(const char *bytes, size_t len)
+{
+	const uint8_t *chars = (const uint8_t*)bytes;
+	uint32_t       hash  = 0;
+	for (size_t i = 0; i < len; ) {
+		uint32_t code;
+		i += decode_utf8(chars + i, len - i, &code);
+		if (code > 0xFFFF) {
+			code -= 0x10000;
+			hash  = 31 * hash + (0xD800 + (code >> 10));
+			hash  = 31 * hash + (0xDC00 + (code & 0x3FF));
+		} else {
+			hash  = 31 * hash + code;
+		}
+	}
+	return (int32_t)hash;
+}
+
+ir_node *gcji_new_string(constant_t *constant)
+{
+	ir_entity *bytes       = gcji_emit_utf8_const(constant, 0);
+	ir_node   *string_symc = new_Address(bytes);
+	ir_node   *mem         = get_store();
+	ir_node   *call;
+	if (string_literal_hashes) {
+		const constant_utf8_string_t *string_const = &constant->utf8_string;
+		int32_t  hash   = string_literal_hash(string_const->bytes,
+		                                      string_const->length);
+		ir_node *addr   = new_Address(gcj_new_string_hashed_entity);
+		ir_node *args[] = { string_symc, new_Const_long(mode_int, hash) };
+		call = new_Call(mem, addr, ARRAY_SIZE(args), args,
+		                get_entity_type(gcj_new_string_hashed_entity));
+	} else {
+		ir_node *addr   = new_Address(gcj_new_string_entity);
+		ir_node *args[] = { string_symc };
+		call = new_Call(mem, addr, ARRAY_SIZE(args), args,
+		                get_entity_type(gcj_new_string_entity));
+	}
 	ir_node *new_mem     = new_Proj(call, mode_M, pn_Call_M);
 	ir_node *ress        = new_Proj(call, mode_T, pn_Call_T_result);
 	ir_node *res         = new_Proj(ress, mode_reference, 0);
@@ -420,6 +579,51 @@ static void set_compound_init_entref(ir_initializer_t *init, size_t idx,
 	set_compound_init_node(init, idx, node);
 }
 
+/**
+ * Sets the bits of all words holding references in objects of type @p type
+ * placed at @p base. Returns false if a reference lies beyond @p max_words.
+ */
+static bool collect_reference_words(ir_type *type, unsigned base,
+                                    unsigned max_words, uint64_t *bitmap)
+{
+	unsigned pointer_size = get_type_size(type_reference);
+	for (size_t m = 0, n = get_compound_n_members(type); m < n; ++m) {
+		ir_entity *member = get_compound_member(type, m);
+		if (is_method_entity(member))
+			continue;
+
+		ir_type  *member_type = get_entity_type(member);
+		unsigned  offset      = base + get_entity_offset(member);
+		if (is_Class_type(member_type)) {
+			/* embedded superclass data */
+			if (!collect_reference_words(member_type, offset, max_words, bitmap))
+				return false;
+		} else if (is_Pointer_type(member_type)) {
+			assert(offset % pointer_size == 0);
+			unsigned word = offset / pointer_size;
+			if (word >= max_words)
+				return false;
+			*bitmap |= UINT64_C(1) << word;
+		}
+	}
+	return true;
+}
+
+/**
+ * Computes the marking descriptor of the simplert collector: a bitmap of
+ * the reference words tagged with 1 (see simplert/c/heap.h), or 0 which
+ * makes the collector scan the object conservatively.
+ */
+static uint64_t get_gc_bitmap_descr(ir_type *cls)
+{
+	/* keep the top bit clear, so the value fits a signed long */
+	unsigned max_words = get_type_size(type_reference) * 8 - 3;
+	uint64_t bitmap    = 0;
+	if (!collect_reference_words(cls, 0, max_words, &bitmap))
+		return 0;
+	return (bitmap << 2) | 1;
+}
+
 static void setup_vtable(ir_type *cls, ir_initializer_t *initializer,
                          unsigned vtable_size)
 {
@@ -441,7 +645,12 @@ static void setup_vtable(ir_type *cls, ir_initializer_t *initializer,
 	set_compound_init_null(initializer, 0);
 	set_compound_init_null(initializer, 1);
 	set_compound_init_entref(initializer, 2, rtti);
-	set_compound_init_null(initializer, 3);
+	if (emit_gc_bitmaps) {
+		set_compound_init_num(initializer, 3, mode_P,
+		                      (long)get_gc_bitmap_descr(cls));
+	} else {
+		set_compound_init_null(initializer, 3);
+	}
 }
 
 static ir_entity *do_emit_utf8_const(const char *bytes, size_t len)
@@ -512,6 +721,71 @@ static ir_initializer_t *get_method_desc(ir_type *classtype, ir_entity *ent)
 	return cinit;
 }
 
+/**
+ * Returns the number of slots of the method hash table of a class with
+ * @p n_methods methods, a power of two at most half full. Must match
+ * get_method_hash_size in simplert/c/objects.c.
+ */
+static unsigned get_method_hash_size(unsigned n_methods)
+{
+	if (n_methods == 0)
+		return 0;
+	unsigned size = 2;
+	while (size < 2 * n_methods)
+		size *= 2;
+	return size;
+}
+
+/**
+ * Returns the first slot to probe for a method with the given utf8 const
+ * hashes of name and signature. Must match get_method_hash_slot in
+ * simplert/c/objects.c.
+ */
+static unsigned get_method_hash_slot(unsigned name_hash, unsigned sig_hash,
+                                     unsigned size)
+{
+	uint32_t hash = ((uint32_t)name_hash << 16 | sig_hash) * 0x9E3779B1u;
+	return (hash >> 16) & (size - 1);
+}
+
+static unsigned get_utf8_const_hash(ir_entity *utf8c)
+{
+	ir_initializer_t *init = get_entity_initializer(utf8c);
+	ir_initializer_t *hash = get_initializer_compound_value(init, 0);
+	return (unsigned)get_tarval_long(get_initializer_tarval_value(hash));
+}
+
+/**
+ * Creates the open addressing hash table over name and signature of the
+ * methods of @p linked_class. A slot holds the index of the method plus 1,
+ * 0 marks empty slots. Collisions probe the following slots.
+ */
+static ir_initializer_t *get_method_hash_table(class_t *linked_class,
+                                               unsigned size)
+{
+	uint16_t *slots = XMALLOCNZ(uint16_t, size);
+	for (uint16_t i = 0; i < linked_class->n_methods; i++) {
+		method_t   *method     = linked_class->methods[i];
+		constant_t *name_const = linked_class->constants[method->name_index];
+		constant_t *desc_const = linked_class->constants[method->descriptor_index];
+		ir_entity  *name_ent   = gcji_emit_utf8_const(name_const, 1);
+		ir_entity  *desc_ent   = gcji_emit_utf8_const(desc_const, 1);
+		unsigned    slot
+			= get_method_hash_slot(get_utf8_const_hash(name_ent),
+			                       get_utf8_const_hash(desc_ent), size);
+		while (slots[slot] != 0)
+			slot = (slot + 1) & (size - 1);
+		slots[slot] = i + 1;
+	}
+
+	ir_initializer_t *init = create_initializer_compound(size);
+	for (unsigned i = 0; i < size; i++) {
+		set_compound_init_num(init, i, mode_ushort, slots[i]);
+	}
+	free(slots);
+	return init;
+}
+
 static ir_entity *emit_method_table(ir_type *classtype)
 {
 	class_t *linked_class = (class_t*) oo_get_type_link(classtype);
@@ -529,8 +803,29 @@ static ir_entity *emit_method_table(ir_type *classtype)
 		set_initializer_compound_value(cinit, i, method_desc);
 	}
 
+	/* the hash table follows the methods, so the class layout stays the
+	 * one of gcj */
+	unsigned hash_size = method_hash_tables
+	                   ? get_method_hash_size(n_methods) : 0;
+	ir_type *mt_type = array_type;
+	if (hash_size > 0) {
+		ir_type *hash_type = new_type_array(type_ushort, hash_size);
+		set_type_size(hash_type, hash_size * get_type_size(type_ushort));
+
+		mt_type = new_type_struct(id_unique("method_table"));
+		add_compound_member(mt_type, "methods", array_type);
+		add_compound_member(mt_type, "hash", hash_type);
+		default_layout_compound_type(mt_type);
+
+		ir_initializer_t *methods_init = cinit;
+		cinit = create_initializer_compound(2);
+		set_initializer_compound_value(cinit, 0, methods_init);
+		set_initializer_compound_value(cinit, 1,
+			get_method_hash_table(linked_class, hash_size));
+	}
+
 	ident     *id     = id_unique("_MT");
-	ir_entity *mt_ent = new_entity(get_glob_type(), id, array_type);
+	ir_entity *mt_ent = new_entity(get_glob_type(), id, mt_type);
 	set_entity_initializer(mt_ent, cinit);
 	set_entity_ld_ident(mt_ent, id);
 
@@ -1009,24 +1304,61 @@ void gcji_checkcast(ir_type *classtype, ir_node *objptr)
 	set_store(new_mem);
 }
 
-static ir_node *alloc_dims_array(unsigned dims, ir_node **sizes)
+static void monitor_call(ir_entity *entity, ir_node *objptr)
+{
+	ir_node *addr      = new_Address(entity);
+	ir_type *call_type = get_entity_type(entity);
+	ir_node *args[]    = { objptr };
+	ir_node *mem       = get_store();
+	ir_node *call      = new_Call(mem, addr, ARRAY_SIZE(args), args, call_type);
+	ir_node *new_mem   = new_Proj(call, mode_M, pn_Call_M);
+	set_store(new_mem);
+}
+
+void gcji_monitor_enter(ir_node *objptr)
+{
+	monitor_call(gcj_monitor_enter_entity, objptr);
+}
+
+void gcji_monitor_exit(ir_node *objptr)
+{
+	monitor_call(gcj_monitor_exit_entity, objptr);
+}
+
+ir_node *gcji_get_exception_object(void)
+{
+	ir_node *addr = new_Address(gcj_exception_entity);
+	ir_node *mem  = get_store();
+	ir_node *load = new_Load(mem, addr, mode_reference, type_reference,
+	                         cons_none);
+	set_store(new_Proj(load, mode_M, pn_Load_M));
+	return new_Proj(load, mode_reference, pn_Load_res);
+}
+
+/**
+ * Stores the @p dims sizes of a multianewarray into a slot of the stack
+ * frame, the runtime only reads them during the call.
+ */
+static ir_node *store_dims_array(unsigned dims, ir_node **sizes)
 {
-	ir_mode *dim_mode   = mode_ushort;
-	unsigned bytes      = dims * (get_mode_size_bits(dim_mode) / 8);
-	ir_node *dims_const = new_Const_long(dim_mode, bytes);
-	ir_node *mem        = get_store();
-	ir_node *alloc      = new_Alloc(mem, dims_const, 1);
-	ir_node *arr        = new_Proj(alloc, mode_reference, pn_Alloc_res);
-	ir_node *new_mem    = new_Proj(alloc, mode_M, pn_Alloc_M);
+	ir_graph  *irg        = current_ir_graph;
+	ir_type   *dims_type  = new_type_array(type_int, dims);
+	set_type_size(dims_type, dims * get_type_size(type_int));
+	set_type_state(dims_type, layout_fixed);
+	ir_entity *slot       = new_entity(get_irg_frame_type(irg),
+	                                   id_unique("multiarray_sizes.%u"),
+	                                   dims_type);
+	ir_node   *arr        = new_Member(get_irg_frame(irg), slot);
+	ir_node   *mem        = get_store();
 
 	for (unsigned d = 0; d < dims; d++) {
 		ir_node *index_const = new_Const_long(mode_int, d);
-		ir_node *sel         = new_Sel(arr, index_const, type_array_int);
-		ir_node *store       = new_Store(new_mem, sel, sizes[d], type_array_int, cons_none);
-		new_mem = new_Proj(store, mode_M, pn_Store_M);
+		ir_node *sel         = new_Sel(arr, index_const, dims_type);
+		ir_node *store       = new_Store(mem, sel, sizes[d], type_int, cons_none);
+		mem = new_Proj(store, mode_M, pn_Store_M);
 	}
 
-	set_store(new_mem);
+	set_store(mem);
 	return arr;
 }
 
@@ -1034,7 +1366,7 @@ ir_node *gcji_new_multiarray(ir_node *array_class_ref, unsigned dims,
                              ir_node **sizes)
 {
 	ir_node *addr      = new_Address(gcj_new_multiarray_entity);
-	ir_node *dims_arr  = alloc_dims_array(dims, sizes);
+	ir_node *dims_arr  = store_dims_array(dims, sizes);
 	ir_node *cnst      = new_Const_long(mode_int, dims);
 	ir_node *args[]    = { array_class_ref, cnst, dims_arr };
 	ir_type *call_type = get_entity_type(gcj_new_multiarray_entity);
@@ -1059,6 +1391,17 @@ static ir_entity *extvar(char const *const name, ir_type *const type)
 	                         IR_LINKAGE_DEFAULT);
 }
 
+/** Returns the type of an ir_bk_compare_swap Builtin on @p value_type. */
+static ir_type *new_compare_swap_type(ir_type *value_type)
+{
+	ir_type *type = new_type_method(3, 1, false, 0, 0);
+	set_method_param_type(type, 0, type_reference);
+	set_method_param_type(type, 1, value_type);
+	set_method_param_type(type, 2, value_type);
+	set_method_res_type(type, 0, value_type);
+	return type;
+}
+
 void gcji_init()
 {
 	class_dollar_ident = new_id_from_str("class$");
@@ -1096,6 +1439,17 @@ void gcji_init()
 	gcj_new_string_entity = new_entity(glob, gcj_new_string_id, gcj_new_string_method_type);
 	set_entity_visibility(gcj_new_string_entity, ir_visibility_external);
 
+	// string literals of simplert with precomputed hash code
+	if (string_literal_hashes) {
+		ir_type *gcj_new_string_hashed_type = new_type_method(2, 1, false, 0, 0);
+		set_method_param_type(gcj_new_string_hashed_type, 0, t_ptr);
+		set_method_param_type(gcj_new_string_hashed_type, 1, type_int);
+		set_method_res_type(gcj_new_string_hashed_type, 0, t_ptr);
+		gcj_new_string_hashed_entity
+			= new_entity(glob, ir_platform_mangle_global("_Jv_NewStringUtf8ConstHashed"), gcj_new_string_hashed_type);
+		set_entity_visibility(gcj_new_string_hashed_entity, ir_visibility_external);
+	}
+
 	// gcj_new_prim_array
 	ir_type *gcj_new_prim_array_method_type
 		= new_type_method(2, 1, false, 0, 0);
@@ -1170,6 +1524,16 @@ void gcji_init()
 		= new_entity(glob, ir_platform_mangle_global("_Z17_Jv_NewMultiArrayPN4java4lang5ClassEiPi"), gcj_new_multiarray_type);
 	set_entity_visibility(gcj_new_multiarray_entity, ir_visibility_external);
 
+	// monitors, libgcj has the same functions
+	ir_type *gcj_monitor_type = new_type_method(1, 0, false, 0, 0);
+	set_method_param_type(gcj_monitor_type, 0, t_ptr);
+	gcj_monitor_enter_entity
+		= new_entity(glob, ir_platform_mangle_global("_Jv_MonitorEnter"), gcj_monitor_type);
+	set_entity_visibility(gcj_monitor_enter_entity, ir_visibility_external);
+	gcj_monitor_exit_entity
+		= new_entity(glob, ir_platform_mangle_global("_Jv_MonitorExit"), gcj_monitor_type);
+	set_entity_visibility(gcj_monitor_exit_entity, ir_visibility_external);
+
 	// primitive classes
 	gcj_boolean_rtti_entity= extvar("_Jv_booleanClass", type_reference);
 	gcj_byte_rtti_entity   = extvar("_Jv_byteClass", type_reference);
@@ -1180,6 +1544,137 @@ void gcji_init()
 	gcj_float_rtti_entity  = extvar("_Jv_floatClass", type_reference);
 	gcj_double_rtti_entity = extvar("_Jv_doubleClass", type_reference);
 
+	// thread local allocation buffer of simplert, see simplert/c/heap.h
+	if (inline_allocation) {
+		ir_type *type_tlab = new_type_struct(new_id_from_str("tlab"));
+		gcj_tlab_top = add_compound_member(type_tlab, "top", type_reference);
+		gcj_tlab_end = add_compound_member(type_tlab, "end", type_reference);
+		default_layout_compound_type(type_tlab);
+
+		ir_type *tls = get_segment_type(IR_SEGMENT_THREAD_LOCAL);
+		gcj_tlab_entity
+			= new_entity(tls, ir_platform_mangle_global("_Jv_tlab"), type_tlab);
+		set_entity_initializer(gcj_tlab_entity, get_initializer_null());
+		/* the runtime references it even if no graph does */
+		add_entity_linkage(gcj_tlab_entity, IR_LINKAGE_HIDDEN_USER);
+	}
+
+	// thin locks of simplert, see simplert/c/monitor.h
+	if (thin_locks) {
+		ir_mode *mode_offset = get_reference_offset_mode(mode_reference);
+		type_lock_word = new_type_primitive(find_unsigned_mode(mode_offset));
+
+		/* only the address of the token matters, it identifies the thread */
+		ir_type *type_byte_u = get_type_for_mode(mode_Bu);
+		ir_type *type_token  = new_type_array(type_byte_u, LOCK_TOKEN_ALIGN);
+		set_type_state(type_token, layout_fixed);
+		ir_type *tls = get_segment_type(IR_SEGMENT_THREAD_LOCAL);
+		gcj_lock_token_entity
+			= new_entity(tls, ir_platform_mangle_global("_Jv_lock_token"), type_token);
+		set_entity_alignment(gcj_lock_token_entity, LOCK_TOKEN_ALIGN);
+		set_entity_initializer(gcj_lock_token_entity, get_initializer_null());
+		/* the runtime references it even if no graph does */
+		add_entity_linkage(gcj_lock_token_entity, IR_LINKAGE_HIDDEN_USER);
+
+		gcj_compare_swap_type = new_compare_swap_type(type_lock_word);
+	}
+
+	// java.util.concurrent.atomic of simplert, see gcji_atomic_intrinsic
+	if (atomic_intrinsics)
+		init_atomic_intrinsics();
+
+	// java.lang.Math, see gcji_math_intrinsic
+	if (math_intrinsics)
+		init_math_intrinsics();
+
+	// zero-cost exceptions of simplert, see simplert/c/exceptions.h
+	if (zero_cost_exceptions) {
+		ir_type *gcj_throw_type = new_type_method(1, 0, false, 0, 0);
+		set_method_param_type(gcj_throw_type, 0, t_ptr);
+		gcj_throw_entity
+			= new_entity(glob, ir_platform_mangle_global("_Jv_Throw"), gcj_throw_type);
+		set_entity_visibility(gcj_throw_entity, ir_visibility_external);
+
+		ir_type *gcj_throw_arithmetic_type = new_type_method(0, 0, false, 0, 0);
+		gcj_throw_arithmetic_entity
+			= new_entity(glob, ir_platform_mangle_global("_Jv_ThrowArithmeticException"), gcj_throw_arithmetic_type);
+		set_entity_visibility(gcj_throw_arithmetic_entity, ir_visibility_external);
+
+		ir_type *gcj_throw_null_pointer_type = new_type_method(0, 0, false, 0, 0);
+		gcj_throw_null_pointer_entity
+			= new_entity(glob, ir_platform_mangle_global("_Jv_ThrowNullPointerException"), gcj_throw_null_pointer_type);
+		set_entity_visibility(gcj_throw_null_pointer_entity, ir_visibility_external);
+
+		ir_type *gcj_throw_array_index_type = new_type_method(1, 0, false, 0, 0);
+		set_method_param_type(gcj_throw_array_index_type, 0, type_int);
+		gcj_throw_array_index_entity
+			= new_entity(glob, ir_platform_mangle_global("_Jv_ThrowBadArrayIndex"), gcj_throw_array_index_type);
+		set_entity_visibility(gcj_throw_array_index_entity, ir_visibility_external);
+
+		ir_type *tls = get_segment_type(IR_SEGMENT_THREAD_LOCAL);
+		gcj_exception_entity
+			= new_entity(tls, ir_platform_mangle_global("_Jv_exception"), type_reference);
+		set_entity_initializer(gcj_exception_entity, get_initializer_null());
+		/* the runtime references it even if no graph does */
+		add_entity_linkage(gcj_exception_entity, IR_LINKAGE_HIDDEN_USER);
+	}
+
+	// safepoint polls of simplert, see simplert/c/gc.c
+	if (safepoint_polls) {
+		gcj_safepoint_flag_entity = extvar("_Jv_safepoint_requested", type_int);
+		ir_type *gcj_safepoint_type = new_type_method(0, 0, false, 0, 0);
+		gcj_safepoint_entity
+			= new_entity(glob, ir_platform_mangle_global("_Jv_Safepoint"), gcj_safepoint_type);
+		set_entity_visibility(gcj_safepoint_entity, ir_visibility_external);
+	}
+
+	// card table of the simplert write barrier, see simplert/c/heap.h
+	if (card_marking) {
+		ir_mode *mode_offset = get_reference_offset_mode(mode_reference);
+		ir_type *type_size   = new_type_primitive(find_unsigned_mode(mode_offset));
+		ir_type *type_table  = new_type_struct(new_id_from_str("card_table"));
+		gcj_card_table_base  = add_compound_member(type_table, "heap_base", type_reference);
+		gcj_card_table_size  = add_compound_member(type_table, "heap_size", type_size);
+		gcj_card_table_cards = add_compound_member(type_table, "cards", type_reference);
+		default_layout_compound_type(type_table);
+		gcj_card_table_entity = extvar("_Jv_card_table", type_table);
+		type_card             = new_type_primitive(mode_Bu);
+	}
+
+	// zeroing elision of simplert, see simplert/c/objects.c
+	if (uninitialized_arrays) {
+		gcj_new_uninitialized_array_entity
+			= new_entity(glob, ir_platform_mangle_global("_Jv_NewPrimArrayUninitialized"), gcj_new_prim_array_method_type);
+		set_entity_visibility(gcj_new_uninitialized_array_entity, ir_visibility_external);
+
+		ir_type *gcj_init_array_copy_type = new_type_method(5, 0, false, 0, 0);
+		set_method_param_type(gcj_init_array_copy_type, 0, t_ptr);
+		set_method_param_type(gcj_init_array_copy_type, 1, type_int);
+		set_method_param_type(gcj_init_array_copy_type, 2, t_ptr);
+		set_method_param_type(gcj_init_array_copy_type, 3, type_int);
+		set_method_param_type(gcj_init_array_copy_type, 4, type_int);
+		gcj_init_array_copy_entity
+			= new_entity(glob, ir_platform_mangle_global("_Jv_InitArrayCopy"), gcj_init_array_copy_type);
+		set_entity_visibility(gcj_init_array_copy_entity, ir_visibility_external);
+
+		arraycopy_ident
+			= new_id_from_str("arraycopy.(Ljava/lang/Object;ILjava/lang/Object;II)V");
+	}
+
+	// string concatenation of simplert, see simplert/c/java_lang_string.c
+	if (string_concat_fusion) {
+		ir_type *gcj_string_concat_type = new_type_method(2, 1, false, 0, 0);
+		set_method_param_type(gcj_string_concat_type, 0, type_int);
+		set_method_param_type(gcj_string_concat_type, 1, t_ptr);
+		set_method_res_type(gcj_string_concat_type, 0, t_ptr);
+		gcj_string_concat_entity
+			= new_entity(glob, ir_platform_mangle_global("_Jv_StringConcat"), gcj_string_concat_type);
+		set_entity_visibility(gcj_string_concat_entity, ir_visibility_external);
+
+		default_init_ident = new_id_from_str("<init>.()V");
+		to_string_ident    = new_id_from_str("toString.()Ljava/lang/String;");
+	}
+
 	mode_ushort = new_int_mode("US", 16, 0, 16);
 	type_ushort = new_type_primitive(mode_ushort);
 
@@ -1213,6 +1708,7 @@ void gcji_deinit()
 	}
 
 	cpset_destroy(&scp);
+	deinit_allocation_lowering();
 }
 
 
@@ -1331,3 +1827,2857 @@ ir_node *gcji_array_data_addr(ir_node *addr)
 	ir_node *offset_cnst = new_Const_long(mode_offset, offset);
 	return new_Add(addr, offset_cnst);
 }
+
+/*
+ * Inline allocation fast paths for the simplert heap.
+ *
+ * Allocations are constructed as calls to the runtime and stay that way
+ * during optimization. Before target lowering the calls are expanded into a
+ * bump of the thread local allocation buffer and the vptr/length
+ * initialization, the runtime is only called if the buffer is exhausted.
+ * These constants must match simplert/c/heap.h.
+ */
+#define HEAP_GRANULE       8
+#define HEAP_LARGE_OBJECT  (32 * 1024 / 4)
+#define HEAP_CARD_SHIFT    9
+
+static cpmap_t rtti2type;
+static bool    rtti2type_valid;
+
+static void collect_rtti_type(ir_type *klass, void *env)
+{
+	(void)env;
+	ir_entity *rtti_entity = oo_get_class_rtti_entity(klass);
+	if (rtti_entity != NULL)
+		cpmap_set(&rtti2type, rtti_entity, klass);
+}
+
+static ir_type *get_type_for_rtti(ir_entity *rtti_entity)
+{
+	if (!rtti2type_valid) {
+		cpmap_init(&rtti2type, hash_ptr, ptr_equals);
+		class_walk_super2sub(collect_rtti_type, NULL, NULL);
+		rtti2type_valid = true;
+	}
+	return cpmap_find(&rtti2type, rtti_entity);
+}
+
+static void deinit_allocation_lowering(void)
+{
+	if (rtti2type_valid) {
+		cpmap_destroy(&rtti2type);
+		rtti2type_valid = false;
+	}
+}
+
+static ir_type *get_prim_type_for_rtti(ir_entity *rtti_entity)
+{
+	if (rtti_entity == gcj_boolean_rtti_entity)
+		return type_boolean;
+	if (rtti_entity == gcj_byte_rtti_entity)
+		return type_byte;
+	if (rtti_entity == gcj_char_rtti_entity)
+		return type_char;
+	if (rtti_entity == gcj_short_rtti_entity)
+		return type_short;
+	if (rtti_entity == gcj_int_rtti_entity)
+		return type_int;
+	if (rtti_entity == gcj_long_rtti_entity)
+		return type_long;
+	if (rtti_entity == gcj_float_rtti_entity)
+		return type_float;
+	if (rtti_entity == gcj_double_rtti_entity)
+		return type_double;
+	return NULL;
+}
+
+static ir_node *add_offset(ir_node *block, ir_node *ptr, unsigned offset)
+{
+	if (offset == 0)
+		return ptr;
+	ir_graph *irg         = get_irn_irg(block);
+	ir_mode  *mode_offset = get_reference_offset_mode(get_irn_mode(ptr));
+	ir_node  *cnst        = new_r_Const_long(irg, mode_offset, offset);
+	return new_r_Add(block, ptr, cnst);
+}
+
+static ir_node *load_reference(ir_node *block, ir_node **mem, ir_node *addr)
+{
+	ir_node *load = new_r_Load(block, *mem, addr, mode_reference,
+	                           type_reference, cons_none);
+	*mem = new_r_Proj(load, mode_M, pn_Load_M);
+	return new_r_Proj(load, mode_reference, pn_Load_res);
+}
+
+static ir_node *store_value(ir_node *block, ir_node *mem, ir_node *addr,
+                            ir_node *value, ir_type *type)
+{
+	ir_node *store = new_r_Store(block, mem, addr, value, type, cons_none);
+	return new_r_Proj(store, mode_M, pn_Store_M);
+}
+
+/**
+ * Returns the result of @p call and its memory Proj in @p mem_proj or NULL.
+ * Calls with exception control flow are left alone unless @p may_throw, the
+ * caller of a Java method call then removes it with the call (see
+ * remove_exception_flow).
+ */
+static ir_node *get_result_proj(ir_node *call, ir_node **mem_proj,
+                                bool may_throw)
+{
+	ir_node *ress = NULL;
+	*mem_proj = NULL;
+	foreach_out_edge(call, edge) {
+		ir_node *proj = get_edge_src_irn(edge);
+		if (!is_Proj(proj))
+			continue;
+		switch (get_Proj_num(proj)) {
+		case pn_Call_M:        *mem_proj = proj; break;
+		case pn_Call_T_result: ress      = proj; break;
+		case pn_Call_X_regular:
+		case pn_Call_X_except:
+			if (!may_throw)
+				return NULL;
+			break;
+		default:               return NULL;
+		}
+	}
+	if (ress == NULL || *mem_proj == NULL)
+		return NULL;
+	foreach_out_edge(ress, edge) {
+		ir_node *proj = get_edge_src_irn(edge);
+		if (is_Proj(proj) && get_Proj_num(proj) == 0)
+			return proj;
+	}
+	return NULL;
+}
+
+static bool lower_allocation(ir_node *call)
+{
+	ir_entity *callee = get_Address_entity(get_Call_ptr(call));
+	ir_node   *jclass;
+	ir_node   *count  = NULL;
+	ir_type   *type   = NULL;
+	unsigned   elsize = 0;
+	if (callee == gcj_alloc_entity) {
+		jclass = get_Call_param(call, 0);
+		if (!is_Address(jclass))
+			return false;
+		type = get_type_for_rtti(get_Address_entity(jclass));
+		if (type == NULL || oo_get_class_is_extern(type)
+		    || oo_get_class_vtable_entity(type) == NULL
+		    || get_type_size(type) > HEAP_LARGE_OBJECT)
+			return false;
+	} else if (callee == gcj_new_prim_array_entity
+	           || callee == gcj_new_uninitialized_array_entity) {
+		/* the buffer is zeroed anyway, only the slow path differs */
+		jclass = get_Call_param(call, 0);
+		count  = get_Call_param(call, 1);
+		if (!is_Address(jclass))
+			return false;
+		ir_type *eltype = get_prim_type_for_rtti(get_Address_entity(jclass));
+		if (eltype == NULL)
+			return false;
+		elsize = get_type_size(eltype);
+	} else {
+		assert(callee == gcj_new_object_array_entity);
+		count  = get_Call_param(call, 0);
+		jclass = get_Call_param(call, 1);
+		ir_node *init = get_Call_param(call, 2);
+		if (!is_Const(init) || !is_Const_null(init))
+			return false;
+		elsize = get_mode_size_bytes(mode_reference);
+	}
+
+	ir_node *mem_proj;
+	ir_node *res_proj = get_result_proj(call, &mem_proj, false);
+	if (res_proj == NULL)
+		return false;
+
+	ir_graph *irg         = get_irn_irg(call);
+	ir_mode  *mode_offset = get_reference_offset_mode(mode_reference);
+	ir_node  *mem         = get_Call_mem(call);
+	ir_node  *lower_block = part_block_edges(call);
+	ir_node  *block       = get_nodes_block(call);
+
+	ir_node *tlab     = new_r_Address(irg, gcj_tlab_entity);
+	ir_node *top_addr = add_offset(block, tlab, get_entity_offset(gcj_tlab_top));
+	ir_node *end_addr = add_offset(block, tlab, get_entity_offset(gcj_tlab_end));
+	ir_node *top      = load_reference(block, &mem, top_addr);
+	ir_node *end      = load_reference(block, &mem, end_addr);
+
+	ir_node *slow_preds[2];
+	int      n_slow_preds = 0;
+	ir_node *size;
+	ir_node *vtable;
+	if (type != NULL) {
+		ir_entity *vtable_ent = oo_get_class_vtable_entity(type);
+		unsigned   vptr_index = ddispatch_get_vptr_points_to_index();
+		unsigned   obj_size   = (get_type_size(type) + HEAP_GRANULE-1)
+		                      & ~(HEAP_GRANULE-1);
+		size   = new_r_Const_long(irg, mode_offset, obj_size);
+		vtable = add_offset(block, new_r_Address(irg, vtable_ent),
+		                    vptr_index * get_mode_size_bytes(mode_reference));
+	} else {
+		/* Larger arrays go to the runtime, this also rules out negative
+		 * counts and overflows in the size computation. The array class is
+		 * created lazily by the runtime, so we need it to exist as well. */
+		ir_mode *count_mode = get_irn_mode(count);
+		long     max_count  = (HEAP_LARGE_OBJECT - array_header_size) / elsize;
+		ir_node *max        = new_r_Const_long(irg, count_mode, max_count);
+		ir_node *small      = new_r_Cmp(block, count, max,
+		                                ir_relation_less_equal);
+		ir_node *aclass_addr
+			= add_offset(block, jclass, get_entity_offset(gcj_class_arrayclass));
+		ir_node *aclass     = load_reference(block, &mem, aclass_addr);
+		ir_node *null       = new_r_Const(irg, get_mode_null(mode_reference));
+		ir_node *has_class  = new_r_Cmp(block, aclass, null,
+		                                ir_relation_less_greater);
+		ir_node *ok         = new_r_And(block, small, has_class);
+		ir_node *cond       = new_r_Cond(block, ok);
+		ir_node *proj_true  = new_r_Proj(cond, mode_X, pn_Cond_true);
+		slow_preds[n_slow_preds++] = new_r_Proj(cond, mode_X, pn_Cond_false);
+
+		block = new_r_Block(irg, 1, &proj_true);
+		ir_node *vtable_addr
+			= add_offset(block, aclass, get_entity_offset(gcj_class_vtable));
+		vtable = load_reference(block, &mem, vtable_addr);
+
+		ir_node *count_offs = new_r_Conv(block, count, mode_offset);
+		ir_node *elsize_c   = new_r_Const_long(irg, mode_offset, elsize);
+		ir_node *data_size  = new_r_Mul(block, count_offs, elsize_c);
+		ir_node *header     = new_r_Const_long(irg, mode_offset,
+		                                       array_header_size + HEAP_GRANULE-1);
+		ir_node *unaligned  = new_r_Add(block, data_size, header);
+		ir_node *mask       = new_r_Const_long(irg, mode_offset,
+		                                       ~(long)(HEAP_GRANULE-1));
+		size = new_r_And(block, unaligned, mask);
+	}
+
+	ir_node *new_top   = new_r_Add(block, top, size);
+	ir_node *fits      = new_r_Cmp(block, new_top, end, ir_relation_less_equal);
+	ir_node *cond      = new_r_Cond(block, fits);
+	ir_node *proj_true = new_r_Proj(cond, mode_X, pn_Cond_true);
+	slow_preds[n_slow_preds++] = new_r_Proj(cond, mode_X, pn_Cond_false);
+
+	/* fast path: bump the pointer and initialize the header, the buffer
+	 * is zeroed by the runtime */
+	ir_node   *fast_block  = new_r_Block(irg, 1, &proj_true);
+	ir_entity *vptr_entity = get_vptr_entity();
+	ir_node   *vptr_addr
+		= add_offset(fast_block, top, get_entity_offset(vptr_entity));
+	mem = store_value(fast_block, mem, top_addr, new_top, type_reference);
+	mem = store_value(fast_block, mem, vptr_addr, vtable,
+	                  get_entity_type(vptr_entity));
+	if (count != NULL) {
+		ir_node *length_addr
+			= add_offset(fast_block, top, get_entity_offset(gcj_array_length));
+		ir_node *length = new_r_Conv(fast_block, count, mode_int);
+		mem = store_value(fast_block, mem, length_addr, length, type_int);
+	}
+	ir_node *fast_jmp = new_r_Jmp(fast_block);
+
+	/* slow path: the original runtime call */
+	ir_node *slow_block = new_r_Block(irg, n_slow_preds, slow_preds);
+	set_nodes_block(call, slow_block);
+	ir_node *slow_jmp = new_r_Jmp(slow_block);
+
+	ir_node *preds[] = { fast_jmp, slow_jmp };
+	set_irn_in(lower_block, ARRAY_SIZE(preds), preds);
+
+	ir_node *mems[]  = { mem, mem_proj };
+	ir_node *mem_phi = new_r_Phi(lower_block, ARRAY_SIZE(mems), mems, mode_M);
+	ir_node *ress[]  = { top, res_proj };
+	ir_node *res_phi = new_r_Phi(lower_block, ARRAY_SIZE(ress), ress,
+	                             mode_reference);
+	edges_reroute_except(mem_proj, mem_phi, mem_phi);
+	edges_reroute_except(res_proj, res_phi, res_phi);
+	return true;
+}
+
+static void collect_allocations(ir_node *node, void *env)
+{
+	ir_node ***calls = (ir_node***)env;
+	if (!is_Call(node))
+		return;
+	ir_node *ptr = get_Call_ptr(node);
+	if (!is_Address(ptr))
+		return;
+	ir_entity *callee = get_Address_entity(ptr);
+	if (callee == gcj_alloc_entity || callee == gcj_new_prim_array_entity
+	    || callee == gcj_new_object_array_entity
+	    || callee == gcj_new_uninitialized_array_entity)
+		ARR_APP1(ir_node*, *calls, node);
+}
+
+void gcji_lower_allocations(ir_graph *irg)
+{
+	if (!inline_allocation)
+		return;
+
+	ir_node **calls = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, NULL, collect_allocations, &calls);
+
+	bool changed = false;
+	if (ARR_LEN(calls) > 0) {
+		assure_edges(irg);
+		for (size_t i = 0, n = ARR_LEN(calls); i < n; ++i) {
+			changed |= lower_allocation(calls[i]);
+		}
+	}
+	DEL_ARR_F(calls);
+
+	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_NONE
+	                                    : IR_GRAPH_PROPERTIES_ALL);
+}
+
+/*
+ * Thin locks
+ *
+ * monitorenter and monitorexit are constructed as calls to the runtime like
+ * allocations. With thin_locks they are expanded late into the fast paths
+ * of simplert/c/monitor.c: entering an unlocked object is a compare and swap
+ * of its lock word from 0 to the address of the thread's _Jv_lock_token,
+ * leaving it again is a plain store of 0 if the word still holds just that
+ * address. Recursion, inflated locks and contention go to the runtime.
+ */
+
+static ir_node *get_monitor_mem_proj(ir_node *call)
+{
+	ir_node *mem_proj = NULL;
+	foreach_out_edge(call, edge) {
+		ir_node *proj = get_edge_src_irn(edge);
+		if (!is_Proj(proj))
+			continue;
+		/* inside a try block, leave it alone */
+		if (get_Proj_num(proj) != pn_Call_M)
+			return NULL;
+		mem_proj = proj;
+	}
+	return mem_proj;
+}
+
+static bool lower_monitor(ir_node *call)
+{
+	ir_node *mem_proj = get_monitor_mem_proj(call);
+	if (mem_proj == NULL)
+		return false;
+
+	ir_entity *callee      = get_Address_entity(get_Call_ptr(call));
+	ir_graph  *irg         = get_irn_irg(call);
+	ir_mode   *mode_lock   = get_type_mode(type_lock_word);
+	ir_node   *objptr      = get_Call_param(call, 0);
+	ir_node   *mem         = get_Call_mem(call);
+	ir_node   *lower_block = part_block_edges(call);
+	ir_node   *block       = get_nodes_block(call);
+
+	ir_node *lock_addr
+		= add_offset(block, objptr, get_entity_offset(gcj_object_lock));
+	ir_node *token_addr = new_r_Address(irg, gcj_lock_token_entity);
+	ir_node *token      = new_r_Conv(block, token_addr, mode_lock);
+	ir_node *zero       = new_r_Const(irg, get_mode_null(mode_lock));
+
+	ir_node *fast_pred;
+	if (callee == gcj_monitor_enter_entity) {
+		ir_node *in[]     = { lock_addr, zero, token };
+		ir_node *cas      = new_r_Builtin(block, mem, ARRAY_SIZE(in), in,
+		                                  ir_bk_compare_swap,
+		                                  gcj_compare_swap_type);
+		ir_node *old      = new_r_Proj(cas, mode_lock, pn_Builtin_max+1);
+		ir_node *unlocked = new_r_Cmp(block, old, zero, ir_relation_equal);
+		ir_node *cond     = new_r_Cond(block, unlocked);
+		set_Cond_jmp_pred(cond, COND_JMP_PRED_TRUE);
+		mem       = new_r_Proj(cas, mode_M, pn_Builtin_M);
+		fast_pred = new_r_Proj(cond, mode_X, pn_Cond_true);
+
+		ir_node *proj_false = new_r_Proj(cond, mode_X, pn_Cond_false);
+		ir_node *slow_block = new_r_Block(irg, 1, &proj_false);
+		set_nodes_block(call, slow_block);
+		set_Call_mem(call, mem);
+	} else {
+		assert(callee == gcj_monitor_exit_entity);
+		ir_node *load     = new_r_Load(block, mem, lock_addr, mode_lock,
+		                               type_lock_word, cons_volatile);
+		ir_node *word     = new_r_Proj(load, mode_lock, pn_Load_res);
+		ir_node *load_mem = new_r_Proj(load, mode_M, pn_Load_M);
+		ir_node *owned    = new_r_Cmp(block, word, token, ir_relation_equal);
+		ir_node *cond     = new_r_Cond(block, owned);
+		set_Cond_jmp_pred(cond, COND_JMP_PRED_TRUE);
+
+		/* stores are not reordered with older memory accesses on x86, so
+		 * a plain store releases the lock */
+		ir_node *proj_true  = new_r_Proj(cond, mode_X, pn_Cond_true);
+		ir_node *fast_block = new_r_Block(irg, 1, &proj_true);
+		ir_node *store      = new_r_Store(fast_block, load_mem, lock_addr,
+		                                  zero, type_lock_word, cons_volatile);
+		mem       = new_r_Proj(store, mode_M, pn_Store_M);
+		fast_pred = new_r_Jmp(fast_block);
+
+		ir_node *proj_false = new_r_Proj(cond, mode_X, pn_Cond_false);
+		ir_node *slow_block = new_r_Block(irg, 1, &proj_false);
+		set_nodes_block(call, slow_block);
+		set_Call_mem(call, load_mem);
+	}
+	ir_node *slow_jmp = new_r_Jmp(get_nodes_block(call));
+
+	ir_node *preds[] = { fast_pred, slow_jmp };
+	set_irn_in(lower_block, ARRAY_SIZE(preds), preds);
+
+	ir_node *mems[]  = { mem, mem_proj };
+	ir_node *mem_phi = new_r_Phi(lower_block, ARRAY_SIZE(mems), mems, mode_M);
+	edges_reroute_except(mem_proj, mem_phi, mem_phi);
+	return true;
+}
+
+static void collect_monitors(ir_node *node, void *env)
+{
+	ir_node ***calls = (ir_node***)env;
+	if (!is_Call(node))
+		return;
+	ir_node *ptr = get_Call_ptr(node);
+	if (!is_Address(ptr))
+		return;
+	ir_entity *callee = get_Address_entity(ptr);
+	if (callee == gcj_monitor_enter_entity || callee == gcj_monitor_exit_entity)
+		ARR_APP1(ir_node*, *calls, node);
+}
+
+void gcji_lower_monitors(ir_graph *irg)
+{
+	if (!thin_locks)
+		return;
+
+	ir_node **calls = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, NULL, collect_monitors, &calls);
+
+	bool changed = false;
+	if (ARR_LEN(calls) > 0) {
+		assure_edges(irg);
+		for (size_t i = 0, n = ARR_LEN(calls); i < n; ++i) {
+			changed |= lower_monitor(calls[i]);
+		}
+	}
+	DEL_ARR_F(calls);
+
+	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_NONE
+	                                    : IR_GRAPH_PROPERTIES_ALL);
+}
+
+/*
+ * GC root tables and safepoints
+ */
+
+void gcji_create_static_roots(void)
+{
+	if (!emit_gc_roots)
+		return;
+
+	/* every static field holding a reference, the table is NULL terminated */
+	ir_entity **roots = NEW_ARR_F(ir_entity*, 0);
+	for (size_t i = 0, n = get_compound_n_members(glob); i < n; ++i) {
+		ir_entity *entity = get_compound_member(glob, i);
+		if (is_method_entity(entity)
+		    || !is_Pointer_type(get_entity_type(entity))
+		    || get_entity_visibility(entity) == ir_visibility_external)
+			continue;
+		ARR_APP1(ir_entity*, roots, entity);
+	}
+
+	size_t   n_roots    = ARR_LEN(roots);
+	ir_type *type_array = new_type_array(type_reference, n_roots + 1);
+	set_type_size(type_array, (n_roots + 1) * get_type_size(type_reference));
+
+	ir_initializer_t *init = create_initializer_compound(n_roots + 1);
+	for (size_t i = 0; i < n_roots; ++i) {
+		set_compound_init_entref(init, i, roots[i]);
+	}
+	set_compound_init_null(init, n_roots);
+	DEL_ARR_F(roots);
+
+	ident     *id    = ir_platform_mangle_global("_Jv_static_roots");
+	ir_entity *table = new_entity(glob, id, type_array);
+	set_entity_initializer(table, init);
+	/* the runtime references it even if no graph does */
+	set_entity_linkage(table, IR_LINKAGE_CONSTANT | IR_LINKAGE_HIDDEN_USER);
+}
+
+/*
+ * Implicit exceptions of simplert
+ */
+
+void gcji_create_implicit_exception_table(void)
+{
+	if (!zero_cost_exceptions)
+		return;
+
+	/* the classes in the order of implicit_exception_t */
+	size_t n_classes = 0;
+	while (gcji_implicit_exceptions[n_classes] != NULL)
+		++n_classes;
+
+	ir_type *type_array = new_type_array(type_reference, n_classes);
+	set_type_size(type_array, n_classes * get_type_size(type_reference));
+
+	ir_initializer_t *init = create_initializer_compound(n_classes);
+	for (size_t i = 0; i < n_classes; ++i) {
+		ir_type *type = class_registry_get(gcji_implicit_exceptions[i]);
+		assert(type != NULL);
+		set_compound_init_entref(init, i, oo_get_class_rtti_entity(type));
+	}
+
+	ident     *id    = ir_platform_mangle_global("_Jv_implicit_exception_classes");
+	ir_entity *table = new_entity(glob, id, type_array);
+	set_entity_initializer(table, init);
+	/* the runtime references it even if no graph does */
+	set_entity_linkage(table, IR_LINKAGE_CONSTANT | IR_LINKAGE_HIDDEN_USER);
+}
+
+/*
+ * Exception table of simplert
+ *
+ * Java calls have exception control flow (see new_throwing_Call in
+ * reader.c), their exceptional exit leads to a landing pad or, if no handler
+ * covers them, to the end block. After the optimizations the blocks both
+ * exits of a call with a landing pad lead to get labels and the pair goes
+ * into _Jv_exception_sites. The unwinder of simplert/c/exceptions.c finds
+ * the landing pad by the return address of the call: the block of the
+ * regular exit either follows the call or the call is followed by a jump to
+ * it, as the call ends its block.
+ *
+ * The return addresses of all Java calls with a source line (see
+ * get_line_dbg in reader.c) go into _Jv_line_numbers the same way, together
+ * with the source file and the line. Stack traces look them up.
+ */
+typedef struct exception_site_t {
+	ir_node *regular;  /**< X_regular Proj of the call */
+	ir_node *except;   /**< X_except Proj of the call */
+} exception_site_t;
+
+static void collect_exception_sites(ir_node *node, void *env)
+{
+	exception_site_t **sites = (exception_site_t**)env;
+	if (!is_Call(node) || !ir_throws_exception(node))
+		return;
+
+	exception_site_t site = { NULL, NULL };
+	foreach_out_edge(node, edge) {
+		ir_node *proj = get_edge_src_irn(edge);
+		if (!is_Proj(proj))
+			continue;
+		switch (get_Proj_num(proj)) {
+		case pn_Call_X_regular: site.regular = proj; break;
+		case pn_Call_X_except:  site.except  = proj; break;
+		default:                break;
+		}
+	}
+	/* calls without handlers need no entry */
+	if (site.regular == NULL || site.except == NULL)
+		return;
+	ir_node *end_block = get_irg_end_block(get_irn_irg(node));
+	foreach_out_edge(site.except, edge) {
+		if (get_edge_src_irn(edge) == end_block)
+			return;
+	}
+	ARR_APP1(exception_site_t, *sites, site);
+}
+
+typedef struct line_site_t {
+	ir_node  *regular;  /**< X_regular Proj of the call */
+	src_loc_t loc;
+} line_site_t;
+
+static void collect_line_sites(ir_node *node, void *env)
+{
+	line_site_t **sites = (line_site_t**)env;
+	if (!is_Call(node) || !ir_throws_exception(node))
+		return;
+	dbg_info *dbgi = get_irn_dbg_info(node);
+	if (dbgi == NULL)
+		return;
+
+	foreach_out_edge(node, edge) {
+		ir_node *proj = get_edge_src_irn(edge);
+		if (is_Proj(proj) && get_Proj_num(proj) == pn_Call_X_regular) {
+			line_site_t site = { proj, ir_retrieve_dbg_info(dbgi) };
+			ARR_APP1(line_site_t, *sites, site);
+		}
+	}
+}
+
+/**
+ * Returns a label for the block the control flow @p proj leads to. The edge
+ * is split unless the block has no other predecessors, so the label is
+ * exactly where the control flow of the call continues.
+ */
+static ir_entity *label_successor(ir_node *proj)
+{
+	ir_node *target = NULL;
+	int      pos    = -1;
+	foreach_out_edge(proj, edge) {
+		ir_node *user = get_edge_src_irn(edge);
+		if (is_Block(user)) {
+			target = user;
+			pos    = get_edge_src_pos(edge);
+		}
+	}
+	assert(target != NULL);
+
+	if (get_Block_n_cfgpreds(target) > 1) {
+		ir_graph *irg   = get_irn_irg(proj);
+		ir_node  *in[]  = { proj };
+		ir_node  *split = new_r_Block(irg, ARRAY_SIZE(in), in);
+		set_Block_cfgpred(target, pos, new_r_Jmp(split));
+		target = split;
+	}
+	return create_Block_entity(target);
+}
+
+/**
+ * Emits the NULL terminated table of all classes, stack traces are
+ * symbolized through their method tables. It is created after the unused
+ * classes were removed and keeps none of them alive.
+ */
+static void create_class_table(void)
+{
+	ir_entity **classes = NEW_ARR_F(ir_entity*, 0);
+	for (size_t i = 0, n = get_compound_n_members(glob); i < n; ++i) {
+		ir_entity *entity = get_compound_member(glob, i);
+		if (get_entity_type(entity) != type_java_lang_class
+		    || get_entity_visibility(entity) == ir_visibility_external)
+			continue;
+		ARR_APP1(ir_entity*, classes, entity);
+	}
+
+	size_t   n_classes  = ARR_LEN(classes);
+	ir_type *type_array = new_type_array(type_reference, n_classes + 1);
+	set_type_size(type_array, (n_classes + 1) * get_type_size(type_reference));
+
+	ir_initializer_t *init = create_initializer_compound(n_classes + 1);
+	for (size_t i = 0; i < n_classes; ++i) {
+		set_compound_init_entref(init, i, classes[i]);
+	}
+	set_compound_init_null(init, n_classes);
+	DEL_ARR_F(classes);
+
+	ident     *id    = ir_platform_mangle_global("_Jv_classes");
+	ir_entity *table = new_entity(glob, id, type_array);
+	set_entity_initializer(table, init);
+	/* the runtime references it even if no graph does */
+	set_entity_linkage(table, IR_LINKAGE_CONSTANT | IR_LINKAGE_HIDDEN_USER);
+}
+
+/**
+ * Emits _Jv_line_numbers, triples of return address, source file and line
+ * terminated by a NULL triple. It is writable as the runtime sorts it.
+ */
+static void create_line_table(ir_entity *const *labels, const src_loc_t *locs)
+{
+	size_t   n_sites    = ARR_LEN(labels);
+	size_t   n_entries  = 3 * (n_sites + 1);
+	ir_type *type_array = new_type_array(type_reference, n_entries);
+	set_type_size(type_array, n_entries * get_type_size(type_reference));
+
+	ir_mode          *mode_line = get_reference_offset_mode(mode_reference);
+	ir_initializer_t *init      = create_initializer_compound(n_entries);
+	for (size_t i = 0; i < n_sites; ++i) {
+		const char *file = locs[i].file;
+		set_compound_init_entref(init, 3 * i, labels[i]);
+		set_compound_init_entref(init, 3 * i + 1,
+		                         do_emit_utf8_const(file, strlen(file)));
+		set_compound_init_num(init, 3 * i + 2, mode_line, locs[i].line);
+	}
+	for (size_t i = 3 * n_sites; i < n_entries; ++i) {
+		set_compound_init_null(init, i);
+	}
+
+	ident     *id    = ir_platform_mangle_global("_Jv_line_numbers");
+	ir_entity *table = new_entity(glob, id, type_array);
+	set_entity_initializer(table, init);
+	/* the runtime references it even if no graph does */
+	add_entity_linkage(table, IR_LINKAGE_HIDDEN_USER);
+}
+
+void gcji_create_exception_table(void)
+{
+	if (!zero_cost_exceptions)
+		return;
+
+	create_class_table();
+
+	/* pairs of return address and landing pad */
+	ir_entity **labels = NEW_ARR_F(ir_entity*, 0);
+	/* return addresses and their source lines */
+	ir_entity **line_labels = NEW_ARR_F(ir_entity*, 0);
+	src_loc_t  *line_locs   = NEW_ARR_F(src_loc_t, 0);
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i) {
+		ir_graph         *irg        = get_irp_irg(i);
+		exception_site_t *sites      = NEW_ARR_F(exception_site_t, 0);
+		line_site_t      *line_sites = NEW_ARR_F(line_site_t, 0);
+		assure_edges(irg);
+		irg_walk_graph(irg, NULL, collect_exception_sites, &sites);
+		irg_walk_graph(irg, NULL, collect_line_sites, &line_sites);
+
+		size_t n_sites = ARR_LEN(sites);
+		for (size_t s = 0; s < n_sites; ++s) {
+			ir_entity *ret     = label_successor(sites[s].regular);
+			ir_entity *landing = label_successor(sites[s].except);
+			ARR_APP1(ir_entity*, labels, ret);
+			ARR_APP1(ir_entity*, labels, landing);
+		}
+		size_t n_line_sites = ARR_LEN(line_sites);
+		for (size_t s = 0; s < n_line_sites; ++s) {
+			ir_entity *ret = label_successor(line_sites[s].regular);
+			ARR_APP1(ir_entity*, line_labels, ret);
+			ARR_APP1(src_loc_t, line_locs, line_sites[s].loc);
+		}
+		DEL_ARR_F(sites);
+		DEL_ARR_F(line_sites);
+		bool changed = n_sites > 0 || n_line_sites > 0;
+		confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_NONE
+		                                    : IR_GRAPH_PROPERTIES_ALL);
+	}
+	create_line_table(line_labels, line_locs);
+	DEL_ARR_F(line_labels);
+	DEL_ARR_F(line_locs);
+
+	/* terminated by a NULL pair, it is writable as the runtime sorts it */
+	size_t   n_labels   = ARR_LEN(labels);
+	size_t   n_entries  = n_labels + 2;
+	ir_type *type_array = new_type_array(type_reference, n_entries);
+	set_type_size(type_array, n_entries * get_type_size(type_reference));
+
+	ir_initializer_t *init = create_initializer_compound(n_entries);
+	for (size_t i = 0; i < n_labels; ++i) {
+		set_compound_init_entref(init, i, labels[i]);
+	}
+	set_compound_init_null(init, n_labels);
+	set_compound_init_null(init, n_labels + 1);
+	DEL_ARR_F(labels);
+
+	ident     *id    = ir_platform_mangle_global("_Jv_exception_sites");
+	ir_entity *table = new_entity(glob, id, type_array);
+	set_entity_initializer(table, init);
+	/* the runtime references it even if no graph does */
+	add_entity_linkage(table, IR_LINKAGE_HIDDEN_USER);
+}
+
+/*
+ * Local throws
+ *
+ * After inlining, a throw and the handler catching it may end up in the
+ * same graph: the exceptional exit of the _Jv_Throw call leads to a landing
+ * pad of the graph. Unwinding is not needed then, the exception is stored
+ * where the landing pad loads it from and the call becomes a jump.
+ */
+
+static void collect_throws(ir_node *node, void *env)
+{
+	ir_node ***calls = (ir_node***)env;
+	if (!is_Call(node))
+		return;
+	ir_node *ptr = get_Call_ptr(node);
+	if (is_Address(ptr) && get_Address_entity(ptr) == gcj_throw_entity)
+		ARR_APP1(ir_node*, *calls, node);
+}
+
+/**
+ * Returns whether @p block only leads to the end block through blocks
+ * without code, like the block inlining merges the exceptional exits of a
+ * graph in. Exceptions going there leave the method.
+ */
+static bool leaves_method(ir_node *block)
+{
+	ir_node *end_block = get_irg_end_block(get_irn_irg(block));
+	while (block != end_block) {
+		ir_node *jmp = NULL;
+		foreach_out_edge(block, edge) {
+			ir_node *node = get_edge_src_irn(edge);
+			if (is_Jmp(node)) {
+				jmp = node;
+			} else if (!is_Phi(node) && !is_End(node)) {
+				return false;
+			}
+		}
+		if (jmp == NULL)
+			return false;
+		block = get_edge_src_irn(get_irn_out_edge_first(jmp));
+	}
+	return true;
+}
+
+/** Returns whether @p exception is certainly not null. */
+static bool is_non_null(ir_node *exception)
+{
+	const ir_node *confirm;
+	if (value_not_null(exception, &confirm))
+		return true;
+	/* an object allocated by the method */
+	if (!is_Proj(exception))
+		return false;
+	ir_node *results = get_Proj_pred(exception);
+	if (!is_Proj(results))
+		return false;
+	ir_node *call = get_Proj_pred(results);
+	if (!is_Call(call))
+		return false;
+	ir_node *ptr = get_Call_ptr(call);
+	return is_Address(ptr) && get_Address_entity(ptr) == gcj_alloc_entity;
+}
+
+static bool lower_local_throw(ir_node *call)
+{
+	ir_node *mem     = NULL;
+	ir_node *regular = NULL;
+	ir_node *except  = NULL;
+	foreach_out_edge(call, edge) {
+		ir_node *proj = get_edge_src_irn(edge);
+		if (!is_Proj(proj))
+			continue;
+		switch (get_Proj_num(proj)) {
+		case pn_Call_M:         mem     = proj; break;
+		case pn_Call_X_regular: regular = proj; break;
+		case pn_Call_X_except:  except  = proj; break;
+		default:                break;
+		}
+	}
+	if (except == NULL)
+		return false;
+
+	ir_node *landing_pad = NULL;
+	foreach_out_edge(except, edge) {
+		ir_node *user = get_edge_src_irn(edge);
+		if (is_Block(user))
+			landing_pad = user;
+	}
+	/* throw null raises a NullPointerException in _Jv_Throw */
+	ir_node *exception = get_Call_param(call, 0);
+	if (landing_pad == NULL || leaves_method(landing_pad)
+	    || !is_non_null(exception))
+		return false;
+
+	ir_graph *irg   = get_irn_irg(call);
+	ir_node  *block = get_nodes_block(call);
+	ir_node  *addr  = new_r_Address(irg, gcj_exception_entity);
+	ir_node  *store = new_r_Store(block, get_Call_mem(call), addr, exception,
+	                              type_reference, cons_none);
+	if (mem != NULL)
+		exchange(mem, new_r_Proj(store, mode_M, pn_Store_M));
+	exchange(except, new_r_Jmp(block));
+	if (regular != NULL)
+		exchange(regular, new_r_Bad(irg, mode_X));
+	return true;
+}
+
+void gcji_lower_local_throws(ir_graph *irg)
+{
+	if (!zero_cost_exceptions)
+		return;
+
+	ir_node **calls = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, NULL, collect_throws, &calls);
+
+	bool changed = false;
+	if (ARR_LEN(calls) > 0) {
+		assure_edges(irg);
+		for (size_t i = 0, n = ARR_LEN(calls); i < n; ++i) {
+			changed |= lower_local_throw(calls[i]);
+		}
+	}
+	DEL_ARR_F(calls);
+
+	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_NONE
+	                                    : IR_GRAPH_PROPERTIES_ALL);
+}
+
+typedef struct backedge_t {
+	ir_node *header;
+	int      pos;
+} backedge_t;
+
+typedef struct poll_sites_t {
+	backedge_t *backedges;
+	ir_node   **returns;
+	bool        has_calls;
+} poll_sites_t;
+
+static void link_memory_phi(ir_node *node, void *env)
+{
+	(void)env;
+	if (is_Phi(node) && get_irn_mode(node) == mode_M)
+		set_irn_link(get_nodes_block(node), node);
+}
+
+static void collect_poll_sites(ir_node *node, void *env)
+{
+	poll_sites_t *sites = (poll_sites_t*)env;
+	if (is_Return(node)) {
+		ARR_APP1(ir_node*, sites->returns, node);
+		return;
+	}
+	if (is_Call(node)) {
+		sites->has_calls = true;
+		return;
+	}
+	if (!is_Block(node))
+		return;
+	for (int i = 0, n = get_Block_n_cfgpreds(node); i < n; ++i) {
+		if (!is_backedge(node, i))
+			continue;
+		backedge_t backedge = { node, i };
+		ARR_APP1(backedge_t, sites->backedges, backedge);
+	}
+}
+
+/**
+ * Tests the safepoint flag after the control flow @p pred with the memory
+ * *@p mem, the runtime is only called if the flag is set. Returns the block
+ * where execution continues, *@p mem is updated to the memory there.
+ */
+static ir_node *new_safepoint_poll(ir_node *pred, ir_node **mem)
+{
+	ir_graph *irg       = get_irn_irg(pred);
+	ir_node  *block     = new_r_Block(irg, 1, &pred);
+	ir_node  *flag_addr = new_r_Address(irg, gcj_safepoint_flag_entity);
+	ir_node  *load      = new_r_Load(block, *mem, flag_addr, mode_int,
+	                                 type_int, cons_volatile);
+	ir_node  *flag      = new_r_Proj(load, mode_int, pn_Load_res);
+	ir_node  *zero      = new_r_Const_long(irg, mode_int, 0);
+	ir_node  *requested = new_r_Cmp(block, flag, zero,
+	                                ir_relation_less_greater);
+	ir_node  *cond      = new_r_Cond(block, requested);
+	ir_node  *proj_true = new_r_Proj(cond, mode_X, pn_Cond_true);
+	ir_node  *load_mem  = new_r_Proj(load, mode_M, pn_Load_M);
+	set_Cond_jmp_pred(cond, COND_JMP_PRED_FALSE);
+
+	ir_node *slow_block = new_r_Block(irg, 1, &proj_true);
+	ir_node *callee     = new_r_Address(irg, gcj_safepoint_entity);
+	ir_node *call       = new_r_Call(slow_block, load_mem, callee, 0, NULL,
+	                                 get_entity_type(gcj_safepoint_entity));
+	ir_node *slow_mem   = new_r_Proj(call, mode_M, pn_Call_M);
+
+	ir_node *preds[] = { new_r_Proj(cond, mode_X, pn_Cond_false),
+	                     new_r_Jmp(slow_block) };
+	ir_node *merge   = new_r_Block(irg, ARRAY_SIZE(preds), preds);
+	ir_node *mems[]  = { load_mem, slow_mem };
+	*mem = new_r_Phi(merge, ARRAY_SIZE(mems), mems, mode_M);
+	return merge;
+}
+
+/**
+ * Routes the backedge through a poll. A loop without a memory phi writes
+ * no memory, other threads still wait for it at collections, so its poll
+ * starts from the initial memory and is kept alive; the control flow alone
+ * places it in the loop.
+ */
+static void insert_backedge_poll(ir_node *header, int pos)
+{
+	ir_graph *irg     = get_irn_irg(header);
+	ir_node  *mem_phi = (ir_node*)get_irn_link(header);
+	ir_node  *mem     = mem_phi != NULL ? get_Phi_pred(mem_phi, pos)
+	                                    : get_irg_initial_mem(irg);
+	ir_node  *merge   = new_safepoint_poll(get_Block_cfgpred(header, pos),
+	                                       &mem);
+	set_Block_cfgpred(header, pos, new_r_Jmp(merge));
+	if (mem_phi != NULL) {
+		set_Phi_pred(mem_phi, pos, mem);
+	} else {
+		keep_alive(mem);
+	}
+}
+
+/**
+ * Polls before @p ret, so a recursion which never runs a loop does not hold
+ * up the collector either.
+ */
+static void insert_return_poll(ir_node *ret)
+{
+	ir_node *mem   = get_Return_mem(ret);
+	ir_node *merge = new_safepoint_poll(new_r_Jmp(get_nodes_block(ret)),
+	                                    &mem);
+	set_nodes_block(ret, merge);
+	set_Return_mem(ret, mem);
+}
+
+void gcji_insert_safepoint_polls(ir_graph *irg)
+{
+	if (!safepoint_polls)
+		return;
+
+	assure_loopinfo(irg);
+	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
+	irg_walk_graph(irg, firm_clear_link, link_memory_phi, NULL);
+
+	poll_sites_t sites;
+	sites.backedges = NEW_ARR_F(backedge_t, 0);
+	sites.returns   = NEW_ARR_F(ir_node*, 0);
+	sites.has_calls = false;
+	irg_walk_graph(irg, collect_poll_sites, NULL, &sites);
+	for (size_t i = 0, n = ARR_LEN(sites.backedges); i < n; ++i) {
+		insert_backedge_poll(sites.backedges[i].header,
+		                     sites.backedges[i].pos);
+	}
+	/* a method without calls and loops returns after a few instructions */
+	if (sites.has_calls) {
+		for (size_t i = 0, n = ARR_LEN(sites.returns); i < n; ++i) {
+			insert_return_poll(sites.returns[i]);
+		}
+	}
+	bool changed = ARR_LEN(sites.backedges) > 0
+	            || (sites.has_calls && ARR_LEN(sites.returns) > 0);
+	DEL_ARR_F(sites.returns);
+	DEL_ARR_F(sites.backedges);
+	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
+
+	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_NONE
+	                                    : IR_GRAPH_PROPERTIES_ALL);
+}
+
+/*
+ * Write barrier
+ *
+ * The simplert collector copies young objects and needs to know about
+ * references from old objects to young ones. Every reference store into the
+ * heap is followed by an unconditional store to the card of the written
+ * address: addresses outside of the heap are clamped to a dummy card past
+ * the end of the card table, which is cheaper than a branch. A compare and
+ * swap of a reference counts as a store, whether it succeeds or not.
+ */
+
+static ir_node *load_card_table_field(ir_node *block, ir_entity *field)
+{
+	ir_graph *irg   = get_irn_irg(block);
+	ir_node  *table = new_r_Address(irg, gcj_card_table_entity);
+	ir_node  *addr  = new_r_Member(block, table, field);
+	ir_type  *type  = get_entity_type(field);
+	/* set up by the runtime before any java code runs */
+	ir_node  *load  = new_r_Load(block, get_irg_no_mem(irg), addr,
+	                             get_type_mode(type), type, cons_floats);
+	return new_r_Proj(load, get_type_mode(type), pn_Load_res);
+}
+
+/**
+ * Returns true if @p store initializes a field of an object fresh from the
+ * nursery. No collection can happen between the allocation and such a
+ * store, so the object is still young and needs no card.
+ */
+static bool is_fresh_object_store(ir_node *store)
+{
+	ir_node *ptr = get_Store_ptr(store);
+	if (!is_Member(ptr))
+		return false;
+	ir_node *object = get_Member_ptr(ptr);
+	if (!is_Proj(object))
+		return false;
+	ir_node *ress = get_Proj_pred(object);
+	if (!is_Proj(ress) || get_Proj_num(ress) != pn_Call_T_result)
+		return false;
+	ir_node *call = get_Proj_pred(ress);
+	if (!is_Call(call))
+		return false;
+	ir_node *callee = get_Call_ptr(call);
+	if (!is_Address(callee) || get_Address_entity(callee) != gcj_alloc_entity)
+		return false;
+
+	/* bigger objects are allocated in the old generation */
+	ir_node *jclass = get_Call_param(call, 0);
+	if (!is_Address(jclass))
+		return false;
+	ir_type *type = get_type_for_rtti(get_Address_entity(jclass));
+	if (type == NULL || get_type_size(type) > HEAP_LARGE_OBJECT)
+		return false;
+
+	for (ir_node *mem = get_Store_mem(store); ; ) {
+		if (!is_Proj(mem))
+			return false;
+		ir_node *pred = get_Proj_pred(mem);
+		if (pred == call) {
+			return true;
+		} else if (is_Store(pred)) {
+			mem = get_Store_mem(pred);
+		} else if (is_Load(pred)) {
+			mem = get_Load_mem(pred);
+		} else {
+			return false;
+		}
+	}
+}
+
+/** Returns true if @p ptr points into a frame entity, see gcji_escape_analysis. */
+static bool is_frame_address(ir_node *ptr)
+{
+	for (;;) {
+		if (is_Member(ptr)) {
+			ptr = get_Member_ptr(ptr);
+		} else if (is_Sel(ptr)) {
+			ptr = get_Sel_ptr(ptr);
+		} else if (is_Add(ptr)) {
+			ir_node *left = get_Add_left(ptr);
+			ptr = mode_is_reference(get_irn_mode(left)) ? left
+			                                            : get_Add_right(ptr);
+		} else {
+			return ptr == get_irg_frame(get_irn_irg(ptr));
+		}
+	}
+}
+
+static bool needs_card_mark(ir_node *store)
+{
+	ir_node *ptr   = get_Store_ptr(store);
+	ir_node *value = get_Store_value(store);
+	if (get_irn_mode(value) != mode_reference)
+		return false;
+	/* static fields are precise roots, the collector scans the stack */
+	if (is_Address(ptr) || is_frame_address(ptr))
+		return false;
+	if (is_Const(value) && is_Const_null(value))
+		return false;
+	return !is_fresh_object_store(store);
+}
+
+/** Returns true for the compare and swap of an AtomicReference. */
+static bool is_reference_compare_swap(ir_node *node)
+{
+	return is_Builtin(node) && get_Builtin_kind(node) == ir_bk_compare_swap
+	    && get_irn_mode(get_Builtin_param(node, 2)) == mode_reference;
+}
+
+static void collect_reference_stores(ir_node *node, void *env)
+{
+	ir_node ***stores = (ir_node***)env;
+	if ((is_Store(node) && needs_card_mark(node))
+	    || is_reference_compare_swap(node))
+		ARR_APP1(ir_node*, *stores, node);
+}
+
+static void insert_card_mark(ir_node *store)
+{
+	unsigned pn_M     = is_Store(store) ? pn_Store_M : pn_Builtin_M;
+	ir_node *mem_proj = NULL;
+	foreach_out_edge(store, edge) {
+		ir_node *proj = get_edge_src_irn(edge);
+		if (is_Proj(proj) && get_Proj_num(proj) == pn_M)
+			mem_proj = proj;
+	}
+	if (mem_proj == NULL)
+		return;
+
+	ir_graph *irg         = get_irn_irg(store);
+	ir_node  *block       = get_nodes_block(store);
+	ir_mode  *mode_offset = get_reference_offset_mode(mode_reference);
+	ir_mode  *mode_size   = get_type_mode(get_entity_type(gcj_card_table_size));
+	ir_node  *base        = load_card_table_field(block, gcj_card_table_base);
+	ir_node  *size        = load_card_table_field(block, gcj_card_table_size);
+	ir_node  *cards       = load_card_table_field(block, gcj_card_table_cards);
+
+	ir_node *address = is_Store(store) ? get_Store_ptr(store)
+	                                   : get_Builtin_param(store, 0);
+	ir_node *ptr     = new_r_Conv(block, address, mode_size);
+	ir_node *offset  = new_r_Sub(block, ptr, new_r_Conv(block, base, mode_size));
+	ir_node *in_heap = new_r_Cmp(block, offset, size, ir_relation_less);
+	ir_node *clamped = new_r_Mux(block, in_heap, size, offset);
+	ir_node *shift   = new_r_Const_long(irg, mode_Iu, HEAP_CARD_SHIFT);
+	ir_node *index   = new_r_Shr(block, clamped, shift);
+	ir_node *card    = new_r_Add(block, cards,
+	                             new_r_Conv(block, index, mode_offset));
+	ir_node *one     = new_r_Const_long(irg, mode_Bu, 1);
+	ir_node *mark    = new_r_Store(block, mem_proj, card, one, type_card,
+	                               cons_none);
+	ir_node *mark_mem = new_r_Proj(mark, mode_M, pn_Store_M);
+	edges_reroute_except(mem_proj, mark_mem, mark);
+}
+
+void gcji_insert_card_marks(ir_graph *irg)
+{
+	if (!card_marking)
+		return;
+
+	ir_node **stores = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, NULL, collect_reference_stores, &stores);
+
+	bool changed = false;
+	if (ARR_LEN(stores) > 0) {
+		assure_edges(irg);
+		for (size_t i = 0, n = ARR_LEN(stores); i < n; ++i) {
+			insert_card_mark(stores[i]);
+		}
+		changed = true;
+	}
+	DEL_ARR_F(stores);
+
+	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_NONE
+	                                    : IR_GRAPH_PROPERTIES_ALL);
+}
+
+/*
+ * Zeroing elision
+ *
+ * The runtime hands out primitive arrays zeroed, which is wasted work if
+ * System.arraycopy or a counted store loop fills the array before anything
+ * can read it. Such allocations call _Jv_NewPrimArrayUninitialized instead.
+ * Copies which do not provably cover the whole array are replaced by
+ * _Jv_InitArrayCopy, which zeroes the rest. That is only right for the first
+ * copy into the array, so every copy has to run at most once per allocation:
+ * it must be dominated by the allocation and sit in the same loop. A copy
+ * which throws leaves the array uninitialized, so its exception must leave
+ * the method, where the array is unreachable.
+ *
+ * A store loop counts as filling the array if it has the shape javac emits
+ * for "for (int i = 0; i < count; ++i) array[i] = ...;": the header tests
+ * i < count (or i < array.length) and is the only exit, i starts at 0 and
+ * grows by one, and the body is a chain of blocks without branches, so its
+ * store to array[i] runs in every iteration. Calls in the body may only
+ * throw out of the method. Nothing in the loop may read the array or let it
+ * escape, once the loop is left the array is initialized.
+ */
+
+/** Limits the number of nodes examined after each allocation. */
+#define ZEROING_ELISION_MAX_NODES  256
+/** Limits the number of blocks in the body of a counted store loop. */
+#define ZEROING_ELISION_MAX_BLOCKS 16
+
+typedef struct fill_loop_t {
+	ir_node *header;
+	ir_node *index;   /**< the counter, a Phi in header */
+	ir_node *body[ZEROING_ELISION_MAX_BLOCKS];
+	size_t   n_body;
+} fill_loop_t;
+
+static bool is_array_copy_into(ir_node *node, ir_node *array)
+{
+	if (!is_Call(node))
+		return false;
+	ir_node *ptr = get_Call_ptr(node);
+	if (!is_Address(ptr))
+		return false;
+	ir_entity *callee = get_Address_entity(ptr);
+	return get_entity_ident(callee) == arraycopy_ident
+	    && get_entity_owner(callee) == class_registry_get("java/lang/System")
+	    && get_Call_param(node, 2) == array;
+}
+
+static bool is_length_load(ir_node *node, ir_node *array)
+{
+	if (!is_Load(node))
+		return false;
+	ir_node *ptr = get_Load_ptr(node);
+	return is_Member(ptr) && get_Member_ptr(ptr) == array
+	    && get_Member_entity(ptr) == gcj_array_length;
+}
+
+/**
+ * Links all nodes which may hold the address of @p array or of one of its
+ * elements to @p array.
+ */
+static void mark_derived_addresses(ir_node *node, ir_node *array)
+{
+	set_irn_link(node, array);
+	foreach_out_edge(node, edge) {
+		ir_node *user = get_edge_src_irn(edge);
+		if (get_irn_link(user) == array)
+			continue;
+		if (is_Add(user) || is_Sub(user) || is_Member(user) || is_Sel(user)
+		    || is_Conv(user) || is_Confirm(user) || is_Phi(user)
+		    || is_Mux(user))
+			mark_derived_addresses(user, array);
+	}
+}
+
+/** Returns true if no handler in this method catches exceptions of @p call. */
+static bool exception_leaves_method(ir_node *call)
+{
+	ir_node *end_block = get_irg_end_block(get_irn_irg(call));
+	foreach_out_edge(call, edge) {
+		ir_node *proj = get_edge_src_irn(edge);
+		if (!is_Proj(proj) || get_Proj_num(proj) != pn_Call_X_except)
+			continue;
+		foreach_out_edge(proj, target_edge) {
+			if (get_edge_src_irn(target_edge) != end_block)
+				return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Returns true if @p copy runs at most once after each execution of the
+ * allocation @p call and its exception is not caught in this method.
+ */
+static bool is_initializing_copy(ir_node *copy, ir_node *call)
+{
+	ir_node *block       = get_nodes_block(copy);
+	ir_node *alloc_block = get_nodes_block(call);
+	return block_dominates(alloc_block, block)
+	    && get_irn_loop(block) == get_irn_loop(alloc_block)
+	    && exception_leaves_method(copy);
+}
+
+static bool uses_address(ir_node *node, ir_node *array)
+{
+	for (int i = 0, n = get_irn_arity(node); i < n; ++i) {
+		if (get_irn_link(get_irn_n(node, i)) == array)
+			return true;
+	}
+	return false;
+}
+
+/** Returns true if @p bound is @p count or the length of @p array. */
+static bool is_array_bound(ir_node *bound, ir_node *array, ir_node *count)
+{
+	if (is_Conv(count))
+		count = get_Conv_op(count);
+	if (is_Conv(bound))
+		bound = get_Conv_op(bound);
+	return bound == count
+	    || (is_Proj(bound) && is_length_load(get_Proj_pred(bound), array));
+}
+
+/** Returns true if @p index counts from 0 up by one in @p header. */
+static bool is_counter(ir_node *index, ir_node *header, int entry, int back)
+{
+	if (!is_Phi(index) || get_nodes_block(index) != header)
+		return false;
+	ir_node *start = get_Phi_pred(index, entry);
+	ir_node *step  = get_Phi_pred(index, back);
+	if (!is_Const(start) || !is_Const_null(start) || !is_Add(step))
+		return false;
+	ir_node *left  = get_Add_left(step);
+	ir_node *right = get_Add_right(step);
+	return (left == index && is_Const(right) && is_Const_one(right))
+	    || (right == index && is_Const(left) && is_Const_one(left));
+}
+
+/**
+ * Collects the body of the loop headed by @p loop->header, walking back from
+ * its backedge @p back to the Cond in the header. Fails unless every body
+ * block runs in every iteration and the Cond tests the counter against the
+ * bound of @p array.
+ */
+static bool find_fill_loop_body(fill_loop_t *loop, int back, ir_node *array,
+                                ir_node *count)
+{
+	ir_node *block = get_Block_cfgpred_block(loop->header, back);
+	for (;;) {
+		if (block == loop->header || get_Block_n_cfgpreds(block) != 1
+		    || loop->n_body == ZEROING_ELISION_MAX_BLOCKS)
+			return false;
+		loop->body[loop->n_body++] = block;
+
+		ir_node *pred = get_Block_cfgpred(block, 0);
+		if (is_Jmp(pred)) {
+			block = get_nodes_block(pred);
+			continue;
+		}
+		if (!is_Proj(pred))
+			return false;
+		ir_node *op = get_Proj_pred(pred);
+		if (is_Call(op)) {
+			if (get_Proj_num(pred) != pn_Call_X_regular
+			    || !exception_leaves_method(op))
+				return false;
+			block = get_nodes_block(op);
+			continue;
+		}
+		if (!is_Cond(op) || get_nodes_block(op) != loop->header)
+			return false;
+
+		ir_node *cmp = get_Cond_selector(op);
+		if (!is_Cmp(cmp))
+			return false;
+		/* javac leaves the loop on i >= count, the body is the false Proj */
+		ir_relation relation = get_Cmp_relation(cmp);
+		if (get_Proj_num(pred) == pn_Cond_false)
+			relation = get_negated_relation(relation) & ~ir_relation_unordered;
+		ir_node    *left     = get_Cmp_left(cmp);
+		ir_node    *right    = get_Cmp_right(cmp);
+		if (relation == ir_relation_less
+		    && is_array_bound(right, array, count)) {
+			loop->index = left;
+		} else if (relation == ir_relation_greater
+		           && is_array_bound(left, array, count)) {
+			loop->index = right;
+		} else {
+			return false;
+		}
+		return true;
+	}
+}
+
+static bool in_fill_loop(const fill_loop_t *loop, ir_node *block)
+{
+	if (block == loop->header)
+		return true;
+	for (size_t i = 0; i < loop->n_body; ++i) {
+		if (loop->body[i] == block)
+			return true;
+	}
+	return false;
+}
+
+/** Returns true if @p node stores a value to array[index] in the body. */
+static bool is_fill_store(ir_node *node, const fill_loop_t *loop,
+                          ir_node *array)
+{
+	if (!is_Store(node) || get_nodes_block(node) == loop->header
+	    || get_irn_link(get_Store_value(node)) == array)
+		return false;
+	ir_node *addr = get_Store_ptr(node);
+	if (!is_Sel(addr) || get_Sel_index(addr) != loop->index)
+		return false;
+	ir_node *data = get_Sel_ptr(addr);
+	if (!is_Add(data))
+		return false;
+	ir_node *base   = get_Add_left(data);
+	ir_node *offset = get_Add_right(data);
+	if (base != array) {
+		base   = offset;
+		offset = get_Add_left(data);
+	}
+	return base == array && is_Const(offset)
+	    && get_tarval_long(get_Const_tarval(offset)) == (long)array_header_size;
+}
+
+/**
+ * Returns true if @p mem_phi heads a counted store loop which fills
+ * @p array, allocated by @p call, and runs at most once per allocation.
+ */
+static bool is_counted_fill(ir_node *mem_phi, ir_node *call, ir_node *array)
+{
+	fill_loop_t loop;
+	loop.header = get_nodes_block(mem_phi);
+	loop.index  = NULL;
+	loop.n_body = 0;
+	if (get_Block_n_cfgpreds(loop.header) != 2)
+		return false;
+	int back  = is_backedge(loop.header, 0) ? 0 : 1;
+	int entry = 1 - back;
+	if (!is_backedge(loop.header, back) || is_backedge(loop.header, entry))
+		return false;
+
+	ir_node *alloc_block = get_nodes_block(call);
+	ir_loop *outer       = get_loop_outer_loop(get_irn_loop(loop.header));
+	if (!block_dominates(alloc_block, loop.header)
+	    || outer != get_irn_loop(alloc_block))
+		return false;
+
+	ir_node *count = get_Call_param(call, 1);
+	if (!find_fill_loop_body(&loop, back, array, count)
+	    || !is_counter(loop.index, loop.header, entry, back))
+		return false;
+
+	/* the memory operations of the loop, those after it see a full array */
+	ir_node **worklist = NEW_ARR_F(ir_node*, 0);
+	ir_node **seen     = NEW_ARR_F(ir_node*, 0);
+	bool      filled   = false;
+	bool      ok       = true;
+	ARR_APP1(ir_node*, worklist, mem_phi);
+	ARR_APP1(ir_node*, seen, mem_phi);
+	while (ok && ARR_LEN(worklist) > 0) {
+		ir_node *value = worklist[ARR_LEN(worklist) - 1];
+		ARR_SHRINKLEN(worklist, ARR_LEN(worklist) - 1);
+		foreach_out_edge(value, edge) {
+			ir_node *user = get_edge_src_irn(edge);
+			if (is_End(user) || !in_fill_loop(&loop, get_nodes_block(user)))
+				continue;
+			bool known = false;
+			for (size_t i = 0, n = ARR_LEN(seen); i < n; ++i) {
+				known |= seen[i] == user;
+			}
+			if (known)
+				continue;
+			if (ARR_LEN(seen) > ZEROING_ELISION_MAX_NODES) {
+				ok = false;
+				break;
+			}
+			ARR_APP1(ir_node*, seen, user);
+
+			if (is_fill_store(user, &loop, array)) {
+				filled = true;
+			} else if (!is_length_load(user, array)
+			           && uses_address(user, array)) {
+				ok = false;
+				break;
+			}
+
+			if (get_irn_mode(user) == mode_M) {
+				ARR_APP1(ir_node*, worklist, user);
+				continue;
+			}
+			foreach_out_edge(user, proj_edge) {
+				ir_node *proj = get_edge_src_irn(proj_edge);
+				if (get_irn_mode(proj) == mode_M)
+					ARR_APP1(ir_node*, worklist, proj);
+			}
+		}
+	}
+	DEL_ARR_F(seen);
+	DEL_ARR_F(worklist);
+	return ok && filled;
+}
+
+/**
+ * Follows the memory operations after the allocation @p call of @p array,
+ * starting at its memory Proj @p mem, and collects the copies into the
+ * array. Fails if the array may be read or escape before a copy or a
+ * counted store loop overwrote it, or if a copy is no initializing copy.
+ */
+static bool find_initializing_copies(ir_node *call, ir_node *mem,
+                                     ir_node *array, ir_node ***copies)
+{
+	ir_graph *irg      = get_irn_irg(mem);
+	ir_node **worklist = NEW_ARR_F(ir_node*, 0);
+	unsigned  n_nodes  = 0;
+	bool      filled   = false;
+	bool      ok       = true;
+
+	inc_irg_visited(irg);
+	mark_irn_visited(mem);
+	ARR_APP1(ir_node*, worklist, mem);
+	while (ok && ARR_LEN(worklist) > 0) {
+		ir_node *value = worklist[ARR_LEN(worklist) - 1];
+		ARR_SHRINKLEN(worklist, ARR_LEN(worklist) - 1);
+		foreach_out_edge(value, edge) {
+			ir_node *user = get_edge_src_irn(edge);
+			if (irn_visited(user) || is_End(user))
+				continue;
+			mark_irn_visited(user);
+			if (++n_nodes > ZEROING_ELISION_MAX_NODES) {
+				ok = false;
+				break;
+			}
+
+			if (is_Phi(user) && get_irn_mode(user) == mode_M
+			    && is_counted_fill(user, call, array)) {
+				filled = true;
+				continue;
+			}
+			if (is_array_copy_into(user, array)) {
+				if (!is_initializing_copy(user, call)) {
+					ok = false;
+					break;
+				}
+				/* the copy must not read the array itself */
+				for (int p = 0, n = get_Call_n_params(user); p < n; ++p) {
+					ir_node *param = get_Call_param(user, p);
+					if (p != 2 && get_irn_link(param) == array)
+						ok = false;
+				}
+				ARR_APP1(ir_node*, *copies, user);
+				continue;
+			}
+			if (!is_length_load(user, array) && uses_address(user, array)) {
+				ok = false;
+				break;
+			}
+
+			if (get_irn_mode(user) == mode_M) {
+				ARR_APP1(ir_node*, worklist, user);
+				continue;
+			}
+			foreach_out_edge(user, proj_edge) {
+				ir_node *proj = get_edge_src_irn(proj_edge);
+				if (get_irn_mode(proj) == mode_M && !irn_visited(proj)) {
+					mark_irn_visited(proj);
+					ARR_APP1(ir_node*, worklist, proj);
+				}
+			}
+		}
+	}
+	DEL_ARR_F(worklist);
+	return ok && (filled || ARR_LEN(*copies) > 0);
+}
+
+static bool copies_whole_array(ir_node *copy, ir_node *array, ir_node *count)
+{
+	ir_node *dstpos = get_Call_param(copy, 3);
+	ir_node *length = get_Call_param(copy, 4);
+	if (!is_Const(dstpos) || !is_Const_null(dstpos))
+		return false;
+	if (is_Conv(count))
+		count = get_Conv_op(count);
+	if (length == count)
+		return true;
+	/* System.arraycopy(src, 0, array, 0, array.length) */
+	return is_Proj(length) && is_length_load(get_Proj_pred(length), array);
+}
+
+static bool elide_zeroing(ir_node *call)
+{
+	ir_node *mem_proj;
+	ir_node *array = get_result_proj(call, &mem_proj, false);
+	if (array == NULL)
+		return false;
+
+	mark_derived_addresses(array, array);
+	ir_node **copies = NEW_ARR_F(ir_node*, 0);
+	bool      found  = find_initializing_copies(call, mem_proj, array,
+	                                           &copies);
+	if (found) {
+		ir_graph *irg   = get_irn_irg(call);
+		ir_node  *count = get_Call_param(call, 1);
+		set_Call_ptr(call,
+		             new_r_Address(irg, gcj_new_uninitialized_array_entity));
+		for (size_t i = 0, n = ARR_LEN(copies); i < n; ++i) {
+			ir_node *copy = copies[i];
+			if (!copies_whole_array(copy, array, count))
+				set_Call_ptr(copy,
+				             new_r_Address(irg, gcj_init_array_copy_entity));
+		}
+	}
+	DEL_ARR_F(copies);
+	return found;
+}
+
+static void collect_prim_array_allocations(ir_node *node, void *env)
+{
+	ir_node ***calls = (ir_node***)env;
+	if (!is_Call(node))
+		return;
+	ir_node *ptr = get_Call_ptr(node);
+	if (is_Address(ptr)
+	    && get_Address_entity(ptr) == gcj_new_prim_array_entity)
+		ARR_APP1(ir_node*, *calls, node);
+}
+
+void gcji_elide_array_zeroing(ir_graph *irg)
+{
+	if (!uninitialized_arrays)
+		return;
+
+	ir_node **calls = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, NULL, collect_prim_array_allocations, &calls);
+
+	bool changed = false;
+	if (ARR_LEN(calls) > 0) {
+		assure_edges(irg);
+		assure_doms(irg);
+		assure_loopinfo(irg);
+		ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK);
+		irg_walk_graph(irg, firm_clear_link, NULL, NULL);
+		ir_reserve_resources(irg, IR_RESOURCE_IRN_VISITED);
+		for (size_t i = 0, n = ARR_LEN(calls); i < n; ++i) {
+			changed |= elide_zeroing(calls[i]);
+		}
+		ir_free_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_IRN_VISITED);
+	}
+	DEL_ARR_F(calls);
+
+	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
+	                                    : IR_GRAPH_PROPERTIES_ALL);
+}
+
+/*
+ * Escape analysis
+ *
+ * Objects and small primitive arrays which never leave the method that
+ * allocates them are placed in its stack frame instead of the heap. An
+ * allocation escapes if its address is stored to memory, returned, thrown or
+ * passed to a method which lets the parameter escape. The parameters of all
+ * methods with a graph are summarized on demand; recursion and calls through
+ * the vtable count as escaping. A method which merely returns a parameter,
+ * like StringBuilder.append, does not let it escape, the call result is
+ * followed instead.
+ *
+ * The frame copies are initialized like the runtime initializes heap objects
+ * and scalar replacement later splits them into local variables where all
+ * accesses are direct. References held by frame objects are found by the
+ * conservative stack scan of the collector.
+ */
+
+/** Limits for allocations placed in the frame. */
+#define STACK_OBJECT_MAX_SIZE   256
+#define STACK_ARRAY_MAX_LENGTH  16
+#define STACK_FRAME_MAX_SIZE    2048
+/** Limits the nesting of parameter summaries. */
+#define ESCAPE_MAX_DEPTH        4
+
+typedef enum escape_state_t {
+	ESCAPE_UNKNOWN,
+	ESCAPE_NONE,      /**< the address stays inside of the method */
+	ESCAPE_RETURNED,  /**< the address is returned, but does not escape */
+	ESCAPE_GLOBAL,    /**< the address may escape */
+} escape_state_t;
+
+typedef struct escape_summary_t {
+	bool            analyzing;
+	size_t          n_params;
+	escape_state_t *params;
+} escape_summary_t;
+
+typedef struct escape_env_t {
+	cpset_t  visited;
+	bool     allow_phi;    /**< false if the frame slot would be shared by
+	                            the objects of several loop iterations */
+	bool     vptr_unset;   /**< reading the vptr counts as escaping */
+	bool     summarizing;  /**< returning the address is allowed */
+	bool     returned;
+	unsigned depth;
+} escape_env_t;
+
+static struct obstack escape_obst;
+static cpmap_t        escape_summaries;
+
+static escape_state_t get_param_escape(ir_entity *callee, size_t pos,
+                                       unsigned depth);
+
+static void init_escape_env(escape_env_t *env, unsigned depth)
+{
+	cpset_init(&env->visited, hash_ptr, ptr_equals);
+	env->allow_phi   = true;
+	env->vptr_unset  = true;
+	env->summarizing = false;
+	env->returned    = false;
+	env->depth       = depth;
+}
+
+static bool address_escapes(escape_env_t *env, ir_node *node);
+
+/** Follows the results of @p call, which returns one of its parameters. */
+static bool results_escape(escape_env_t *env, ir_node *call)
+{
+	foreach_out_edge(call, edge) {
+		ir_node *ress = get_edge_src_irn(edge);
+		if (!is_Proj(ress) || get_Proj_num(ress) != pn_Call_T_result)
+			continue;
+		foreach_out_edge(ress, res_edge) {
+			ir_node *res = get_edge_src_irn(res_edge);
+			if (get_irn_mode(res) == mode_reference
+			    && address_escapes(env, res))
+				return true;
+		}
+	}
+	return false;
+}
+
+/** Returns true if the address @p node, derived from an allocation, escapes. */
+static bool address_escapes(escape_env_t *env, ir_node *node)
+{
+	if (cpset_find(&env->visited, node) != NULL)
+		return false;
+	cpset_insert(&env->visited, node);
+
+	foreach_out_edge(node, edge) {
+		ir_node *user = get_edge_src_irn(edge);
+		int      pos  = get_edge_src_pos(edge);
+		switch (get_irn_opcode(user)) {
+		case iro_Load:
+		case iro_Cmp:
+		case iro_End:
+			continue;
+		case iro_Store:
+			if (pos != n_Store_ptr)
+				return true;
+			continue;
+		case iro_Member:
+			if (env->vptr_unset && get_Member_entity(user) == get_vptr_entity())
+				return true;
+			break;
+		case iro_Sel:
+			if (pos != n_Sel_ptr)
+				return true;
+			break;
+		case iro_Sub:
+			if (pos != n_Sub_left)
+				return true;
+			break;
+		case iro_Add:
+		case iro_Conv:
+		case iro_Mux:
+			break;
+		case iro_Confirm:
+			if (pos != n_Confirm_value)
+				continue;
+			break;
+		case iro_Phi:
+			if (!env->allow_phi)
+				return true;
+			break;
+		case iro_Return:
+			if (!env->summarizing)
+				return true;
+			env->returned = true;
+			continue;
+		case iro_Call: {
+			ir_node *ptr = get_Call_ptr(user);
+			if (pos <= n_Call_max || !is_Address(ptr))
+				return true;
+			size_t         param = pos - (n_Call_max + 1);
+			escape_state_t state = get_param_escape(get_Address_entity(ptr),
+			                                        param, env->depth + 1);
+			if (state == ESCAPE_GLOBAL
+			    || (state == ESCAPE_RETURNED && results_escape(env, user)))
+				return true;
+			continue;
+		}
+		default:
+			return true;
+		}
+		if (address_escapes(env, user))
+			return true;
+	}
+	return false;
+}
+
+static escape_state_t summarize_param(ir_graph *irg, size_t pos,
+                                      unsigned depth)
+{
+	assure_edges(irg);
+
+	escape_env_t env;
+	init_escape_env(&env, depth);
+	env.summarizing = true;
+	bool escapes = false;
+	foreach_out_edge(get_irg_args(irg), edge) {
+		ir_node *arg = get_edge_src_irn(edge);
+		if (is_Proj(arg) && get_Proj_num(arg) == pos
+		    && address_escapes(&env, arg)) {
+			escapes = true;
+			break;
+		}
+	}
+	cpset_destroy(&env.visited);
+
+	if (escapes)
+		return ESCAPE_GLOBAL;
+	return env.returned ? ESCAPE_RETURNED : ESCAPE_NONE;
+}
+
+static escape_state_t get_param_escape(ir_entity *callee, size_t pos,
+                                       unsigned depth)
+{
+	ir_graph *irg = get_entity_irg(callee);
+	if (irg == NULL || depth > ESCAPE_MAX_DEPTH)
+		return ESCAPE_GLOBAL;
+
+	escape_summary_t *summary = cpmap_find(&escape_summaries, callee);
+	if (summary == NULL) {
+		size_t n_params = get_method_n_params(get_entity_type(callee));
+		summary           = OALLOCZ(&escape_obst, escape_summary_t);
+		summary->n_params = n_params;
+		summary->params   = OALLOCNZ(&escape_obst, escape_state_t, n_params);
+		cpmap_set(&escape_summaries, callee, summary);
+	}
+	if (pos >= summary->n_params)
+		return ESCAPE_GLOBAL;
+	if (summary->params[pos] != ESCAPE_UNKNOWN)
+		return summary->params[pos];
+	/* recursion, give up */
+	if (summary->analyzing)
+		return ESCAPE_GLOBAL;
+
+	summary->analyzing    = true;
+	escape_state_t state  = summarize_param(irg, pos, depth);
+	summary->analyzing    = false;
+	summary->params[pos]  = state;
+	return state;
+}
+
+/** Stores the zero value to all fields of the object at @p addr. */
+static ir_node *zero_fields(ir_node *block, ir_node *mem, ir_node *addr,
+                            ir_type *type)
+{
+	ir_graph  *irg         = get_irn_irg(block);
+	ir_entity *vptr_entity = get_vptr_entity();
+	for (size_t m = 0, n = get_compound_n_members(type); m < n; ++m) {
+		ir_entity *member = get_compound_member(type, m);
+		if (is_method_entity(member) || member == vptr_entity)
+			continue;
+
+		ir_type *member_type = get_entity_type(member);
+		if (is_Class_type(member_type)) {
+			/* embedded superclass data */
+			mem = zero_fields(block, mem, addr, member_type);
+			continue;
+		}
+		ir_mode *mode = get_type_mode(member_type);
+		assert(mode != NULL);
+		ir_node *ptr  = new_r_Member(block, addr, member);
+		ir_node *zero = new_r_Const(irg, get_mode_null(mode));
+		mem = store_value(block, mem, ptr, zero, member_type);
+	}
+	return mem;
+}
+
+/**
+ * Replaces the allocation @p call by a frame entity if the allocated object
+ * does not escape. @p frame_size accumulates the size of the frame entities
+ * created so far.
+ */
+static bool place_in_frame(ir_node *call, unsigned *frame_size)
+{
+	ir_entity *callee = get_Address_entity(get_Call_ptr(call));
+	ir_node   *jclass = get_Call_param(call, 0);
+	ir_type   *type   = NULL;
+	ir_type   *eltype = NULL;
+	long       count  = 0;
+	unsigned   size;
+	if (!is_Address(jclass))
+		return false;
+	if (callee == gcj_alloc_entity) {
+		type = get_type_for_rtti(get_Address_entity(jclass));
+		if (type == NULL || oo_get_class_is_extern(type)
+		    || oo_get_class_vtable_entity(type) == NULL)
+			return false;
+		size = get_type_size(type);
+		if (size > STACK_OBJECT_MAX_SIZE)
+			return false;
+	} else {
+		ir_node *count_node = get_Call_param(call, 1);
+		eltype = get_prim_type_for_rtti(get_Address_entity(jclass));
+		if (eltype == NULL || !is_Const(count_node))
+			return false;
+		count = get_tarval_long(get_Const_tarval(count_node));
+		if (count < 0 || count > STACK_ARRAY_MAX_LENGTH)
+			return false;
+		size = array_header_size + (unsigned)count * get_type_size(eltype);
+	}
+	if (*frame_size + size > STACK_FRAME_MAX_SIZE)
+		return false;
+
+	ir_node *mem_proj;
+	ir_node *res = get_result_proj(call, &mem_proj, false);
+	if (res == NULL)
+		return false;
+
+	ir_graph    *irg   = get_irn_irg(call);
+	ir_node     *block = get_nodes_block(call);
+	escape_env_t env;
+	init_escape_env(&env, 0);
+	env.allow_phi  = get_irn_loop(block) == get_irg_loop(irg);
+	env.vptr_unset = type == NULL;
+	bool escapes = address_escapes(&env, res);
+	cpset_destroy(&env.visited);
+	if (escapes)
+		return false;
+
+	ir_type *frame_type = get_irg_frame_type(irg);
+	ir_node *frame      = get_irg_frame(irg);
+	ir_node *mem        = get_Call_mem(call);
+	ir_node *addr;
+	if (type != NULL) {
+		ir_entity *slot = new_entity(frame_type, id_unique("stack_object.%u"),
+		                             type);
+		addr = new_r_Member(block, frame, slot);
+
+		ir_entity *vtable_ent  = oo_get_class_vtable_entity(type);
+		unsigned   vptr_index  = ddispatch_get_vptr_points_to_index();
+		ir_node   *vtable
+			= add_offset(block, new_r_Address(irg, vtable_ent),
+			             vptr_index * get_mode_size_bytes(mode_reference));
+		ir_entity *vptr_entity = get_vptr_entity();
+		ir_node   *vptr_addr   = new_r_Member(block, addr, vptr_entity);
+		mem = store_value(block, mem, vptr_addr, vtable,
+		                  get_entity_type(vptr_entity));
+		mem = zero_fields(block, mem, addr, type);
+	} else {
+		/* the vptr stays unset, arrays in the frame never have it read */
+		ir_type *slot_type = new_type_array(type_long, (size + 7) / 8);
+		set_type_state(slot_type, layout_fixed);
+		ir_entity *slot = new_entity(frame_type, id_unique("stack_array.%u"),
+		                             slot_type);
+		addr = new_r_Member(block, frame, slot);
+
+		ir_node *length_addr = new_r_Member(block, addr, gcj_array_length);
+		ir_node *length      = new_r_Const_long(irg, mode_int, count);
+		mem = store_value(block, mem, length_addr, length, type_int);
+
+		unsigned elsize = get_type_size(eltype);
+		ir_node *zero   = new_r_Const(irg, get_mode_null(get_type_mode(eltype)));
+		for (long i = 0; i < count; ++i) {
+			ir_node *elem_addr
+				= add_offset(block, addr, array_header_size + i * elsize);
+			mem = store_value(block, mem, elem_addr, zero, eltype);
+		}
+	}
+
+	exchange(mem_proj, mem);
+	exchange(res, addr);
+	*frame_size += size;
+	return true;
+}
+
+static void collect_object_allocations(ir_node *node, void *env)
+{
+	ir_node ***calls = (ir_node***)env;
+	if (!is_Call(node))
+		return;
+	ir_node *ptr = get_Call_ptr(node);
+	if (!is_Address(ptr))
+		return;
+	ir_entity *callee = get_Address_entity(ptr);
+	if (callee == gcj_alloc_entity || callee == gcj_new_prim_array_entity)
+		ARR_APP1(ir_node*, *calls, node);
+}
+
+void gcji_escape_analysis(void)
+{
+	if (!stack_allocation)
+		return;
+
+	obstack_init(&escape_obst);
+	cpmap_init(&escape_summaries, hash_ptr, ptr_equals);
+
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i) {
+		ir_graph *irg   = get_irp_irg(i);
+		ir_node **calls = NEW_ARR_F(ir_node*, 0);
+		irg_walk_graph(irg, NULL, collect_object_allocations, &calls);
+
+		bool changed = false;
+		if (ARR_LEN(calls) > 0) {
+			assure_edges(irg);
+			assure_loopinfo(irg);
+			unsigned frame_size = 0;
+			for (size_t c = 0, n_calls = ARR_LEN(calls); c < n_calls; ++c) {
+				changed |= place_in_frame(calls[c], &frame_size);
+			}
+		}
+		DEL_ARR_F(calls);
+
+		confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
+		                                    : IR_GRAPH_PROPERTIES_ALL);
+	}
+
+	cpmap_destroy(&escape_summaries);
+	obstack_free(&escape_obst, NULL);
+}
+
+/*
+ * String concatenation
+ *
+ * javac compiles a + b + c to
+ * new StringBuilder().append(a).append(b).append(c).toString(), which grows
+ * the buffer of the builder several times and copies it once more in
+ * toString. Such chains are replaced by a call to _Jv_StringConcat, which
+ * computes the length of the result first and copies each part once. The
+ * operands are converted with the String.valueOf overload the append method
+ * would have used at the place of the append call, chars are passed
+ * directly.
+ *
+ * The pass runs on the freshly constructed graphs, before rapid type analysis
+ * can drop the String.valueOf methods.
+ */
+
+/** Chains with more parts are left alone. */
+#define CONCAT_MAX_PARTS 64
+
+typedef struct concat_part_t {
+	ir_node   *call;     /**< the append call */
+	ir_entity *convert;  /**< String.valueOf overload or NULL */
+	bool       is_char;
+} concat_part_t;
+
+static ir_node *get_method_sel(ir_node *call)
+{
+	ir_node *ptr = get_Call_ptr(call);
+	if (is_Proj(ptr) && is_MethodSel(get_Proj_pred(ptr)))
+		return get_Proj_pred(ptr);
+	return NULL;
+}
+
+static ir_entity *get_called_method(ir_node *call)
+{
+	ir_node *ptr = get_Call_ptr(call);
+	if (is_Address(ptr))
+		return get_Address_entity(ptr);
+	ir_node *sel = get_method_sel(call);
+	return sel != NULL ? get_MethodSel_entity(sel) : NULL;
+}
+
+/**
+ * Returns the memory before @p call and its MethodSel or NULL if the
+ * MethodSel is not directly in front of the call.
+ */
+static ir_node *get_mem_before_call(ir_node *call)
+{
+	ir_node *mem = get_Call_mem(call);
+	ir_node *sel = get_method_sel(call);
+	if (sel == NULL)
+		return mem;
+	if (!is_Proj(mem) || get_Proj_pred(mem) != sel)
+		return NULL;
+	return get_MethodSel_mem(sel);
+}
+
+static ir_node *get_mem_proj(ir_node *node)
+{
+	foreach_out_edge(node, edge) {
+		ir_node *proj = get_edge_src_irn(edge);
+		if (is_Proj(proj) && get_irn_mode(proj) == mode_M)
+			return proj;
+	}
+	return NULL;
+}
+
+/** Removes @p node from the memory chain, starting at @p mem. */
+static void bypass_memory(ir_node *node, ir_node *mem)
+{
+	ir_node *mem_proj = get_mem_proj(node);
+	if (mem_proj != NULL)
+		exchange(mem_proj, mem);
+}
+
+/**
+ * Removes the exception control flow of the Java method call @p call, which
+ * goes away: its regular exit becomes a jump, the exceptional one is gone.
+ */
+static void remove_exception_flow(ir_node *call)
+{
+	ir_node  *block = get_nodes_block(call);
+	ir_graph *irg   = get_irn_irg(call);
+	foreach_out_edge_safe(call, edge) {
+		ir_node *proj = get_edge_src_irn(edge);
+		if (!is_Proj(proj))
+			continue;
+		switch (get_Proj_num(proj)) {
+		case pn_Call_X_regular: exchange(proj, new_r_Jmp(block));       break;
+		case pn_Call_X_except:  exchange(proj, new_r_Bad(irg, mode_X)); break;
+		default:                break;
+		}
+	}
+}
+
+/**
+ * Moves the exception control flow of the Java method call @p call to
+ * @p replacement in the same block.
+ */
+static void move_exception_flow(ir_node *call, ir_node *replacement)
+{
+	bool throws = false;
+	foreach_out_edge_safe(call, edge) {
+		ir_node *proj = get_edge_src_irn(edge);
+		if (is_Proj(proj) && get_irn_mode(proj) == mode_X) {
+			set_Proj_pred(proj, replacement);
+			throws = true;
+		}
+	}
+	if (throws)
+		ir_set_throws_exception(replacement, true);
+}
+
+/**
+ * Returns the String.valueOf overload for the parameter descriptor of the
+ * StringBuilder.append method @p append or NULL if there is none.
+ */
+static ir_entity *find_value_of(ir_entity *append)
+{
+	const char *name  = get_entity_name(append);
+	const char *begin = strchr(name, '(');
+	const char *end   = strchr(name, ')');
+	if (begin == NULL || end == NULL)
+		return NULL;
+
+	struct obstack obst;
+	obstack_init(&obst);
+	obstack_printf(&obst, "%.*s)Ljava/lang/String;", (int)(end - begin), begin);
+	obstack_1grow(&obst, '\0');
+	const char *descriptor = obstack_finish(&obst);
+	ident *ld_ident = mangle_member_name("java/lang/String", "valueOf",
+	                                     descriptor);
+	obstack_free(&obst, NULL);
+
+	for (size_t i = 0, n = get_class_n_members(glob); i < n; ++i) {
+		ir_entity *member = get_class_member(glob, i);
+		if (is_method_entity(member) && get_entity_ld_ident(member) == ld_ident)
+			return member;
+	}
+	return NULL;
+}
+
+/**
+ * Classifies the append method @p append, returns false if the chain
+ * cannot be fused.
+ */
+static bool init_concat_part(concat_part_t *part, ir_node *call,
+                             ir_entity *append)
+{
+	const char *name = get_entity_name(append);
+	part->call    = call;
+	part->convert = NULL;
+	part->is_char = false;
+	if (strcmp(name, "append.(Ljava/lang/String;)Ljava/lang/StringBuilder;") == 0)
+		return true;
+	if (strcmp(name, "append.(C)Ljava/lang/StringBuilder;") == 0) {
+		part->is_char = true;
+		return true;
+	}
+	if (get_method_n_params(get_entity_type(append)) != 2)
+		return false;
+	part->convert = find_value_of(append);
+	return part->convert != NULL;
+}
+
+/**
+ * Follows the StringBuilder @p builder through its constructor @p init and
+ * append calls to the final toString call. Fails unless each intermediate
+ * builder is used by nothing but the next call of the chain.
+ */
+static ir_node *match_concat_chain(ir_node *builder, ir_type *builder_type,
+                                   ir_node **init, concat_part_t **parts)
+{
+	ir_node *value = builder;
+	*init = NULL;
+	for (;;) {
+		ir_node *next   = NULL;
+		unsigned n_sels = 0;
+		foreach_out_edge(value, edge) {
+			ir_node *user = get_edge_src_irn(edge);
+			if (is_MethodSel(user)) {
+				++n_sels;
+				continue;
+			}
+			if (!is_Call(user) || get_edge_src_pos(edge) != n_Call_max + 1)
+				return NULL;
+			ir_entity *callee = get_called_method(user);
+			if (callee == NULL || get_entity_owner(callee) != builder_type)
+				return NULL;
+			if (value == builder && *init == NULL
+			    && get_entity_ident(callee) == default_init_ident) {
+				*init = user;
+			} else if (next == NULL) {
+				next = user;
+			} else {
+				return NULL;
+			}
+		}
+		if (next == NULL || (value == builder && *init == NULL))
+			return NULL;
+		ir_node *sel = get_method_sel(next);
+		if (n_sels != (sel != NULL ? 1u : 0u)
+		    || (sel != NULL && get_MethodSel_ptr(sel) != value)
+		    || get_mem_before_call(next) == NULL)
+			return NULL;
+		if (value == builder && get_method_sel(*init) != NULL)
+			return NULL;
+
+		ir_entity  *callee = get_called_method(next);
+		const char *name   = get_entity_name(callee);
+		if (get_entity_ident(callee) == to_string_ident)
+			return next;
+		if (strncmp(name, "append.(", 8) != 0
+		    || ARR_LEN(*parts) >= CONCAT_MAX_PARTS)
+			return NULL;
+
+		concat_part_t part;
+		if (!init_concat_part(&part, next, callee))
+			return NULL;
+		ARR_APP1(concat_part_t, *parts, part);
+
+		ir_node *mem_proj;
+		value = get_result_proj(next, &mem_proj, true);
+		if (value == NULL)
+			return NULL;
+	}
+}
+
+/** Returns the value passed to _Jv_StringConcat for @p part. */
+static ir_node *lower_concat_part(const concat_part_t *part)
+{
+	ir_node  *call  = part->call;
+	ir_node  *block = get_nodes_block(call);
+	ir_graph *irg   = get_irn_irg(call);
+	ir_node  *mem   = get_mem_before_call(call);
+	ir_node  *arg   = get_Call_param(call, 1);
+	ir_node  *value;
+	if (part->convert != NULL) {
+		ir_entity *convert = part->convert;
+		ir_node   *addr    = new_r_Address(irg, convert);
+		ir_node   *in[]    = { arg };
+		ir_node   *conv_call = new_r_Call(block, mem, addr, ARRAY_SIZE(in), in,
+		                                  get_entity_type(convert));
+		ir_node   *ress    = new_r_Proj(conv_call, mode_T, pn_Call_T_result);
+		mem   = new_r_Proj(conv_call, mode_M, pn_Call_M);
+		value = new_r_Proj(ress, mode_reference, 0);
+		/* valueOf calls toString, which may throw in place of append */
+		move_exception_flow(call, conv_call);
+	} else if (part->is_char) {
+		ir_mode *mode_offset = get_reference_offset_mode(mode_reference);
+		ir_node *c     = new_r_Conv(block, arg, mode_offset);
+		ir_node *one   = new_r_Const_long(irg, mode_offset, 1);
+		ir_node *shift = new_r_Const_long(irg, mode_Iu, 1);
+		ir_node *tag   = new_r_Or(block, new_r_Shl(block, c, shift), one);
+		value = new_r_Conv(block, tag, mode_reference);
+	} else {
+		value = arg;
+	}
+	bypass_memory(call, mem);
+	remove_exception_flow(call);
+	return value;
+}
+
+static bool fuse_concat(ir_node *alloc, ir_type *builder_type)
+{
+	ir_node *jclass = get_Call_param(alloc, 0);
+	if (!is_Address(jclass)
+	    || get_Address_entity(jclass) != gcji_get_rtti_entity(builder_type))
+		return false;
+
+	ir_node *alloc_mem;
+	ir_node *builder = get_result_proj(alloc, &alloc_mem, false);
+	if (builder == NULL)
+		return false;
+	ir_node *vptr_is_set = NULL;
+	if (get_irn_n_edges(builder) == 1
+	    && is_VptrIsSet(get_edge_src_irn(get_irn_out_edge_first(builder)))) {
+		vptr_is_set = get_edge_src_irn(get_irn_out_edge_first(builder));
+		builder     = NULL;
+		foreach_out_edge(vptr_is_set, edge) {
+			ir_node *proj = get_edge_src_irn(edge);
+			if (is_Proj(proj) && get_Proj_num(proj) == pn_VptrIsSet_res)
+				builder = proj;
+		}
+		if (builder == NULL)
+			return false;
+	}
+
+	ir_node       *init;
+	concat_part_t *parts     = NEW_ARR_F(concat_part_t, 0);
+	ir_node       *to_string = match_concat_chain(builder, builder_type,
+	                                              &init, &parts);
+	ir_node       *str_mem;
+	ir_node       *str       = to_string != NULL
+	                         ? get_result_proj(to_string, &str_mem, true)
+	                         : NULL;
+	size_t         n_parts   = ARR_LEN(parts);
+	if (str == NULL || n_parts == 0) {
+		DEL_ARR_F(parts);
+		return false;
+	}
+
+	/* the builder is gone, so are its allocation and constructor */
+	bypass_memory(init, get_Call_mem(init));
+	remove_exception_flow(init);
+	if (vptr_is_set != NULL)
+		bypass_memory(vptr_is_set, get_VptrIsSet_mem(vptr_is_set));
+	exchange(alloc_mem, get_Call_mem(alloc));
+
+	ir_node *values[n_parts];
+	for (size_t i = 0; i < n_parts; ++i) {
+		values[i] = lower_concat_part(&parts[i]);
+	}
+	DEL_ARR_F(parts);
+
+	ir_graph  *irg        = get_irn_irg(to_string);
+	ir_node   *block      = get_nodes_block(to_string);
+	ir_node   *mem        = get_mem_before_call(to_string);
+	ir_type   *parts_type = new_type_array(type_reference, n_parts);
+	set_type_state(parts_type, layout_fixed);
+	ir_entity *slot       = new_entity(get_irg_frame_type(irg),
+	                                   id_unique("concat_parts.%u"),
+	                                   parts_type);
+	ir_node   *addr       = new_r_Member(block, get_irg_frame(irg), slot);
+	unsigned   ref_size   = get_mode_size_bytes(mode_reference);
+	for (size_t i = 0; i < n_parts; ++i) {
+		ir_node *part_addr = add_offset(block, addr, (unsigned)i * ref_size);
+		mem = store_value(block, mem, part_addr, values[i], type_reference);
+	}
+
+	ir_node *count  = new_r_Const_long(irg, mode_int, (long)n_parts);
+	ir_node *in[]   = { count, addr };
+	ir_node *callee = new_r_Address(irg, gcj_string_concat_entity);
+	ir_node *call   = new_r_Call(block, mem, callee, ARRAY_SIZE(in), in,
+	                             get_entity_type(gcj_string_concat_entity));
+	ir_node *ress   = new_r_Proj(call, mode_T, pn_Call_T_result);
+	exchange(str_mem, new_r_Proj(call, mode_M, pn_Call_M));
+	exchange(str, new_r_Proj(ress, mode_reference, 0));
+	remove_exception_flow(to_string);
+	return true;
+}
+
+void gcji_fuse_string_concat(ir_graph *irg)
+{
+	if (!string_concat_fusion)
+		return;
+	ir_type *builder_type = class_registry_get("java/lang/StringBuilder");
+	if (builder_type == NULL)
+		return;
+
+	ir_node **calls = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, NULL, collect_object_allocations, &calls);
+
+	bool changed = false;
+	if (ARR_LEN(calls) > 0) {
+		assure_edges(irg);
+		for (size_t i = 0, n = ARR_LEN(calls); i < n; ++i) {
+			changed |= fuse_concat(calls[i], builder_type);
+		}
+	}
+	DEL_ARR_F(calls);
+
+	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_CONTROL_FLOW
+	                                    : IR_GRAPH_PROPERTIES_ALL);
+}
+
+/*
+ * Atomic intrinsics
+ *
+ * Calls of the atomic methods of the simplert java.util.concurrent.atomic
+ * classes are constructed inline. get is a volatile load and lazySet a
+ * volatile store, which already have acquire and release semantics on x86.
+ * compareAndSet is a compare and swap Builtin, a locked instruction and thus
+ * a full barrier as a volatile write needs one. There is no fetch and add
+ * Builtin, so set, getAndSet and the add methods are compare and swap loops.
+ * The classes are final, so the method of a call is known statically.
+ * With zero-cost exceptions a null receiver raises a NullPointerException
+ * and an index outside the AtomicIntegerArray an
+ * ArrayIndexOutOfBoundsException, like the synchronized bodies do.
+ */
+
+typedef enum atomic_op_t {
+	ATOMIC_GET,
+	ATOMIC_LAZY_SET,
+	ATOMIC_SET,
+	ATOMIC_GET_AND_SET,
+	ATOMIC_COMPARE_AND_SET,
+	ATOMIC_GET_AND_ADD,
+	ATOMIC_ADD_AND_GET,
+} atomic_op_t;
+
+typedef struct atomic_method_t {
+	/**
+	 * method name and descriptor, # stands for the value type, the index of
+	 * indexed classes precedes the parameters
+	 */
+	const char  *name;
+	atomic_op_t  op;
+	int          delta;  /**< added by the method, 0 to add the argument */
+} atomic_method_t;
+
+static const atomic_method_t atomic_methods[] = {
+	{ "get.()#",                 ATOMIC_GET,               0 },
+	{ "lazySet.(#)V",            ATOMIC_LAZY_SET,          0 },
+	{ "set.(#)V",                ATOMIC_SET,               0 },
+	{ "getAndSet.(#)#",          ATOMIC_GET_AND_SET,       0 },
+	{ "compareAndSet.(##)Z",     ATOMIC_COMPARE_AND_SET,   0 },
+	{ "weakCompareAndSet.(##)Z", ATOMIC_COMPARE_AND_SET,   0 },
+	{ "getAndAdd.(#)#",          ATOMIC_GET_AND_ADD,       0 },
+	{ "addAndGet.(#)#",          ATOMIC_ADD_AND_GET,       0 },
+	{ "getAndIncrement.()#",     ATOMIC_GET_AND_ADD,       1 },
+	{ "getAndDecrement.()#",     ATOMIC_GET_AND_ADD,      -1 },
+	{ "incrementAndGet.()#",     ATOMIC_ADD_AND_GET,       1 },
+	{ "decrementAndGet.()#",     ATOMIC_ADD_AND_GET,      -1 },
+};
+
+typedef struct atomic_class_t {
+	const char *name;
+	const char *field;              /**< the value or the array of values */
+	const char *value_descriptor;
+	bool        indexed;            /**< the methods take an array index */
+	ir_type    *value_type;
+	ir_type    *compare_swap_type;
+} atomic_class_t;
+
+static atomic_class_t atomic_classes[] = {
+	{ "java/util/concurrent/atomic/AtomicInteger",      "value", "I",                  false, NULL, NULL },
+	{ "java/util/concurrent/atomic/AtomicLong",         "value", "J",                  false, NULL, NULL },
+	{ "java/util/concurrent/atomic/AtomicReference",    "value", "Ljava/lang/Object;", false, NULL, NULL },
+	{ "java/util/concurrent/atomic/AtomicIntegerArray", "array", "I",                  true,  NULL, NULL },
+};
+
+static void init_atomic_intrinsics(void)
+{
+	atomic_classes[0].value_type = type_int;
+	atomic_classes[1].value_type = type_long;
+	atomic_classes[2].value_type = type_reference;
+	atomic_classes[3].value_type = type_int;
+	for (size_t i = 0; i < ARRAY_SIZE(atomic_classes); ++i) {
+		atomic_class_t *cls = &atomic_classes[i];
+		cls->compare_swap_type = new_compare_swap_type(cls->value_type);
+	}
+}
+
+static const atomic_class_t *find_atomic_class(ir_type *owner)
+{
+	const char *name = get_compound_name(owner);
+	for (size_t i = 0; i < ARRAY_SIZE(atomic_classes); ++i) {
+		if (strcmp(atomic_classes[i].name, name) == 0)
+			return &atomic_classes[i];
+	}
+	return NULL;
+}
+
+/** Returns whether @p name is the name of the pattern @p desc in @p cls. */
+static bool atomic_method_matches(const atomic_class_t *cls,
+                                  const atomic_method_t *desc,
+                                  const char *name)
+{
+	size_t value_length = strlen(cls->value_descriptor);
+	for (const char *p = desc->name; *p != '\0'; ++p) {
+		if (*p == '#') {
+			if (strncmp(name, cls->value_descriptor, value_length) != 0)
+				return false;
+			name += value_length;
+			continue;
+		}
+		if (*name++ != *p)
+			return false;
+		if (*p == '(' && cls->indexed && *name++ != 'I')
+			return false;
+	}
+	return *name == '\0';
+}
+
+static const atomic_method_t *find_atomic_method(const atomic_class_t *cls,
+                                                 ir_entity *method)
+{
+	/* the entity name is the method name followed by its descriptor */
+	const char *name = get_entity_name(method);
+	for (size_t i = 0; i < ARRAY_SIZE(atomic_methods); ++i) {
+		if (atomic_method_matches(cls, &atomic_methods[i], name))
+			return &atomic_methods[i];
+	}
+	return NULL;
+}
+
+static ir_entity *find_field(ir_type *owner, const char *name)
+{
+	ident *id = new_id_from_str(name);
+	for (size_t i = 0, n = get_class_n_members(owner); i < n; ++i) {
+		ir_entity *member = get_class_member(owner, i);
+		if (!is_method_entity(member) && get_entity_ident(member) == id)
+			return member;
+	}
+	return NULL;
+}
+
+/**
+ * Calls the runtime function @p thrower if @p failed is true, its exception
+ * goes to @p landing_pad. The current block continues where the check
+ * passed.
+ */
+static void construct_check(ir_node *failed, ir_node *landing_pad,
+                            ir_entity *thrower, int n_args,
+                            ir_node *const *args)
+{
+	ir_node *cond       = new_Cond(failed);
+	set_Cond_jmp_pred(cond, COND_JMP_PRED_FALSE);
+	ir_node *proj_throw = new_Proj(cond, mode_X, pn_Cond_true);
+	ir_node *proj_next  = new_Proj(cond, mode_X, pn_Cond_false);
+
+	set_cur_block(new_Block(1, &proj_throw));
+	ir_node *call = new_Call(get_store(), new_Address(thrower), n_args, args,
+	                         get_entity_type(thrower));
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+	ir_set_throws_exception(call, true);
+	add_immBlock_pred(landing_pad, new_Proj(call, mode_X, pn_Call_X_except));
+	/* the thrower does not return, the block after it stays empty */
+	ir_node *proj_regular = new_Proj(call, mode_X, pn_Call_X_regular);
+	keep_alive(new_Block(1, &proj_regular));
+
+	set_cur_block(new_Block(1, &proj_next));
+}
+
+static ir_node *atomic_load(ir_node *addr, ir_type *type)
+{
+	ir_mode *mode = get_type_mode(type);
+	ir_node *load = new_Load(get_store(), addr, mode, type, cons_volatile);
+	set_store(new_Proj(load, mode_M, pn_Load_M));
+	return new_Proj(load, mode, pn_Load_res);
+}
+
+/** Returns the value found at @p addr, it was replaced if it is @p expected. */
+static ir_node *atomic_compare_swap(const atomic_class_t *cls, ir_node *addr,
+                                    ir_node *expected, ir_node *value)
+{
+	ir_mode *mode = get_type_mode(cls->value_type);
+	ir_node *in[] = { addr, expected, value };
+	ir_node *cas  = new_Builtin(get_store(), ARRAY_SIZE(in), in,
+	                            ir_bk_compare_swap, cls->compare_swap_type);
+	set_store(new_Proj(cas, mode_M, pn_Builtin_M));
+	return new_Proj(cas, mode, pn_Builtin_max+1);
+}
+
+/**
+ * Constructs a compare and swap loop which replaces the value at @p addr by
+ * @p operand or, if @p add is set, by the sum of both. Returns the old value,
+ * the new one in @p new_value.
+ */
+static ir_node *atomic_update(const atomic_class_t *cls, ir_node *addr,
+                              ir_node *operand, bool add, ir_node **new_value)
+{
+	ir_node *entry = new_Jmp();
+	ir_node *loop  = new_immBlock();
+	add_immBlock_pred(loop, entry);
+	set_cur_block(loop);
+
+	ir_node *old   = atomic_load(addr, cls->value_type);
+	ir_node *value = add ? new_Add(old, operand) : operand;
+	ir_node *found = atomic_compare_swap(cls, addr, old, value);
+	ir_node *cmp   = new_Cmp(found, old, ir_relation_equal);
+	ir_node *cond  = new_Cond(cmp);
+	set_Cond_jmp_pred(cond, COND_JMP_PRED_TRUE);
+	add_immBlock_pred(loop, new_Proj(cond, mode_X, pn_Cond_false));
+	mature_immBlock(loop);
+
+	ir_node *done = new_immBlock();
+	add_immBlock_pred(done, new_Proj(cond, mode_X, pn_Cond_true));
+	mature_immBlock(done);
+	set_cur_block(done);
+
+	*new_value = value;
+	return old;
+}
+
+bool gcji_atomic_intrinsic(ir_entity *method, ir_node **args,
+                           ir_node *landing_pad, ir_node **result)
+{
+	if (!atomic_intrinsics)
+		return false;
+	ir_type              *owner = get_entity_owner(method);
+	const atomic_class_t *cls   = find_atomic_class(owner);
+	if (cls == NULL)
+		return false;
+	const atomic_method_t *desc  = find_atomic_method(cls, method);
+	ir_entity             *field = find_field(owner, cls->field);
+	if (desc == NULL || field == NULL)
+		return false;
+
+	if (landing_pad != NULL) {
+		ir_node *null = new_Const(get_mode_null(mode_reference));
+		ir_node *cmp  = new_Cmp(args[0], null, ir_relation_equal);
+		construct_check(cmp, landing_pad, gcj_throw_null_pointer_entity, 0,
+		                NULL);
+	}
+
+	ir_node  *addr     = new_Member(args[0], field);
+	ir_node **operands = args + 1;
+	if (cls->indexed) {
+		/* the array field is final */
+		ir_node *load  = new_Load(get_store(), addr, mode_reference,
+		                          type_reference, cons_none);
+		ir_node *array = new_Proj(load, mode_reference, pn_Load_res);
+		set_store(new_Proj(load, mode_M, pn_Load_M));
+		ir_node *index = operands[0];
+		if (landing_pad != NULL) {
+			/* negative indices compare as large unsigned ones */
+			ir_node *arlen  = new_Arraylength(get_store(), array);
+			ir_node *length = new_Proj(arlen, mode_int, pn_Arraylength_res);
+			set_store(new_Proj(arlen, mode_M, pn_Arraylength_M));
+			ir_node *cmp    = new_Cmp(new_Conv(index, mode_Iu),
+			                          new_Conv(length, mode_Iu),
+			                          ir_relation_greater_equal);
+			construct_check(cmp, landing_pad, gcj_throw_array_index_entity, 1,
+			                &index);
+		}
+		addr      = new_Sel(gcji_array_data_addr(array), index,
+		                    type_array_int);
+		operands += 1;
+	}
+
+	ir_type *method_type = get_entity_type(method);
+	ir_mode *res_mode    = get_method_n_ress(method_type) > 0
+		? get_type_mode(get_method_res_type(method_type, 0)) : NULL;
+	ir_mode *value_mode  = get_type_mode(cls->value_type);
+	ir_node *operand     = desc->delta != 0
+		? new_Const_long(value_mode, desc->delta) : operands[0];
+	ir_node *new_value;
+	*result = NULL;
+	switch (desc->op) {
+	case ATOMIC_GET:
+		*result = atomic_load(addr, cls->value_type);
+		break;
+	case ATOMIC_LAZY_SET: {
+		ir_node *store = new_Store(get_store(), addr, operand,
+		                           cls->value_type, cons_volatile);
+		set_store(new_Proj(store, mode_M, pn_Store_M));
+		break;
+	}
+	case ATOMIC_SET:
+		atomic_update(cls, addr, operand, false, &new_value);
+		break;
+	case ATOMIC_GET_AND_SET:
+		*result = atomic_update(cls, addr, operand, false, &new_value);
+		break;
+	case ATOMIC_COMPARE_AND_SET: {
+		ir_node *expected = operands[0];
+		ir_node *found    = atomic_compare_swap(cls, addr, expected,
+		                                        operands[1]);
+		ir_node *cmp      = new_Cmp(found, expected, ir_relation_equal);
+		*result = new_Mux(cmp, new_Const_long(res_mode, 0),
+		                  new_Const_long(res_mode, 1));
+		break;
+	}
+	case ATOMIC_GET_AND_ADD:
+		*result = atomic_update(cls, addr, operand, true, &new_value);
+		break;
+	case ATOMIC_ADD_AND_GET:
+		atomic_update(cls, addr, operand, true, &new_value);
+		*result = new_value;
+		break;
+	}
+	assert((*result == NULL) == (res_mode == NULL));
+	return true;
+}
+
+/*
+ * Math intrinsics
+ *
+ * Calls of the java.lang.Math methods below are constructed inline. abs,
+ * min and max of ints and longs are Muxes. The floating point variants
+ * follow Math.java: the result is NaN if an operand is NaN, min and max
+ * order -0.0 before 0.0 and abs(-0.0) is 0.0. Their selections are Cond
+ * diamonds, if-conversion turns them into Muxes where the backend supports
+ * floating point Muxes. Firm has no nodes for square roots and rounding, so
+ * sqrt, ceil, floor and rint call libm directly instead of going through
+ * the Math natives. The libm functions are declared pure, errno is not
+ * observable from Java.
+ */
+
+typedef enum math_op_t {
+	MATH_ABS,
+	MATH_MIN,
+	MATH_MAX,
+	MATH_LIBM,
+} math_op_t;
+
+typedef struct math_method_t {
+	const char *name;       /**< method name and descriptor */
+	math_op_t   op;
+	const char *libm_name;  /**< the libm function of MATH_LIBM */
+	ir_entity  *libm;
+} math_method_t;
+
+static math_method_t math_methods[] = {
+	{ "abs.(I)I",   MATH_ABS,  NULL,    NULL },
+	{ "abs.(J)J",   MATH_ABS,  NULL,    NULL },
+	{ "abs.(F)F",   MATH_ABS,  NULL,    NULL },
+	{ "abs.(D)D",   MATH_ABS,  NULL,    NULL },
+	{ "min.(II)I",  MATH_MIN,  NULL,    NULL },
+	{ "min.(JJ)J",  MATH_MIN,  NULL,    NULL },
+	{ "min.(FF)F",  MATH_MIN,  NULL,    NULL },
+	{ "min.(DD)D",  MATH_MIN,  NULL,    NULL },
+	{ "max.(II)I",  MATH_MAX,  NULL,    NULL },
+	{ "max.(JJ)J",  MATH_MAX,  NULL,    NULL },
+	{ "max.(FF)F",  MATH_MAX,  NULL,    NULL },
+	{ "max.(DD)D",  MATH_MAX,  NULL,    NULL },
+	{ "sqrt.(D)D",  MATH_LIBM, "sqrt",  NULL },
+	{ "ceil.(D)D",  MATH_LIBM, "ceil",  NULL },
+	{ "floor.(D)D", MATH_LIBM, "floor", NULL },
+	{ "rint.(D)D",  MATH_LIBM, "rint",  NULL },
+};
+
+static void init_math_intrinsics(void)
+{
+	ir_type *type = new_type_method(1, 1, false, 0,
+	                                mtp_property_no_write | mtp_property_pure);
+	set_method_param_type(type, 0, type_double);
+	set_method_res_type(type, 0, type_double);
+	for (size_t i = 0; i < ARRAY_SIZE(math_methods); ++i) {
+		math_method_t *desc = &math_methods[i];
+		if (desc->op != MATH_LIBM)
+			continue;
+		ident *id  = ir_platform_mangle_global(desc->libm_name);
+		desc->libm = new_entity(glob, id, type);
+		set_entity_visibility(desc->libm, ir_visibility_external);
+	}
+}
+
+/**
+ * Returns @p if_true if @p selector is true, @p if_false otherwise.
+ * Floating point values are selected by a Cond diamond.
+ */
+static ir_node *math_select(ir_node *selector, ir_node *if_true,
+                            ir_node *if_false)
+{
+	ir_mode *mode = get_irn_mode(if_true);
+	if (!mode_is_float(mode))
+		return new_Mux(selector, if_false, if_true);
+
+	ir_node *cond       = new_Cond(selector);
+	ir_node *proj_true  = new_Proj(cond, mode_X, pn_Cond_true);
+	ir_node *proj_false = new_Proj(cond, mode_X, pn_Cond_false);
+	ir_node *tblock     = new_Block(1, &proj_true);
+	ir_node *fblock     = new_Block(1, &proj_false);
+	set_cur_block(tblock);
+	ir_node *tjump = new_Jmp();
+	set_cur_block(fblock);
+	ir_node *fjump = new_Jmp();
+
+	ir_node *in[]     = { tjump, fjump };
+	ir_node *merge    = new_Block(ARRAY_SIZE(in), in);
+	set_cur_block(merge);
+	ir_node *phi_in[] = { if_true, if_false };
+	return new_Phi(ARRAY_SIZE(phi_in), phi_in, mode);
+}
+
+static ir_node *math_abs(ir_node *value)
+{
+	ir_mode *mode = get_irn_mode(value);
+	ir_node *zero = new_Const(get_mode_null(mode));
+	if (!mode_is_float(mode)) {
+		/* abs(MIN_VALUE) is MIN_VALUE, as the negation wraps around */
+		ir_node *negative = new_Cmp(value, zero, ir_relation_less);
+		return math_select(negative, new_Minus(value), value);
+	}
+	/* 0 - -0.0 is 0.0, NaN <= 0 is false */
+	ir_node *not_positive = new_Cmp(value, zero, ir_relation_less_equal);
+	return math_select(not_positive, new_Sub(zero, value), value);
+}
+
+static ir_node *math_min_max(ir_node *a, ir_node *b, bool max)
+{
+	ir_relation first = max ? ir_relation_greater : ir_relation_less;
+	ir_mode    *mode  = get_irn_mode(a);
+	if (!mode_is_float(mode))
+		return math_select(new_Cmp(a, b, first), a, b);
+
+	/*
+	 * Neither operand comes first if they are equal or one is NaN. Equal
+	 * zeros are combined so that a negative zero wins for min and a
+	 * positive one for max, which also yields NaN if b is NaN. If a is NaN
+	 * the sum is NaN as well. Otherwise the values are equal.
+	 */
+	ir_node *zero     = new_Const(get_mode_null(mode));
+	ir_node *combined = max ? new_Add(a, b)
+	                        : new_Minus(new_Sub(new_Minus(a), b));
+	ir_node *special  = new_Cmp(a, zero, ir_relation_unordered_equal);
+	ir_node *tie      = math_select(special, combined, b);
+	ir_node *second   = math_select(new_Cmp(b, a, first), b, tie);
+	return math_select(new_Cmp(a, b, first), a, second);
+}
+
+static ir_node *math_libm_call(ir_entity *function, ir_node *value)
+{
+	ir_node *addr   = new_Address(function);
+	ir_type *type   = get_entity_type(function);
+	ir_node *args[] = { value };
+	ir_node *mem    = get_store();
+	ir_node *call   = new_Call(mem, addr, ARRAY_SIZE(args), args, type);
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+	ir_node *ress   = new_Proj(call, mode_T, pn_Call_T_result);
+	return new_Proj(ress, mode_double, 0);
+}
+
+bool gcji_math_intrinsic(ir_entity *method, ir_node **args, ir_node **result)
+{
+	if (!math_intrinsics)
+		return false;
+	ir_type *owner = get_entity_owner(method);
+	if (strcmp(get_compound_name(owner), "java/lang/Math") != 0)
+		return false;
+
+	const char          *name = get_entity_name(method);
+	const math_method_t *desc = NULL;
+	for (size_t i = 0; i < ARRAY_SIZE(math_methods); ++i) {
+		if (strcmp(math_methods[i].name, name) == 0) {
+			desc = &math_methods[i];
+			break;
+		}
+	}
+	if (desc == NULL)
+		return false;
+
+	switch (desc->op) {
+	case MATH_ABS:
+		*result = math_abs(args[0]);
+		return true;
+	case MATH_MIN:
+		*result = math_min_max(args[0], args[1], false);
+		return true;
+	case MATH_MAX:
+		*result = math_min_max(args[0], args[1], true);
+		return true;
+	case MATH_LIBM:
+		*result = math_libm_call(desc->libm, args[0]);
+		return true;
+	}
+	panic("invalid math intrinsic");
+}
@@ -6,6 +6,26 @@
 
 extern ident *superobject_ident;
 extern bool   create_jcr_segment;
+extern bool   inline_allocation;
+extern bool   emit_gc_bitmaps;
+extern bool   emit_gc_roots;
+extern bool   safepoint_polls;
+extern bool   card_marking;
+extern bool   uninitialized_arrays;
+extern bool   stack_allocation;
+extern bool   string_concat_fusion;
+extern bool   string_literal_hashes;
+extern bool   method_hash_tables;
+extern bool   thin_locks;
+extern bool   atomic_intrinsics;
+extern bool   math_intrinsics;
+extern bool   zero_cost_exceptions;
+
+/**
+ * Classes of the exceptions simplert preallocates, NULL terminated. Must
+ * match implicit_exception_t in simplert/c/exceptions.h.
+ */
+extern const char *const gcji_implicit_exceptions[];
 
 void       gcji_init(void);
 void       gcji_deinit(void);
@@ -13,7 +33,7 @@ void       gcji_class_init(ir_type *type);
 ir_node   *gcji_allocate_object(ir_type *type);
 ir_node   *gcji_allocate_array(ir_type *eltype, ir_node *count);
 ir_entity *gcji_emit_utf8_const(constant_t *constant, int mangle_slash);
-ir_node   *gcji_new_string(ir_entity *bytes);
+ir_node   *gcji_new_string(constant_t *constant);
 ir_node   *gcji_new_multiarray(ir_node *array_class_ref, unsigned dims,
                                ir_node **sizes);
 ir_entity *gcji_get_rtti_entity(ir_type *classtype);
@@ -22,12 +42,19 @@ void       gcji_create_rtti_entity(ir_type *type);
 void       gcji_setup_rtti_entity(class_t *cls, ir_type *type);
 ir_node   *gcji_lookup_interface(ir_node *obptr, ir_type *iface, ir_entity *method, ir_graph *irg, ir_node *block, ir_node **mem);
 void       gcji_checkcast(ir_type *classtype, ir_node *objptr);
+void       gcji_monitor_enter(ir_node *objptr);
+void       gcji_monitor_exit(ir_node *objptr);
 void       gcji_create_vtable_entity(ir_type *type);
 void       gcji_set_java_lang_class(ir_type *type);
 void       gcji_set_java_lang_object(ir_type *type);
 void       gcji_add_java_lang_class_fields(ir_type *type);
+void       gcji_add_java_lang_object_fields(ir_type *type);
 void       gcji_create_array_type(void);
 ir_entity *gcji_get_abstract_method_entity(void);
+ir_entity *gcji_get_throw_entity(void);
+ir_entity *gcji_get_throw_arithmetic_entity(void);
+ir_entity *gcji_get_class_init_entity(void);
+ir_node   *gcji_get_exception_object(void);
 
 void       init_rta_callbacks(void);
 void       deinit_rta_callbacks(void);
@@ -38,4 +65,93 @@ ir_entity *detect_call(ir_node *call);
  */
 ir_node *gcji_array_data_addr(ir_node *addr);
 
+/**
+ * Replaces the runtime calls for object and array allocation with an inline
+ * bump pointer fast path (simplert only, see inline_allocation).
+ */
+void gcji_lower_allocations(ir_graph *irg);
+
+/**
+ * Replaces the runtime calls for monitorenter and monitorexit with an inline
+ * thin lock fast path (simplert only, see thin_locks).
+ */
+void gcji_lower_monitors(ir_graph *irg);
+
+/**
+ * Emits the table of static fields holding references which the simplert
+ * collector uses as precise roots (see emit_gc_roots).
+ */
+void gcji_create_static_roots(void);
+
+/**
+ * Emits the table of the classes of gcji_implicit_exceptions, which simplert
+ * preallocates (see zero_cost_exceptions).
+ */
+void gcji_create_implicit_exception_table(void);
+
+/**
+ * Labels the call sites with exception handlers and emits the table mapping
+ * their return addresses to the landing pads, which the simplert unwinder
+ * searches, and the tables of all classes and of the source lines of all
+ * calls, which symbolize stack traces (see zero_cost_exceptions). Must run
+ * after all optimizations.
+ */
+void gcji_create_exception_table(void);
+
+/**
+ * Replaces throws whose exception is caught in the same method, which
+ * inlining exposes, by a jump to the landing pad (see zero_cost_exceptions).
+ */
+void gcji_lower_local_throws(ir_graph *irg);
+
+/**
+ * Adds a poll of the runtime's safepoint flag to each loop backedge and,
+ * in methods with calls, before each return (simplert only, see
+ * safepoint_polls).
+ */
+void gcji_insert_safepoint_polls(ir_graph *irg);
+
+/**
+ * Adds the card marking write barrier of the simplert generational collector
+ * after each reference store into the heap (see card_marking).
+ */
+void gcji_insert_card_marks(ir_graph *irg);
+
+/**
+ * Lets primitive arrays which are filled by System.arraycopy right after
+ * their allocation skip the zeroing (simplert only, see uninitialized_arrays).
+ */
+void gcji_elide_array_zeroing(ir_graph *irg);
+
+/**
+ * Places objects and small primitive arrays which do not escape the method
+ * allocating them in its stack frame (simplert only, see stack_allocation).
+ */
+void gcji_escape_analysis(void);
+
+/**
+ * Replaces StringBuilder append chains ending in toString by a single call
+ * concatenating the parts (simplert only, see string_concat_fusion). Must run
+ * before rapid type analysis.
+ */
+void gcji_fuse_string_concat(ir_graph *irg);
+
+/**
+ * Constructs a call of @p method with @p args inline if it is one of the
+ * atomic methods of the java.util.concurrent.atomic classes (simplert only,
+ * see atomic_intrinsics). Returns false if it is not, otherwise @p result is
+ * the result of the call or NULL for a void method. The exceptions of the
+ * null and index checks go to @p landing_pad, there are no checks if it is
+ * NULL.
+ */
+bool gcji_atomic_intrinsic(ir_entity *method, ir_node **args,
+                           ir_node *landing_pad, ir_node **result);
+
+/**
+ * Constructs a call of the static @p method with @p args inline if it is one
+ * of the java.lang.Math methods with a Firm equivalent (see math_intrinsics).
+ * Returns false if it is not, otherwise @p result is the result of the call.
+ */
+bool gcji_math_intrinsic(ir_entity *method, ir_node **args, ir_node **result);
+
 #endif
@@ -22,6 +22,7 @@
 #include "adt/cpmap.h"
 #include "adt/hashptr.h"
 #include "adt/xmalloc.h"
+#include "adt/util.h"
 #include "driver/firm_opt.h"
 
 #include "class_registry.h"
@@ -331,6 +332,8 @@ static void create_field_entity(field_t *field, ir_type *owner)
 static const attribute_code_t *code;
 static uint16_t                stack_pointer;
 static uint16_t                max_locals;
+/** object locked by the current synchronized method, NULL for others */
+static ir_node                *sync_object;
 
 static ir_mode *get_arith_mode(ir_mode *mode)
 {
@@ -880,9 +883,8 @@ static void push_load_const(uint16_t index)
 		break;
 	}
 	case CONSTANT_STRING: {
-		constant_t *utf8_const   = get_constant(constant->string.string_index);
-		ir_entity  *string_const = gcji_emit_utf8_const(utf8_const, 0);
-		ir_node    *res          = gcji_new_string(string_const);
+		constant_t *utf8_const = get_constant(constant->string.string_index);
+		ir_node    *res        = gcji_new_string(utf8_const);
 		symbolic_push(res);
 		break;
 	}
@@ -912,6 +914,8 @@ static void construct_vreturn(ir_type *method_type, ir_mode *mode)
 		n_ins = 1;
 		in[0] = new_Conv(val, res_mode);
 	}
+	if (sync_object != NULL)
+		gcji_monitor_exit(sync_object);
 
 	ir_node *ret   = new_Return(get_store(), n_ins, in);
 
@@ -1212,10 +1216,308 @@ static void sort_exceptions(exception_t *excptns, size_t n)
 	// Example: B extends A, try { ... } catch (B b) {} catch (A a) {}
 }
 
+/*
+ * Zero-cost exceptions (see zero_cost_exceptions): calls which may throw
+ * get exception control flow. The exceptional exit of a call leads to a
+ * landing pad, which tests the exception against the handlers covering the
+ * call in the order of the exception table, calls covered by the same
+ * handlers share one. Exceptions no handler catches go to the end block, so
+ * inlining routes them to the handlers of the caller.
+ */
+typedef struct landing_pad_t {
+	unsigned *handlers;  /**< exception table entries covering the calls */
+	ir_node  *block;
+} landing_pad_t;
+
+static landing_pad_t *landing_pads;
+/** handler releasing the monitor of a synchronized method, NULL for others */
+static ir_node       *sync_handler;
+
+static ir_node *get_uncaught_target(void)
+{
+	if (sync_handler != NULL)
+		return sync_handler;
+	return get_irg_end_block(current_ir_graph);
+}
+
+/**
+ * Constructs a call whose exceptional exit leads to @p landing_pad, the
+ * current block continues after it.
+ */
+static ir_node *new_throwing_Call_to(ir_node *landing_pad, ir_node *mem,
+                                     ir_node *callee, int n_args,
+                                     ir_node *const *args, ir_type *type)
+{
+	ir_node *call = new_Call(mem, callee, n_args, args, type);
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+	ir_set_throws_exception(call, true);
+	ir_node *except = new_Proj(call, mode_X, pn_Call_X_except);
+	add_immBlock_pred(landing_pad, except);
+
+	ir_node *regular = new_Proj(call, mode_X, pn_Call_X_regular);
+	ir_node *block   = new_immBlock();
+	add_immBlock_pred(block, regular);
+	mature_immBlock(block);
+	set_cur_block(block);
+	return call;
+}
+
+/**
+ * Calls the runtime function @p entity, which throws an exception and does
+ * not return. @p landing_pad is where its handlers start.
+ */
+static void construct_throwing_call(ir_node *landing_pad, ir_entity *entity,
+                                    int n_args, ir_node *const *args)
+{
+	ir_node *callee = new_Address(entity);
+	ir_type *type   = get_entity_type(entity);
+	new_throwing_Call_to(landing_pad, get_store(), callee, n_args, args,
+	                     type);
+	/* the block after the call stays empty */
+	keep_alive(get_cur_block());
+	set_cur_block(NULL);
+}
+
+/** Throws @p exception, @p landing_pad is where its handlers start. */
+static void construct_throw(ir_node *landing_pad, ir_node *exception)
+{
+	construct_throwing_call(landing_pad, gcji_get_throw_entity(), 1,
+	                        &exception);
+}
+
+static ir_node *construct_landing_pad(const unsigned *handlers)
+{
+	ir_node *old_block = get_cur_block();
+	ir_node *block     = new_immBlock();
+	set_cur_block(block);
+
+	ir_node *exception = gcji_get_exception_object();
+	for (size_t i = 0; i < code->n_exceptions; ++i) {
+		if (!rbitset_is_set(handlers, i))
+			continue;
+		const exception_t *e       = &code->exceptions[i];
+		ir_node           *handler = get_basic_block(e->handler_pc)->block;
+		if (e->catch_type == 0) {
+			add_immBlock_pred(handler, new_Jmp());
+			set_cur_block(NULL);
+			break;
+		}
+
+		ir_type *catch_type = get_classref_type(e->catch_type);
+		finalize_class_type(catch_type);
+		ir_node *mem        = get_store();
+		ir_node *instanceof = new_InstanceOf(mem, exception, catch_type);
+		ir_node *matches    = new_Proj(instanceof, mode_b, pn_InstanceOf_res);
+		set_store(new_Proj(instanceof, mode_M, pn_InstanceOf_M));
+
+		ir_node *cond = new_Cond(matches);
+		add_immBlock_pred(handler, new_Proj(cond, mode_X, pn_Cond_true));
+		ir_node *next = new_immBlock();
+		add_immBlock_pred(next, new_Proj(cond, mode_X, pn_Cond_false));
+		mature_immBlock(next);
+		set_cur_block(next);
+	}
+
+	/* no handler of the method catches it */
+	if (get_cur_block() != NULL) {
+		if (sync_handler != NULL) {
+			add_immBlock_pred(sync_handler, new_Jmp());
+		} else {
+			construct_throw(get_irg_end_block(current_ir_graph), exception);
+		}
+	}
+
+	set_cur_block(old_block);
+	return block;
+}
+
+/** Returns the landing pad for the calls at @p pc. */
+static ir_node *get_landing_pad(uint32_t pc)
+{
+	size_t n_handlers = code->n_exceptions;
+	if (n_handlers == 0)
+		return get_uncaught_target();
+
+	unsigned *handlers = rbitset_malloc(n_handlers);
+	bool      covered  = false;
+	for (size_t i = 0; i < n_handlers; ++i) {
+		const exception_t *e = &code->exceptions[i];
+		if (e->start_pc <= pc && pc < e->end_pc) {
+			rbitset_set(handlers, i);
+			covered = true;
+		}
+	}
+	if (!covered) {
+		xfree(handlers);
+		return get_uncaught_target();
+	}
+
+	for (size_t i = 0, n = ARR_LEN(landing_pads); i < n; ++i) {
+		if (rbitset_equal(landing_pads[i].handlers, handlers, n_handlers)) {
+			xfree(handlers);
+			return landing_pads[i].block;
+		}
+	}
+	landing_pad_t landing_pad;
+	landing_pad.handlers = handlers;
+	landing_pad.block    = construct_landing_pad(handlers);
+	ARR_APP1(landing_pad_t, landing_pads, landing_pad);
+	return landing_pad.block;
+}
+
+/*
+ * Line numbers
+ *
+ * Calls of Java methods carry the source line of their bytecode as debug
+ * info, a line_dbg_t. It survives inlining and the other optimizations, the
+ * table of return addresses and lines for stack traces is created from it
+ * (see gcji_create_exception_table).
+ */
+typedef struct line_dbg_t {
+	const char *file;
+	unsigned    line;
+} line_dbg_t;
+
+/** LineNumberTable of the current method or NULL */
+static const attribute_unknown_t *line_numbers;
+/** SourceFile of the current class or NULL */
+static const char                *source_file;
+/** consecutive calls are often on the same line */
+static line_dbg_t                *last_line_dbg;
+
+static src_loc_t retrieve_line_dbg(dbg_info const *dbg)
+{
+	const line_dbg_t *line_dbg = (const line_dbg_t*)dbg;
+	src_loc_t         loc      = { line_dbg->file, line_dbg->line, 0 };
+	return loc;
+}
+
+static uint16_t get_be16(const uint8_t *data)
+{
+	return (uint16_t)(data[0] << 8 | data[1]);
+}
+
+/** Returns the attribute @p name of @p attributes if it is not parsed. */
+static const attribute_unknown_t *find_attribute(size_t n_attributes,
+		attribute_t *const *attributes, const char *name)
+{
+	for (size_t i = 0; i < n_attributes; ++i) {
+		const attribute_t *attribute = attributes[i];
+		if (attribute->kind != ATTRIBUTE_CUSTOM)
+			continue;
+		const constant_t *constant = get_constant(attribute->unknown.name_index);
+		if (strcmp(constant->utf8_string.bytes, name) == 0)
+			return &attribute->unknown;
+	}
+	return NULL;
+}
+
+/** Returns the debug info of the source line of @p pc or NULL. */
+static dbg_info *get_line_dbg(uint32_t pc)
+{
+	if (line_numbers == NULL || source_file == NULL)
+		return NULL;
+
+	/* the entry with the greatest start pc not after pc */
+	const uint8_t *data      = line_numbers->data;
+	unsigned       n_entries = get_be16(data);
+	unsigned       line      = 0;
+	uint32_t       start     = 0;
+	for (unsigned i = 0; i < n_entries; ++i) {
+		uint32_t entry_start = get_be16(data + 2 + 4 * i);
+		if (entry_start <= pc && (line == 0 || entry_start >= start)) {
+			start = entry_start;
+			line  = get_be16(data + 4 + 4 * i);
+		}
+	}
+	if (line == 0)
+		return NULL;
+
+	if (last_line_dbg == NULL || last_line_dbg->line != line
+	    || last_line_dbg->file != source_file) {
+		last_line_dbg       = XMALLOC(line_dbg_t);
+		last_line_dbg->file = source_file;
+		last_line_dbg->line = line;
+	}
+	return (dbg_info*)last_line_dbg;
+}
+
+/** Constructs a call of a Java method at @p pc, which may throw. */
+static ir_node *new_throwing_Call(uint32_t pc, ir_node *mem, ir_node *callee,
+                                  int n_args, ir_node *const *args,
+                                  ir_type *type)
+{
+	ir_node *call;
+	if (!zero_cost_exceptions) {
+		call = new_Call(mem, callee, n_args, args, type);
+		set_store(new_Proj(call, mode_M, pn_Call_M));
+	} else {
+		call = new_throwing_Call_to(get_landing_pad(pc), mem, callee, n_args,
+		                            args, type);
+	}
+	set_irn_dbg_info(call, get_line_dbg(pc));
+	return call;
+}
+
+/**
+ * Integer division and remainder at @p pc, a zero divisor raises an
+ * ArithmeticException. The check is only constructed with zero-cost
+ * exceptions, it folds away for constant divisors.
+ */
+static void construct_division(uint32_t pc, ir_mode *mode,
+                               ir_node *(*construct_func)(ir_node *, ir_node *))
+{
+	if (zero_cost_exceptions) {
+		ir_node *divisor = symbolic_pop(mode);
+		symbolic_push(divisor);
+
+		ir_node *zero = new_Const(get_mode_null(get_irn_mode(divisor)));
+		ir_node *cmp  = new_Cmp(divisor, zero, ir_relation_equal);
+		ir_node *cond = new_Cond(cmp);
+		set_Cond_jmp_pred(cond, COND_JMP_PRED_FALSE);
+
+		ir_node *throw_block = new_immBlock();
+		add_immBlock_pred(throw_block, new_Proj(cond, mode_X, pn_Cond_true));
+		mature_immBlock(throw_block);
+		ir_node *next_block = new_immBlock();
+		add_immBlock_pred(next_block, new_Proj(cond, mode_X, pn_Cond_false));
+		mature_immBlock(next_block);
+
+		set_cur_block(throw_block);
+		construct_throwing_call(get_landing_pad(pc),
+		                        gcji_get_throw_arithmetic_entity(), 0, NULL);
+		set_cur_block(next_block);
+	}
+	construct_arith(mode, construct_func);
+}
+
+/**
+ * Initializes @p type before its use at @p pc. Exceptions of the
+ * initializers go to the handlers of @p pc.
+ */
+static void construct_class_init(uint32_t pc, ir_type *type)
+{
+	if (!zero_cost_exceptions) {
+		gcji_class_init(type);
+		return;
+	}
+	ir_entity *entity = gcji_get_class_init_entity();
+	ir_node   *args[] = { gcji_get_runtime_classinfo(type) };
+	new_throwing_Call(pc, get_store(), new_Address(entity), ARRAY_SIZE(args),
+	                  args, get_entity_type(entity));
+}
+
 static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 {
 	code = new_code;
 
+	line_numbers = find_attribute(code->n_attributes, code->attributes,
+	                              "LineNumberTable");
+	const attribute_unknown_t *source = find_attribute(class_file->n_attributes,
+		class_file->attributes, "SourceFile");
+	source_file = source != NULL
+		? get_constant(get_be16(source->data))->utf8_string.bytes : NULL;
+
 	ir_type *method_type = get_entity_type(entity);
 
 	max_locals = code->max_locals + get_method_n_params(method_type);
@@ -1230,6 +1532,19 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 		gcji_class_init(owner);
 	}
 
+	/* synchronized methods hold the monitor of this or of their class,
+	 * each return releases it */
+	sync_object = NULL;
+	if (method->access_flags & ACCESS_FLAG_SYNCHRONIZED) {
+		if (method->access_flags & ACCESS_FLAG_STATIC) {
+			ir_type *owner = (ir_type*)class_file->link;
+			sync_object = gcji_get_runtime_classinfo(owner);
+		} else {
+			sync_object = new_Proj(get_irg_args(irg), mode_reference, 0);
+		}
+		gcji_monitor_enter(sync_object);
+	}
+
 	/* arguments become local variables */
 	ir_node *first_block = get_cur_block();
 	set_cur_block(get_irg_start_block(irg));
@@ -1698,8 +2013,21 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 	set_cur_block(NULL);
 	basic_block_t *next_target = &basic_blocks[0];
 
+	/* exceptions leaving a synchronized method release its monitor, the
+	 * handler rethrowing them is constructed after the code */
+	sync_handler = NULL;
 #ifdef EXCEPTIONS
 	eh_start_method();
+
+	if (sync_object != NULL) {
+		sync_handler = new_immBlock();
+		eh_new_lpad();
+		eh_add_handler(NULL, sync_handler);
+	}
+#else
+	landing_pads = NEW_ARR_F(landing_pad_t, 0);
+	if (zero_cost_exceptions && sync_object != NULL)
+		sync_handler = new_immBlock();
 #endif
 
 	for (uint32_t i = 0; i < code->code_length; /* nothing */) {
@@ -1753,10 +2081,18 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 		if (rbitset_is_set(try_ends, i))
 			eh_pop_lpad();
 #else
-		if (rbitset_is_set(catch_begins, i))
-			symbolic_push(new_Unknown(mode_reference));
+		/* the operand stack of a handler holds just the exception */
+		if (rbitset_is_set(catch_begins, i)) {
+			if (zero_cost_exceptions) {
+				stack_pointer = 0;
+				symbolic_push(gcji_get_exception_object());
+			} else {
+				symbolic_push(new_Unknown(mode_reference));
+			}
+		}
 #endif
 
+		uint32_t      pc     = i;
 		opcode_kind_t opcode = code->code[i++];
 		switch (opcode) {
 		case OPC_NOP: continue;
@@ -1885,12 +2221,12 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 		case OPC_LMUL:  construct_arith(mode_long,   new_Mul);        continue;
 		case OPC_FMUL:  construct_arith(mode_float,  new_Mul);        continue;
 		case OPC_DMUL:  construct_arith(mode_double, new_Mul);        continue;
-		case OPC_IDIV:  construct_arith(mode_int,    simple_new_Div); continue;
-		case OPC_LDIV:  construct_arith(mode_long,   simple_new_Div); continue;
+		case OPC_IDIV:  construct_division(pc, mode_int,  simple_new_Div); continue;
+		case OPC_LDIV:  construct_division(pc, mode_long, simple_new_Div); continue;
 		case OPC_FDIV:  construct_arith(mode_float,  simple_new_Div); continue;
 		case OPC_DDIV:  construct_arith(mode_double, simple_new_Div); continue;
-		case OPC_IREM:  construct_arith(mode_int,    simple_new_Mod); continue;
-		case OPC_LREM:  construct_arith(mode_long,   simple_new_Mod); continue;
+		case OPC_IREM:  construct_division(pc, mode_int,  simple_new_Mod); continue;
+		case OPC_LREM:  construct_division(pc, mode_long, simple_new_Mod); continue;
 		case OPC_FREM:  construct_arith(mode_float,  simple_new_Mod); continue;
 		case OPC_DREM:  construct_arith(mode_double, simple_new_Mod); continue;
 
@@ -2113,7 +2449,7 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 				ir_type *owner = get_field_defining_class(index);
 				finalize_class_type(owner);
 
-				gcji_class_init(owner);
+				construct_class_init(pc, owner);
 				addr = new_Address(entity);
 			} else {
 				ir_node  *object = symbolic_pop(mode_reference);
@@ -2157,6 +2493,15 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 				args[i]           = val;
 			}
 
+			ir_node *result;
+			ir_node *landing_pad = zero_cost_exceptions ? get_landing_pad(pc)
+			                                            : NULL;
+			if (gcji_atomic_intrinsic(entity, args, landing_pad, &result)) {
+				if (result != NULL)
+					symbolic_push(get_arith_value(result));
+				continue;
+			}
+
 			ir_node *mem     = get_store();
 			ir_node *sel     = new_MethodSel(mem, args[0], entity);
 			ir_node *sel_mem = new_Proj(sel, mode_M, pn_MethodSel_M);
@@ -2166,9 +2511,8 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 			set_store(sel_mem);
 			ir_node *call     = eh_new_Call(callee, n_args, args, type);
 #else
-			ir_node *call     = new_Call(sel_mem, callee, n_args, args, type);
-			ir_node *call_mem = new_Proj(call, mode_M, pn_Call_M);
-			set_store(call_mem);
+			ir_node *call     = new_throwing_Call(pc, sel_mem, callee, n_args,
+			                                      args, type);
 #endif
 
 			int n_res = get_method_n_ress(type);
@@ -2203,15 +2547,21 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 					val = new_Conv(val, mode);
 				args[i]           = val;
 			}
-			gcji_class_init(owner);
+
+			/* the intrinsics don't need Math to be initialized */
+			ir_node *result;
+			if (gcji_math_intrinsic(entity, args, &result)) {
+				symbolic_push(get_arith_value(result));
+				continue;
+			}
+			construct_class_init(pc, owner);
 
 #ifdef EXCEPTIONS
 			ir_node *call     = eh_new_Call(callee, n_args, args, type);
 #else
 			ir_node *mem     = get_store();
-			ir_node *call    = new_Call(mem, callee, n_args, args, type);
-			ir_node *new_mem = new_Proj(call, mode_M, pn_Call_M);
-			set_store(new_mem);
+			ir_node *call    = new_throwing_Call(pc, mem, callee, n_args, args,
+			                                     type);
 #endif
 
 			int n_res = get_method_n_ress(type);
@@ -2249,9 +2599,8 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 			ir_node *call     = eh_new_Call(callee, n_args, args, type);
 #else
 			ir_node *cur_mem  = get_store();
-			ir_node *call     = new_Call(cur_mem, callee, n_args, args, type);
-			cur_mem = new_Proj(call, mode_M, pn_Call_M);
-			set_store(cur_mem);
+			ir_node *call     = new_throwing_Call(pc, cur_mem, callee, n_args,
+			                                      args, type);
 #endif
 
 			int n_res = get_method_n_ress(type);
@@ -2296,9 +2645,8 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 			set_store(sel_mem);
 			ir_node *call     = eh_new_Call(callee, n_args, args, type);
 #else
-			ir_node *call     = new_Call(sel_mem, callee, n_args, args, type);
-			ir_node *call_mem = new_Proj(call, mode_M, pn_Call_M);
-			set_store(call_mem);
+			ir_node *call     = new_throwing_Call(pc, sel_mem, callee, n_args,
+			                                      args, type);
 #endif
 
 			int n_res = get_method_n_ress(type);
@@ -2392,6 +2740,10 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 		case OPC_ATHROW: {
 			ir_node *addr       = symbolic_pop(mode_reference);
 #ifndef EXCEPTIONS
+			if (zero_cost_exceptions) {
+				construct_throw(get_landing_pad(pc), addr);
+				continue;
+			}
 			(void)addr;
 			ir_node *abaddr  = new_Address(abort_entity);
 			ir_type *abtype  = get_entity_type(abort_entity);
@@ -2405,11 +2757,14 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 #endif
 			continue;
 		}
-		case OPC_MONITORENTER:
+		case OPC_MONITORENTER: {
+			ir_node *addr = symbolic_pop(mode_reference);
+			gcji_monitor_enter(addr);
+			continue;
+		}
 		case OPC_MONITOREXIT: {
-			// FIXME: need real implementation.
 			ir_node *addr = symbolic_pop(mode_reference);
-			(void) addr;
+			gcji_monitor_exit(addr);
 			continue;
 		}
 		case OPC_MULTIANEWARRAY: {
@@ -2534,7 +2889,31 @@ static void code_to_firm(ir_entity *entity, const attribute_code_t *new_code)
 	xfree(excptns);
 
 #ifdef EXCEPTIONS
+	if (sync_handler != NULL) {
+		eh_pop_lpad();
+		set_cur_block(sync_handler);
+		ir_node *exception = eh_get_exception_object();
+		gcji_monitor_exit(sync_object);
+		eh_throw(exception);
+	}
 	eh_end_method();
+	if (sync_handler != NULL)
+		mature_immBlock(sync_handler);
+#else
+	if (sync_handler != NULL) {
+		if (get_Block_n_cfgpreds(sync_handler) > 0) {
+			set_cur_block(sync_handler);
+			ir_node *exception = gcji_get_exception_object();
+			gcji_monitor_exit(sync_object);
+			construct_throw(get_irg_end_block(irg), exception);
+		}
+		mature_immBlock(sync_handler);
+	}
+	for (size_t i = 0, n = ARR_LEN(landing_pads); i < n; ++i) {
+		mature_immBlock(landing_pads[i].block);
+		xfree(landing_pads[i].handlers);
+	}
+	DEL_ARR_F(landing_pads);
 #endif
 
 	for (size_t t = 0; t < n_basic_blocks; ++t) {
@@ -2809,6 +3188,7 @@ static void finalize_class_type(ir_type *type)
 		ident     *vptr_ident = new_id_from_str("@vptr");
 		ir_entity *vptr       = new_entity(type, vptr_ident, type_reference);
 		oo_set_class_vptr_entity(type, vptr);
+		gcji_add_java_lang_object_fields(type);
 	}
 
 	for (size_t f = 0; f < (size_t) class_file->n_fields; ++f) {
@@ -2919,7 +3299,10 @@ static int link_executable(const char *startup_file, const char *asm_file,
 			obstack_printf(&obst, " -Wl,-R%s", CLASSPATH_SIMPLERT);
 #endif
 		}
+		obstack_printf(&obst, " -lpthread");
 	}
+	/* for the libm calls of the Math intrinsics */
+	obstack_printf(&obst, " -lm");
 	obstack_printf(&obst, " -o %s", output_name);
 	obstack_1grow(&obst, '\0');
 
@@ -2932,6 +3315,7 @@ static int link_executable(const char *startup_file, const char *asm_file,
 int main(int argc, char **argv)
 {
 	ir_init_library();
+	ir_set_debug_retrieve(retrieve_line_dbg);
 	ir_machine_triple_t *target = ir_get_host_machine_triple();
 	ir_target_set_triple(target);
 	ir_free_machine_triple(target);
@@ -3017,11 +3401,39 @@ int main(int argc, char **argv)
 
 	if (runtime_type == RUNTIME_GCJ) {
 		classpath_append(CLASSPATH_GCJ, true);
-		create_jcr_segment = true;
+		create_jcr_segment    = true;
+		inline_allocation     = false;
+		emit_gc_bitmaps       = false;
+		emit_gc_roots         = false;
+		safepoint_polls       = false;
+		card_marking          = false;
+		uninitialized_arrays  = false;
+		stack_allocation      = false;
+		string_concat_fusion  = false;
+		string_literal_hashes = false;
+		method_hash_tables    = false;
+		thin_locks            = false;
+		atomic_intrinsics     = false;
+		math_intrinsics       = true;
+		zero_cost_exceptions  = false;
 	} else {
 		assert(runtime_type == RUNTIME_SIMPLERT);
 		classpath_append(CLASSPATH_SIMPLERT, false);
-		create_jcr_segment = false;
+		create_jcr_segment    = false;
+		inline_allocation     = true;
+		emit_gc_bitmaps       = true;
+		emit_gc_roots         = true;
+		safepoint_polls       = true;
+		card_marking          = true;
+		uninitialized_arrays  = true;
+		stack_allocation      = true;
+		string_concat_fusion  = true;
+		string_literal_hashes = true;
+		method_hash_tables    = true;
+		thin_locks            = true;
+		atomic_intrinsics     = true;
+		math_intrinsics       = true;
+		zero_cost_exceptions  = true;
 	}
 	if (verbose)
 		classpath_print(stderr);
@@ -3049,6 +3461,14 @@ int main(int argc, char **argv)
 	ir_type *main_class = get_class_type(main_class_name);
 	enqueue_class(main_class);
 
+	/* the runtime preallocates the implicit exceptions */
+	if (zero_cost_exceptions) {
+		for (const char *const *name = gcji_implicit_exceptions;
+		     *name != NULL; ++name) {
+			enqueue_class(get_class_type(*name));
+		}
+	}
+
 	while (!pdeq_empty(worklist)) {
 		ir_type *classtype = pdeq_getl(worklist);
 
@@ -3072,6 +3492,12 @@ int main(int argc, char **argv)
 	int res = tr_verify();
 	assert(res != 0);
 
+	/* the fused concatenations call String.valueOf, which rapid type
+	 * analysis has to see */
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i) {
+		gcji_fuse_string_concat(get_irp_irg(i));
+	}
+
 	/* optimize */
 	if (optimize) {
 		oo_register_opt_funcs();
@@ -3101,6 +3527,10 @@ int main(int argc, char **argv)
 		assert(class_constr);
 		ir_entity *string_constr = find_method_entity("java/lang/String", "<init>.()V");
 		assert(string_constr);
+		/* the runtime calls it on new threads */
+		ir_entity *thread_run = NULL;
+		if (class_registry_get("java/lang/Thread") != NULL)
+			thread_run = find_method_entity("java/lang/Thread", "runThread.()V");
 /*		ir_entity *class_clinit = find_method_entity("java/lang/Class", "<clinit>.()V");
 		assert(class_clinit);
 		ir_entity *string_clinit = find_method_entity("java/lang/String", "<clinit>.()V");
@@ -3108,8 +3538,33 @@ int main(int argc, char **argv)
 */
 		ir_entity* entry_points_gcj[] = { javamain, NULL };
 		ir_type* initial_live_classes_gcj[] = { jl_class, jl_string, NULL };
-		ir_entity* entry_points_simplert[] = { javamain, class_constr, string_constr/*, class_clinit , string_clinit*/, NULL }; //TODO add constructors and clinits of Class and String (-> but String has no clinit at the moment in case of simplert!)
-		ir_type* initial_live_classes_simplert[] = { jl_class, jl_string, NULL };
+
+		//TODO add constructors and clinits of Class and String (-> but String has no clinit at the moment in case of simplert!)
+		ir_entity **entry_points_simplert = NEW_ARR_F(ir_entity*, 0);
+		ARR_APP1(ir_entity*, entry_points_simplert, javamain);
+		ARR_APP1(ir_entity*, entry_points_simplert, class_constr);
+		ARR_APP1(ir_entity*, entry_points_simplert, string_constr);
+		if (thread_run != NULL)
+			ARR_APP1(ir_entity*, entry_points_simplert, thread_run);
+		ir_type **initial_live_classes_simplert = NEW_ARR_F(ir_type*, 0);
+		ARR_APP1(ir_type*, initial_live_classes_simplert, jl_class);
+		ARR_APP1(ir_type*, initial_live_classes_simplert, jl_string);
+		if (zero_cost_exceptions) {
+			/* the runtime wraps exceptions of failed initializers */
+			ir_entity *initializer_error = find_method_entity(
+				"java/lang/ExceptionInInitializerError",
+				"<init>.(Ljava/lang/Throwable;)V");
+			assert(initializer_error);
+			ARR_APP1(ir_entity*, entry_points_simplert, initializer_error);
+
+			for (const char *const *name = gcji_implicit_exceptions;
+			     *name != NULL; ++name) {
+				ARR_APP1(ir_type*, initial_live_classes_simplert,
+				         class_registry_get(*name));
+			}
+		}
+		ARR_APP1(ir_entity*, entry_points_simplert, NULL);
+		ARR_APP1(ir_type*, initial_live_classes_simplert, NULL);
 
 		if (runtime_type == RUNTIME_GCJ) {
 			entry_points = entry_points_gcj;
@@ -3120,6 +3575,8 @@ int main(int argc, char **argv)
 		}
 		if (javamain)
 			rta_optimization(entry_points, initial_live_classes);
+		DEL_ARR_F(initial_live_classes_simplert);
+		DEL_ARR_F(entry_points_simplert);
 
 		deinit_rta_callbacks();
 
@@ -3134,6 +3591,8 @@ int main(int argc, char **argv)
 	 *  for the methods in non-external subclasses)
 	 */
 	class_walk_super2sub(remove_external_vtable, NULL, NULL);
+	gcji_create_static_roots();
+	gcji_create_implicit_exception_table();
 
 
 	if (verbose)
@@ -0,0 +1,79 @@
+import java.util.HashMap;
+
+/**
+ * Insert and lookup throughput of HashMap with Integer and String keys.
+ * "make simplert-map-bench" runs it against simplert's open addressing
+ * table and against libgcj's chained HashMap.
+ */
+public class MapBench {
+	static final int KEYS   = 1 << 20;
+	static final int ROUNDS = 5;
+
+	static long seed = 42;
+
+	static int next() {
+		seed = seed * 6364136223846793005L + 1442695040888963407L;
+		return (int)(seed >>> 32);
+	}
+
+	static void report(String name, long nanos) {
+		System.out.println(name + ": " + (nanos / ROUNDS / KEYS) + " ns per key");
+	}
+
+	public static void main(String[] args) {
+		Integer[] ints    = new Integer[KEYS];
+		String[]  strings = new String[KEYS];
+		for (int i = 0; i < KEYS; ++i) {
+			ints[i]    = new Integer(next());
+			strings[i] = "key" + next();
+		}
+
+		long insertInts    = 0;
+		long lookupInts    = 0;
+		long missInts      = 0;
+		long insertStrings = 0;
+		long lookupStrings = 0;
+		int  found         = 0;
+		for (int r = 0; r < ROUNDS; ++r) {
+			HashMap<Integer, Integer> intMap = new HashMap<Integer, Integer>();
+			long start = System.nanoTime();
+			for (int i = 0; i < KEYS; ++i)
+				intMap.put(ints[i], ints[i]);
+			insertInts += System.nanoTime() - start;
+
+			start = System.nanoTime();
+			for (int i = 0; i < KEYS; ++i) {
+				if (intMap.get(ints[i]) != null)
+					++found;
+			}
+			lookupInts += System.nanoTime() - start;
+
+			start = System.nanoTime();
+			for (int i = 0; i < KEYS; ++i) {
+				if (intMap.get(next()) != null)
+					++found;
+			}
+			missInts += System.nanoTime() - start;
+
+			HashMap<String, String> stringMap = new HashMap<String, String>();
+			start = System.nanoTime();
+			for (int i = 0; i < KEYS; ++i)
+				stringMap.put(strings[i], strings[i]);
+			insertStrings += System.nanoTime() - start;
+
+			start = System.nanoTime();
+			for (int i = 0; i < KEYS; ++i) {
+				if (stringMap.get(strings[i]) != null)
+					++found;
+			}
+			lookupStrings += System.nanoTime() - start;
+		}
+
+		report("insert Integer       ", insertInts);
+		report("lookup Integer       ", lookupInts);
+		report("lookup random Integer", missInts);
+		report("insert String        ", insertStrings);
+		report("lookup String        ", lookupStrings);
+		System.out.println("found " + found);
+	}
+}
@@ -0,0 +1,41 @@
+import java.io.BufferedReader;
+import java.io.FileInputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.InputStreamReader;
+
+/**
+ * Java side of the I/O benchmark, does what read_lines.c does with stdio.
+ * Run with "make simplert-io-bench".
+ */
+public class ReadLines {
+	public static void main(String[] args) throws IOException {
+		/* the mode and the file come last, "-" reads stdin */
+		String mode = args[args.length - 2];
+		String name = args[args.length - 1];
+		InputStream in = name.equals("-") ? System.in : new FileInputStream(name);
+
+		long lines = 0;
+		long chars = 0;
+		if (mode.equals("lines")) {
+			BufferedReader reader = new BufferedReader(new InputStreamReader(in));
+			String line;
+			while ((line = reader.readLine()) != null) {
+				++lines;
+				chars += line.length();
+			}
+		} else {
+			byte[] block = new byte[64 * 1024];
+			int n;
+			while ((n = in.read(block)) > 0) {
+				chars += n;
+				for (int i = 0; i < n; ++i) {
+					if (block[i] == '\n')
+						++lines;
+				}
+			}
+		}
+		in.close();
+		System.out.println(lines + " " + chars);
+	}
+}
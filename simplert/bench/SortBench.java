@@ -0,0 +1,174 @@
+import java.util.Arrays;
+
+/**
+ * Compares the native Arrays.sort with a dual-pivot quicksort written in
+ * Java, both on random data. Run with "make simplert-sort-bench".
+ */
+public class SortBench {
+	static final int LENGTH = 1000000;
+	static final int ROUNDS = 10;
+
+	/** Partitions shorter than this are insertion sorted. */
+	static final int INSERTION_SORT_THRESHOLD = 47;
+
+	static long seed = 42;
+
+	static int next() {
+		seed = seed * 6364136223846793005L + 1442695040888963407L;
+		return (int)(seed >>> 32);
+	}
+
+	static void dualPivotQuicksort(int[] a, int left, int right) {
+		if (right - left < INSERTION_SORT_THRESHOLD) {
+			for (int i = left + 1; i <= right; ++i) {
+				int value = a[i];
+				int j     = i - 1;
+				while (j >= left && a[j] > value) {
+					a[j + 1] = a[j];
+					--j;
+				}
+				a[j + 1] = value;
+			}
+			return;
+		}
+
+		if (a[left] > a[right]) {
+			int t = a[left]; a[left] = a[right]; a[right] = t;
+		}
+		int p = a[left];
+		int q = a[right];
+		int l = left + 1;
+		int g = right - 1;
+		for (int k = l; k <= g; ++k) {
+			int value = a[k];
+			if (value < p) {
+				a[k] = a[l]; a[l] = value;
+				++l;
+			} else if (value > q) {
+				while (a[g] > q && k < g)
+					--g;
+				a[k] = a[g]; a[g] = value;
+				--g;
+				value = a[k];
+				if (value < p) {
+					a[k] = a[l]; a[l] = value;
+					++l;
+				}
+			}
+		}
+		--l;
+		++g;
+		a[left] = a[l]; a[l] = p;
+		a[right] = a[g]; a[g] = q;
+
+		dualPivotQuicksort(a, left, l - 1);
+		if (p < q)
+			dualPivotQuicksort(a, l + 1, g - 1);
+		dualPivotQuicksort(a, g + 1, right);
+	}
+
+	/* there are no NaNs in the data, so < is the right order */
+	static void dualPivotQuicksort(double[] a, int left, int right) {
+		if (right - left < INSERTION_SORT_THRESHOLD) {
+			for (int i = left + 1; i <= right; ++i) {
+				double value = a[i];
+				int    j     = i - 1;
+				while (j >= left && a[j] > value) {
+					a[j + 1] = a[j];
+					--j;
+				}
+				a[j + 1] = value;
+			}
+			return;
+		}
+
+		if (a[left] > a[right]) {
+			double t = a[left]; a[left] = a[right]; a[right] = t;
+		}
+		double p = a[left];
+		double q = a[right];
+		int    l = left + 1;
+		int    g = right - 1;
+		for (int k = l; k <= g; ++k) {
+			double value = a[k];
+			if (value < p) {
+				a[k] = a[l]; a[l] = value;
+				++l;
+			} else if (value > q) {
+				while (a[g] > q && k < g)
+					--g;
+				a[k] = a[g]; a[g] = value;
+				--g;
+				value = a[k];
+				if (value < p) {
+					a[k] = a[l]; a[l] = value;
+					++l;
+				}
+			}
+		}
+		--l;
+		++g;
+		a[left] = a[l]; a[l] = p;
+		a[right] = a[g]; a[g] = q;
+
+		dualPivotQuicksort(a, left, l - 1);
+		if (p < q)
+			dualPivotQuicksort(a, l + 1, g - 1);
+		dualPivotQuicksort(a, g + 1, right);
+	}
+
+	static void report(String name, long nanos, boolean sorted) {
+		System.out.println(name + ": " + (nanos / ROUNDS / 1000) + " us per "
+		                   + LENGTH + " values" + (sorted ? "" : " NOT SORTED"));
+	}
+
+	public static void main(String[] args) {
+		int[]    ints    = new int[LENGTH];
+		int[]    work    = new int[LENGTH];
+		double[] doubles = new double[LENGTH];
+		double[] dwork   = new double[LENGTH];
+		for (int i = 0; i < LENGTH; ++i) {
+			ints[i]    = next();
+			doubles[i] = next() / 65536.0;
+		}
+
+		long    nativeInts = 0;
+		long    javaInts   = 0;
+		boolean intsSorted = true;
+		for (int r = 0; r < ROUNDS; ++r) {
+			System.arraycopy(ints, 0, work, 0, LENGTH);
+			long start = System.nanoTime();
+			Arrays.sort(work);
+			nativeInts += System.nanoTime() - start;
+
+			System.arraycopy(ints, 0, work, 0, LENGTH);
+			start = System.nanoTime();
+			dualPivotQuicksort(work, 0, LENGTH - 1);
+			javaInts += System.nanoTime() - start;
+			for (int i = 1; i < LENGTH; ++i)
+				intsSorted &= work[i - 1] <= work[i];
+		}
+
+		long    nativeDoubles = 0;
+		long    javaDoubles   = 0;
+		boolean doublesSorted = true;
+		for (int r = 0; r < ROUNDS; ++r) {
+			System.arraycopy(doubles, 0, dwork, 0, LENGTH);
+			long start = System.nanoTime();
+			Arrays.sort(dwork);
+			nativeDoubles += System.nanoTime() - start;
+
+			System.arraycopy(doubles, 0, dwork, 0, LENGTH);
+			start = System.nanoTime();
+			dualPivotQuicksort(dwork, 0, LENGTH - 1);
+			javaDoubles += System.nanoTime() - start;
+			for (int i = 1; i < LENGTH; ++i)
+				doublesSorted &= dwork[i - 1] <= dwork[i];
+		}
+
+		report("Arrays.sort(int[])         ", nativeInts, true);
+		report("dual-pivot quicksort int[] ", javaInts, intsSorted);
+		report("Arrays.sort(double[])      ", nativeDoubles, true);
+		report("dual-pivot quicksort double", javaDoubles, doublesSorted);
+	}
+}
@@ -0,0 +1,170 @@
+/*
+ * Compares Double.toString and parseDouble with the dtoa.c code simplert
+ * used before, which allocates bignums per conversion. Build and run with
+ * "make simplert-bench".
+ */
+#define _GNU_SOURCE
+#include "double_format.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dtoa/mprec.h"
+
+#define N_VALUES   (1 << 16)
+#define ITERATIONS 16
+
+static double values[N_VALUES];
+static char   strings[N_VALUES][DOUBLE_FORMAT_SIZE + 1];
+
+/** Keeps the compiler from dropping the conversions. */
+static volatile size_t sink;
+
+static uint64_t now_ns(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000u + (uint64_t)time.tv_nsec;
+}
+
+static uint64_t random_state = 88172645463325252u;
+
+static uint64_t next_random(void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+	return random_state;
+}
+
+/** The formatting of the old java_lang_double.c on top of _dtoa. */
+static size_t legacy_format(char *result, double value, int is_float)
+{
+	char buffer[50];
+	int  decpt;
+	int  sign;
+	_dtoa(value, 0, 20, &decpt, &sign, NULL, buffer, is_float);
+
+	value = fabs(value);
+	char *s = buffer;
+	char *d = result;
+	if (sign)
+		*d++ = '-';
+
+	if ((value >= 1e-3 && value < 1e7) || value == 0) {
+		if (decpt <= 0) {
+			*d++ = '0';
+		} else {
+			for (int i = 0; i < decpt; i++)
+				*d++ = *s ? *s++ : '0';
+		}
+		*d++ = '.';
+		if (*s == 0) {
+			*d++ = '0';
+			decpt++;
+		}
+		while (decpt++ < 0)
+			*d++ = '0';
+		while (*s)
+			*d++ = *s++;
+		return (size_t)(d - result);
+	}
+
+	*d++ = *s++;
+	decpt--;
+	*d++ = '.';
+	if (*s == 0)
+		*d++ = '0';
+	while (*s)
+		*d++ = *s++;
+	*d++ = 'E';
+	if (decpt < 0) {
+		*d++ = '-';
+		decpt = -decpt;
+	}
+	char  exp[4];
+	char *e = exp + sizeof(exp);
+	*--e = 0;
+	do {
+		*--e = (char)('0' + decpt % 10);
+		decpt /= 10;
+	} while (decpt > 0);
+	while (*e)
+		*d++ = *e++;
+	return (size_t)(d - result);
+}
+
+typedef enum benchmark_t {
+	B_LEGACY_DOUBLE,
+	B_RYU_DOUBLE,
+	B_LEGACY_FLOAT,
+	B_RYU_FLOAT,
+	B_STRTOD,
+	B_PARSE_DOUBLE,
+	B_LAST = B_PARSE_DOUBLE
+} benchmark_t;
+
+static const char *const benchmark_names[] = {
+	"dtoa toString(double)", "ryu toString(double)",
+	"dtoa toString(float)", "ryu toString(float)",
+	"strtod", "parseDouble"
+};
+
+static size_t run(benchmark_t benchmark, size_t i)
+{
+	char   buffer[64];
+	double parsed;
+	switch (benchmark) {
+	case B_LEGACY_DOUBLE: return legacy_format(buffer, values[i], 0);
+	case B_RYU_DOUBLE:    return format_double(buffer, values[i]);
+	case B_LEGACY_FLOAT:  return legacy_format(buffer, (float)values[i], 1);
+	case B_RYU_FLOAT:     return format_float(buffer, (float)values[i]);
+	case B_STRTOD:        return (size_t)strtod(strings[i], NULL);
+	case B_PARSE_DOUBLE:
+		parse_double(strings[i], strlen(strings[i]), &parsed);
+		return (size_t)parsed;
+	}
+	abort();
+}
+
+static void measure(const char *kind)
+{
+	for (size_t i = 0; i < N_VALUES; ++i) {
+		size_t len = format_double(strings[i], values[i]);
+		strings[i][len] = '\0';
+	}
+	printf("%s\n", kind);
+	for (benchmark_t benchmark = 0; benchmark <= B_LAST; ++benchmark) {
+		uint64_t start = now_ns();
+		for (int iteration = 0; iteration < ITERATIONS; ++iteration) {
+			for (size_t i = 0; i < N_VALUES; ++i)
+				sink = run(benchmark, i);
+		}
+		uint64_t time = now_ns() - start;
+		printf("  %-24s %8.1f ns\n", benchmark_names[benchmark],
+		       (double)time / (ITERATIONS * N_VALUES));
+	}
+}
+
+int main(void)
+{
+	/* random bit patterns give 17 digit values over the whole range */
+	for (size_t i = 0; i < N_VALUES; ++i) {
+		uint64_t bits;
+		do {
+			bits = next_random();
+			memcpy(&values[i], &bits, sizeof(bits));
+		} while (!isfinite(values[i]));
+	}
+	measure("random doubles");
+
+	/* short values like prices and measurements */
+	for (size_t i = 0; i < N_VALUES; ++i)
+		values[i] = (double)(next_random() % 1000000) / 100;
+	measure("two decimals");
+	return 0;
+}
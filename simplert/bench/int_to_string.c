@@ -0,0 +1,154 @@
+/*
+ * Compares Long.toString and parseLong with the digit at a time loops of
+ * the Classpath Java code simplert ran before. Build and run with
+ * "make simplert-bench".
+ */
+#define _GNU_SOURCE
+#include "int_format.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define N_VALUES   (1 << 16)
+#define ITERATIONS 64
+
+static int64_t values[N_VALUES];
+static char    strings[N_VALUES][LONG_FORMAT_SIZE + 1];
+static size_t  lengths[N_VALUES];
+
+/** Keeps the compiler from dropping the conversions. */
+static volatile size_t sink;
+
+static uint64_t now_ns(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000u + (uint64_t)time.tv_nsec;
+}
+
+static uint64_t random_state = 88172645463325252u;
+
+static uint64_t next_random(void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+	return random_state;
+}
+
+/** Long.toString(long, int) of Classpath with radix 10. */
+static size_t legacy_format(char *result, int64_t num)
+{
+	char   buffer[LONG_FORMAT_SIZE];
+	size_t i      = sizeof(buffer);
+	bool   is_neg = num < 0;
+	if (is_neg) {
+		num = -num;
+		if (num < 0) {
+			buffer[--i] = (char)('0' + -(num + 10) % 10);
+			num         = -(num / 10);
+		}
+	}
+	do {
+		buffer[--i] = (char)('0' + num % 10);
+		num        /= 10;
+	} while (num > 0);
+	if (is_neg)
+		buffer[--i] = '-';
+	memcpy(result, buffer + i, sizeof(buffer) - i);
+	return sizeof(buffer) - i;
+}
+
+/** Long.parseLong(String, int, boolean) of Classpath with radix 10. */
+static int64_t legacy_parse(const char *str, size_t len)
+{
+	size_t index  = 0;
+	bool   is_neg = false;
+	if (str[0] == '-') {
+		is_neg = true;
+		++index;
+	} else if (str[0] == '+') {
+		++index;
+	}
+	int64_t max = INT64_MAX / 10;
+	if (is_neg && INT64_MAX % 10 == 9)
+		++max;
+	int64_t val = 0;
+	while (index < len) {
+		if (val < 0 || val > max)
+			abort();
+		int ch = str[index++] - '0';
+		val = (int64_t)((uint64_t)val * 10 + (uint64_t)ch);
+		if (ch < 0 || ch > 9 || (val < 0 && (!is_neg || val != INT64_MIN)))
+			abort();
+	}
+	return is_neg ? -val : val;
+}
+
+typedef enum benchmark_t {
+	B_LEGACY_FORMAT,
+	B_FORMAT,
+	B_LEGACY_PARSE,
+	B_STRTOLL,
+	B_PARSE,
+	B_LAST = B_PARSE
+} benchmark_t;
+
+static const char *const benchmark_names[] = {
+	"loop toString(long)", "pairs toString(long)",
+	"loop parseLong", "strtoll", "swar parseLong"
+};
+
+static size_t run(benchmark_t benchmark, size_t i)
+{
+	char    buffer[LONG_FORMAT_SIZE];
+	int64_t parsed;
+	switch (benchmark) {
+	case B_LEGACY_FORMAT: return legacy_format(buffer, values[i]);
+	case B_FORMAT:        return format_long(buffer, values[i]);
+	case B_LEGACY_PARSE:  return (size_t)legacy_parse(strings[i], lengths[i]);
+	case B_STRTOLL:       return (size_t)strtoll(strings[i], NULL, 10);
+	case B_PARSE:
+		parse_long(strings[i], lengths[i], 10, INT64_MIN, INT64_MAX, &parsed);
+		return (size_t)parsed;
+	}
+	abort();
+}
+
+static void measure(const char *kind)
+{
+	for (size_t i = 0; i < N_VALUES; ++i) {
+		lengths[i] = format_long(strings[i], values[i]);
+		strings[i][lengths[i]] = '\0';
+	}
+	printf("%s\n", kind);
+	for (benchmark_t benchmark = 0; benchmark <= B_LAST; ++benchmark) {
+		uint64_t start = now_ns();
+		for (int iteration = 0; iteration < ITERATIONS; ++iteration) {
+			for (size_t i = 0; i < N_VALUES; ++i)
+				sink = run(benchmark, i);
+		}
+		uint64_t time = now_ns() - start;
+		printf("  %-24s %8.1f ns\n", benchmark_names[benchmark],
+		       (double)time / (ITERATIONS * N_VALUES));
+	}
+}
+
+int main(void)
+{
+	for (size_t i = 0; i < N_VALUES; ++i)
+		values[i] = (int64_t)next_random();
+	measure("random longs");
+
+	/* counters, sizes and timestamps in log lines */
+	for (size_t i = 0; i < N_VALUES; ++i)
+		values[i] = (int64_t)(next_random() % 100000);
+	measure("up to 5 digits");
+	for (size_t i = 0; i < N_VALUES; ++i)
+		values[i] = 1700000000000 + (int64_t)(next_random() % 100000000000);
+	measure("millisecond timestamps");
+	return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * C side of the I/O benchmark, reads a file with stdio like ReadLines.java
+ * does with simplert. Usage: read_lines_bench lines|bytes FILE, where FILE
+ * "-" reads stdin. Only ASCII input gives the same char counts.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char **argv)
+{
+	if (argc != 3) {
+		fprintf(stderr, "usage: %s lines|bytes FILE\n", argv[0]);
+		return 1;
+	}
+	const char *mode = argv[1];
+	const char *name = argv[2];
+	FILE *in = strcmp(name, "-") == 0 ? stdin : fopen(name, "r");
+	if (in == NULL) {
+		perror(name);
+		return 1;
+	}
+
+	long long lines = 0;
+	long long chars = 0;
+	if (strcmp(mode, "lines") == 0) {
+		char   *line     = NULL;
+		size_t  capacity = 0;
+		ssize_t len;
+		while ((len = getline(&line, &capacity, in)) >= 0) {
+			if (len > 0 && line[len - 1] == '\n')
+				--len;
+			if (len > 0 && line[len - 1] == '\r')
+				--len;
+			++lines;
+			chars += len;
+		}
+		free(line);
+	} else {
+		static char block[64 * 1024];
+		size_t n;
+		while ((n = fread(block, 1, sizeof(block), in)) > 0) {
+			chars += (long long)n;
+			for (size_t i = 0; i < n; ++i) {
+				if (block[i] == '\n')
+					++lines;
+			}
+		}
+	}
+	fclose(in);
+	printf("%lld %lld\n", lines, chars);
+	return 0;
+}
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Compares simplert file and stdin reading with C stdio.
+# Usage: read_lines.sh C_BENCH JAVA_BENCH [FILE]
+set -e
+c_bench="$1"
+java_bench="$2"
+file="${3:-${TMPDIR:-/tmp}/read_lines_bench.txt}"
+
+if [ ! -f "$file" ]; then
+	echo "generating $file"
+	awk 'BEGIN { for (i = 0; i < 4000000; ++i) printf "line %d of the read benchmark\n", i }' > "$file"
+fi
+
+run() {
+	name="$1"
+	shift
+	start=$(date +%s%N)
+	result=$("$@")
+	end=$(date +%s%N)
+	printf "%-24s %8d ms   %s\n" "$name" $(((end - start) / 1000000)) "$result"
+}
+
+for mode in lines bytes; do
+	run "stdio $mode" "$c_bench" $mode "$file"
+	run "simplert $mode" "$java_bench" $mode "$file"
+	run "stdio $mode (stdin)" sh -c "\"$c_bench\" $mode - < \"$file\""
+	run "simplert $mode (stdin)" sh -c "\"$java_bench\" $mode - < \"$file\""
+done
@@ -0,0 +1,241 @@
+/*
+ * Compares the sort kernels of Arrays.sort with the dual-pivot quicksort of
+ * SortBench.java and with qsort, on several input patterns and lengths.
+ * Build with "make simplert-bench", the runtime itself is not needed.
+ */
+#define _GNU_SOURCE
+#include "sort_kernels.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** Every measurement sorts about this many values in total. */
+#define TOTAL_VALUES  (4 * 1024 * 1024)
+#define MAX_LENGTH    (1024 * 1024)
+/**
+ * The baseline uses the first and last value as pivots, which is quadratic
+ * (and recurses once per value) on presorted patterns longer than this.
+ */
+#define BASELINE_PRESORTED_LENGTH 20000
+/** Partitions shorter than this are insertion sorted, as in SortBench. */
+#define INSERTION_SORT_THRESHOLD 47
+
+static jint    input[MAX_LENGTH];
+static jint    work[MAX_LENGTH];
+static jdouble dinput[MAX_LENGTH];
+static jdouble dwork[MAX_LENGTH];
+
+static uint64_t seed = 42;
+
+static jint next(void)
+{
+	seed = seed * 6364136223846793005u + 1442695040888963407u;
+	return (jint)(seed >> 32);
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000u + (uint64_t)time.tv_nsec;
+}
+
+/* the baseline of SortBench.java, translated literally */
+#define DEFINE_DUAL_PIVOT(T)                                                   \
+static void dual_pivot_##T(T *a, long left, long right)                       \
+{                                                                              \
+	if (right - left < INSERTION_SORT_THRESHOLD) {                             \
+		for (long i = left + 1; i <= right; ++i) {                             \
+			T    value = a[i];                                                 \
+			long j     = i - 1;                                                \
+			while (j >= left && a[j] > value) {                                \
+				a[j + 1] = a[j];                                               \
+				--j;                                                           \
+			}                                                                  \
+			a[j + 1] = value;                                                  \
+		}                                                                      \
+		return;                                                                \
+	}                                                                          \
+                                                                               \
+	if (a[left] > a[right]) {                                                  \
+		T t = a[left]; a[left] = a[right]; a[right] = t;                       \
+	}                                                                          \
+	T    p = a[left];                                                          \
+	T    q = a[right];                                                         \
+	long l = left + 1;                                                         \
+	long g = right - 1;                                                        \
+	for (long k = l; k <= g; ++k) {                                            \
+		T value = a[k];                                                        \
+		if (value < p) {                                                       \
+			a[k] = a[l]; a[l] = value;                                         \
+			++l;                                                               \
+		} else if (value > q) {                                                \
+			while (a[g] > q && k < g)                                          \
+				--g;                                                           \
+			a[k] = a[g]; a[g] = value;                                         \
+			--g;                                                               \
+			value = a[k];                                                      \
+			if (value < p) {                                                   \
+				a[k] = a[l]; a[l] = value;                                     \
+				++l;                                                           \
+			}                                                                  \
+		}                                                                      \
+	}                                                                          \
+	--l;                                                                       \
+	++g;                                                                       \
+	a[left] = a[l]; a[l] = p;                                                  \
+	a[right] = a[g]; a[g] = q;                                                 \
+                                                                               \
+	dual_pivot_##T(a, left, l - 1);                                            \
+	if (p < q)                                                                 \
+		dual_pivot_##T(a, l + 1, g - 1);                                       \
+	dual_pivot_##T(a, g + 1, right);                                           \
+}
+
+DEFINE_DUAL_PIVOT(jint)
+DEFINE_DUAL_PIVOT(jdouble)
+
+static int compare_ints(const void *p1, const void *p2)
+{
+	jint i1 = *(const jint*)p1;
+	jint i2 = *(const jint*)p2;
+	return (i1 > i2) - (i1 < i2);
+}
+
+static int compare_doubles(const void *p1, const void *p2)
+{
+	jdouble d1 = *(const jdouble*)p1;
+	jdouble d2 = *(const jdouble*)p2;
+	return (d1 > d2) - (d1 < d2);
+}
+
+typedef enum pattern_t {
+	P_RANDOM,
+	P_SORTED,
+	P_REVERSED,
+	P_FEW_UNIQUE,
+	P_ORGAN_PIPE,
+	P_SAWTOOTH,
+	P_LAST = P_SAWTOOTH
+} pattern_t;
+
+static const char *const pattern_names[] = {
+	"random", "sorted", "reversed", "few unique", "organ pipe", "sawtooth"
+};
+
+static void fill(pattern_t pattern, size_t n)
+{
+	for (size_t i = 0; i < n; ++i) {
+		jint value = 0;
+		switch (pattern) {
+		case P_RANDOM:     value = next();                             break;
+		case P_SORTED:     value = (jint)i;                            break;
+		case P_REVERSED:   value = (jint)(n - i);                      break;
+		case P_FEW_UNIQUE: value = next() & 15;                        break;
+		case P_ORGAN_PIPE: value = (jint)(i < n / 2 ? i : n - i);      break;
+		case P_SAWTOOTH:   value = (jint)(i % 1000);                   break;
+		}
+		input[i]  = value;
+		/* distinct doubles for the random pattern, like SortBench */
+		dinput[i] = pattern == P_RANDOM ? value / 65536.0 : value;
+	}
+}
+
+typedef enum sorter_t {
+	S_KERNEL,
+	S_DUAL_PIVOT,
+	S_QSORT,
+	S_LAST = S_QSORT
+} sorter_t;
+
+static const char *const sorter_names[] = {
+	"kernel", "dual-pivot", "qsort"
+};
+
+static void sort(sorter_t sorter, bool doubles, size_t n)
+{
+	switch (sorter) {
+	case S_KERNEL:
+		if (doubles)
+			sort_doubles(dwork, n);
+		else
+			sort_ints(work, n);
+		return;
+	case S_DUAL_PIVOT:
+		if (doubles)
+			dual_pivot_jdouble(dwork, 0, (long)n - 1);
+		else
+			dual_pivot_jint(work, 0, (long)n - 1);
+		return;
+	case S_QSORT:
+		if (doubles)
+			qsort(dwork, n, sizeof(dwork[0]), compare_doubles);
+		else
+			qsort(work, n, sizeof(work[0]), compare_ints);
+		return;
+	}
+	abort();
+}
+
+static bool skip(sorter_t sorter, pattern_t pattern, size_t n)
+{
+	return sorter == S_DUAL_PIVOT && n > BASELINE_PRESORTED_LENGTH
+	    && pattern != P_RANDOM && pattern != P_FEW_UNIQUE;
+}
+
+static bool is_sorted(bool doubles, size_t n)
+{
+	for (size_t i = 1; i < n; ++i) {
+		if (doubles ? dwork[i - 1] > dwork[i] : work[i - 1] > work[i])
+			return false;
+	}
+	return true;
+}
+
+int main(void)
+{
+	static const size_t lengths[] = {
+		16, 100, 1000, BASELINE_PRESORTED_LENGTH, MAX_LENGTH
+	};
+
+	printf("%-6s %-10s %7s", "type", "pattern", "length");
+	for (sorter_t sorter = 0; sorter <= S_LAST; ++sorter)
+		printf(" %10s", sorter_names[sorter]);
+	printf("   (ns per value)\n");
+
+	for (int doubles = 0; doubles <= 1; ++doubles) {
+		for (pattern_t pattern = 0; pattern <= P_LAST; ++pattern) {
+			for (size_t l = 0; l < sizeof(lengths)/sizeof(lengths[0]); ++l) {
+				size_t n      = lengths[l];
+				size_t rounds = TOTAL_VALUES / n;
+				fill(pattern, n);
+				printf("%-6s %-10s %7zu", doubles ? "double" : "int",
+				       pattern_names[pattern], n);
+				for (sorter_t sorter = 0; sorter <= S_LAST; ++sorter) {
+					if (skip(sorter, pattern, n)) {
+						printf(" %10s", "-");
+						continue;
+					}
+					uint64_t time   = 0;
+					bool     sorted = true;
+					for (size_t r = 0; r < rounds; ++r) {
+						memcpy(work, input, n * sizeof(work[0]));
+						memcpy(dwork, dinput, n * sizeof(dwork[0]));
+						uint64_t start = now_ns();
+						sort(sorter, doubles, n);
+						time += now_ns() - start;
+						sorted &= is_sorted(doubles, n);
+					}
+					printf(" %10.2f%s", (double)time / rounds / n,
+					       sorted ? "" : " NOT SORTED");
+				}
+				printf("\n");
+				fflush(stdout);
+			}
+		}
+	}
+	return 0;
+}
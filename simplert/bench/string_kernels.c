@@ -0,0 +1,100 @@
+/*
+ * Compares the string kernel sets supported by this CPU. Build with
+ * "make simplert-bench", the runtime itself is not needed.
+ */
+#define _GNU_SOURCE
+#include "string_kernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_LENGTH  4096
+#define TOTAL_CHARS (64 * 1024 * 1024)
+
+static uint8_t bytes_a[MAX_LENGTH];
+static uint8_t bytes_b[MAX_LENGTH];
+static jchar   chars_a[MAX_LENGTH];
+static jchar   chars_b[MAX_LENGTH];
+
+/** Keeps the compiler from dropping the kernel calls. */
+static volatile size_t sink;
+
+static uint64_t now_ns(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000u + (uint64_t)time.tv_nsec;
+}
+
+typedef enum kernel_t {
+	K_MISMATCH_LATIN1,
+	K_MISMATCH_UTF16,
+	K_FIND_LATIN1,
+	K_FIND_UTF16,
+	K_IS_ASCII,
+	K_IS_LATIN1,
+	K_WIDEN,
+	K_NARROW,
+	K_HASH_LATIN1,
+	K_HASH_UTF16,
+	K_LAST = K_HASH_UTF16
+} kernel_t;
+
+static const char *const kernel_names[] = {
+	"mismatch_latin1", "mismatch_utf16", "find_latin1", "find_utf16",
+	"is_ascii", "is_latin1", "widen", "narrow", "hash_latin1", "hash_utf16"
+};
+
+static size_t run(const string_kernels_t *k, kernel_t kernel, size_t n)
+{
+	switch (kernel) {
+	case K_MISMATCH_LATIN1: return k->mismatch_latin1(bytes_a, bytes_b, n);
+	case K_MISMATCH_UTF16:  return k->mismatch_utf16(chars_a, chars_b, n);
+	case K_FIND_LATIN1:     return k->find_latin1(bytes_a, n, '!');
+	case K_FIND_UTF16:      return k->find_utf16(chars_a, n, '!');
+	case K_IS_ASCII:        return k->is_ascii(bytes_a, n);
+	case K_IS_LATIN1:       return k->is_latin1(chars_a, n);
+	case K_WIDEN:           k->widen(chars_b, bytes_a, n); return chars_b[0];
+	case K_NARROW:          k->narrow(bytes_b, chars_a, n); return bytes_b[0];
+	case K_HASH_LATIN1:     return (size_t)k->hash_latin1(0, bytes_a, n);
+	case K_HASH_UTF16:      return (size_t)k->hash_utf16(0, chars_a, n);
+	}
+	abort();
+}
+
+int main(void)
+{
+	/* equal ASCII contents without the searched char, the worst case */
+	for (size_t i = 0; i < MAX_LENGTH; ++i) {
+		bytes_a[i] = bytes_b[i] = (uint8_t)('a' + i % 26);
+		chars_a[i] = chars_b[i] = bytes_a[i];
+	}
+
+	static const size_t lengths[] = { 8, 32, 128, 1024, MAX_LENGTH };
+	const string_kernels_t *const *available = string_kernels_available();
+
+	printf("%-16s %6s", "kernel", "length");
+	for (size_t k = 0; available[k] != NULL; ++k)
+		printf(" %10s", available[k]->name);
+	printf("   (ns per call)\n");
+
+	for (kernel_t kernel = 0; kernel <= K_LAST; ++kernel) {
+		for (size_t l = 0; l < sizeof(lengths)/sizeof(lengths[0]); ++l) {
+			size_t n          = lengths[l];
+			size_t iterations = TOTAL_CHARS / n;
+			printf("%-16s %6zu", kernel_names[kernel], n);
+			for (size_t k = 0; available[k] != NULL; ++k) {
+				const string_kernels_t *kernels = available[k];
+				uint64_t start = now_ns();
+				for (size_t i = 0; i < iterations; ++i)
+					sink = run(kernels, kernel, n);
+				uint64_t time = now_ns() - start;
+				printf(" %10.1f", (double)time / iterations);
+			}
+			printf("\n");
+		}
+	}
+	return 0;
+}
@@ -31,15 +31,9 @@ void dump_rtti(const java_lang_Class *cls)
 	}
 }
 
-static const jchar *get_string_begin(const java_lang_String *string)
-{
-	return (const jchar*)((const char*)string->data + string->boffset);
-}
-
 void print_string(const java_lang_String *string)
 {
-	const jchar *chars = get_string_begin(string);
 	for (jint i = 0; i < string->count; ++i) {
-		putchar((char)chars[i]);
+		putchar((char)string_char_at(string, i));
 	}
 }
@@ -0,0 +1,702 @@
+/*
+ * Double and float conversions of java.lang.Double and Float. Formatting is
+ * Ryu by Ulf Adams (https://github.com/ulfjack/ryu), it needs no bignums
+ * and no heap. Parsing takes the exact fast path of Clinger for short
+ * inputs and strtod for the others.
+ */
+#include "double_format.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ryu_tables.h"
+
+/** ceil(log2(5^e)), 1 for e = 0, for 0 <= e <= 3528 */
+static int32_t pow5bits(int32_t e)
+{
+	return (int32_t)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+/** floor(log10(2^e)) for 0 <= e <= 1650 */
+static uint32_t log10_pow2(int32_t e)
+{
+	return ((uint32_t)e * 78913) >> 18;
+}
+
+/** floor(log10(5^e)) for 0 <= e <= 2620 */
+static uint32_t log10_pow5(int32_t e)
+{
+	return ((uint32_t)e * 732923) >> 20;
+}
+
+static uint32_t pow5_factor(uint64_t value)
+{
+	uint32_t count = 0;
+	while (value % 5 == 0) {
+		value /= 5;
+		++count;
+	}
+	return count;
+}
+
+static bool multiple_of_pow5(uint64_t value, uint32_t p)
+{
+	return pow5_factor(value) >= p;
+}
+
+static bool multiple_of_pow2(uint64_t value, uint32_t p)
+{
+	return (value & ((UINT64_C(1) << p) - 1)) == 0;
+}
+
+static uint64_t mul_shift64(uint64_t m, const uint64_t *mul, int32_t j)
+{
+	unsigned __int128 b0 = (unsigned __int128)m * mul[0];
+	unsigned __int128 b2 = (unsigned __int128)m * mul[1];
+	return (uint64_t)(((b0 >> 64) + b2) >> (j - 64));
+}
+
+static uint32_t mul_shift32(uint32_t m, uint64_t factor, int32_t shift)
+{
+	uint64_t bits0 = (uint64_t)m * (uint32_t)factor;
+	uint64_t bits1 = (uint64_t)m * (uint32_t)(factor >> 32);
+	uint64_t sum   = (bits0 >> 32) + bits1;
+	return (uint32_t)(sum >> (shift - 32));
+}
+
+/** A decimal output * 10^exponent. */
+typedef struct decimal_t {
+	uint64_t output;
+	int32_t  exponent;
+} decimal_t;
+
+/*
+ * Java wants at least two digits where the shortest decimal has one
+ * (Double.MIN_VALUE is 4.9E-324, not 5.0E-324), so the digit removal loops
+ * stop at two digits. Keeping a removable digit keeps the result in the
+ * rounding interval.
+ */
+#define MIN_DIGITS_BOUND 10
+
+static decimal_t d2d(uint64_t ieee_mantissa, uint32_t ieee_exponent)
+{
+	int32_t  e2;
+	uint64_t m2;
+	if (ieee_exponent == 0) {
+		e2 = 1 - 1023 - 52 - 2;
+		m2 = ieee_mantissa;
+	} else {
+		e2 = (int32_t)ieee_exponent - 1023 - 52 - 2;
+		m2 = (UINT64_C(1) << 52) | ieee_mantissa;
+	}
+	bool accept_bounds = (m2 & 1) == 0;
+
+	/* the interval of decimals rounding to the value is (mm, mp) * 2^e2 */
+	uint64_t mv       = 4 * m2;
+	uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+	uint64_t mp       = mv + 2;
+	uint64_t mm       = mv - 1 - mm_shift;
+
+	uint64_t vr;
+	uint64_t vp;
+	uint64_t vm;
+	int32_t  e10;
+	bool     vm_trailing_zeros = false;
+	bool     vr_trailing_zeros = false;
+	if (e2 >= 0) {
+		uint32_t q = log10_pow2(e2) - (e2 > 3);
+		int32_t  k = DOUBLE_POW5_INV_BITCOUNT + pow5bits((int32_t)q) - 1;
+		int32_t  i = -e2 + (int32_t)q + k;
+		e10 = (int32_t)q;
+		vr  = mul_shift64(mv, DOUBLE_POW5_INV_SPLIT[q], i);
+		vp  = mul_shift64(mp, DOUBLE_POW5_INV_SPLIT[q], i);
+		vm  = mul_shift64(mm, DOUBLE_POW5_INV_SPLIT[q], i);
+		if (q <= 21) {
+			/* only one of mp, mv and mm can be a multiple of 5 */
+			if (mv % 5 == 0) {
+				vr_trailing_zeros = multiple_of_pow5(mv, q);
+			} else if (accept_bounds) {
+				vm_trailing_zeros = multiple_of_pow5(mm, q);
+			} else {
+				vp -= multiple_of_pow5(mp, q);
+			}
+		}
+	} else {
+		uint32_t q = log10_pow5(-e2) - (-e2 > 1);
+		int32_t  i = -e2 - (int32_t)q;
+		int32_t  k = pow5bits(i) - DOUBLE_POW5_BITCOUNT;
+		int32_t  j = (int32_t)q - k;
+		e10 = (int32_t)q + e2;
+		vr  = mul_shift64(mv, DOUBLE_POW5_SPLIT[i], j);
+		vp  = mul_shift64(mp, DOUBLE_POW5_SPLIT[i], j);
+		vm  = mul_shift64(mm, DOUBLE_POW5_SPLIT[i], j);
+		if (q <= 1) {
+			/* mv has at least q trailing zero bits */
+			vr_trailing_zeros = true;
+			if (accept_bounds) {
+				vm_trailing_zeros = mm_shift == 1;
+			} else {
+				--vp;
+			}
+		} else if (q < 63) {
+			vr_trailing_zeros = multiple_of_pow2(mv, q);
+		}
+	}
+
+	/* remove digits while the interval still contains a shorter decimal */
+	int32_t  removed   = 0;
+	uint32_t last_digit = 0;
+	uint64_t output;
+	if (vm_trailing_zeros || vr_trailing_zeros) {
+		/* rare general case, the bounds or the value may be exact */
+		while (vp / 10 > vm / 10 && vr / 10 >= MIN_DIGITS_BOUND) {
+			vm_trailing_zeros &= vm % 10 == 0;
+			vr_trailing_zeros &= last_digit == 0;
+			last_digit = (uint32_t)(vr % 10);
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		if (vm_trailing_zeros) {
+			while (vm % 10 == 0 && vr / 10 >= MIN_DIGITS_BOUND) {
+				vr_trailing_zeros &= last_digit == 0;
+				last_digit = (uint32_t)(vr % 10);
+				vr /= 10;
+				vp /= 10;
+				vm /= 10;
+				++removed;
+			}
+		}
+		/* round half to even */
+		if (vr_trailing_zeros && last_digit == 5 && vr % 2 == 0)
+			last_digit = 4;
+		output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros))
+		               || last_digit >= 5);
+	} else {
+		bool round_up = false;
+		if (vp / 100 > vm / 100 && vr / 100 >= MIN_DIGITS_BOUND) {
+			round_up = vr % 100 >= 50;
+			vr /= 100;
+			vp /= 100;
+			vm /= 100;
+			removed += 2;
+		}
+		while (vp / 10 > vm / 10 && vr / 10 >= MIN_DIGITS_BOUND) {
+			round_up = vr % 10 >= 5;
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		output = vr + (vr == vm || round_up);
+	}
+	decimal_t result = { output, e10 + removed };
+	return result;
+}
+
+static decimal_t f2d(uint32_t ieee_mantissa, uint32_t ieee_exponent)
+{
+	int32_t  e2;
+	uint32_t m2;
+	if (ieee_exponent == 0) {
+		e2 = 1 - 127 - 23 - 2;
+		m2 = ieee_mantissa;
+	} else {
+		e2 = (int32_t)ieee_exponent - 127 - 23 - 2;
+		m2 = (UINT32_C(1) << 23) | ieee_mantissa;
+	}
+	bool accept_bounds = (m2 & 1) == 0;
+
+	uint32_t mv       = 4 * m2;
+	uint32_t mp       = mv + 2;
+	uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+	uint32_t mm       = mv - 1 - mm_shift;
+
+	uint32_t vr;
+	uint32_t vp;
+	uint32_t vm;
+	int32_t  e10;
+	bool     vm_trailing_zeros = false;
+	bool     vr_trailing_zeros = false;
+	uint32_t last_digit        = 0;
+	if (e2 >= 0) {
+		uint32_t q = log10_pow2(e2);
+		int32_t  k = FLOAT_POW5_INV_BITCOUNT + pow5bits((int32_t)q) - 1;
+		int32_t  i = -e2 + (int32_t)q + k;
+		e10 = (int32_t)q;
+		vr  = mul_shift32(mv, FLOAT_POW5_INV_SPLIT[q], i);
+		vp  = mul_shift32(mp, FLOAT_POW5_INV_SPLIT[q], i);
+		vm  = mul_shift32(mm, FLOAT_POW5_INV_SPLIT[q], i);
+		if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+			/* the loop below may not remove a digit, compute the one
+			 * below vr for rounding */
+			int32_t l = FLOAT_POW5_INV_BITCOUNT + pow5bits((int32_t)q - 1) - 1;
+			last_digit = mul_shift32(mv, FLOAT_POW5_INV_SPLIT[q - 1],
+			                         -e2 + (int32_t)q - 1 + l) % 10;
+		}
+		if (q <= 9) {
+			if (mv % 5 == 0) {
+				vr_trailing_zeros = multiple_of_pow5(mv, q);
+			} else if (accept_bounds) {
+				vm_trailing_zeros = multiple_of_pow5(mm, q);
+			} else {
+				vp -= multiple_of_pow5(mp, q);
+			}
+		}
+	} else {
+		uint32_t q = log10_pow5(-e2);
+		int32_t  i = -e2 - (int32_t)q;
+		int32_t  k = pow5bits(i) - FLOAT_POW5_BITCOUNT;
+		int32_t  j = (int32_t)q - k;
+		e10 = (int32_t)q + e2;
+		vr  = mul_shift32(mv, FLOAT_POW5_SPLIT[i], j);
+		vp  = mul_shift32(mp, FLOAT_POW5_SPLIT[i], j);
+		vm  = mul_shift32(mm, FLOAT_POW5_SPLIT[i], j);
+		if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+			j = (int32_t)q - 1 - (pow5bits(i + 1) - FLOAT_POW5_BITCOUNT);
+			last_digit = mul_shift32(mv, FLOAT_POW5_SPLIT[i + 1], j) % 10;
+		}
+		if (q <= 1) {
+			vr_trailing_zeros = true;
+			if (accept_bounds) {
+				vm_trailing_zeros = mm_shift == 1;
+			} else {
+				--vp;
+			}
+		} else if (q < 31) {
+			vr_trailing_zeros = multiple_of_pow2(mv, q - 1);
+		}
+	}
+
+	int32_t removed = 0;
+	while (vp / 10 > vm / 10 && vr / 10 >= MIN_DIGITS_BOUND) {
+		vm_trailing_zeros &= vm % 10 == 0;
+		vr_trailing_zeros &= last_digit == 0;
+		last_digit = vr % 10;
+		vr /= 10;
+		vp /= 10;
+		vm /= 10;
+		++removed;
+	}
+	if (vm_trailing_zeros) {
+		while (vm % 10 == 0 && vr / 10 >= MIN_DIGITS_BOUND) {
+			vr_trailing_zeros &= last_digit == 0;
+			last_digit = vr % 10;
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+	}
+	if (vr_trailing_zeros && last_digit == 5 && vr % 2 == 0)
+		last_digit = 4;
+	uint32_t output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros))
+	                        || last_digit >= 5);
+	decimal_t result = { output, e10 + removed };
+	return result;
+}
+
+/** Writes the decimal digits of @p value ending before @p end. */
+static void write_digits(char *end, uint64_t value)
+{
+	do {
+		*--end = (char)('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
+}
+
+static size_t count_digits(uint64_t value)
+{
+	size_t n = 1;
+	while (value >= 10) {
+		value /= 10;
+		++n;
+	}
+	return n;
+}
+
+static size_t format_special(char *buffer, double value)
+{
+	const char *chars;
+	if (isnan(value)) {
+		chars = "NaN";
+	} else if (isinf(value)) {
+		chars = signbit(value) ? "-Infinity" : "Infinity";
+	} else {
+		chars = signbit(value) ? "-0.0" : "0.0";
+	}
+	size_t len = strlen(chars);
+	memcpy(buffer, chars, len);
+	return len;
+}
+
+/**
+ * Lays out @p decimal like Double.toString, plain for magnitudes in
+ * [10^-3, 10^7) and in computerized scientific notation otherwise.
+ */
+static size_t format_decimal(char *buffer, decimal_t decimal, bool negative,
+                             bool plain)
+{
+	/* the two digit rule may have rounded up to a trailing zero */
+	while (decimal.output >= 10 && decimal.output % 10 == 0) {
+		decimal.output /= 10;
+		++decimal.exponent;
+	}
+	char   digits[20];
+	size_t n = count_digits(decimal.output);
+	write_digits(digits + n, decimal.output);
+	int32_t sci_exponent = decimal.exponent + (int32_t)n - 1;
+
+	char *p = buffer;
+	if (negative)
+		*p++ = '-';
+	if (plain) {
+		if (sci_exponent < 0) {
+			*p++ = '0';
+			*p++ = '.';
+			for (int32_t i = -1; i > sci_exponent; --i)
+				*p++ = '0';
+			memcpy(p, digits, n);
+			p += n;
+		} else {
+			size_t int_digits = (size_t)sci_exponent + 1;
+			for (size_t i = 0; i < int_digits; ++i)
+				*p++ = i < n ? digits[i] : '0';
+			*p++ = '.';
+			if (n > int_digits) {
+				memcpy(p, digits + int_digits, n - int_digits);
+				p += n - int_digits;
+			} else {
+				*p++ = '0';
+			}
+		}
+		return (size_t)(p - buffer);
+	}
+
+	*p++ = digits[0];
+	*p++ = '.';
+	if (n > 1) {
+		memcpy(p, digits + 1, n - 1);
+		p += n - 1;
+	} else {
+		*p++ = '0';
+	}
+	*p++ = 'E';
+	if (sci_exponent < 0) {
+		*p++ = '-';
+		sci_exponent = -sci_exponent;
+	}
+	size_t exponent_digits = count_digits((uint64_t)sci_exponent);
+	write_digits(p + exponent_digits, (uint64_t)sci_exponent);
+	p += exponent_digits;
+	return (size_t)(p - buffer);
+}
+
+static bool is_plain(double magnitude)
+{
+	return magnitude >= 1e-3 && magnitude < 1e7;
+}
+
+size_t format_double(char *buffer, double value)
+{
+	if (value == 0 || !isfinite(value))
+		return format_special(buffer, value);
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	uint64_t  mantissa = bits & ((UINT64_C(1) << 52) - 1);
+	uint32_t  exponent = (uint32_t)(bits >> 52) & 0x7FF;
+	decimal_t decimal  = d2d(mantissa, exponent);
+	return format_decimal(buffer, decimal, bits >> 63, is_plain(fabs(value)));
+}
+
+size_t format_float(char *buffer, float value)
+{
+	if (value == 0 || !isfinite(value))
+		return format_special(buffer, value);
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	uint32_t  mantissa = bits & ((UINT32_C(1) << 23) - 1);
+	uint32_t  exponent = (bits >> 23) & 0xFF;
+	decimal_t decimal  = f2d(mantissa, exponent);
+	return format_decimal(buffer, decimal, bits >> 31,
+	                      is_plain(fabs((double)value)));
+}
+
+/** Powers of ten which are exact doubles. */
+static const double exact_pow10[] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+#define MAX_EXACT_POW10 22
+
+/** Powers of ten which are exact floats. */
+static const float exact_pow10f[] = {
+	1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+#define MAX_EXACT_POW10F 10
+
+/** Largest integers that all are exact doubles and floats. */
+#define MAX_EXACT_DOUBLE_INT (UINT64_C(1) << 53)
+#define MAX_EXACT_FLOAT_INT  (UINT64_C(1) << 24)
+
+/** The first 19 significant digits of a decimal literal. */
+typedef struct parsed_t {
+	bool     negative;
+	bool     truncated; /**< nonzero digits were dropped */
+	uint64_t digits;
+	int32_t  exponent;
+	/* the number for strtod, without whitespace and suffix */
+	const char *begin;
+	const char *end;
+} parsed_t;
+
+static bool is_digit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static bool is_hex_digit(char c)
+{
+	return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static bool is_suffix(char c)
+{
+	return c == 'f' || c == 'F' || c == 'd' || c == 'D';
+}
+
+static bool matches(const char *p, const char *end, const char *word)
+{
+	size_t len = strlen(word);
+	return (size_t)(end - p) == len && memcmp(p, word, len) == 0;
+}
+
+/** Checks the syntax of a hexadecimal literal starting after "0x". */
+static bool check_hex(const char *p, const char *end)
+{
+	size_t n_digits = 0;
+	while (p < end && is_hex_digit(*p)) {
+		++p;
+		++n_digits;
+	}
+	if (p < end && *p == '.') {
+		++p;
+		while (p < end && is_hex_digit(*p)) {
+			++p;
+			++n_digits;
+		}
+	}
+	if (n_digits == 0 || p == end || (*p != 'p' && *p != 'P'))
+		return false;
+	++p;
+	if (p < end && (*p == '+' || *p == '-'))
+		++p;
+	if (p == end || !is_digit(*p))
+		return false;
+	while (p < end && is_digit(*p))
+		++p;
+	return p == end;
+}
+
+typedef enum parse_kind_t {
+	PARSE_INVALID,
+	PARSE_SPECIAL,  /**< NaN or infinity, result is set */
+	PARSE_DECIMAL,
+	PARSE_HEX
+} parse_kind_t;
+
+static parse_kind_t parse_literal(const char *chars, size_t len,
+                                  parsed_t *parsed, double *special)
+{
+	/* like String.trim */
+	const char *p   = chars;
+	const char *end = chars + len;
+	while (p < end && (unsigned char)*p <= ' ')
+		++p;
+	while (end > p && (unsigned char)end[-1] <= ' ')
+		--end;
+
+	parsed->begin    = p;
+	parsed->negative = false;
+	if (p < end && (*p == '+' || *p == '-')) {
+		parsed->negative = *p == '-';
+		++p;
+	}
+	if (matches(p, end, "NaN")) {
+		*special = NAN;
+		return PARSE_SPECIAL;
+	}
+	if (matches(p, end, "Infinity")) {
+		*special = parsed->negative ? -INFINITY : INFINITY;
+		return PARSE_SPECIAL;
+	}
+	if (p < end && is_suffix(end[-1]))
+		--end;
+	parsed->end = end;
+	if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+		return check_hex(p + 2, end) ? PARSE_HEX : PARSE_INVALID;
+
+	uint64_t digits    = 0;
+	int32_t  n_digits  = 0;  /**< significant digits kept in digits */
+	int32_t  exponent  = 0;
+	bool     truncated = false;
+	bool     any_digit = false;
+	while (p < end && is_digit(*p)) {
+		any_digit = true;
+		if (n_digits < 19) {
+			digits = digits * 10 + (uint64_t)(*p - '0');
+			n_digits += digits != 0;
+		} else {
+			truncated |= *p != '0';
+			++exponent;
+		}
+		++p;
+	}
+	if (p < end && *p == '.') {
+		++p;
+		while (p < end && is_digit(*p)) {
+			any_digit = true;
+			if (n_digits < 19) {
+				digits = digits * 10 + (uint64_t)(*p - '0');
+				n_digits += digits != 0;
+				--exponent;
+			} else {
+				truncated |= *p != '0';
+			}
+			++p;
+		}
+	}
+	if (!any_digit)
+		return PARSE_INVALID;
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		++p;
+		bool negative_exponent = false;
+		if (p < end && (*p == '+' || *p == '-')) {
+			negative_exponent = *p == '-';
+			++p;
+		}
+		if (p == end || !is_digit(*p))
+			return PARSE_INVALID;
+		int32_t value = 0;
+		while (p < end && is_digit(*p)) {
+			/* anything beyond this over- or underflows anyway */
+			if (value < 100000)
+				value = value * 10 + (*p - '0');
+			++p;
+		}
+		exponent += negative_exponent ? -value : value;
+	}
+	if (p != end)
+		return PARSE_INVALID;
+	parsed->digits    = digits;
+	parsed->exponent  = exponent;
+	parsed->truncated = truncated;
+	return PARSE_DECIMAL;
+}
+
+/** Runs strtod or strtof on the literal in @p parsed. */
+static double parse_slow(const parsed_t *parsed, bool is_float)
+{
+	char   small[64];
+	size_t len    = (size_t)(parsed->end - parsed->begin);
+	char  *buffer = small;
+	if (len >= sizeof(small)) {
+		buffer = malloc(len + 1);
+		if (buffer == NULL) {
+			fprintf(stderr, "panic: out of memory\n");
+			abort();
+		}
+	}
+	memcpy(buffer, parsed->begin, len);
+	buffer[len] = '\0';
+	double result = is_float ? strtof(buffer, NULL) : strtod(buffer, NULL);
+	if (buffer != small)
+		free(buffer);
+	return result;
+}
+
+/** Clinger's fast path, the operands are exact so it rounds once. */
+static bool parse_exact(const parsed_t *parsed, double *result)
+{
+	uint64_t digits   = parsed->digits;
+	int32_t  exponent = parsed->exponent;
+	if (digits == 0) {
+		*result = parsed->negative ? -0.0 : 0.0;
+		return true;
+	}
+	if (parsed->truncated || digits > MAX_EXACT_DOUBLE_INT
+	    || exponent < -MAX_EXACT_POW10)
+		return false;
+	/* move a surplus exponent into the digits while they stay exact */
+	while (exponent > MAX_EXACT_POW10) {
+		if (digits > MAX_EXACT_DOUBLE_INT / 10)
+			return false;
+		digits *= 10;
+		--exponent;
+	}
+	double value = (double)digits;
+	if (exponent < 0) {
+		value /= exact_pow10[-exponent];
+	} else {
+		value *= exact_pow10[exponent];
+	}
+	*result = parsed->negative ? -value : value;
+	return true;
+}
+
+static bool parse_exact_float(const parsed_t *parsed, float *result)
+{
+	uint64_t digits   = parsed->digits;
+	int32_t  exponent = parsed->exponent;
+	if (digits == 0) {
+		*result = parsed->negative ? -0.0f : 0.0f;
+		return true;
+	}
+	if (parsed->truncated || digits > MAX_EXACT_FLOAT_INT
+	    || exponent < -MAX_EXACT_POW10F || exponent > MAX_EXACT_POW10F)
+		return false;
+	float value = (float)digits;
+	if (exponent < 0) {
+		value /= exact_pow10f[-exponent];
+	} else {
+		value *= exact_pow10f[exponent];
+	}
+	*result = parsed->negative ? -value : value;
+	return true;
+}
+
+bool parse_double(const char *chars, size_t len, double *result)
+{
+	parsed_t     parsed;
+	parse_kind_t kind = parse_literal(chars, len, &parsed, result);
+	if (kind == PARSE_INVALID)
+		return false;
+	if (kind == PARSE_SPECIAL)
+		return true;
+	if (kind == PARSE_DECIMAL && parse_exact(&parsed, result))
+		return true;
+	*result = parse_slow(&parsed, false);
+	return true;
+}
+
+bool parse_float(const char *chars, size_t len, float *result)
+{
+	parsed_t     parsed;
+	double       special;
+	parse_kind_t kind = parse_literal(chars, len, &parsed, &special);
+	if (kind == PARSE_INVALID)
+		return false;
+	if (kind == PARSE_SPECIAL) {
+		*result = (float)special;
+		return true;
+	}
+	if (kind == PARSE_DECIMAL && parse_exact_float(&parsed, result))
+		return true;
+	*result = (float)parse_slow(&parsed, true);
+	return true;
+}
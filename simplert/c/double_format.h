@@ -0,0 +1,30 @@
+#ifndef DOUBLE_FORMAT_H
+#define DOUBLE_FORMAT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** Buffer size needed by format_double and format_float. */
+#define DOUBLE_FORMAT_SIZE 32
+
+/**
+ * Writes @p value the way Double.toString does into @p buffer and returns
+ * the number of chars, no NUL is added. The digits are the shortest ones
+ * that parse back to @p value (Ryu), a single digit is extended to the
+ * closest two digit decimal like Java 19 does.
+ */
+size_t format_double(char *buffer, double value);
+
+/** Like format_double for Float.toString. */
+size_t format_float(char *buffer, float value);
+
+/**
+ * Parses the ASCII chars @p chars the way Double.parseDouble does, including
+ * the surrounding whitespace. Returns false if they are malformed.
+ */
+bool parse_double(const char *chars, size_t len, double *result);
+
+/** Like parse_double for Float.parseFloat, rounds only once. */
+bool parse_float(const char *chars, size_t len, float *result);
+
+#endif
@@ -0,0 +1,374 @@
+#include "exceptions.h"
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unwind.h>
+
+#if !defined(__x86_64__)
+#error "exceptions.c only supports x86-64"
+#endif
+
+typedef struct exception_site_t {
+	const char *ret;      /**< return address of a call in a try block */
+	const char *landing;  /**< landing pad of its handlers */
+} exception_site_t;
+
+/**
+ * Call sites with handlers, terminated by a NULL pair. It is emitted by the
+ * compiler (see gcji_create_exception_table) and sorted by exceptions_init.
+ */
+extern exception_site_t _Jv_exception_sites[] __attribute__((weak));
+
+static size_t n_sites;
+
+typedef struct line_site_t {
+	const char       *ret;   /**< return address of a Java call */
+	const utf8_const *file;  /**< its source file */
+	uintptr_t         line;
+} line_site_t;
+
+/**
+ * Source lines of the calls, terminated by a NULL triple. It is emitted by
+ * the compiler (see gcji_create_exception_table) and sorted by
+ * exceptions_init.
+ */
+extern line_site_t _Jv_line_numbers[] __attribute__((weak));
+
+static size_t n_line_sites;
+
+/**
+ * Classes of the implicit exceptions in the order of implicit_exception_t,
+ * emitted by the compiler (see gcji_create_implicit_exception_table).
+ */
+extern java_lang_Class *const _Jv_implicit_exception_classes[]
+	__attribute__((weak));
+
+static const char *const implicit_exception_names[N_IMPLICIT_EXCEPTIONS] = {
+	"NullPointerException",
+	"ArrayIndexOutOfBoundsException",
+	"ArithmeticException",
+	"NoClassDefFoundError",
+	"ExceptionInInitializerError",
+	"IllegalMonitorStateException",
+	"IllegalArgumentException",
+};
+
+jobject implicit_exceptions[N_IMPLICIT_EXCEPTIONS];
+
+static const utf8_const init_name     = { 0x0272,  6, { "<init>"                   } };
+static const utf8_const throwable_sig = { 0x83a0, 24, { "(Ljava/lang/Throwable;)V" } };
+static const utf8_const error_name    = { 0xe134, 15, { "java.lang.Error"          } };
+
+/**
+ * A handler of exceptions_call_catching. The handlers of a thread form a
+ * stack, the innermost one comes first.
+ */
+typedef struct native_handler_t native_handler_t;
+struct native_handler_t {
+	native_handler_t *next;
+	jmp_buf           target;
+};
+
+static __thread native_handler_t *native_handlers;
+
+/** Machine state to continue at a landing pad, see resume. */
+typedef struct landing_t {
+	uintptr_t rbx;
+	uintptr_t rbp;
+	uintptr_t r12;
+	uintptr_t r13;
+	uintptr_t r14;
+	uintptr_t r15;
+	uintptr_t rsp;
+	uintptr_t rip;
+} landing_t;
+
+typedef struct unwind_t {
+	bool      found;
+	landing_t landing;
+} unwind_t;
+
+/* DWARF register numbers of the callee saved registers */
+enum {
+	DWARF_RBX = 3,
+	DWARF_RBP = 6,
+	DWARF_R12 = 12,
+	DWARF_R13 = 13,
+	DWARF_R14 = 14,
+	DWARF_R15 = 15,
+};
+
+static int compare_sites(const void *p1, const void *p2)
+{
+	const exception_site_t *site1 = (const exception_site_t*)p1;
+	const exception_site_t *site2 = (const exception_site_t*)p2;
+	if (site1->ret != site2->ret)
+		return (uintptr_t)site1->ret < (uintptr_t)site2->ret ? -1 : 1;
+	return 0;
+}
+
+static int compare_line_sites(const void *p1, const void *p2)
+{
+	const line_site_t *site1 = (const line_site_t*)p1;
+	const line_site_t *site2 = (const line_site_t*)p2;
+	if (site1->ret != site2->ret)
+		return (uintptr_t)site1->ret < (uintptr_t)site2->ret ? -1 : 1;
+	return 0;
+}
+
+void exceptions_init(void)
+{
+	/* the fields stay zero: no message, no cause and no stack trace */
+	if (_Jv_implicit_exception_classes != NULL) {
+		for (int i = 0; i < N_IMPLICIT_EXCEPTIONS; ++i) {
+			implicit_exceptions[i]
+				= _Jv_AllocObjectNoFinalizer(_Jv_implicit_exception_classes[i]);
+		}
+	}
+
+	if (_Jv_line_numbers != NULL) {
+		while (_Jv_line_numbers[n_line_sites].ret != NULL)
+			++n_line_sites;
+		qsort(_Jv_line_numbers, n_line_sites, sizeof(_Jv_line_numbers[0]),
+		      compare_line_sites);
+	}
+
+	if (_Jv_exception_sites == NULL)
+		return;
+	while (_Jv_exception_sites[n_sites].ret != NULL)
+		++n_sites;
+	qsort(_Jv_exception_sites, n_sites, sizeof(_Jv_exception_sites[0]),
+	      compare_sites);
+}
+
+static const char *find_site(const char *ret)
+{
+	size_t low  = 0;
+	size_t high = n_sites;
+	while (low < high) {
+		size_t      mid      = low + (high - low) / 2;
+		const char *mid_ret  = _Jv_exception_sites[mid].ret;
+		if (mid_ret == ret)
+			return _Jv_exception_sites[mid].landing;
+		if ((uintptr_t)mid_ret < (uintptr_t)ret) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Returns the target of the jump at @p ret or NULL. The block a call
+ * returns to is labelled, but the backend may place it elsewhere and jump
+ * to it right after the call.
+ */
+static const char *find_jump_target(const char *ret)
+{
+	const unsigned char *code = (const unsigned char*)ret;
+	if (code[0] == 0xEB) {
+		/* jmp rel8 */
+		return ret + 2 + (int8_t)code[1];
+	} else if (code[0] == 0xE9) {
+		/* jmp rel32 */
+		int32_t offset;
+		memcpy(&offset, code + 1, sizeof(offset));
+		return ret + 5 + offset;
+	}
+	return NULL;
+}
+
+/** Returns the landing pad for the call returning to @p ret or NULL. */
+static const char *find_landing_pad(const char *ret)
+{
+	const char *landing = find_site(ret);
+	if (landing != NULL)
+		return landing;
+	const char *target = find_jump_target(ret);
+	return target != NULL ? find_site(target) : NULL;
+}
+
+static const line_site_t *find_line_site(const char *ret)
+{
+	size_t low  = 0;
+	size_t high = n_line_sites;
+	while (low < high) {
+		size_t      mid     = low + (high - low) / 2;
+		const char *mid_ret = _Jv_line_numbers[mid].ret;
+		if (mid_ret == ret)
+			return &_Jv_line_numbers[mid];
+		if ((uintptr_t)mid_ret < (uintptr_t)ret) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return NULL;
+}
+
+bool exceptions_find_line(const char *ret, const utf8_const **file,
+                          jint *line)
+{
+	if (n_line_sites == 0)
+		return false;
+	const line_site_t *site = find_line_site(ret);
+	if (site == NULL) {
+		const char *target = find_jump_target(ret);
+		if (target == NULL)
+			return false;
+		site = find_line_site(target);
+		if (site == NULL)
+			return false;
+	}
+	*file = site->file;
+	*line = (jint)site->line;
+	return true;
+}
+
+static _Unwind_Reason_Code find_handler(struct _Unwind_Context *context,
+                                        void *data)
+{
+	unwind_t   *unwind  = (unwind_t*)data;
+	const char *ip      = (const char*)_Unwind_GetIP(context);
+	const char *landing = ip != NULL && n_sites > 0
+	                    ? find_landing_pad(ip) : NULL;
+	if (landing == NULL)
+		return _URC_NO_REASON;
+
+	/* the registers as the frame sees them after the call returned, the
+	 * CFA libgcc keeps while visiting the frame is the one of its callee,
+	 * which is the stack pointer of the frame at the call */
+	landing_t *state = &unwind->landing;
+	state->rbx    = _Unwind_GetGR(context, DWARF_RBX);
+	state->rbp    = _Unwind_GetGR(context, DWARF_RBP);
+	state->r12    = _Unwind_GetGR(context, DWARF_R12);
+	state->r13    = _Unwind_GetGR(context, DWARF_R13);
+	state->r14    = _Unwind_GetGR(context, DWARF_R14);
+	state->r15    = _Unwind_GetGR(context, DWARF_R15);
+	state->rsp    = _Unwind_GetCFA(context);
+	state->rip    = (uintptr_t)landing;
+	unwind->found = true;
+	return _URC_END_OF_STACK;
+}
+
+/**
+ * Continues at the landing pad described by @p state. The frames below it,
+ * including the current one, are discarded.
+ */
+static void __attribute__((noreturn)) resume(const landing_t *state)
+{
+	__asm__ volatile(
+		"movq  0(%0), %%rbx\n\t"
+		"movq  8(%0), %%rbp\n\t"
+		"movq 16(%0), %%r12\n\t"
+		"movq 24(%0), %%r13\n\t"
+		"movq 32(%0), %%r14\n\t"
+		"movq 40(%0), %%r15\n\t"
+		"movq 56(%0), %%rcx\n\t"
+		"movq 48(%0), %%rsp\n\t"
+		"jmpq *%%rcx\n\t"
+		: : "a"(state) : "rcx", "memory");
+	__builtin_unreachable();
+}
+
+void _Jv_Throw(jobject exception)
+{
+	if (exception == NULL)
+		_Jv_ThrowNullPointerException();
+	_Jv_exception = exception;
+
+	unwind_t unwind;
+	unwind.found = false;
+	_Unwind_Backtrace(find_handler, &unwind);
+
+	/* the stack grows down, a native handler below the frame of the landing
+	 * pad is closer to the throw */
+	native_handler_t *native = native_handlers;
+	if (native != NULL
+	    && (!unwind.found || (uintptr_t)native < unwind.landing.rsp)) {
+		native_handlers = native->next;
+		longjmp(native->target, 1);
+	}
+	if (unwind.found)
+		resume(&unwind.landing);
+
+	const utf8_const *name = exception->vptr->rtti->name;
+	fprintf(stderr, "throw %.*s\n", (int)name->len, name->data);
+	abort();
+}
+
+void exceptions_throw_implicit(implicit_exception_t kind)
+{
+	jobject exception = implicit_exceptions[kind];
+	if (exception == NULL) {
+		fprintf(stderr, "throw %s\n", implicit_exception_names[kind]);
+		abort();
+	}
+	_Jv_Throw(exception);
+}
+
+void _Jv_ThrowNullPointerException(void)
+{
+	exceptions_throw_implicit(IMPLICIT_NULL_POINTER);
+}
+
+void _Jv_ThrowBadArrayIndex(jint index)
+{
+	/* the preallocated instance has no message to put the index into */
+	(void)index;
+	exceptions_throw_implicit(IMPLICIT_ARRAY_INDEX);
+}
+
+void _Jv_ThrowArithmeticException(void)
+{
+	exceptions_throw_implicit(IMPLICIT_ARITHMETIC);
+}
+
+void _Jv_ThrowNoClassDefFoundError(void)
+{
+	exceptions_throw_implicit(IMPLICIT_NO_CLASS_DEF);
+}
+
+jobject exceptions_call_catching(void (*function)(void *data), void *data)
+{
+	native_handler_t handler;
+	handler.next = native_handlers;
+	/* _Jv_Throw removes the handler before it jumps back */
+	if (setjmp(handler.target) != 0)
+		return _Jv_exception;
+	native_handlers = &handler;
+	function(data);
+	native_handlers = handler.next;
+	return NULL;
+}
+
+static bool utf8_equals(const utf8_const *c1, const utf8_const *c2)
+{
+	return c1->len == c2->len && memcmp(c1->data, c2->data, c1->len) == 0;
+}
+
+void exceptions_throw_initializer_failure(jobject exception)
+{
+	for (java_lang_Class *cls = exception->vptr->rtti; cls != NULL;
+	     cls = cls->superclass) {
+		if (utf8_equals(cls->name, &error_name))
+			_Jv_Throw(exception);
+	}
+
+	/* without exception tables the class is not there */
+	java_lang_Class *error_class = _Jv_implicit_exception_classes != NULL
+		? _Jv_implicit_exception_classes[IMPLICIT_INITIALIZER] : NULL;
+	jv_method       *init        = error_class != NULL
+		? get_declared_method(error_class, &init_name, &throwable_sig) : NULL;
+	if (init == NULL)
+		exceptions_throw_implicit(IMPLICIT_INITIALIZER);
+	void  (*construct)(jobject, jobject) = (void(*)(jobject, jobject))init->code;
+	jobject error                       = _Jv_AllocObjectNoFinalizer(error_class);
+	construct(error, exception);
+	_Jv_Throw(error);
+}
@@ -0,0 +1,86 @@
+#ifndef EXCEPTIONS_H
+#define EXCEPTIONS_H
+
+#include "types.h"
+
+/*
+ * Zero-cost exceptions: the compiler emits a table mapping the return
+ * address of each call inside a try block to the landing pad of its
+ * handlers (see gcji_create_exception_table). Nothing is executed for a try
+ * block unless an exception is thrown. _Jv_Throw then walks the stack with
+ * the DWARF unwinder of libgcc, using the call frame information the backend
+ * emits, until a frame returns to a call site of the table. It restores the
+ * callee saved registers and the stack pointer of that frame and continues
+ * at the landing pad, which loads _Jv_exception and tests the catch types.
+ */
+
+/**
+ * The exception being thrown by the current thread. It is defined by the
+ * compiled program (see gcji_init) so landing pads can use the cheapest TLS
+ * access model, like _Jv_tlab.
+ */
+extern __thread jobject _Jv_exception;
+
+/**
+ * Exceptions raised by the runtime and by the checks of the compiled code.
+ * They are preallocated by exceptions_init, so throwing them allocates
+ * nothing, and have no stack trace. Must match gcji_implicit_exceptions.
+ */
+typedef enum implicit_exception_t {
+	IMPLICIT_NULL_POINTER,
+	IMPLICIT_ARRAY_INDEX,
+	IMPLICIT_ARITHMETIC,
+	IMPLICIT_NO_CLASS_DEF,
+	IMPLICIT_INITIALIZER,
+	IMPLICIT_ILLEGAL_MONITOR_STATE,
+	IMPLICIT_ILLEGAL_ARGUMENT,
+	N_IMPLICIT_EXCEPTIONS
+} implicit_exception_t;
+
+/** The preallocated instances, the collector treats them as roots. */
+extern jobject implicit_exceptions[N_IMPLICIT_EXCEPTIONS];
+
+/**
+ * Prepares the table of call sites emitted by the compiler and allocates
+ * the implicit exceptions, the heap must be set up already.
+ */
+void exceptions_init(void);
+
+/**
+ * Finds the source file and line of the Java call returning to @p ret.
+ * Returns false if the compiler recorded none.
+ */
+bool exceptions_find_line(const char *ret, const utf8_const **file,
+                          jint *line);
+
+/**
+ * Calls @p function with @p data and returns the exception it throws and
+ * does not catch itself, NULL if it returns normally. Lets the runtime clean
+ * up after the Java code it runs, handlers of the compiled code further up
+ * the stack don't see the exception.
+ */
+jobject exceptions_call_catching(void (*function)(void *data), void *data);
+
+/**
+ * Throws the exception of a failed static initializer as JLS 12.4.2 says:
+ * Errors as they are, other exceptions wrapped in an
+ * ExceptionInInitializerError.
+ */
+void exceptions_throw_initializer_failure(jobject exception)
+	__attribute__((noreturn));
+
+/** Throws the preallocated exception @p kind. */
+void exceptions_throw_implicit(implicit_exception_t kind)
+	__attribute__((noreturn));
+
+/** Throws @p exception, called by compiled code for athrow. */
+void _Jv_Throw(jobject exception) __attribute__((noreturn));
+
+void _Jv_ThrowNullPointerException(void) __attribute__((noreturn));
+void _Jv_ThrowBadArrayIndex(jint index) __attribute__((noreturn));
+/** Thrown for uses of classes whose initialization failed. */
+void _Jv_ThrowNoClassDefFoundError(void) __attribute__((noreturn));
+/** Called by the division checks of the compiled code. */
+void _Jv_ThrowArithmeticException(void) __attribute__((noreturn));
+
+#endif
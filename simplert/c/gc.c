@@ -0,0 +1,676 @@
+#define _GNU_SOURCE
+#include "exceptions.h"
+#include "heap.h"
+#include "monitor.h"
+#include "threads.h"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __APPLE__
+#include <mach-o/getsect.h>
+#include <mach-o/ldsyms.h>
+#else
+#include <link.h>
+#endif
+
+/*
+ * Generational collector. Objects are described precisely by the gc_descr
+ * of their vtable and static fields by the root table of the compiler. The
+ * stacks and the registers of all threads are scanned conservatively: every
+ * word that points into an object (interior pointers included) keeps that
+ * object alive.
+ *
+ * Minor collections evacuate the nursery in the style of a mostly-copying
+ * collector: nursery objects referenced ambiguously are pinned first, then
+ * all objects reachable from the precise roots, from the pinned objects and
+ * from old objects on dirty cards are copied into the old generation. The
+ * forwarding pointer replaces the vptr of the copied object, its lowest bit
+ * is set. Nursery chunks with pinned objects become part of the old
+ * generation, all others are reused.
+ *
+ * Major collections mark and sweep the old generation without moving
+ * anything, they run right after a minor collection when the nursery is
+ * empty.
+ */
+
+volatile int _Jv_safepoint_requested;
+
+/** Callbacks for the values found by the scanning functions. */
+typedef struct visitor_t {
+	/** called for words which might be references, may be NULL */
+	void (*ambiguous)(const void *value);
+	/** called for fields known to hold references, may be NULL */
+	void (*slot)(java_lang_Object **slot);
+} visitor_t;
+
+typedef struct hash_entry_t {
+	java_lang_Object *object;
+	jint              hash;
+} hash_entry_t;
+
+static java_lang_Object **mark_stack;
+static size_t             mark_stack_top;
+static size_t             mark_stack_size;
+
+/**
+ * Identity hash codes of objects which were hashed while in the nursery,
+ * keyed by their current address. All other objects use their address.
+ */
+static hash_entry_t *hash_table;
+static size_t        hash_table_size;
+static size_t        n_hashes;
+
+static void find_object_starts(chunk_t *chunk)
+{
+	memset(chunk->start_bits, 0, chunk_bitmap_size(chunk));
+	for (char *p = chunk->begin; p < chunk->free; ) {
+		size_t size = heap_object_size((java_lang_Object*)p);
+		assert(size > 0);
+		set_bit(chunk->start_bits, granule_index(chunk, p));
+		p += size;
+	}
+}
+
+/** Returns the index of the last object start at or before @p idx. */
+static size_t find_start(const chunk_t *chunk, size_t idx)
+{
+	if (chunk->large)
+		return 0;
+	const uint8_t *bits = chunk->start_bits;
+	size_t         byte = idx / 8;
+	unsigned       mask = bits[byte] & ((2u << (idx % 8)) - 1);
+	while (mask == 0) {
+		assert(byte > 0);
+		mask = bits[--byte];
+	}
+	return byte * 8 + (unsigned)(31 - __builtin_clz(mask));
+}
+
+static bool is_free_cell(const java_lang_Object *object)
+{
+	return gc_descr_tag(object->vptr->gc_descr) == GC_DESCR_FREE;
+}
+
+static bool is_forwarded(const java_lang_Object *object)
+{
+	return ((uintptr_t)object->vptr & 1) != 0;
+}
+
+static java_lang_Object *get_forwardee(const java_lang_Object *object)
+{
+	return (java_lang_Object*)((uintptr_t)object->vptr & ~(uintptr_t)1);
+}
+
+/** Like heap_object_size but also works for objects moved to their copy. */
+static size_t object_size(const java_lang_Object *object)
+{
+	if (is_forwarded(object))
+		return heap_object_size(get_forwardee(object));
+	return heap_object_size(object);
+}
+
+static void push_mark(java_lang_Object *object)
+{
+	if (mark_stack_top == mark_stack_size) {
+		mark_stack_size = mark_stack_size == 0 ? 1024 : mark_stack_size*2;
+		mark_stack = realloc(mark_stack, mark_stack_size * sizeof(mark_stack[0]));
+		if (mark_stack == NULL) {
+			fprintf(stderr, "panic: out of memory\n");
+			abort();
+		}
+	}
+	mark_stack[mark_stack_top++] = object;
+}
+
+static void mark_granule(chunk_t *chunk, size_t idx)
+{
+	if (test_bit(chunk->mark_bits, idx))
+		return;
+	java_lang_Object *object
+		= (java_lang_Object*)(chunk->begin + idx * HEAP_GRANULE);
+	if (is_free_cell(object))
+		return;
+	set_bit(chunk->mark_bits, idx);
+	if (chunk->young)
+		chunk->pinned = true;
+	push_mark(object);
+}
+
+/** Marks the object in @p chunk containing @p ptr. */
+static void mark_ambiguous(chunk_t *chunk, const void *ptr)
+{
+	size_t idx   = granule_index(chunk, ptr);
+	size_t start = find_start(chunk, idx);
+	mark_granule(chunk, start);
+
+	/* a pointer just past the end of an object looks like a pointer to the
+	 * start of the next one, keep both alive */
+	if ((const char*)ptr == chunk->begin + start * HEAP_GRANULE && start > 0)
+		mark_granule(chunk, find_start(chunk, start - 1));
+}
+
+/** Marks the old object containing @p ptr if there is one. */
+static void mark_conservative(const void *ptr)
+{
+	chunk_t *chunk = heap_find_chunk(ptr);
+	if (chunk != NULL && !chunk->young)
+		mark_ambiguous(chunk, ptr);
+}
+
+/** Marks the object referenced by the field value @p ptr. */
+static void mark_reference(const void *ptr)
+{
+	chunk_t *chunk = heap_find_chunk(ptr);
+	if (chunk == NULL)
+		return;
+
+	size_t idx = granule_index(chunk, ptr);
+	if (!test_bit(chunk->start_bits, idx))
+		idx = find_start(chunk, idx);
+	mark_granule(chunk, idx);
+}
+
+static void mark_slot(java_lang_Object **slot)
+{
+	mark_reference(*slot);
+}
+
+/** Pins the nursery object containing @p ptr if there is one. */
+static void pin_conservative(const void *ptr)
+{
+	chunk_t *chunk = heap_find_chunk(ptr);
+	if (chunk != NULL && chunk->young)
+		mark_ambiguous(chunk, ptr);
+}
+
+/**
+ * Updates a reference to a nursery object, the object is copied to the old
+ * generation unless that already happened or it is pinned.
+ */
+static void forward_slot(java_lang_Object **slot)
+{
+	java_lang_Object *object = *slot;
+	chunk_t          *chunk  = heap_find_chunk(object);
+	if (chunk == NULL || !chunk->young)
+		return;
+	if (is_forwarded(object)) {
+		*slot = get_forwardee(object);
+		return;
+	}
+	if (test_bit(chunk->mark_bits, granule_index(chunk, object)))
+		return;
+
+	size_t            size = heap_object_size(object);
+	java_lang_Object *copy = heap_alloc_promoted(size);
+	memcpy(copy, object, size);
+	object->vptr = (vtable_t*)((uintptr_t)copy | 1);
+	*slot        = copy;
+	push_mark(copy);
+
+	heap_stats.bytes_promoted += size;
+	heap_stats.objects_promoted++;
+}
+
+static const visitor_t mark_visitor    = { mark_conservative, mark_slot };
+static const visitor_t pin_visitor     = { pin_conservative, NULL };
+static const visitor_t forward_visitor = { NULL, forward_slot };
+
+static void scan_range(const visitor_t *visitor, const void *begin,
+                       const void *end)
+{
+	if (visitor->ambiguous == NULL)
+		return;
+	uintptr_t addr = ((uintptr_t)begin + sizeof(void*)-1)
+	               & ~(uintptr_t)(sizeof(void*)-1);
+	for (void *const *p = (void *const*)addr; (const void*)(p+1) <= end; ++p) {
+		visitor->ambiguous(*p);
+	}
+}
+
+/** Visits the fields of @p object which lie in [low, high). */
+static void scan_object_range(const visitor_t *visitor,
+                              java_lang_Object *object, const char *low,
+                              const char *high)
+{
+	void     **words = (void**)object;
+	uintptr_t  descr = (uintptr_t)object->vptr->gc_descr;
+	switch (gc_descr_tag(descr)) {
+	case GC_DESCR_BITMAP:
+		if (visitor->slot == NULL)
+			return;
+		for (uintptr_t bits = descr >> 2; bits != 0; bits >>= 1, ++words) {
+			if ((bits & 1) && (const char*)words >= low
+			    && (const char*)words < high)
+				visitor->slot((java_lang_Object**)words);
+		}
+		return;
+	case GC_DESCR_ARRAY:
+		if ((descr & 4) && visitor->slot != NULL) {
+			array_header_t    *array = (array_header_t*)object;
+			java_lang_Object **data  = get_array_data(java_lang_Object*, array);
+			java_lang_Object **begin = data;
+			java_lang_Object **end   = data + array->length;
+			if ((const char*)begin < low)
+				begin = (java_lang_Object**)low;
+			if ((const char*)end > high)
+				end = (java_lang_Object**)high;
+			for (java_lang_Object **slot = begin; slot < end; ++slot) {
+				visitor->slot(slot);
+			}
+		}
+		return;
+	case GC_DESCR_CONSERVATIVE: {
+		const char *begin = (const char*)(words + 1);
+		const char *end   = (const char*)object + heap_object_size(object);
+		scan_range(visitor, begin > low ? begin : low, end < high ? end : high);
+		return;
+	}
+	default:
+		assert(false);
+		return;
+	}
+}
+
+static void scan_object(const visitor_t *visitor, java_lang_Object *object)
+{
+	const char *begin = (const char*)object;
+	scan_object_range(visitor, object, begin,
+	                  begin + heap_object_size(object));
+}
+
+static void process_mark_stack(const visitor_t *visitor)
+{
+	while (mark_stack_top > 0) {
+		scan_object(visitor, mark_stack[--mark_stack_top]);
+	}
+}
+
+static void __attribute__((noinline)) scan_stacks(const visitor_t *visitor)
+{
+	/* spill callee saved registers into this frame, setjmp alone is not
+	 * enough as glibc mangles some of them */
+	__builtin_unwind_init();
+	jmp_buf registers;
+	setjmp(registers);
+
+	/* the other threads are blocked, thread_blocking_call saved their
+	 * registers the same way */
+	thread_t *self = thread_current();
+	for (thread_t *thread = threads; thread != NULL; thread = thread->next) {
+		scan_range(visitor, &thread->object, &thread->object + 1);
+		if (thread->exception != NULL)
+			scan_range(visitor, thread->exception, thread->exception + 1);
+		if (thread == self) {
+			scan_range(visitor, &registers, thread->stack_bottom);
+		} else if (thread->stack_bottom != NULL) {
+			scan_range(visitor, thread->stack_top, thread->stack_bottom);
+		}
+	}
+}
+
+static void retire_tlabs(void)
+{
+	for (thread_t *thread = threads; thread != NULL; thread = thread->next) {
+		if (thread->tlab != NULL)
+			heap_retire_tlab(thread->tlab);
+	}
+}
+
+#ifdef __APPLE__
+static void scan_data_segments(const visitor_t *visitor)
+{
+	unsigned long  size;
+	const uint8_t *data = getsegmentdata(&_mh_execute_header, "__DATA", &size);
+	if (data != NULL)
+		scan_range(visitor, data, data + size);
+}
+#else
+static int scan_phdr(struct dl_phdr_info *info, size_t size, void *data)
+{
+	(void)size;
+	const visitor_t *visitor = (const visitor_t*)data;
+
+	/* static fields live in the program itself, the runtime libraries hold
+	 * no java references */
+	if (info->dlpi_name != NULL && info->dlpi_name[0] != '\0')
+		return 0;
+
+	for (int i = 0; i < info->dlpi_phnum; ++i) {
+		const ElfW(Phdr) *phdr = &info->dlpi_phdr[i];
+		if (phdr->p_type != PT_LOAD || !(phdr->p_flags & PF_W))
+			continue;
+		const char *begin = (const char*)(info->dlpi_addr + phdr->p_vaddr);
+		scan_range(visitor, begin, begin + phdr->p_memsz);
+	}
+	return 0;
+}
+
+static void scan_data_segments(const visitor_t *visitor)
+{
+	dl_iterate_phdr(scan_phdr, (void*)visitor);
+}
+#endif
+
+static void scan_static_roots(const visitor_t *visitor)
+{
+	for (java_lang_Object **const *root = _Jv_static_roots; *root != NULL;
+	     ++root) {
+		visitor->slot(*root);
+	}
+}
+
+/** Scans the roots which don't have a precise description. */
+static void scan_ambiguous_roots(const visitor_t *visitor)
+{
+	scan_stacks(visitor);
+	scan_range(visitor, implicit_exceptions,
+	           implicit_exceptions + N_IMPLICIT_EXCEPTIONS);
+	if (_Jv_static_roots == NULL)
+		scan_data_segments(visitor);
+}
+
+/**
+ * Visits the fields of old objects on dirty cards, these are the only old
+ * fields which may reference nursery objects.
+ */
+static void scan_dirty_cards(const visitor_t *visitor, bool clear)
+{
+	uint8_t *cards = _Jv_card_table.cards;
+	char    *base  = _Jv_card_table.heap_base;
+	for (chunk_t *chunk = heap_chunks; chunk != NULL; chunk = chunk->next) {
+		if (chunk->free == chunk->begin)
+			continue;
+		size_t first = (size_t)(chunk->begin - base) >> HEAP_CARD_SHIFT;
+		size_t last  = (size_t)(chunk->free - base - 1) >> HEAP_CARD_SHIFT;
+		for (size_t card = first; card <= last; ++card) {
+			if (cards[card] == 0)
+				continue;
+			if (clear)
+				cards[card] = 0;
+
+			char *low  = base + (card << HEAP_CARD_SHIFT);
+			char *high = low + ((size_t)1 << HEAP_CARD_SHIFT);
+			if (low < chunk->begin)
+				low = chunk->begin;
+			if (high > chunk->free)
+				high = chunk->free;
+			size_t start = find_start(chunk, granule_index(chunk, low));
+			for (char *p = chunk->begin + start * HEAP_GRANULE; p < high; ) {
+				java_lang_Object *object = (java_lang_Object*)p;
+				if (!is_free_cell(object))
+					scan_object_range(visitor, object, low, high);
+				p += heap_object_size(object);
+			}
+		}
+	}
+}
+
+/**
+ * Pins everything referenced by nursery objects without precise layout
+ * information. They are treated as roots since their fields can't be
+ * updated once the referenced objects moved.
+ */
+static void scan_conservative_objects(chunk_t *chunk)
+{
+	for (char *p = chunk->begin; p < chunk->free; ) {
+		java_lang_Object *object = (java_lang_Object*)p;
+		if (gc_descr_tag(object->vptr->gc_descr) == GC_DESCR_CONSERVATIVE)
+			scan_object(&pin_visitor, object);
+		p += heap_object_size(object);
+	}
+}
+
+/**
+ * Frees unmarked objects, returns the number of live bytes in @p chunk.
+ * The bytes of dead objects are added to @p freed.
+ */
+static size_t sweep_chunk(chunk_t *chunk, uint64_t *freed)
+{
+	size_t  live       = 0;
+	char   *free_begin = NULL;
+	for (char *p = chunk->begin; p < chunk->free; ) {
+		java_lang_Object *object = (java_lang_Object*)p;
+		size_t            size   = object_size(object);
+		size_t            idx    = granule_index(chunk, p);
+		if (test_bit(chunk->mark_bits, idx)) {
+			clear_bit(chunk->mark_bits, idx);
+			live += size;
+			if (free_begin != NULL) {
+				heap_add_free(free_begin, (size_t)(p - free_begin));
+				free_begin = NULL;
+			}
+		} else {
+			if (!is_forwarded(object) && !is_free_cell(object))
+				*freed += size;
+			if (free_begin == NULL) {
+				free_begin = p;
+			} else {
+				/* merged into the free cell started before */
+				clear_bit(chunk->start_bits, idx);
+			}
+		}
+		p += size;
+	}
+	if (free_begin != NULL && live > 0)
+		heap_add_free(free_begin, (size_t)(chunk->free - free_begin));
+	return live;
+}
+
+static void sweep(void)
+{
+	heap_clear_free_lists();
+
+	size_t live = 0;
+	for (chunk_t **anchor = &heap_chunks; *anchor != NULL; ) {
+		chunk_t *chunk      = *anchor;
+		size_t   chunk_live = sweep_chunk(chunk, &heap_stats.bytes_freed);
+		if (chunk_live == 0) {
+			*anchor = chunk->next;
+			heap_release_chunk(chunk);
+			continue;
+		}
+		live  += chunk_live;
+		anchor = &chunk->next;
+	}
+	heap_stats.live_bytes = live;
+}
+
+static size_t hash_index(const java_lang_Object *object)
+{
+	return (size_t)(((uintptr_t)object >> 3) * 0x9E3779B1u)
+	       & (hash_table_size - 1);
+}
+
+static hash_entry_t *find_hash_entry(const java_lang_Object *object)
+{
+	for (size_t i = hash_index(object); ; i = (i + 1) & (hash_table_size - 1)) {
+		hash_entry_t *entry = &hash_table[i];
+		if (entry->object == object || entry->object == NULL)
+			return entry;
+	}
+}
+
+/**
+ * Rebuilds the identity hash table, @p update returns the new address of an
+ * object or NULL if it died.
+ */
+static void rehash_identity_hashes(java_lang_Object *(*update)(java_lang_Object*))
+{
+	hash_entry_t *old_table = hash_table;
+	size_t        old_size  = hash_table_size;
+	size_t        new_size  = 64;
+	while (new_size < 4 * n_hashes)
+		new_size *= 2;
+
+	hash_table      = calloc(new_size, sizeof(hash_table[0]));
+	hash_table_size = new_size;
+	n_hashes        = 0;
+	if (hash_table == NULL) {
+		fprintf(stderr, "panic: out of memory\n");
+		abort();
+	}
+	for (size_t i = 0; i < old_size; ++i) {
+		java_lang_Object *object = old_table[i].object;
+		if (object == NULL)
+			continue;
+		if (update != NULL)
+			object = update(object);
+		if (object == NULL)
+			continue;
+		hash_entry_t *entry = find_hash_entry(object);
+		entry->object = object;
+		entry->hash   = old_table[i].hash;
+		++n_hashes;
+	}
+	free(old_table);
+}
+
+static java_lang_Object *update_after_minor(java_lang_Object *object)
+{
+	chunk_t *chunk = heap_find_chunk(object);
+	if (chunk == NULL || !chunk->young)
+		return object;
+	if (is_forwarded(object))
+		return get_forwardee(object);
+	if (test_bit(chunk->mark_bits, granule_index(chunk, object)))
+		return object;
+	return NULL;
+}
+
+static java_lang_Object *update_after_major(java_lang_Object *object)
+{
+	/* classes and string constants live outside the heap */
+	chunk_t *chunk = heap_find_chunk(object);
+	if (chunk != NULL
+	    && !test_bit(chunk->mark_bits, granule_index(chunk, object)))
+		return NULL;
+	return object;
+}
+
+static jint identity_hash(java_lang_Object *object)
+{
+	if (n_hashes > 0) {
+		hash_entry_t *entry = find_hash_entry(object);
+		if (entry->object != NULL)
+			return entry->hash;
+	}
+
+	jint     hash  = (jint)((intptr_t)object >> 3);
+	chunk_t *chunk = heap_find_chunk(object);
+	if (chunk != NULL && chunk->young) {
+		/* remember the hash, the address changes when it is promoted */
+		if (4 * (n_hashes + 1) > 3 * hash_table_size)
+			rehash_identity_hashes(NULL);
+		hash_entry_t *entry = find_hash_entry(object);
+		entry->object = object;
+		entry->hash   = hash;
+		++n_hashes;
+	}
+	return hash;
+}
+
+jint gc_identity_hash(java_lang_Object *object)
+{
+	heap_lock();
+	jint hash = identity_hash(object);
+	heap_unlock();
+	return hash;
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000000u + (uint64_t)time.tv_nsec;
+}
+
+void gc_collect_minor(void)
+{
+	uint64_t start = now_ns();
+
+	retire_tlabs();
+	for (chunk_t *chunk = heap_nursery; chunk != NULL; chunk = chunk->next) {
+		find_object_starts(chunk);
+	}
+
+	/* pin first, an ambiguous reference can't be updated after a copy */
+	for (chunk_t *chunk = heap_nursery; chunk != NULL; chunk = chunk->next) {
+		scan_conservative_objects(chunk);
+	}
+	scan_ambiguous_roots(&pin_visitor);
+	scan_dirty_cards(&pin_visitor, false);
+
+	if (_Jv_static_roots != NULL)
+		scan_static_roots(&forward_visitor);
+	scan_dirty_cards(&forward_visitor, true);
+	process_mark_stack(&forward_visitor);
+
+	if (n_hashes > 0)
+		rehash_identity_hashes(update_after_minor);
+	monitor_update_objects(update_after_minor);
+
+	for (chunk_t *chunk = heap_nursery, *next; chunk != NULL; chunk = next) {
+		next = chunk->next;
+		if (chunk->pinned) {
+			uint64_t dead = 0;
+			heap_tenure_nursery_chunk(chunk);
+			heap_stats.bytes_pinned += sweep_chunk(chunk, &dead);
+		} else {
+			heap_reset_nursery_chunk(chunk);
+		}
+	}
+	heap_finish_promotion();
+
+	uint64_t pause = now_ns() - start;
+	heap_stats.minor_collections++;
+	heap_stats.minor_pause_ns += pause;
+	if (pause > heap_stats.max_minor_pause_ns)
+		heap_stats.max_minor_pause_ns = pause;
+}
+
+void gc_tenure_nursery(void)
+{
+	retire_tlabs();
+	for (chunk_t *chunk = heap_nursery, *next; chunk != NULL; chunk = next) {
+		next = chunk->next;
+		find_object_starts(chunk);
+		heap_tenure_nursery_chunk(chunk);
+	}
+}
+
+void gc_collect_major(void)
+{
+	uint64_t start = now_ns();
+
+	scan_ambiguous_roots(&mark_visitor);
+	if (_Jv_static_roots != NULL)
+		scan_static_roots(&mark_visitor);
+	process_mark_stack(&mark_visitor);
+
+	if (n_hashes > 0)
+		rehash_identity_hashes(update_after_major);
+	monitor_update_objects(update_after_major);
+	sweep();
+
+	uint64_t pause = now_ns() - start;
+	heap_stats.collections++;
+	heap_stats.pause_ns += pause;
+	if (pause > heap_stats.max_pause_ns)
+		heap_stats.max_pause_ns = pause;
+}
+
+void _Jv_Safepoint(void)
+{
+	/* SAFEPOINT_COLLECT concerns all threads, the collector clears it */
+	int requested = __atomic_fetch_and(&_Jv_safepoint_requested,
+	                                   ~SAFEPOINT_INFLATE, __ATOMIC_ACQUIRE);
+	if (requested & SAFEPOINT_INFLATE)
+		monitor_inflate_requested();
+	if (requested & SAFEPOINT_COLLECT)
+		thread_stop_for_collection();
+}
@@ -0,0 +1,789 @@
+#define _GNU_SOURCE
+#include "heap.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "threads.h"
+
+#define CHUNK_HEADER_SIZE  heap_align(sizeof(chunk_t))
+#define PAGE_SIZE          4096
+
+/* collect the old generation at least once this much was put into it */
+#define DEFAULT_HEAP_MIN   (8 * 1024 * 1024)
+#define DEFAULT_NURSERY    (4 * 1024 * 1024)
+
+/* address space reserved for the heap unless SIMPLERT_HEAP_MAX is given */
+#if UINTPTR_MAX > 0xFFFFFFFFu
+#define DEFAULT_RESERVATION ((size_t)64 << 30)
+#else
+#define DEFAULT_RESERVATION ((size_t)1 << 30)
+#endif
+
+/*
+ * Free cells of the old generation are kept in size segregated lists, list
+ * i holds the cells of size [HEAP_MIN_TLAB << i, HEAP_MIN_TLAB << (i+1)).
+ * Smaller cells are not listed, they are reclaimed when the collector
+ * coalesces them with their neighbours.
+ */
+#define N_SIZE_CLASSES     32
+
+/*
+ * The heap has two generations. New objects up to HEAP_LARGE_OBJECT bytes
+ * are bump allocated in the nursery, a few chunks which are emptied by each
+ * minor collection: objects reachable from precise references are copied
+ * into the old generation, objects referenced from the stack (which is
+ * scanned conservatively) are pinned and their chunk becomes part of the
+ * old generation. The old generation is only collected by a major, non
+ * moving mark and sweep collection which runs once enough memory was
+ * promoted or allocated there (see gc.c).
+ *
+ * All chunks are placed in one reserved address range, so finding the chunk
+ * of an address and the card of the write barrier is simple arithmetic.
+ *
+ * Each thread bumps its own TLAB without synchronization. Everything else,
+ * refilling TLABs included, happens under the heap lock, and the thread
+ * holding it stops all others before it collects (see threads.h).
+ */
+
+extern java_lang_Class _ZN4java4lang6String6class$E;
+
+card_table_t  _Jv_card_table;
+chunk_t      *heap_chunks;
+chunk_t      *heap_nursery;
+chunk_t     **heap_chunk_map;
+heap_stats_t  heap_stats;
+vtable_t      heap_free_cell_vtable = {
+	NULL, (void*)GC_DESCR_FREE
+};
+vtable_t      heap_filler_vtable = {
+	NULL, (void*)((HEAP_GRANULE << 2) | GC_DESCR_FREE)
+};
+
+static size_t       n_slots;        /**< number of chunk sized slots */
+static chunk_t     *nursery_chunk;  /**< nursery chunk allocated from */
+static chunk_t     *old_chunk;      /**< chunk new old memory is carved from */
+static char        *promotion_top;
+static char        *promotion_end;
+static free_cell_t *free_lists[N_SIZE_CLASSES];
+static size_t       free_bytes;     /**< size of the cells on the lists */
+static size_t       heap_max_size = SIZE_MAX;
+static size_t       heap_min_size = DEFAULT_HEAP_MIN;
+static size_t       nursery_size  = DEFAULT_NURSERY;
+static size_t       old_allocated;  /**< bytes put into the old generation */
+static size_t       gc_trigger    = DEFAULT_HEAP_MIN;
+static bool         gc_enabled;
+
+static pthread_mutex_t heap_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void panic_out_of_memory(void)
+{
+	fprintf(stderr, "panic: out of memory\n");
+	abort();
+}
+
+size_t heap_object_size(const java_lang_Object *object)
+{
+	const vtable_t *vtable = object->vptr;
+	uintptr_t       descr  = (uintptr_t)vtable->gc_descr;
+	switch (gc_descr_tag(descr)) {
+	case GC_DESCR_ARRAY: {
+		const array_header_t *array = (const array_header_t*)object;
+		return heap_align(sizeof(array_header_t)
+		                  + (size_t)array->length * (descr >> 3));
+	}
+	case GC_DESCR_FREE:
+		if ((descr >> 2) != 0)
+			return descr >> 2;
+		return ((const free_cell_t*)object)->size;
+	default: {
+		size_t size = (size_t)vtable->rtti->size_in_bytes;
+		/* strings are the only objects of variable size */
+		if (vtable->rtti == &_ZN4java4lang6String6class$E)
+			size += string_inline_size((const java_lang_String*)object);
+		return heap_align(size);
+	}
+	}
+}
+
+static size_t card_index(const void *ptr)
+{
+	return (size_t)((const char*)ptr - _Jv_card_table.heap_base)
+	       >> HEAP_CARD_SHIFT;
+}
+
+void heap_mark_cards(const void *begin, size_t size)
+{
+	size_t offset = (size_t)((const char*)begin - _Jv_card_table.heap_base);
+	if (size == 0 || offset >= _Jv_card_table.heap_size)
+		return;
+	size_t first = card_index(begin);
+	size_t last  = card_index((const char*)begin + size - 1);
+	memset(&_Jv_card_table.cards[first], 1, last - first + 1);
+}
+
+static void clear_cards(const char *begin, const char *end)
+{
+	if (begin >= end)
+		return;
+	size_t first = card_index(begin);
+	size_t last  = card_index(end - 1);
+	memset(&_Jv_card_table.cards[first], 0, last - first + 1);
+}
+
+static unsigned size_class(size_t size)
+{
+	assert(size >= HEAP_MIN_TLAB);
+	unsigned cls = 0;
+	for (size_t s = size / HEAP_MIN_TLAB; s > 1 && cls < N_SIZE_CLASSES-1;
+	     s >>= 1) {
+		++cls;
+	}
+	return cls;
+}
+
+/** Writes the header of a free cell, which keeps the chunk walkable. */
+static void format_free(char *begin, size_t size)
+{
+	if (size == HEAP_GRANULE) {
+		((java_lang_Object*)begin)->vptr = &heap_filler_vtable;
+		return;
+	}
+	free_cell_t *cell = (free_cell_t*)begin;
+	cell->vptr = &heap_free_cell_vtable;
+	cell->size = size;
+}
+
+void heap_add_free(char *begin, size_t size)
+{
+	assert(size > 0 && size % HEAP_GRANULE == 0);
+	format_free(begin, size);
+
+	/* the nursery is emptied by the next minor collection anyway */
+	chunk_t *chunk = heap_find_chunk(begin);
+	assert(chunk != NULL);
+	if (chunk->young)
+		return;
+
+	set_bit(chunk->start_bits, granule_index(chunk, begin));
+	if (size < HEAP_MIN_TLAB)
+		return;
+
+	free_cell_t *cell = (free_cell_t*)begin;
+	unsigned     cls  = size_class(size);
+	cell->next       = free_lists[cls];
+	free_lists[cls]  = cell;
+	free_bytes      += size;
+}
+
+void heap_clear_free_lists(void)
+{
+	memset(free_lists, 0, sizeof(free_lists));
+	free_bytes = 0;
+}
+
+static free_cell_t *take_free_cell(size_t size)
+{
+	unsigned cls = size_class(size);
+
+	/* first fit in the class of the requested size */
+	for (free_cell_t **anchor = &free_lists[cls]; *anchor != NULL;
+	     anchor = &(*anchor)->next) {
+		free_cell_t *cell = *anchor;
+		if (cell->size >= size) {
+			*anchor     = cell->next;
+			free_bytes -= cell->size;
+			return cell;
+		}
+	}
+
+	/* every cell of a bigger class fits */
+	for (++cls; cls < N_SIZE_CLASSES; ++cls) {
+		free_cell_t *cell = free_lists[cls];
+		if (cell != NULL) {
+			free_lists[cls] = cell->next;
+			free_bytes     -= cell->size;
+			return cell;
+		}
+	}
+	return NULL;
+}
+
+/** Returns the index of the first of @p n consecutive free slots. */
+static size_t find_slots(size_t n)
+{
+	for (size_t i = 0; i + n <= n_slots; ) {
+		size_t j = 0;
+		while (j < n && heap_chunk_map[i + j] == NULL)
+			++j;
+		if (j == n)
+			return i;
+		i += j + 1;
+	}
+	return SIZE_MAX;
+}
+
+static chunk_t *new_chunk(size_t size, bool large, bool young)
+{
+	if (size > heap_max_size - heap_stats.heap_size)
+		return NULL;
+	size_t n    = (size + HEAP_CHUNK_SIZE-1) / HEAP_CHUNK_SIZE;
+	size_t slot = find_slots(n);
+	if (slot == SIZE_MAX)
+		return NULL;
+
+	/* anonymous mappings are zeroed which saves us clearing new memory */
+	char *addr = _Jv_card_table.heap_base + slot * HEAP_CHUNK_SIZE;
+	void *mem  = mmap(addr, size, PROT_READ | PROT_WRITE,
+	                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+	if (mem == MAP_FAILED)
+		return NULL;
+
+	chunk_t *chunk = (chunk_t*)mem;
+	chunk->begin      = (char*)mem + CHUNK_HEADER_SIZE;
+	chunk->free       = chunk->begin;
+	chunk->end        = (char*)mem + size;
+	chunk->large      = large;
+	chunk->young      = young;
+	chunk->pinned     = false;
+	chunk->mark_bits  = calloc(1, chunk_bitmap_size(chunk));
+	chunk->start_bits = calloc(1, chunk_bitmap_size(chunk));
+	if (chunk->mark_bits == NULL || chunk->start_bits == NULL)
+		panic_out_of_memory();
+	if (young) {
+		chunk->next  = heap_nursery;
+		heap_nursery = chunk;
+	} else {
+		chunk->next  = heap_chunks;
+		heap_chunks  = chunk;
+	}
+	for (size_t i = 0; i < n; ++i) {
+		heap_chunk_map[slot + i] = chunk;
+	}
+
+	heap_stats.heap_size += size;
+	if (heap_stats.heap_size > heap_stats.max_heap_size)
+		heap_stats.max_heap_size = heap_stats.heap_size;
+	return chunk;
+}
+
+void heap_release_chunk(chunk_t *chunk)
+{
+	if (chunk == old_chunk)
+		old_chunk = NULL;
+
+	size_t size = (size_t)(chunk->end - (char*)chunk);
+	size_t slot = (size_t)((char*)chunk - _Jv_card_table.heap_base)
+	              / HEAP_CHUNK_SIZE;
+	for (size_t i = 0; i < (size + HEAP_CHUNK_SIZE-1) / HEAP_CHUNK_SIZE; ++i) {
+		heap_chunk_map[slot + i] = NULL;
+	}
+	clear_cards(chunk->begin, chunk->free);
+	free(chunk->mark_bits);
+	free(chunk->start_bits);
+	/* give the memory back but keep the address range reserved */
+	mmap(chunk, size, PROT_NONE,
+	     MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE, -1, 0);
+	heap_stats.heap_size -= size;
+}
+
+void heap_reset_nursery_chunk(chunk_t *chunk)
+{
+	/* the memory is zeroed again when it is handed out */
+	clear_cards(chunk->begin, chunk->free);
+	chunk->free   = chunk->begin;
+	chunk->pinned = false;
+}
+
+void heap_tenure_nursery_chunk(chunk_t *chunk)
+{
+	chunk_t **anchor = &heap_nursery;
+	while (*anchor != chunk)
+		anchor = &(*anchor)->next;
+	*anchor = chunk->next;
+	if (chunk == nursery_chunk)
+		nursery_chunk = NULL;
+
+	chunk->young  = false;
+	chunk->pinned = false;
+	chunk->next   = heap_chunks;
+	heap_chunks   = chunk;
+	clear_cards(chunk->begin, chunk->free);
+	old_allocated += (size_t)(chunk->free - chunk->begin);
+}
+
+void heap_retire_tlab(tlab_t *tlab)
+{
+	size_t rest = (size_t)(tlab->end - tlab->top);
+	if (rest > 0) {
+		chunk_t *chunk = heap_find_chunk(tlab->top);
+		if (chunk->free == tlab->end) {
+			/* the rest is the end of the chunk, simply hand it back */
+			chunk->free = tlab->top;
+		} else {
+			heap_add_free(tlab->top, rest);
+		}
+		heap_stats.bytes_allocated   -= rest;
+		heap_stats.nursery_allocated -= rest;
+	}
+	tlab->top = NULL;
+	tlab->end = NULL;
+}
+
+/**
+ * Tops the nursery up to its configured size. Near the heap limit it is kept
+ * smaller, there must be room to promote everything it holds.
+ */
+static void refill_nursery(void)
+{
+	size_t size = 0;
+	for (chunk_t *chunk = heap_nursery; chunk != NULL; chunk = chunk->next) {
+		size += (size_t)(chunk->end - (char*)chunk);
+	}
+	for ( ; size < nursery_size; size += HEAP_CHUNK_SIZE) {
+		if (heap_max_size - heap_stats.heap_size < nursery_size + HEAP_CHUNK_SIZE)
+			break;
+		if (new_chunk(HEAP_CHUNK_SIZE, false, true) == NULL)
+			break;
+	}
+	nursery_chunk = heap_nursery;
+}
+
+/** Returns true if the old generation might not fit the nursery survivors. */
+static bool promotion_may_fail(void)
+{
+	if (heap_max_size == SIZE_MAX)
+		return false;
+	size_t used = 0;
+	for (chunk_t *chunk = heap_nursery; chunk != NULL; chunk = chunk->next) {
+		used += (size_t)(chunk->free - chunk->begin);
+	}
+	size_t available = heap_max_size - heap_stats.heap_size + free_bytes;
+	if (old_chunk != NULL)
+		available += (size_t)(old_chunk->end - old_chunk->free);
+	/* leave some slack for fragmentation */
+	return available < used + HEAP_CHUNK_SIZE;
+}
+
+void gc_collect(void)
+{
+	/* without room to copy the nursery is collected in place */
+	if (promotion_may_fail()) {
+		gc_tenure_nursery();
+	} else {
+		gc_collect_minor();
+	}
+	gc_collect_major();
+	refill_nursery();
+	old_allocated = 0;
+	gc_trigger    = heap_stats.live_bytes > heap_min_size
+	              ? heap_stats.live_bytes : heap_min_size;
+}
+
+static void collect_full(void)
+{
+	threads_stop_world();
+	gc_collect();
+	threads_resume_world();
+}
+
+static void collect_minor(void)
+{
+	threads_stop_world();
+	if (old_allocated >= gc_trigger || promotion_may_fail()) {
+		gc_collect();
+	} else {
+		gc_collect_minor();
+		refill_nursery();
+		if (old_allocated >= gc_trigger)
+			gc_collect();
+	}
+	threads_resume_world();
+}
+
+/**
+ * Returns memory of at least @p min_size and at most @p want_size bytes in
+ * the old generation, taken from the free lists or from the unused part of
+ * a chunk. The memory is zeroed if @p zero is set.
+ */
+static char *find_memory(size_t min_size, size_t want_size, size_t *size,
+                         bool zero)
+{
+	free_cell_t *cell = take_free_cell(min_size);
+	if (cell != NULL) {
+		char   *result    = (char*)cell;
+		size_t  cell_size = cell->size;
+		if (cell_size > want_size) {
+			heap_add_free(result + want_size, cell_size - want_size);
+			cell_size = want_size;
+		}
+		if (zero)
+			memset(result, 0, cell_size);
+		*size = cell_size;
+		return result;
+	}
+
+	chunk_t *chunk = old_chunk;
+	if (chunk == NULL || (size_t)(chunk->end - chunk->free) < min_size) {
+		/* the rest of the old chunk stays unused */
+		chunk = new_chunk(HEAP_CHUNK_SIZE, false, false);
+		if (chunk == NULL)
+			return NULL;
+		old_chunk = chunk;
+	}
+	size_t available = (size_t)(chunk->end - chunk->free);
+	char  *result    = chunk->free;
+	*size        = available < want_size ? available : want_size;
+	chunk->free += *size;
+	set_bit(chunk->start_bits, granule_index(chunk, result));
+	return result;
+}
+
+static void account(size_t size)
+{
+	heap_stats.bytes_allocated += size;
+}
+
+static char *alloc_old(size_t size, bool zero)
+{
+	if (gc_enabled && old_allocated >= gc_trigger)
+		collect_full();
+
+	size_t min_size = size > HEAP_MIN_TLAB ? size : HEAP_MIN_TLAB;
+	size_t got;
+	char  *result   = find_memory(min_size, size, &got, zero);
+	if (result == NULL && gc_enabled) {
+		collect_full();
+		result = find_memory(min_size, size, &got, zero);
+	}
+	if (result == NULL)
+		panic_out_of_memory();
+	assert(got == size);
+	old_allocated += size;
+	account(size);
+	return result;
+}
+
+static void *alloc_huge(size_t size)
+{
+	if (size > SIZE_MAX - CHUNK_HEADER_SIZE - PAGE_SIZE)
+		panic_out_of_memory();
+	size_t chunk_size = (CHUNK_HEADER_SIZE + size + PAGE_SIZE-1)
+	                  & ~(size_t)(PAGE_SIZE-1);
+
+	if (gc_enabled && old_allocated >= gc_trigger)
+		collect_full();
+
+	chunk_t *chunk = new_chunk(chunk_size, true, false);
+	if (chunk == NULL && gc_enabled) {
+		collect_full();
+		chunk = new_chunk(chunk_size, true, false);
+	}
+	if (chunk == NULL)
+		panic_out_of_memory();
+
+	chunk->free = chunk->begin + size;
+	set_bit(chunk->start_bits, 0);
+	old_allocated += size;
+	account(size);
+	return chunk->begin;
+}
+
+/**
+ * Carves memory from the nursery, see find_memory. Nursery chunks are not
+ * cleared when they are reset, the memory is zeroed here if @p zero is set.
+ */
+static char *find_nursery_memory(size_t min_size, size_t want_size,
+                                 size_t *size, bool zero)
+{
+	for (chunk_t *chunk = nursery_chunk; chunk != NULL; chunk = chunk->next) {
+		size_t available = (size_t)(chunk->end - chunk->free);
+		if (available < min_size)
+			continue;
+		nursery_chunk = chunk;
+		char *result  = chunk->free;
+		*size        = available < want_size ? available : want_size;
+		chunk->free += *size;
+		if (zero)
+			memset(result, 0, *size);
+		return result;
+	}
+	return NULL;
+}
+
+static char *alloc_young(size_t min_size, size_t want_size, size_t *size,
+                         bool zero)
+{
+	/* near the heap limit the nursery may be gone completely */
+	char *result = find_nursery_memory(min_size, want_size, size, zero);
+	if (result == NULL && gc_enabled && heap_nursery != NULL) {
+		collect_minor();
+		result = find_nursery_memory(min_size, want_size, size, zero);
+	}
+	if (result != NULL) {
+		heap_stats.nursery_allocated += *size;
+		account(*size);
+	}
+	return result;
+}
+
+/**
+ * Allocates an object of nursery size in the old generation when the
+ * nursery is exhausted at the heap limit. The compiled code initializes
+ * such objects without write barrier, so their cards are dirtied here.
+ */
+static void *alloc_tenured(size_t size, bool zero)
+{
+	char *result = alloc_old(size, zero);
+	heap_mark_cards(result, size);
+	return result;
+}
+
+static void *alloc_slow(tlab_t *tlab, size_t size, bool zero)
+{
+	if (size > HEAP_HUGE_OBJECT)
+		return alloc_huge(size);
+	if (size > HEAP_LARGE_OBJECT)
+		return alloc_old(size, zero);
+
+	size_t got;
+	if (size > HEAP_MEDIUM_OBJECT) {
+		char *result = alloc_young(size, size, &got, zero);
+		return result != NULL ? result : alloc_tenured(size, zero);
+	}
+
+	/* the TLAB is always zeroed, the inline fast paths rely on it */
+	heap_retire_tlab(tlab);
+	size_t min_size = size > HEAP_MIN_TLAB ? size : HEAP_MIN_TLAB;
+	char  *buffer   = alloc_young(min_size, HEAP_TLAB_SIZE, &got, true);
+	if (buffer == NULL)
+		return alloc_tenured(size, zero);
+	tlab->top = buffer + size;
+	tlab->end = buffer + got;
+	return buffer;
+}
+
+static void *alloc_object(size_t size, bool zero)
+{
+	size = heap_align(size);
+
+	tlab_t *tlab = &_Jv_tlab;
+	if (__builtin_expect((size_t)(tlab->end - tlab->top) >= size, true)) {
+		char *result = tlab->top;
+		tlab->top += size;
+		return result;
+	}
+
+	heap_lock();
+	void *result = alloc_slow(tlab, size, zero);
+	heap_unlock();
+	return result;
+}
+
+void *heap_alloc(size_t size)
+{
+	return alloc_object(size, true);
+}
+
+void *heap_alloc_uninitialized(size_t size)
+{
+	return alloc_object(size, false);
+}
+
+/** Records the starts of the objects in [begin, begin+size) if it is old. */
+static void add_object_starts(char *begin, size_t size)
+{
+	chunk_t *chunk = heap_find_chunk(begin);
+	if (chunk->young)
+		return;
+	/* references may point to any of the objects now */
+	chunk->large = false;
+	for (char *p = begin; p < begin + size; ) {
+		set_bit(chunk->start_bits, granule_index(chunk, p));
+		p += heap_object_size((java_lang_Object*)p);
+	}
+}
+
+void *heap_alloc_objects(size_t size, heap_format_func format, void *env)
+{
+	size = heap_align(size);
+
+	tlab_t *tlab = &_Jv_tlab;
+	if ((size_t)(tlab->end - tlab->top) >= size) {
+		char *result = tlab->top;
+		tlab->top += size;
+		format(result, env);
+		return result;
+	}
+
+	/* the collector must not see the memory before it is formatted */
+	heap_lock();
+	char *result = alloc_slow(tlab, size, true);
+	format(result, env);
+	add_object_starts(result, size);
+	heap_unlock();
+	return result;
+}
+
+void *heap_alloc_promoted(size_t size)
+{
+	if ((size_t)(promotion_end - promotion_top) < size) {
+		heap_finish_promotion();
+
+		size_t min_size  = size > HEAP_MIN_TLAB ? size : HEAP_MIN_TLAB;
+		size_t want_size = size > HEAP_TLAB_SIZE ? size : HEAP_TLAB_SIZE;
+		size_t got;
+		/* we are inside of a collection, there is no way to make room */
+		char *buffer = find_memory(min_size, want_size, &got, false);
+		if (buffer == NULL)
+			panic_out_of_memory();
+		format_free(buffer, got);
+		promotion_top = buffer;
+		promotion_end = buffer + got;
+	}
+
+	/* keep the rest of the buffer walkable for the card scanning */
+	char  *result = promotion_top;
+	size_t rest   = (size_t)(promotion_end - result) - size;
+	promotion_top += size;
+	if (rest > 0) {
+		chunk_t *chunk = heap_find_chunk(promotion_top);
+		format_free(promotion_top, rest);
+		set_bit(chunk->start_bits, granule_index(chunk, promotion_top));
+	}
+	old_allocated += size;
+	return result;
+}
+
+void heap_finish_promotion(void)
+{
+	size_t rest = (size_t)(promotion_end - promotion_top);
+	if (rest > 0)
+		heap_add_free(promotion_top, rest);
+	promotion_top = NULL;
+	promotion_end = NULL;
+}
+
+static size_t parse_size(const char *name, size_t default_size)
+{
+	const char *value = getenv(name);
+	if (value == NULL)
+		return default_size;
+
+	char               *end;
+	unsigned long long  size = strtoull(value, &end, 10);
+	switch (*end) {
+	case 'k': case 'K': size <<= 10; ++end; break;
+	case 'm': case 'M': size <<= 20; ++end; break;
+	case 'g': case 'G': size <<= 30; ++end; break;
+	default: break;
+	}
+	if (end == value || *end != '\0' || size > SIZE_MAX) {
+		fprintf(stderr, "invalid size '%s' in %s\n", value, name);
+		exit(1);
+	}
+	return (size_t)size;
+}
+
+static void print_heap_stats(void)
+{
+	const heap_stats_t *stats = &heap_stats;
+	uint64_t survived = stats->bytes_promoted + stats->bytes_pinned;
+	double   rate     = stats->nursery_allocated > 0
+	                  ? 100.0 * survived / stats->nursery_allocated : 0.0;
+	fprintf(stderr, "gc: %u minor collections, %.3f ms total pause, %.3f ms max pause\n",
+	        stats->minor_collections, stats->minor_pause_ns / 1e6,
+	        stats->max_minor_pause_ns / 1e6);
+	fprintf(stderr, "gc: %llu bytes promoted in %llu objects, %llu bytes pinned, %.2f%% of the nursery allocations survived\n",
+	        (unsigned long long)stats->bytes_promoted,
+	        (unsigned long long)stats->objects_promoted,
+	        (unsigned long long)stats->bytes_pinned, rate);
+	fprintf(stderr, "gc: %u major collections, %.3f ms total pause, %.3f ms max pause\n",
+	        stats->collections, stats->pause_ns / 1e6,
+	        stats->max_pause_ns / 1e6);
+	fprintf(stderr, "gc: %llu bytes allocated, %llu bytes freed, %zu bytes live after last collection\n",
+	        (unsigned long long)stats->bytes_allocated,
+	        (unsigned long long)stats->bytes_freed, stats->live_bytes);
+	fprintf(stderr, "gc: heap size %zu KiB (max %zu KiB)\n",
+	        stats->heap_size / 1024, stats->max_heap_size / 1024);
+}
+
+/**
+ * Reserves the address range of the heap (without committing any memory)
+ * and sets up the card table and chunk map covering it.
+ */
+static void reserve_heap(size_t size)
+{
+	char *mem;
+	for (;;) {
+		size = size / HEAP_CHUNK_SIZE * HEAP_CHUNK_SIZE;
+		if (size < 16 * HEAP_CHUNK_SIZE)
+			panic_out_of_memory();
+		mem = mmap(NULL, size + HEAP_CHUNK_SIZE, PROT_NONE,
+		           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (mem != MAP_FAILED)
+			break;
+		size /= 2;
+	}
+
+	/* chunks are aligned to their size */
+	char *base = (char*)(((uintptr_t)mem + HEAP_CHUNK_SIZE-1)
+	                     & ~(uintptr_t)(HEAP_CHUNK_SIZE-1));
+	if (base > mem)
+		munmap(mem, (size_t)(base - mem));
+	munmap(base + size, HEAP_CHUNK_SIZE - (size_t)(base - mem));
+
+	size_t   n_cards = (size >> HEAP_CARD_SHIFT) + 1;
+	uint8_t *cards   = mmap(NULL, n_cards, PROT_READ | PROT_WRITE,
+	                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+	                        -1, 0);
+	n_slots        = size / HEAP_CHUNK_SIZE;
+	heap_chunk_map = calloc(n_slots, sizeof(heap_chunk_map[0]));
+	if (cards == MAP_FAILED || heap_chunk_map == NULL)
+		panic_out_of_memory();
+
+	_Jv_card_table.heap_base = base;
+	_Jv_card_table.heap_size = size;
+	_Jv_card_table.cards     = cards;
+}
+
+static void wait_for_heap_lock(void *data)
+{
+	(void)data;
+	pthread_mutex_lock(&heap_mutex);
+}
+
+void heap_lock(void)
+{
+	if (pthread_mutex_trylock(&heap_mutex) != 0)
+		thread_blocking_call(wait_for_heap_lock, NULL);
+}
+
+void heap_unlock(void)
+{
+	pthread_mutex_unlock(&heap_mutex);
+}
+
+void heap_init(void)
+{
+	heap_max_size = parse_size("SIMPLERT_HEAP_MAX", SIZE_MAX);
+	heap_min_size = parse_size("SIMPLERT_HEAP_MIN", DEFAULT_HEAP_MIN);
+	nursery_size  = parse_size("SIMPLERT_NURSERY_SIZE", DEFAULT_NURSERY);
+	gc_trigger    = heap_min_size;
+	if (getenv("SIMPLERT_GC_STATS") != NULL)
+		atexit(print_heap_stats);
+
+	/* leave room for fragmentation of the address range */
+	size_t reservation = DEFAULT_RESERVATION;
+	if (heap_max_size < reservation / 2)
+		reservation = 2 * heap_max_size + nursery_size + 16 * HEAP_CHUNK_SIZE;
+	reserve_heap(reservation);
+
+	refill_nursery();
+	gc_enabled = true;
+}
@@ -0,0 +1,310 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "types.h"
+
+/**
+ * All heap objects are aligned to and sized in multiples of this.
+ * The compiler emits the same rounding in its inline allocation fast path.
+ */
+#define HEAP_GRANULE       8
+/**
+ * Size of the chunks the heap requests from the operating system and
+ * alignment of all chunks.
+ */
+#define HEAP_CHUNK_SIZE    (1024 * 1024)
+/** Size of a thread local allocation buffer. */
+#define HEAP_TLAB_SIZE     (32 * 1024)
+/**
+ * Objects larger than this are allocated in the old generation directly,
+ * smaller ones in the nursery.
+ */
+#define HEAP_LARGE_OBJECT  (HEAP_TLAB_SIZE / 4)
+/** Nursery objects larger than this bypass the TLAB. */
+#define HEAP_MEDIUM_OBJECT (HEAP_TLAB_SIZE / 8)
+/** Objects larger than this get a chunk of their own. */
+#define HEAP_HUGE_OBJECT   (HEAP_CHUNK_SIZE / 4)
+/** Free cells smaller than this are not reused for allocation. */
+#define HEAP_MIN_TLAB      (2 * 1024)
+/** A card of the write barrier covers 1 << HEAP_CARD_SHIFT bytes. */
+#define HEAP_CARD_SHIFT    9
+
+#define heap_align(size) \
+	(((size) + (HEAP_GRANULE-1)) & ~(size_t)(HEAP_GRANULE-1))
+
+/*
+ * Encoding of vtable_t::gc_descr, the low two bits are a tag:
+ *  - GC_DESCR_CONSERVATIVE: no information, every word of the object is
+ *    treated as a potential reference. The size is taken from the rtti.
+ *  - GC_DESCR_BITMAP: bit i of (descr >> 2) is set if word i of the object
+ *    holds a reference. Emitted by the compiler for every class.
+ *  - GC_DESCR_ARRAY: an array, (descr >> 3) is the element size, bit 2 is
+ *    set if the elements are references.
+ *  - GC_DESCR_FREE: heap internal free cell, (descr >> 2) is the size or 0 if
+ *    the size is stored in the cell.
+ */
+#define GC_DESCR_CONSERVATIVE  0
+#define GC_DESCR_BITMAP        1
+#define GC_DESCR_ARRAY         2
+#define GC_DESCR_FREE          3
+
+#define gc_descr_tag(descr)    ((uintptr_t)(descr) & 3)
+#define gc_array_descr(elsize, is_ref) \
+	((void*)(((uintptr_t)(elsize) << 3) | ((is_ref) ? 4 : 0) | GC_DESCR_ARRAY))
+
+/**
+ * Thread local allocation buffer. Memory between top and end is zeroed and
+ * owned by the current thread, allocation is a simple pointer bump.
+ */
+typedef struct tlab_t {
+	char *top;
+	char *end;
+} tlab_t;
+
+/**
+ * The allocation buffer of the current thread. It is defined by the compiled
+ * program (see gcji_init) so the inline fast paths can use the cheapest TLS
+ * access model, the runtime only refills it.
+ */
+extern __thread tlab_t _Jv_tlab;
+
+/**
+ * NULL terminated table of the addresses of all static fields holding
+ * references, emitted by the compiler (see gcji_create_static_roots). If it
+ * is missing, the data segments are scanned conservatively instead.
+ */
+extern java_lang_Object **const _Jv_static_roots[] __attribute__((weak));
+
+/**
+ * Polled by the compiled code on loop backedges and before returns,
+ * _Jv_Safepoint is called when it is non-zero. It is a set of the
+ * SAFEPOINT_ bits.
+ */
+extern volatile int _Jv_safepoint_requested;
+
+enum {
+	SAFEPOINT_COLLECT = 1 << 0,  /**< stop for a collection, see threads.h */
+	SAFEPOINT_INFLATE = 1 << 1   /**< see monitor_inflate_requested */
+};
+
+void _Jv_Safepoint(void);
+
+/**
+ * Card table of the generational write barrier. All chunks live in one
+ * reserved address range starting at heap_base, a reference store into it
+ * sets the card byte of the stored-to address so minor collections find
+ * old-to-young pointers without scanning the old generation. There is an
+ * extra card at index heap_size >> HEAP_CARD_SHIFT which absorbs stores
+ * outside of the heap, the compiled barrier (see gcji_insert_card_marks)
+ * clamps to it instead of branching.
+ */
+typedef struct card_table_t {
+	char    *heap_base;
+	size_t   heap_size;
+	uint8_t *cards;
+} card_table_t;
+
+extern card_table_t _Jv_card_table;
+
+/** Write barrier for a reference store to @p slot done by the runtime. */
+static inline void heap_mark_card(const void *slot)
+{
+	size_t offset = (size_t)((const char*)slot - _Jv_card_table.heap_base);
+	if (offset < _Jv_card_table.heap_size)
+		_Jv_card_table.cards[offset >> HEAP_CARD_SHIFT] = 1;
+}
+
+/** Write barrier for reference stores to [begin, begin+size). */
+void heap_mark_cards(const void *begin, size_t size);
+
+/**
+ * A chunk of heap memory. Everything between begin and free is a sequence
+ * of objects and free cells, which allows the collector to walk it.
+ */
+typedef struct chunk_t chunk_t;
+struct chunk_t {
+	chunk_t  *next;
+	char     *begin;
+	char     *free;       /**< start of the part not yet handed out */
+	char     *end;
+	bool      large;      /**< chunk holds a single large object */
+	bool      young;      /**< chunk belongs to the nursery */
+	bool      pinned;     /**< young chunk holding objects that can't move */
+	uint8_t  *mark_bits;  /**< one bit per granule */
+	/**
+	 * one bit per granule, kept up to date in the old generation and
+	 * computed by minor collections for the nursery
+	 */
+	uint8_t  *start_bits;
+};
+
+/** Size in bytes of the mark and start bitmaps of @p chunk. */
+#define chunk_bitmap_size(chunk) \
+	(((size_t)((chunk)->end - (chunk)->begin) / HEAP_GRANULE + 7) / 8)
+
+/** Header of unused memory inside a chunk. */
+typedef struct free_cell_t free_cell_t;
+struct free_cell_t {
+	vtable_t    *vptr;
+	size_t       size;
+	free_cell_t *next;  /**< only present in cells on a free list */
+};
+
+typedef struct heap_stats_t {
+	unsigned collections;
+	uint64_t pause_ns;
+	uint64_t max_pause_ns;
+	unsigned minor_collections;
+	uint64_t minor_pause_ns;
+	uint64_t max_minor_pause_ns;
+	uint64_t bytes_allocated;
+	uint64_t nursery_allocated;  /**< bytes allocated in the nursery */
+	uint64_t bytes_promoted;
+	uint64_t objects_promoted;
+	uint64_t bytes_pinned;
+	uint64_t bytes_freed;
+	size_t   heap_size;
+	size_t   max_heap_size;
+	size_t   live_bytes;
+} heap_stats_t;
+
+extern chunk_t      *heap_chunks;     /**< chunks of the old generation */
+extern chunk_t      *heap_nursery;    /**< chunks of the nursery */
+extern chunk_t     **heap_chunk_map;  /**< chunk of each chunk sized slot */
+extern heap_stats_t  heap_stats;
+extern vtable_t      heap_free_cell_vtable;
+extern vtable_t      heap_filler_vtable;
+
+/** Returns the chunk whose used part contains @p ptr or NULL. */
+static inline chunk_t *heap_find_chunk(const void *ptr)
+{
+	size_t offset = (size_t)((const char*)ptr - _Jv_card_table.heap_base);
+	if (offset >= _Jv_card_table.heap_size)
+		return NULL;
+	chunk_t *chunk = heap_chunk_map[offset / HEAP_CHUNK_SIZE];
+	if (chunk == NULL || (const char*)ptr < chunk->begin
+	    || (const char*)ptr >= chunk->free)
+		return NULL;
+	return chunk;
+}
+
+static inline size_t granule_index(const chunk_t *chunk, const void *ptr)
+{
+	return (size_t)((const char*)ptr - chunk->begin) / HEAP_GRANULE;
+}
+
+static inline bool test_bit(const uint8_t *bits, size_t idx)
+{
+	return (bits[idx / 8] & (1u << (idx % 8))) != 0;
+}
+
+static inline void set_bit(uint8_t *bits, size_t idx)
+{
+	bits[idx / 8] |= 1u << (idx % 8);
+}
+
+static inline void clear_bit(uint8_t *bits, size_t idx)
+{
+	bits[idx / 8] &= ~(1u << (idx % 8));
+}
+
+/** Initializes the heap, the threads must be set up already. */
+void heap_init(void);
+
+/**
+ * Serializes everything but the allocation from the TLABs. Waiting for the
+ * lock counts as blocked, the holder may be collecting.
+ */
+void heap_lock(void);
+void heap_unlock(void);
+
+/**
+ * Allocates @p size bytes of zeroed, granule aligned heap memory.
+ * Aborts if the heap limit is exceeded even after a collection.
+ */
+void *heap_alloc(size_t size);
+
+/**
+ * Like heap_alloc, but the memory is only zeroed if it comes from the TLAB.
+ * The caller has to overwrite everything the collector may look at.
+ */
+void *heap_alloc_uninitialized(size_t size);
+
+/** Writes the headers of the objects allocated by heap_alloc_objects. */
+typedef void (*heap_format_func)(char *begin, void *env);
+
+/**
+ * Allocates @p size bytes of zeroed heap memory for a sequence of objects,
+ * which @p format initializes before a collection can look at them. The
+ * collector treats them as separate objects afterwards.
+ */
+void *heap_alloc_objects(size_t size, heap_format_func format, void *env);
+
+/**
+ * Allocates uninitialized memory in the old generation for an object
+ * promoted by a minor collection. Aborts if the heap limit is exceeded.
+ */
+void *heap_alloc_promoted(size_t size);
+
+/** Returns the unused rest of the promotion buffer to the free lists. */
+void heap_finish_promotion(void);
+
+/** Returns the size of the heap object (or free cell) at @p object. */
+size_t heap_object_size(const java_lang_Object *object);
+
+/**
+ * Turns [begin, begin+size) into a free cell. Cells in the old generation
+ * are added to the free lists.
+ */
+void heap_add_free(char *begin, size_t size);
+
+/** Turns the unused rest of @p tlab into a free cell. */
+void heap_retire_tlab(tlab_t *tlab);
+
+/** Empties the free lists, the collector rebuilds them while sweeping. */
+void heap_clear_free_lists(void);
+
+/** Releases a chunk which contains no live objects anymore. */
+void heap_release_chunk(chunk_t *chunk);
+
+/** Makes a nursery chunk whose objects were all evacuated reusable. */
+void heap_reset_nursery_chunk(chunk_t *chunk);
+
+/**
+ * Moves the nursery chunk @p chunk to the old generation, its start bits
+ * must be valid.
+ */
+void heap_tenure_nursery_chunk(chunk_t *chunk);
+
+/** Promotes all live objects of the nursery to the old generation. */
+void gc_collect_minor(void);
+
+/**
+ * Runs a full collection of the old generation. Must only be called when
+ * the nursery is empty, right after gc_collect_minor or gc_tenure_nursery.
+ */
+void gc_collect_major(void);
+
+/**
+ * Moves all nursery chunks to the old generation without copying anything,
+ * used instead of gc_collect_minor when the old generation is too full.
+ */
+void gc_tenure_nursery(void);
+
+/**
+ * Runs a minor and a major collection. The caller holds the heap lock and
+ * has stopped the other threads (see threads_stop_world).
+ */
+void gc_collect(void);
+
+/**
+ * Returns the identity hash code of @p object, it does not change when the
+ * collector moves the object.
+ */
+jint gc_identity_hash(java_lang_Object *object);
+
+#endif
@@ -1,25 +1,89 @@
 #include "types.h"
 
+#include <pthread.h>
 #include <stdio.h>
 #include <stdbool.h>
 
+#include "exceptions.h"
+#include "threads.h"
+
 static const utf8_const clinit_name = { 0x0ea9, 8, { "<clinit>" } };
 static const utf8_const void_sig    = { 0x9b75, 3, { "()V"      } };
 
-void _Jv_InitClass(java_lang_Class *cls)
+/*
+ * Class initialization as in JLS 12.4.2: the first thread marks the class in
+ * progress and runs the initializers, other threads wait until it is done.
+ * Requests of the initializing thread itself, recursive or circular ones,
+ * return at once. If an initializer throws, the class becomes erroneous,
+ * the waiting threads and all later uses get a NoClassDefFoundError.
+ */
+static pthread_mutex_t init_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  init_done = PTHREAD_COND_INITIALIZER;
+
+typedef struct init_request_t {
+	java_lang_Class *cls;
+	thread_t        *self;
+	bool             run;   /**< the requesting thread has to initialize */
+} init_request_t;
+
+static void begin_init(void *data)
 {
-	// TODO: this probably fails for recursive dependent inits
+	init_request_t  *request = (init_request_t*)data;
+	java_lang_Class *cls     = request->cls;
+	pthread_mutex_lock(&init_lock);
+	while (cls->state == JV_STATE_IN_PROGRESS && cls->thread != request->self)
+		pthread_cond_wait(&init_done, &init_lock);
+	/* nothing to do if it is done, failed or in progress in this thread */
+	request->run = cls->state != JV_STATE_DONE
+	            && cls->state != JV_STATE_ERROR
+	            && cls->state != JV_STATE_IN_PROGRESS;
+	if (request->run) {
+		cls->state  = JV_STATE_IN_PROGRESS;
+		cls->thread = request->self;
+	}
+	pthread_mutex_unlock(&init_lock);
+}
 
-	if (__builtin_expect (cls->state == JV_STATE_DONE, true))
-		return;
-	cls->state = JV_STATE_DONE;
+static void run_initializers(void *data)
+{
+	java_lang_Class *cls        = (java_lang_Class*)data;
 	java_lang_Class *superclass = cls->superclass;
 	if (superclass != NULL)
 		_Jv_InitClass(superclass);
-	// search class init method
-	jv_method *init = get_method(cls, &clinit_name, &void_sig);
+	// search class init method, the one of the superclass already ran
+	jv_method *init = get_declared_method(cls, &clinit_name, &void_sig);
 	if (init != NULL) {
 		void(*initmethod)(void) = init->code;
 		initmethod();
 	}
 }
+
+void _Jv_InitClass(java_lang_Class *cls)
+{
+	if (__builtin_expect(__atomic_load_n(&cls->state, __ATOMIC_ACQUIRE)
+	                     == JV_STATE_DONE, true))
+		return;
+
+	/* waiting for another thread counts as blocked, its initializers may
+	 * allocate */
+	init_request_t request = { cls, thread_current(), false };
+	thread_blocking_call(begin_init, &request);
+	if (!request.run) {
+		if (__atomic_load_n(&cls->state, __ATOMIC_ACQUIRE) == JV_STATE_ERROR)
+			_Jv_ThrowNoClassDefFoundError();
+		return;
+	}
+
+	jobject exception = exceptions_call_catching(run_initializers, cls);
+
+	pthread_mutex_lock(&init_lock);
+	cls->thread = NULL;
+	__atomic_store_n(&cls->state,
+	                 exception == NULL ? JV_STATE_DONE : JV_STATE_ERROR,
+	                 __ATOMIC_RELEASE);
+	pthread_cond_broadcast(&init_done);
+	pthread_mutex_unlock(&init_lock);
+
+	if (exception != NULL)
+		exceptions_throw_initializer_failure(exception);
+}
@@ -0,0 +1,215 @@
+/*
+ * Decimal conversions of java.lang.Integer and Long. Formatting writes two
+ * digits per division from a table of all pairs, and splits 64 bit values
+ * into 32 bit chunks of eight digits first. Decimal parsing checks and
+ * converts eight digits at once within a 64 bit word (SWAR), a long has at
+ * most 19 digits, too few for the vector string kernels to pay off.
+ */
+#include "int_format.h"
+
+#include <string.h>
+
+static const char DIGIT_PAIRS[200] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static const uint64_t POW10[20] = {
+	1ULL,
+	10ULL,
+	100ULL,
+	1000ULL,
+	10000ULL,
+	100000ULL,
+	1000000ULL,
+	10000000ULL,
+	100000000ULL,
+	1000000000ULL,
+	10000000000ULL,
+	100000000000ULL,
+	1000000000000ULL,
+	10000000000000ULL,
+	100000000000000ULL,
+	1000000000000000ULL,
+	10000000000000000ULL,
+	100000000000000000ULL,
+	1000000000000000000ULL,
+	10000000000000000000ULL
+};
+
+unsigned count_decimal_digits(uint64_t value)
+{
+	/* floor(log10(2^bits)) is the number of digits or one less */
+	unsigned bits  = 64 - (unsigned)__builtin_clzll(value | 1);
+	unsigned guess = (bits * 1233) >> 12;
+	return guess + (value >= POW10[guess]) + (value == 0);
+}
+
+static char *write_pair(char *end, uint32_t pair)
+{
+	end -= 2;
+	memcpy(end, DIGIT_PAIRS + 2 * pair, 2);
+	return end;
+}
+
+/** Writes exactly eight digits of @p value including leading zeros. */
+static char *write_eight_digits(char *end, uint32_t value)
+{
+	for (int i = 0; i < 4; ++i) {
+		end    = write_pair(end, value % 100);
+		value /= 100;
+	}
+	return end;
+}
+
+char *write_decimal_digits(char *end, uint64_t value)
+{
+	/* 64 bit divisions are slower, split off the low eight digits */
+	while (value > UINT32_MAX) {
+		end    = write_eight_digits(end, (uint32_t)(value % 100000000));
+		value /= 100000000;
+	}
+	uint32_t low = (uint32_t)value;
+	while (low >= 100) {
+		end  = write_pair(end, low % 100);
+		low /= 100;
+	}
+	if (low >= 10)
+		return write_pair(end, low);
+	*--end = (char)('0' + low);
+	return end;
+}
+
+size_t format_long(char *buffer, int64_t value)
+{
+	uint64_t magnitude = value < 0 ? -(uint64_t)value : (uint64_t)value;
+	size_t   len       = count_decimal_digits(magnitude) + (value < 0);
+	write_decimal_digits(buffer + len, magnitude);
+	if (value < 0)
+		buffer[0] = '-';
+	return len;
+}
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+static uint64_t load_eight_chars(const char *chars)
+{
+	uint64_t word;
+	memcpy(&word, chars, sizeof(word));
+	return word;
+}
+
+/**
+ * Returns true if all bytes of @p word are '0' to '9': their high nibble is
+ * 3 and adding 6 does not carry into it.
+ */
+static bool is_eight_digits(uint64_t word)
+{
+	uint64_t high  = word & 0xF0F0F0F0F0F0F0F0ULL;
+	uint64_t carry = ((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL)
+	               >> 4;
+	return (high | carry) == 0x3333333333333333ULL;
+}
+
+/**
+ * Converts eight digit chars, the first one in the lowest byte, by
+ * combining neighbouring digits, then pairs, then quadruples.
+ */
+static uint32_t convert_eight_digits(uint64_t word)
+{
+	word -= 0x3030303030303030ULL;
+	word  = word * 10 + (word >> 8);
+	word  = ((word & 0x000000FF000000FFULL) * 0x000F424000000064ULL
+	      + ((word >> 16) & 0x000000FF000000FFULL) * 0x0000271000000001ULL)
+	      >> 32;
+	return (uint32_t)word;
+}
+#endif
+
+static bool parse_decimal(const char *chars, size_t len, uint64_t limit,
+                          uint64_t *result)
+{
+	/* leading zeros don't count towards the 19 digits which fit */
+	size_t i = 0;
+	while (i < len && chars[i] == '0')
+		++i;
+	if (len - i > 19)
+		return false;
+
+	uint64_t value = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	while (len - i >= 8) {
+		uint64_t word = load_eight_chars(chars + i);
+		if (!is_eight_digits(word))
+			return false;
+		value = value * 100000000 + convert_eight_digits(word);
+		i    += 8;
+	}
+#endif
+	for (; i < len; ++i) {
+		unsigned digit = (unsigned)(unsigned char)chars[i] - '0';
+		if (digit > 9)
+			return false;
+		value = value * 10 + digit;
+	}
+	if (value > limit)
+		return false;
+	*result = value;
+	return true;
+}
+
+static int digit_value(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	c |= 0x20; /* lower case */
+	if (c >= 'a' && c <= 'z')
+		return c - 'a' + 10;
+	return -1;
+}
+
+static bool parse_radix(const char *chars, size_t len, int radix,
+                        uint64_t limit, uint64_t *result)
+{
+	uint64_t value = 0;
+	for (size_t i = 0; i < len; ++i) {
+		int digit = digit_value(chars[i]);
+		if (digit < 0 || digit >= radix)
+			return false;
+		if (value > (limit - (uint64_t)digit) / (uint64_t)radix)
+			return false;
+		value = value * (uint64_t)radix + (uint64_t)digit;
+	}
+	*result = value;
+	return true;
+}
+
+bool parse_long(const char *chars, size_t len, int radix, int64_t min,
+                int64_t max, int64_t *result)
+{
+	if (radix < 2 || radix > 36 || len == 0)
+		return false;
+	bool negative = chars[0] == '-';
+	if (negative || chars[0] == '+') {
+		++chars;
+		--len;
+		if (len == 0)
+			return false;
+	}
+
+	uint64_t limit = negative ? -(uint64_t)min : (uint64_t)max;
+	uint64_t magnitude;
+	bool     valid = radix == 10
+	               ? parse_decimal(chars, len, limit, &magnitude)
+	               : parse_radix(chars, len, radix, limit, &magnitude);
+	if (!valid)
+		return false;
+	*result = negative ? (int64_t)-magnitude : (int64_t)magnitude;
+	return true;
+}
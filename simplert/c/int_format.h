@@ -0,0 +1,34 @@
+#ifndef INT_FORMAT_H
+#define INT_FORMAT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Buffer size needed by format_long, 19 digits and the sign. */
+#define LONG_FORMAT_SIZE 20
+
+/** Returns the number of decimal digits of @p value, 1 for 0. */
+unsigned count_decimal_digits(uint64_t value);
+
+/**
+ * Writes the decimal digits of @p value so that the last one is right
+ * before @p end, two digits per step. Returns the first digit.
+ */
+char *write_decimal_digits(char *end, uint64_t value);
+
+/**
+ * Writes @p value the way Long.toString does into @p buffer and returns the
+ * number of chars, no NUL is added.
+ */
+size_t format_long(char *buffer, int64_t value);
+
+/**
+ * Parses the chars @p chars the way Long.parseLong does: an optional sign
+ * followed by digits of @p radix, no whitespace. Returns false if they are
+ * malformed or the value is outside of [@p min, @p max].
+ */
+bool parse_long(const char *chars, size_t len, int radix, int64_t min,
+                int64_t max, int64_t *result);
+
+#endif
@@ -0,0 +1,420 @@
+/*
+ * Natives of java.io.FileInputStream, FileOutputStream and RandomAccessFile.
+ * Errors are reported as IO_ERROR, the Java side turns them into
+ * IOExceptions.
+ */
+#define _GNU_SOURCE
+#include "types.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "output.h"
+#include "threads.h"
+
+/** Size of the read buffer of unmapped input files. */
+#define INPUT_BUFFER_SIZE   (64 * 1024)
+/** Regular files at least this big are mapped instead of read. */
+#define FILE_MMAP_THRESHOLD (256 * 1024)
+
+enum {
+	IO_EOF   = -1,
+	IO_ERROR = -2
+};
+
+/**
+ * An open FileInputStream. Big regular files are mapped and read by copying
+ * from the mapping, the others are read into the buffer in large blocks.
+ * Reads that would fill the buffer anyway go straight into the Java array.
+ */
+typedef struct input_file_t {
+	int         fd;
+	const char *map;      /**< the mapped file or NULL */
+	size_t      map_size;
+	size_t      pos;      /**< next byte in map or buffer */
+	size_t      end;      /**< end of the data in map or buffer */
+	char        buffer[]; /**< only allocated if the file is not mapped */
+} input_file_t;
+
+static void *alloc_or_panic(size_t size)
+{
+	void *result = malloc(size);
+	if (result == NULL) {
+		fprintf(stderr, "panic: out of memory\n");
+		abort();
+	}
+	return result;
+}
+
+static jlong to_handle(void *pointer)
+{
+	return (jlong)(intptr_t)pointer;
+}
+
+static void *from_handle(jlong handle)
+{
+	return (void*)(intptr_t)handle;
+}
+
+static int open_path(const java_lang_String *name, int flags)
+{
+	char *path = string_to_c_chars(name);
+	int   fd;
+	do {
+		fd = open(path, flags | O_CLOEXEC, 0666);
+	} while (fd < 0 && errno == EINTR);
+	free(path);
+	return fd;
+}
+
+/**
+ * A read or write run by thread_blocking_call: pipes, terminals and sockets
+ * may keep the thread waiting for a long time and a collection must not
+ * wait for it. The data may be in a byte array, it holds no references and
+ * the pointer kept in the request pins it while the thread is blocked.
+ */
+typedef struct io_request_t {
+	int     fd;
+	char   *data;
+	size_t  len;
+	ssize_t result;
+} io_request_t;
+
+static void do_read(void *data)
+{
+	io_request_t *request = (io_request_t*)data;
+	do {
+		request->result = read(request->fd, request->data, request->len);
+	} while (request->result < 0 && errno == EINTR);
+}
+
+static void do_write_fully(void *data)
+{
+	io_request_t *request = (io_request_t*)data;
+	request->result = 0;
+	while (request->len > 0) {
+		ssize_t written = write(request->fd, request->data, request->len);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			request->result = -1;
+			return;
+		}
+		request->data += written;
+		request->len  -= (size_t)written;
+	}
+}
+
+static ssize_t read_blocking(int fd, void *buffer, size_t size)
+{
+	io_request_t request = { fd, (char*)buffer, size, 0 };
+	thread_blocking_call(do_read, &request);
+	return request.result;
+}
+
+static int write_fully(int fd, const char *data, size_t len)
+{
+	io_request_t request = { fd, (char*)data, len, 0 };
+	thread_blocking_call(do_write_fully, &request);
+	return (int)request.result;
+}
+
+/** Descriptors 0 to 2 belong to the process and are never closed. */
+static int close_fd(int fd)
+{
+	if (fd <= 2)
+		return 0;
+	/* retrying close after EINTR might close a reused descriptor */
+	return close(fd) == 0 || errno == EINTR ? 0 : IO_ERROR;
+}
+
+static input_file_t *new_input_file(int fd)
+{
+	/* map the rest of big regular files */
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)
+	    && st.st_size >= FILE_MMAP_THRESHOLD) {
+		off_t start = lseek(fd, 0, SEEK_CUR);
+		void *map   = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+		                   fd, 0);
+		if (start >= 0 && start <= st.st_size && map != MAP_FAILED) {
+			madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+			input_file_t *file = alloc_or_panic(sizeof(*file));
+			file->fd       = fd;
+			file->map      = map;
+			file->map_size = (size_t)st.st_size;
+			file->pos      = (size_t)start;
+			file->end      = (size_t)st.st_size;
+			return file;
+		}
+		if (map != MAP_FAILED)
+			munmap(map, (size_t)st.st_size);
+	}
+
+	input_file_t *file = alloc_or_panic(sizeof(*file) + INPUT_BUFFER_SIZE);
+	file->fd       = fd;
+	file->map      = NULL;
+	file->map_size = 0;
+	file->pos      = 0;
+	file->end      = 0;
+	return file;
+}
+
+static const char *input_data(const input_file_t *file)
+{
+	return file->map != NULL ? file->map : file->buffer;
+}
+
+/** Refills the empty buffer, returns the number of bytes or IO_EOF/ERROR. */
+static jint refill(input_file_t *file)
+{
+	if (file->map != NULL)
+		return IO_EOF;
+	ssize_t n = read_blocking(file->fd, file->buffer, INPUT_BUFFER_SIZE);
+	if (n < 0)
+		return IO_ERROR;
+	if (n == 0)
+		return IO_EOF;
+	file->pos = 0;
+	file->end = (size_t)n;
+	return (jint)n;
+}
+
+jlong _ZN4java2io15FileInputStream4openEJxPNS_4lang6StringE(
+	const java_lang_String *name)
+{
+	int fd = open_path(name, O_RDONLY);
+	if (fd < 0)
+		return 0;
+	return to_handle(new_input_file(fd));
+}
+
+jlong _ZN4java2io15FileInputStream6openFdEJxi(jint fd)
+{
+	return to_handle(new_input_file(fd));
+}
+
+jint _ZN4java2io15FileInputStream8readByteEJix(jlong handle)
+{
+	input_file_t *file = from_handle(handle);
+	if (file->pos == file->end) {
+		jint result = refill(file);
+		if (result < 0)
+			return result;
+	}
+	return (uint8_t)input_data(file)[file->pos++];
+}
+
+jint _ZN4java2io15FileInputStream9readBytesEJixP6JArrayIcEii(jlong handle,
+	jarray array, jint offset, jint length)
+{
+	input_file_t *file = from_handle(handle);
+	char         *dst  = get_array_data(char, array) + offset;
+	size_t        len  = (size_t)length;
+	if (file->pos == file->end) {
+		/* large reads bypass the buffer */
+		if (file->map == NULL && len >= INPUT_BUFFER_SIZE) {
+			ssize_t n = read_blocking(file->fd, dst, len);
+			if (n < 0)
+				return IO_ERROR;
+			return n == 0 ? IO_EOF : (jint)n;
+		}
+		jint result = refill(file);
+		if (result < 0)
+			return result;
+	}
+	/* return what is there instead of blocking for more */
+	size_t available = file->end - file->pos;
+	size_t n         = len < available ? len : available;
+	memcpy(dst, input_data(file) + file->pos, n);
+	file->pos += n;
+	return (jint)n;
+}
+
+jlong _ZN4java2io15FileInputStream9skipBytesEJxxx(jlong handle, jlong n)
+{
+	input_file_t *file     = from_handle(handle);
+	size_t        buffered = file->end - file->pos;
+	if ((uint64_t)n <= buffered || file->map != NULL) {
+		size_t skipped = (uint64_t)n < buffered ? (size_t)n : buffered;
+		file->pos += skipped;
+		return (jlong)skipped;
+	}
+
+	file->pos = file->end;
+	jlong left = n - (jlong)buffered;
+	/* seek over the rest of regular files, read it from pipes */
+	off_t current = lseek(file->fd, 0, SEEK_CUR);
+	struct stat st;
+	if (current >= 0 && fstat(file->fd, &st) == 0 && S_ISREG(st.st_mode)) {
+		off_t target = current + left < st.st_size ? current + left
+		                                           : st.st_size;
+		if (target < current)
+			target = current;
+		if (lseek(file->fd, target, SEEK_SET) < 0)
+			return IO_ERROR;
+		return (jlong)buffered + (target - current);
+	}
+	while (left > 0) {
+		jint result = refill(file);
+		if (result == IO_ERROR)
+			return IO_ERROR;
+		if (result == IO_EOF)
+			break;
+		size_t skipped = (uint64_t)left < file->end ? (size_t)left : file->end;
+		file->pos  = skipped;
+		left      -= (jlong)skipped;
+	}
+	return n - left;
+}
+
+jint _ZN4java2io15FileInputStream14availableBytesEJix(jlong handle)
+{
+	input_file_t *file      = from_handle(handle);
+	jlong         available = (jlong)(file->end - file->pos);
+	if (file->map == NULL) {
+		struct stat st;
+		off_t       current = lseek(file->fd, 0, SEEK_CUR);
+		if (current >= 0 && fstat(file->fd, &st) == 0 && S_ISREG(st.st_mode)
+		    && st.st_size > current)
+			available += st.st_size - current;
+	}
+	return available > INT32_MAX ? INT32_MAX : (jint)available;
+}
+
+jint _ZN4java2io15FileInputStream11closeHandleEJix(jlong handle)
+{
+	input_file_t *file = from_handle(handle);
+	if (file->map != NULL)
+		munmap((void*)file->map, file->map_size);
+	jint result = close_fd(file->fd);
+	free(file);
+	return result;
+}
+
+jlong _ZN4java2io16FileOutputStream4openEJxPNS_4lang6StringEb(
+	const java_lang_String *name, jboolean append)
+{
+	int flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+	int fd    = open_path(name, flags);
+	if (fd < 0)
+		return 0;
+	return to_handle(output_open(fd));
+}
+
+jlong _ZN4java2io16FileOutputStream6openFdEJxi(jint fd)
+{
+	return to_handle(output_open(fd));
+}
+
+static jint output_status(const output_t *out)
+{
+	return out->failed ? IO_ERROR : 0;
+}
+
+jint _ZN4java2io16FileOutputStream9writeByteEJixi(jlong handle, jint b)
+{
+	output_t *out  = from_handle(handle);
+	char      byte = (char)b;
+	output_lock();
+	output_bytes(out, &byte, 1);
+	output_unlock();
+	return output_status(out);
+}
+
+jint _ZN4java2io16FileOutputStream10writeBytesEJixP6JArrayIcEii(jlong handle,
+	jarray array, jint offset, jint length)
+{
+	output_t *out = from_handle(handle);
+	output_lock();
+	output_bytes(out, get_array_data(const char, array) + offset,
+	             (size_t)length);
+	output_unlock();
+	return output_status(out);
+}
+
+jint _ZN4java2io16FileOutputStream11flushHandleEJix(jlong handle)
+{
+	output_t *out = from_handle(handle);
+	output_lock();
+	output_flush(out);
+	output_unlock();
+	return output_status(out);
+}
+
+jint _ZN4java2io16FileOutputStream11closeHandleEJix(jlong handle)
+{
+	output_lock();
+	bool ok = output_close(from_handle(handle));
+	output_unlock();
+	return ok ? 0 : IO_ERROR;
+}
+
+jint _ZN4java2io16RandomAccessFile4openEJiPNS_4lang6StringEb(
+	const java_lang_String *name, jboolean write)
+{
+	return open_path(name, write ? O_RDWR | O_CREAT : O_RDONLY);
+}
+
+jint _ZN4java2io16RandomAccessFile8readByteEJii(jint fd)
+{
+	uint8_t byte;
+	ssize_t n = read_blocking(fd, &byte, 1);
+	if (n < 0)
+		return IO_ERROR;
+	return n == 0 ? IO_EOF : byte;
+}
+
+jint _ZN4java2io16RandomAccessFile9readBytesEJiiP6JArrayIcEii(jint fd,
+	jarray array, jint offset, jint length)
+{
+	ssize_t n = read_blocking(fd, get_array_data(char, array) + offset,
+	                          (size_t)length);
+	if (n < 0)
+		return IO_ERROR;
+	return n == 0 ? IO_EOF : (jint)n;
+}
+
+jint _ZN4java2io16RandomAccessFile9writeByteEJiii(jint fd, jint b)
+{
+	char byte = (char)b;
+	return write_fully(fd, &byte, 1) < 0 ? IO_ERROR : 0;
+}
+
+jint _ZN4java2io16RandomAccessFile10writeBytesEJiiP6JArrayIcEii(jint fd,
+	jarray array, jint offset, jint length)
+{
+	const char *data = get_array_data(const char, array) + offset;
+	return write_fully(fd, data, (size_t)length) < 0 ? IO_ERROR : 0;
+}
+
+jlong _ZN4java2io16RandomAccessFile6seekToEJxix(jint fd, jlong pos)
+{
+	off_t result = lseek(fd, (off_t)pos, SEEK_SET);
+	return result < 0 ? IO_ERROR : (jlong)result;
+}
+
+jlong _ZN4java2io16RandomAccessFile8positionEJxi(jint fd)
+{
+	off_t result = lseek(fd, 0, SEEK_CUR);
+	return result < 0 ? IO_ERROR : (jlong)result;
+}
+
+jlong _ZN4java2io16RandomAccessFile10fileLengthEJxi(jint fd)
+{
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+		return IO_ERROR;
+	return (jlong)st.st_size;
+}
+
+jint _ZN4java2io16RandomAccessFile7closeFdEJii(jint fd)
+{
+	return close_fd(fd);
+}
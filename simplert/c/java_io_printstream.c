@@ -1,14 +1,59 @@
 #include "types.h"
 
-#include <stdio.h>
+#include "output.h"
 
-void _ZN4java2io11PrintStream7putcharEJvw(jchar c)
+/** Layout of java.io.PrintStream. */
+typedef struct java_io_PrintStream {
+	java_lang_Object base;
+	jint             fd;
+} java_io_PrintStream;
+
+/** Returns the output of @p stream with the output lock held. */
+static output_t *lock_output(const java_io_PrintStream *stream)
+{
+	output_lock();
+	return output_get(stream->fd);
+}
+
+void _ZN4java2io11PrintStream5flushEJvv(java_io_PrintStream *this_)
+{
+	output_flush(lock_output(this_));
+	output_unlock();
+}
+
+void _ZN4java2io11PrintStream7printlnEJvv(java_io_PrintStream *this_)
+{
+	output_newline(lock_output(this_));
+	output_unlock();
+}
+
+void _ZN4java2io11PrintStream5printEJvPNS_4lang6StringE(
+	java_io_PrintStream *this_, const java_lang_String *s)
+{
+	static const char null_chars[] = "null";
+	output_t *out = lock_output(this_);
+	if (s == NULL) {
+		output_bytes(out, null_chars, sizeof(null_chars) - 1);
+	} else {
+		output_string(out, s);
+	}
+	output_unlock();
+}
+
+void _ZN4java2io11PrintStream5printEJvw(java_io_PrintStream *this_, jchar c)
+{
+	output_char(lock_output(this_), c);
+	output_unlock();
+}
+
+void _ZN4java2io11PrintStream5printEJvi(java_io_PrintStream *this_, jint i)
 {
-	putchar(c);
+	output_long(lock_output(this_), i);
+	output_unlock();
 }
 
-void _ZN4java2io11PrintStream5printEJvi(jobject this_, jint i)
+void _ZN4java2io11PrintStream5printEJvx(java_io_PrintStream *this_, jlong l)
 {
-	(void)this_;
-	printf("%d", i);
+	output_long(lock_output(this_), l);
+	output_unlock();
 }
@@ -7,3 +7,9 @@ java_lang_String *_ZN4java4lang5Float8toStringEJPNS0_6StringEf(jfloat value)
 {
 	return double_to_string(value, true);
 }
+
+jfloat _ZN4java4lang5Float16nativeParseFloatEJfPNS0_6StringE(
+	const java_lang_String *string)
+{
+	return (jfloat)parse_string_double(string, true);
+}
@@ -0,0 +1,15 @@
+#include "types.h"
+
+java_lang_String *_ZN4java4lang7Integer8toStringEJPNS0_6StringEi(jint value)
+{
+	return long_to_string(value);
+}
+
+jlong _ZN4java4lang7Integer14nativeParseIntEJxPNS0_6StringEi(
+	const java_lang_String *string, jint radix)
+{
+	jlong result;
+	if (!parse_string_long(string, radix, INT32_MIN, INT32_MAX, &result))
+		return INT64_MIN;
+	return result;
+}
@@ -0,0 +1,67 @@
+#include <stdlib.h>
+
+#include "types.h"
+#include "int_format.h"
+
+java_lang_String *long_to_string(jlong value)
+{
+	/* write the digits right into a string of the exact size */
+	uint64_t          magnitude = value < 0 ? -(uint64_t)value
+	                                        : (uint64_t)value;
+	size_t            len       = count_decimal_digits(magnitude)
+	                            + (value < 0);
+	char             *chars;
+	java_lang_String *result    = string_alloc_latin1(len, &chars);
+	write_decimal_digits(chars + len, magnitude);
+	if (value < 0)
+		chars[0] = '-';
+	return result;
+}
+
+bool parse_string_long(const java_lang_String *string, jint radix, jlong min,
+                       jlong max, jlong *result)
+{
+	char        small[64];
+	char       *allocated;
+	const char *chars = string_narrow_chars(string, small, sizeof(small),
+	                                        &allocated);
+	if (chars == NULL)
+		return false;
+	bool valid = parse_long(chars, (size_t)string->count, radix, min, max,
+	                        result);
+	free(allocated);
+	return valid;
+}
+
+java_lang_String *_ZN4java4lang4Long8toStringEJPNS0_6StringEx(jlong value)
+{
+	return long_to_string(value);
+}
+
+jint _ZN4java4lang4Long8getCharsEJixP6JArrayIwEi(jlong value, jarray array,
+                                                jint offset)
+{
+	char   buffer[LONG_FORMAT_SIZE];
+	size_t len = format_long(buffer, value);
+	jchar *dst = get_array_data(jchar, array) + offset;
+	for (size_t i = 0; i < len; ++i) {
+		dst[i] = (jchar)buffer[i];
+	}
+	return offset + (jint)len;
+}
+
+jlong _ZN4java4lang4Long15nativeParseLongEJxPNS0_6StringEi(
+	const java_lang_String *string, jint radix)
+{
+	jlong result;
+	if (!parse_string_long(string, radix, INT64_MIN, INT64_MAX, &result))
+		return INT64_MIN;
+	return result;
+}
+
+jboolean _ZN4java4lang4Long12nativeIsLongEJbPNS0_6StringEi(
+	const java_lang_String *string, jint radix)
+{
+	jlong result;
+	return parse_string_long(string, radix, INT64_MIN, INT64_MAX, &result);
+}
@@ -6,3 +6,25 @@ jdouble _ZN4java4lang4Math3powEJddd(jdouble a, jdouble b)
 {
 	return pow(a, b);
 }
+
+/* calls of these are usually replaced by libm calls, see math_intrinsics */
+
+jdouble _ZN4java4lang4Math4sqrtEJdd(jdouble a)
+{
+	return sqrt(a);
+}
+
+jdouble _ZN4java4lang4Math4ceilEJdd(jdouble a)
+{
+	return ceil(a);
+}
+
+jdouble _ZN4java4lang4Math5floorEJdd(jdouble a)
+{
+	return floor(a);
+}
+
+jdouble _ZN4java4lang4Math4rintEJdd(jdouble a)
+{
+	return rint(a);
+}
@@ -8,36 +8,111 @@
 #include <assert.h>
 
 #include "debug.h"
+#include "heap.h"
+#include "string_kernels.h"
 
 // String rtti
 extern java_lang_Class _ZN4java4lang6String6class$E;
+extern java_lang_Class _Jv_byteClass;
+extern java_lang_Class _Jv_charClass;
 
-java_lang_String *new_string(jchar *data, jint boffset, jint count)
+/**
+ * Creates a string sharing its chars with another one, @p data is the byte
+ * or char array or the String holding the chars.
+ */
+static java_lang_String *new_shared_string(void *data, jint boffset,
+                                           jint count, jbyte coder)
 {
 	java_lang_String *result =
 		(java_lang_String*)_Jv_AllocObjectNoFinalizer(&_ZN4java4lang6String6class$E);
-	result->data    = data;
-	result->boffset = boffset;
-	result->count   = count;
+	result->data         = data;
+	heap_mark_card(&result->data);
+	result->boffset      = boffset;
+	result->count        = count;
+	result->coder        = coder;
+	result->chars_inline = false;
+	result->cached_hash  = 0;
 	return result;
 }
 
-static const jchar *get_string_begin(const java_lang_String *string)
+static size_t get_char_size(jbyte coder)
 {
-	return (const jchar*)((const char*)string->data + string->boffset);
+	return coder == STRING_CODER_LATIN1 ? 1 : sizeof(jchar);
 }
 
-jint _ZN4java4lang6String8hashCodeEJiv(const java_lang_String *this_)
+/**
+ * Creates a string with room for @p count chars right after the object, so
+ * the string takes a single allocation. The caller has to fill in all chars,
+ * they are not zeroed.
+ */
+static java_lang_String *new_inline_string(size_t count, jbyte coder)
 {
-	const jchar *begin = get_string_begin(this_);
-	const jchar *end   = begin + this_->count;
+	java_lang_Class *string_class = &_ZN4java4lang6String6class$E;
+	assert((size_t)string_class->size_in_bytes == sizeof(java_lang_String));
+	assert((size_t)(jint)count == count);
+	size_t            size   = sizeof(java_lang_String)
+	                         + count * get_char_size(coder);
+	java_lang_String *result = heap_alloc_uninitialized(size);
+	result->base.vptr    = string_class->vtable;
+	result->base.lock    = 0;
+	/* referencing itself needs no card mark */
+	result->data         = (jarray)result;
+	result->boffset      = sizeof(java_lang_String);
+	result->count        = (jint)count;
+	result->coder        = coder;
+	result->chars_inline = true;
+	result->cached_hash  = 0;
+	return result;
+}
+
+static uint8_t *inline_latin1(java_lang_String *string)
+{
+	return (uint8_t*)(string + 1);
+}
+
+static jchar *inline_utf16(java_lang_String *string)
+{
+	return (jchar*)(string + 1);
+}
+
+/**
+ * Chars of strings created by the constructors are kept in byte or char
+ * arrays on the heap, depending on the coder. The callers overwrite all of
+ * the array, so it is not zeroed.
+ */
+static jarray new_string_data(size_t count, jbyte coder)
+{
+	assert((size_t)(jint)count == count);
+	java_lang_Class *eltype = coder == STRING_CODER_LATIN1 ? &_Jv_byteClass
+	                                                       : &_Jv_charClass;
+	return _Jv_NewPrimArrayUninitialized(eltype, (jint)count);
+}
 
-	// djb-style hash
-	jint hash = 5381;
-	for (const jchar *c = begin; c < end; ++c) {
-		hash = ((hash << 5) + hash) + *c;
+/** Copies @p count chars of @p string starting at @p begin to @p dst. */
+static void copy_to_utf16(jchar *dst, const java_lang_String *string,
+                          jint begin, jint count)
+{
+	if (string->coder == STRING_CODER_LATIN1) {
+		string_kernels.widen(dst, string_latin1(string) + begin, count);
+	} else {
+		memcpy(dst, string_utf16(string) + begin, count * sizeof(dst[0]));
 	}
+}
+
+jint _ZN4java4lang6String8hashCodeEJiv(java_lang_String *this_)
+{
+	/* strings hashing to 0 are recomputed each time, like in the JDK */
+	jint hash = this_->cached_hash;
+	if (hash != 0)
+		return hash;
 
+	if (this_->coder == STRING_CODER_LATIN1) {
+		hash = string_kernels.hash_latin1(0, string_latin1(this_),
+		                                  this_->count);
+	} else {
+		hash = string_kernels.hash_utf16(0, string_utf16(this_), this_->count);
+	}
+	this_->cached_hash = hash;
 	return hash;
 }
 
@@ -57,11 +132,14 @@ jboolean _ZN4java4lang6String6equalsEJbPNS0_6ObjectE(
 	if (count != other_count)
 		return false;
 
-	const jchar *begin  = get_string_begin(this_);
-	const jchar *obegin = get_string_begin(other);
-
+	if (this_->coder == other->coder) {
+		size_t size = count * get_char_size(this_->coder);
+		return string_kernels.mismatch_latin1(string_latin1(this_),
+		                                      string_latin1(other), size) == size;
+	}
+	/* substrings of UTF-16 strings may consist of Latin-1 chars only */
 	for (jint i = 0; i < count; ++i) {
-		if (begin[i] != obegin[i])
+		if (string_char_at(this_, i) != string_char_at(other, i))
 			return false;
 	}
 	return true;
@@ -69,45 +147,215 @@ jboolean _ZN4java4lang6String6equalsEJbPNS0_6ObjectE(
 
 jchar _ZN4java4lang6String6charAtEJwi(const java_lang_String *this_, jint index)
 {
-	const jchar *chars = get_string_begin(this_);
-	return chars[index];
+	return string_char_at(this_, index);
 }
 
 void _ZN4java4lang6String4initEJvP6JArrayIwEiib(java_lang_String *this_,
 	jarray chars, jint offset, jint count, jboolean dont_copy)
 {
-	jchar *data = malloc(count * sizeof(data[0]));
-	if (data == NULL) {
-		fprintf(stderr, "out of memory\n");
-		abort();
-	}
-	const jchar *chars_data = get_array_data(const jchar, chars) + offset;
 	if (chars->length < count) {
 		fprintf(stderr, "chars array too short\n");
 		abort();
 	}
 	(void)dont_copy;
-	memcpy(data, chars_data, count * sizeof(data[0]));
+	const jchar *chars_data = get_array_data(const jchar, chars) + offset;
+	jbyte        coder      = string_kernels.is_latin1(chars_data, count)
+	                        ? STRING_CODER_LATIN1 : STRING_CODER_UTF16;
+	jarray       data       = new_string_data(count, coder);
+	if (coder == STRING_CODER_LATIN1) {
+		string_kernels.narrow(get_array_data(uint8_t, data), chars_data, count);
+	} else {
+		memcpy(get_array_data(jchar, data), chars_data, count * sizeof(jchar));
+	}
 
-	this_->data = data;
-	this_->boffset = 0;
-	this_->count   = count;
+	/* the object is already allocated, so the chars can't be inline */
+	this_->data         = data;
+	heap_mark_card(&this_->data);
+	this_->boffset      = sizeof(array_header_t);
+	this_->count        = count;
+	this_->coder        = coder;
+	this_->chars_inline = false;
+	this_->cached_hash  = 0;
+}
+
+java_lang_String *_ZN4java4lang6String7valueOfEJPS1_P6JArrayIwEii(
+	jarray chars, jint offset, jint count)
+{
+	assert(offset >= 0 && count >= 0 && offset <= chars->length - count);
+	const jchar *chars_data = get_array_data(const jchar, chars) + offset;
+	if (string_kernels.is_latin1(chars_data, count)) {
+		java_lang_String *result = new_inline_string(count,
+		                                             STRING_CODER_LATIN1);
+		string_kernels.narrow(inline_latin1(result), chars_data, count);
+		return result;
+	}
+	java_lang_String *result = new_inline_string(count, STRING_CODER_UTF16);
+	memcpy(inline_utf16(result), chars_data, count * sizeof(jchar));
+	return result;
+}
+
+/**
+ * Decodes the (modified) UTF-8 sequence at @p chars into a code point and
+ * returns its length. Malformed bytes are taken as Latin-1 chars.
+ */
+static size_t decode_utf8(const uint8_t *chars, size_t len, uint32_t *result)
+{
+	uint8_t c = chars[0];
+	size_t  n;
+	uint32_t code;
+	if (c >= 0xC0 && c < 0xE0) {
+		n    = 2;
+		code = c & 0x1F;
+	} else if (c >= 0xE0 && c < 0xF0) {
+		n    = 3;
+		code = c & 0x0F;
+	} else if (c >= 0xF0 && c < 0xF8) {
+		n    = 4;
+		code = c & 0x07;
+	} else {
+		*result = c;
+		return 1;
+	}
+	if (n > len) {
+		*result = c;
+		return 1;
+	}
+	for (size_t i = 1; i < n; ++i) {
+		if ((chars[i] & 0xC0) != 0x80) {
+			*result = c;
+			return 1;
+		}
+		code = (code << 6) | (chars[i] & 0x3F);
+	}
+	if (code > 0x10FFFF) {
+		*result = c;
+		return 1;
+	}
+	*result = code;
+	return n;
 }
 
 java_lang_String *string_from_c_chars(const char *chars, size_t len)
 {
-	jchar *data = malloc(len * sizeof(data[0]));
-	if (data == NULL) {
-		fprintf(stderr, "out of memory\n");
+	const uint8_t *bytes = (const uint8_t*)chars;
+	if (string_kernels.is_ascii(bytes, len)) {
+		java_lang_String *result = new_inline_string(len, STRING_CODER_LATIN1);
+		memcpy(inline_latin1(result), bytes, len);
+		return result;
+	}
+
+	/* first pass determines length and coder */
+	size_t   count    = 0;
+	uint32_t max_code = 0;
+	for (size_t i = 0; i < len; ) {
+		uint32_t code;
+		i += decode_utf8(bytes + i, len - i, &code);
+		count += code > 0xFFFF ? 2 : 1;
+		if (code > max_code)
+			max_code = code;
+	}
+
+	jbyte             coder  = max_code <= 0xFF ? STRING_CODER_LATIN1
+	                                            : STRING_CODER_UTF16;
+	java_lang_String *result = new_inline_string(count, coder);
+	if (coder == STRING_CODER_LATIN1) {
+		uint8_t *dst = inline_latin1(result);
+		for (size_t i = 0; i < len; ) {
+			uint32_t code;
+			i += decode_utf8(bytes + i, len - i, &code);
+			*dst++ = (uint8_t)code;
+		}
+	} else {
+		jchar *dst = inline_utf16(result);
+		for (size_t i = 0; i < len; ) {
+			uint32_t code;
+			i += decode_utf8(bytes + i, len - i, &code);
+			if (code > 0xFFFF) {
+				code  -= 0x10000;
+				*dst++ = (jchar)(0xD800 + (code >> 10));
+				*dst++ = (jchar)(0xDC00 + (code & 0x3FF));
+			} else {
+				*dst++ = (jchar)code;
+			}
+		}
+	}
+	return result;
+}
+
+char *string_to_c_chars(const java_lang_String *string)
+{
+	/* up to three bytes per char, a surrogate pair takes four */
+	size_t count  = (size_t)string->count;
+	char  *result = malloc(3 * count + 1);
+	if (result == NULL) {
+		fprintf(stderr, "panic: out of memory\n");
 		abort();
 	}
-	// TODO: proper UTF-8 decoder...
-	for (size_t i = 0; i < len; ++i) {
-		data[i] = chars[i];
+	if (string->coder == STRING_CODER_LATIN1
+	    && string_kernels.is_ascii(string_latin1(string), count)) {
+		memcpy(result, string_latin1(string), count);
+		result[count] = '\0';
+		return result;
+	}
+
+	uint8_t *dst = (uint8_t*)result;
+	for (size_t i = 0; i < count; ++i) {
+		uint32_t code = string_char_at(string, (jint)i);
+		if (code >= 0xD800 && code < 0xDC00 && i + 1 < count) {
+			uint32_t low = string_char_at(string, (jint)i + 1);
+			if (low >= 0xDC00 && low < 0xE000) {
+				code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+				++i;
+			}
+		}
+		if (code < 0x80) {
+			*dst++ = (uint8_t)code;
+		} else if (code < 0x800) {
+			*dst++ = (uint8_t)(0xC0 | (code >> 6));
+			*dst++ = (uint8_t)(0x80 | (code & 0x3F));
+		} else if (code < 0x10000) {
+			*dst++ = (uint8_t)(0xE0 | (code >> 12));
+			*dst++ = (uint8_t)(0x80 | ((code >> 6) & 0x3F));
+			*dst++ = (uint8_t)(0x80 | (code & 0x3F));
+		} else {
+			*dst++ = (uint8_t)(0xF0 | (code >> 18));
+			*dst++ = (uint8_t)(0x80 | ((code >> 12) & 0x3F));
+			*dst++ = (uint8_t)(0x80 | ((code >> 6) & 0x3F));
+			*dst++ = (uint8_t)(0x80 | (code & 0x3F));
+		}
 	}
+	*dst = '\0';
+	return result;
+}
+
+java_lang_String *string_alloc_latin1(size_t count, char **chars)
+{
+	java_lang_String *result = new_inline_string(count, STRING_CODER_LATIN1);
+	*chars = (char*)inline_latin1(result);
+	return result;
+}
+
+const char *string_narrow_chars(const java_lang_String *string, char *buffer,
+                                size_t size, char **allocated)
+{
+	*allocated = NULL;
+	if (string->coder == STRING_CODER_LATIN1)
+		return (const char*)string_latin1(string);
 
-	assert((size_t)(jint)len == len);
-	return new_string(data, 0, len);
+	size_t       count = (size_t)string->count;
+	const jchar *chars = string_utf16(string);
+	if (!string_kernels.is_latin1(chars, count))
+		return NULL;
+	char *result = buffer;
+	if (count > size) {
+		result = *allocated = malloc(count);
+		if (result == NULL) {
+			fprintf(stderr, "panic: out of memory\n");
+			abort();
+		}
+	}
+	string_kernels.narrow((uint8_t*)result, chars, count);
+	return result;
 }
 
 java_lang_String *_Z22_Jv_NewStringUtf8ConstP13_Jv_Utf8Const(const utf8_const *cnst)
@@ -115,6 +363,14 @@ java_lang_String *_Z22_Jv_NewStringUtf8ConstP13_Jv_Utf8Const(const utf8_const *c
 	return string_from_c_chars(cnst->data, cnst->len);
 }
 
+java_lang_String *_Jv_NewStringUtf8ConstHashed(const utf8_const *cnst,
+                                               jint hash)
+{
+	java_lang_String *result = string_from_c_chars(cnst->data, cnst->len);
+	result->cached_hash = hash;
+	return result;
+}
+
 void _ZN4java4lang6String8getCharsEJviiP6JArrayIwEi(
 	const java_lang_String *this_, jint srcBegin, jint srcEnd,
 	jarray dstArray, jint dstBegin)
@@ -125,10 +381,74 @@ void _ZN4java4lang6String8getCharsEJviiP6JArrayIwEi(
 	jint len = srcEnd - srcBegin;
 	assert(len <= (dstArray->length - dstBegin));
 
-	jchar       *dst  = get_array_data(jchar, dstArray) + dstBegin;
-	const jchar *data = get_string_begin(this_) + srcBegin;
+	jchar *dst = get_array_data(jchar, dstArray) + dstBegin;
+	copy_to_utf16(dst, this_, srcBegin, len);
+}
 
-	memcpy(dst, data, len * sizeof(dst[0]));
+jint _ZN4java4lang6String7indexOfEJiii(const java_lang_String *this_, jint ch,
+                                      jint fromIndex)
+{
+	jint count = this_->count;
+	if (fromIndex < 0)
+		fromIndex = 0;
+	if (fromIndex >= count)
+		return -1;
+
+	size_t n = count - fromIndex;
+	size_t index;
+	if (ch > 0xFFFF) {
+		/* supplementary code point, search for its surrogate pair */
+		if (this_->coder == STRING_CODER_LATIN1 || ch > 0x10FFFF)
+			return -1;
+		jchar high = (jchar)(0xD800 + ((ch - 0x10000) >> 10));
+		jchar low  = (jchar)(0xDC00 + ((ch - 0x10000) & 0x3FF));
+		const jchar *chars = string_utf16(this_);
+		for (jint i = fromIndex; i + 1 < count; ++i) {
+			if (chars[i] == high && chars[i + 1] == low)
+				return i;
+		}
+		return -1;
+	} else if (this_->coder == STRING_CODER_LATIN1) {
+		if (ch < 0 || ch > 0xFF)
+			return -1;
+		index = string_kernels.find_latin1(string_latin1(this_) + fromIndex, n,
+		                                   (uint8_t)ch);
+	} else {
+		if (ch < 0)
+			return -1;
+		index = string_kernels.find_utf16(string_utf16(this_) + fromIndex, n,
+		                                  (jchar)ch);
+	}
+	return index == n ? -1 : fromIndex + (jint)index;
+}
+
+jint _ZN4java4lang6String15nativeCompareToEJiPS1_(
+	const java_lang_String *this_, const java_lang_String *other)
+{
+	jint   count       = this_->count;
+	jint   other_count = other->count;
+	size_t n           = count < other_count ? count : other_count;
+
+	if (this_->coder == other->coder) {
+		size_t index;
+		if (this_->coder == STRING_CODER_LATIN1) {
+			index = string_kernels.mismatch_latin1(string_latin1(this_),
+			                                       string_latin1(other), n);
+		} else {
+			index = string_kernels.mismatch_utf16(string_utf16(this_),
+			                                      string_utf16(other), n);
+		}
+		if (index < n)
+			return string_char_at(this_, index) - string_char_at(other, index);
+	} else {
+		for (size_t i = 0; i < n; ++i) {
+			jchar c       = string_char_at(this_, i);
+			jchar other_c = string_char_at(other, i);
+			if (c != other_c)
+				return c - other_c;
+		}
+	}
+	return count - other_count;
 }
 
 java_lang_String *_ZN4java4lang6String9substringEJPS1_ii(const java_lang_String *this_, jint begin, jint end)
@@ -137,21 +457,100 @@ java_lang_String *_ZN4java4lang6String9substringEJPS1_ii(const java_lang_String
 	assert(begin <= end);
 	assert(end <= this_->count);
 
-	return new_string(this_->data, this_->boffset + begin * sizeof(this_->data[0]), end - begin);
+	/* the data of a string with inline chars is the string itself */
+	jbyte coder = this_->coder;
+	return new_shared_string(this_->data,
+	                         this_->boffset + begin * get_char_size(coder),
+	                         end - begin, coder);
 }
 
 java_lang_String *_ZN4java4lang6String6concatEJPS1_S2_(const java_lang_String *this_, const java_lang_String *other)
 {
-	const jchar *src1 = get_string_begin(this_);
-	const jchar *src2 = get_string_begin(other);
-	jint len = this_->count + other->count;
+	jint count1 = this_->count;
+	jint count2 = other->count;
+	jint len    = count1 + count2;
 	// TODO: check overflow...
-	jchar *resdata = malloc(len * sizeof(resdata[0]));
-	if (resdata == NULL) {
-		fprintf(stderr, "out of memory\n");
-		abort();
+	if (this_->coder == STRING_CODER_LATIN1
+	    && other->coder == STRING_CODER_LATIN1) {
+		java_lang_String *result  = new_inline_string(len,
+		                                              STRING_CODER_LATIN1);
+		uint8_t          *resdata = inline_latin1(result);
+		memcpy(resdata, string_latin1(this_), count1);
+		memcpy(resdata + count1, string_latin1(other), count2);
+		return result;
 	}
-	memcpy(resdata, src1, this_->count * sizeof(resdata[0]));
-	memcpy(resdata + this_->count, src2, other->count * sizeof(resdata[0]));
-	return new_string(resdata, 0, len);
+
+	java_lang_String *result  = new_inline_string(len, STRING_CODER_UTF16);
+	jchar            *resdata = inline_utf16(result);
+	copy_to_utf16(resdata, this_, 0, count1);
+	copy_to_utf16(resdata + count1, other, 0, count2);
+	return result;
+}
+
+/**
+ * Returns true if the concatenation part @p part is a char encoded as
+ * (c << 1) | 1, object addresses are always aligned.
+ */
+static bool is_char_part(const java_lang_String *part)
+{
+	return ((uintptr_t)part & 1) != 0;
+}
+
+static jchar get_char_part(const java_lang_String *part)
+{
+	return (jchar)((uintptr_t)part >> 1);
+}
+
+java_lang_String *_Jv_StringConcat(jint n_parts,
+                                   java_lang_String *const *parts)
+{
+	static const char null_chars[] = "null";
+	size_t len   = 0;
+	jbyte  coder = STRING_CODER_LATIN1;
+	for (jint i = 0; i < n_parts; ++i) {
+		const java_lang_String *part = parts[i];
+		if (is_char_part(part)) {
+			len += 1;
+			if (get_char_part(part) > 0xFF)
+				coder = STRING_CODER_UTF16;
+		} else if (part == NULL) {
+			len += sizeof(null_chars) - 1;
+		} else {
+			len += (size_t)part->count;
+			if (part->coder != STRING_CODER_LATIN1)
+				coder = STRING_CODER_UTF16;
+		}
+	}
+
+	java_lang_String *result = new_inline_string(len, coder);
+	if (coder == STRING_CODER_LATIN1) {
+		uint8_t *resdata = inline_latin1(result);
+		for (jint i = 0; i < n_parts; ++i) {
+			const java_lang_String *part = parts[i];
+			if (is_char_part(part)) {
+				*resdata++ = (uint8_t)get_char_part(part);
+			} else if (part == NULL) {
+				memcpy(resdata, null_chars, sizeof(null_chars) - 1);
+				resdata += sizeof(null_chars) - 1;
+			} else {
+				memcpy(resdata, string_latin1(part), part->count);
+				resdata += part->count;
+			}
+		}
+	} else {
+		jchar *resdata = inline_utf16(result);
+		for (jint i = 0; i < n_parts; ++i) {
+			const java_lang_String *part = parts[i];
+			if (is_char_part(part)) {
+				*resdata++ = get_char_part(part);
+			} else if (part == NULL) {
+				for (const char *c = null_chars; *c != '\0'; ++c)
+					*resdata++ = *c;
+			} else {
+				copy_to_utf16(resdata, part, 0, part->count);
+				resdata += part->count;
+			}
+		}
+	}
+	return result;
 }
@@ -1,26 +1,68 @@
+#define _GNU_SOURCE
 #include "types.h"
 
 #include <assert.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
+
+#include "exceptions.h"
+#include "heap.h"
 
 void _ZN4java4lang6System9arraycopyEJvPNS0_6ObjectEiS3_ii(jobject src,
 	jint srcpos, jobject dst, jint dstpos, jint length)
 {
+	if (src == NULL || dst == NULL)
+		_Jv_ThrowNullPointerException();
 	// TODO check that src+dest are actually an array and of the same type
 	assert(src->vptr == dst->vptr);
 	jarray srca = (jarray)src;
 	jarray dsta = (jarray)dst;
 	jint src_len = srca->length;
 	jint dst_len = dsta->length;
-	assert(srcpos + length <= src_len);
-	assert(dstpos + length <= dst_len);
+	if (srcpos < 0 || length > src_len - srcpos)
+		_Jv_ThrowBadArrayIndex(srcpos);
+	if (dstpos < 0 || length > dst_len - dstpos)
+		_Jv_ThrowBadArrayIndex(dstpos);
+	if (length < 0)
+		_Jv_ThrowBadArrayIndex(length);
 
-	// TODO: how do I get the element size?
-	jint element_size = src->vptr->rtti->me.element_type->size_in_bytes;
-	assert(element_size > 0);
+	uintptr_t descr        = (uintptr_t)dst->vptr->gc_descr;
+	size_t    element_size = descr >> 3;
+	assert(gc_descr_tag(descr) == GC_DESCR_ARRAY && element_size > 0);
 
-	memmove(get_array_data(char, dsta) + (dstpos * element_size),
+	char *dst_data = get_array_data(char, dsta) + (dstpos * element_size);
+	memmove(dst_data,
 	        get_array_data(const char, srca) + (srcpos * element_size),
 	        length * element_size);
+	if (descr & 4)
+		heap_mark_cards(dst_data, length * element_size);
+}
+
+void _Jv_InitArrayCopy(jobject src, jint srcpos, jobject dst, jint dstpos,
+                       jint length)
+{
+	_ZN4java4lang6System9arraycopyEJvPNS0_6ObjectEiS3_ii(src, srcpos, dst,
+	                                                      dstpos, length);
+
+	jarray dsta         = (jarray)dst;
+	size_t element_size = (uintptr_t)dst->vptr->gc_descr >> 3;
+	char  *data         = get_array_data(char, dsta);
+	char  *copy_end     = data + (dstpos + length) * element_size;
+	memset(data, 0, dstpos * element_size);
+	memset(copy_end, 0, (dsta->length - dstpos - length) * element_size);
+}
+
+jlong _ZN4java4lang6System8nanoTimeEJxv(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (jlong)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+jint _ZN4java4lang6System16identityHashCodeEJiPNS0_6ObjectE(jobject object)
+{
+	if (object == NULL)
+		return 0;
+	return gc_identity_hash(object);
 }
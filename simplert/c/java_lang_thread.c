@@ -0,0 +1,69 @@
+#define _GNU_SOURCE
+#include "types.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "exceptions.h"
+#include "threads.h"
+
+static const utf8_const run_thread_name = { 0x6075, 9, { "runThread" } };
+static const utf8_const void_sig        = { 0x9b75, 3, { "()V"       } };
+
+/**
+ * Runs Thread.runThread of the new thread. The method is looked up from
+ * the class of the object, the runtime must not refer to Thread directly as
+ * programs without threads do not contain it.
+ */
+static void run_thread(thread_t *thread)
+{
+	jobject    object = thread->object;
+	jv_method *method = get_method(object->vptr->rtti, &run_thread_name,
+	                               &void_sig);
+	if (method == NULL) {
+		fprintf(stderr, "panic: Thread.runThread not found\n");
+		abort();
+	}
+	void (*run)(jobject) = method->code;
+	run(object);
+}
+
+void _ZN4java4lang6Thread6start0EJvv(jobject this_)
+{
+	thread_start(this_, run_thread);
+}
+
+jobject _ZN4java4lang6Thread19nativeCurrentThreadEJPS1_v(void)
+{
+	return thread_current()->object;
+}
+
+void _ZN4java4lang6Thread12nativeAttachEJvPS1_(jobject thread)
+{
+	thread_current()->object = thread;
+}
+
+static void do_sleep(void *data)
+{
+	struct timespec *time = (struct timespec*)data;
+	while (nanosleep(time, time) != 0 && errno == EINTR) {
+	}
+}
+
+void _ZN4java4lang6Thread5sleepEJvx(jlong millis)
+{
+	if (millis < 0)
+		exceptions_throw_implicit(IMPLICIT_ILLEGAL_ARGUMENT);
+	struct timespec time = {
+		(time_t)(millis / 1000), (long)(millis % 1000) * 1000000
+	};
+	thread_blocking_call(do_sleep, &time);
+}
+
+void _ZN4java4lang6Thread5yieldEJvv(void)
+{
+	sched_yield();
+}
@@ -0,0 +1,160 @@
+#include "types.h"
+#include "exceptions.h"
+
+#include <string.h>
+#include <unwind.h>
+
+/*
+ * Stack traces of java.lang.Throwable. Creating a Throwable only records the
+ * return addresses of the frames on the stack, they are mapped to methods
+ * when the program asks for the stack trace. The unwinder finds the start of
+ * the function of an address from the call frame information, which is
+ * looked up in the method tables of all classes. Source files and lines
+ * come from the table of call sites of the compiler (see
+ * exceptions_find_line).
+ */
+
+/** Frames deeper than this are left out of stack traces. */
+#define MAX_STACK_TRACE_DEPTH 1024
+
+/**
+ * NULL terminated table of all classes of the program, emitted by the
+ * compiler (see gcji_create_exception_table).
+ */
+extern java_lang_Class *const _Jv_classes[] __attribute__((weak));
+
+extern java_lang_Class _Jv_longClass;
+
+static const utf8_const init_name        = { 0x0272,  6, { "<init>"                } };
+static const utf8_const fill_in_name     = { 0x2fc5, 16, { "fillInStackTrace"      } };
+static const utf8_const vmthrowable_name = { 0xe295, 21, { "java.lang.VMThrowable" } };
+
+typedef struct backtrace_t {
+	jlong addresses[MAX_STACK_TRACE_DEPTH];
+	jint  n_addresses;
+	bool  skip;  /**< the frame of captureAddresses comes first */
+} backtrace_t;
+
+static _Unwind_Reason_Code record_frame(struct _Unwind_Context *context,
+                                        void *data)
+{
+	backtrace_t *backtrace = (backtrace_t*)data;
+	if (backtrace->skip) {
+		backtrace->skip = false;
+		return _URC_NO_REASON;
+	}
+	if (backtrace->n_addresses == MAX_STACK_TRACE_DEPTH)
+		return _URC_END_OF_STACK;
+	uintptr_t ip = _Unwind_GetIP(context);
+	if (ip == 0)
+		return _URC_END_OF_STACK;
+	backtrace->addresses[backtrace->n_addresses++] = (jlong)ip;
+	return _URC_NO_REASON;
+}
+
+jarray _ZN4java4lang11VMThrowable16captureAddressesEJP6JArrayIxEv(void)
+{
+	backtrace_t backtrace;
+	backtrace.n_addresses = 0;
+	backtrace.skip        = true;
+	_Unwind_Backtrace(record_frame, &backtrace);
+
+	jarray result = _Jv_NewPrimArray(&_Jv_longClass, backtrace.n_addresses);
+	memcpy(get_array_data(jlong, result), backtrace.addresses,
+	       backtrace.n_addresses * sizeof(jlong));
+	return result;
+}
+
+/**
+ * Finds the Java method containing the return address @p address. Returns
+ * NULL for frames of the runtime or of C libraries.
+ */
+static jv_method *find_method(jlong address, java_lang_Class **cls)
+{
+	if (_Jv_classes == NULL)
+		return NULL;
+	/* a call may be the last instruction of a function, a return address
+	 * is then the start of the next one */
+	void *code = _Unwind_FindEnclosingFunction((void*)(uintptr_t)(address - 1));
+	if (code == NULL)
+		return NULL;
+
+	for (java_lang_Class *const *c = _Jv_classes; *c != NULL; ++c) {
+		jv_method *methods = (*c)->me.methods;
+		for (int16_t i = 0; i < (*c)->method_count; ++i) {
+			if (methods[i].code == code) {
+				*cls = *c;
+				return &methods[i];
+			}
+		}
+	}
+	return NULL;
+}
+
+static bool utf8_equals(const utf8_const *c1, const utf8_const *c2)
+{
+	return c1->len == c2->len && memcmp(c1->data, c2->data, c1->len) == 0;
+}
+
+java_lang_String *_ZN4java4lang11VMThrowable12getClassNameEJPNS0_6StringEx(
+		jlong address)
+{
+	java_lang_Class *cls;
+	if (find_method(address, &cls) == NULL)
+		return NULL;
+	return _Z22_Jv_NewStringUtf8ConstP13_Jv_Utf8Const(cls->name);
+}
+
+java_lang_String *_ZN4java4lang11VMThrowable13getMethodNameEJPNS0_6StringEx(
+		jlong address)
+{
+	java_lang_Class *cls;
+	jv_method       *method = find_method(address, &cls);
+	if (method == NULL)
+		return NULL;
+	return _Z22_Jv_NewStringUtf8ConstP13_Jv_Utf8Const(method->name);
+}
+
+java_lang_String *_ZN4java4lang11VMThrowable11getFileNameEJPNS0_6StringEx(
+		jlong address)
+{
+	const utf8_const *file;
+	jint              line;
+	if (!exceptions_find_line((const char*)(uintptr_t)address, &file, &line))
+		return NULL;
+	return _Z22_Jv_NewStringUtf8ConstP13_Jv_Utf8Const(file);
+}
+
+jint _ZN4java4lang11VMThrowable13getLineNumberEJix(jlong address)
+{
+	const utf8_const *file;
+	jint              line;
+	if (!exceptions_find_line((const char*)(uintptr_t)address, &file, &line))
+		return -1;
+	return line;
+}
+
+/**
+ * Returns whether the frame of @p address belongs to the creation of
+ * @p throwable, these frames are left out of its stack trace.
+ */
+jboolean _ZN4java4lang11VMThrowable11isFillingInEJbxPNS0_9ThrowableE(
+		jlong address, jobject throwable)
+{
+	java_lang_Class *cls;
+	jv_method       *method = find_method(address, &cls);
+	if (method == NULL)
+		return true;
+	if (!utf8_equals(method->name, &init_name)
+	    && !utf8_equals(method->name, &fill_in_name))
+		return false;
+	if (utf8_equals(cls->name, &vmthrowable_name))
+		return true;
+	/* constructors of the throwable or of its superclasses */
+	for (java_lang_Class *super = throwable->vptr->rtti; super != NULL;
+	     super = super->superclass) {
+		if (super == cls)
+			return true;
+	}
+	return false;
+}
@@ -0,0 +1,46 @@
+#include "types.h"
+#include "sort_kernels.h"
+
+/* java.util.Arrays checks the bounds before calling the sorts */
+
+void _ZN4java4util6Arrays10nativeSortEJvP6JArrayIaEii(jarray array, jint from,
+                                                       jint to)
+{
+	sort_bytes(get_array_data(jbyte, array) + from, (size_t)(to - from));
+}
+
+void _ZN4java4util6Arrays10nativeSortEJvP6JArrayIwEii(jarray array, jint from,
+                                                       jint to)
+{
+	sort_chars(get_array_data(jchar, array) + from, (size_t)(to - from));
+}
+
+void _ZN4java4util6Arrays10nativeSortEJvP6JArrayIsEii(jarray array, jint from,
+                                                       jint to)
+{
+	sort_shorts(get_array_data(jshort, array) + from, (size_t)(to - from));
+}
+
+void _ZN4java4util6Arrays10nativeSortEJvP6JArrayIiEii(jarray array, jint from,
+                                                       jint to)
+{
+	sort_ints(get_array_data(jint, array) + from, (size_t)(to - from));
+}
+
+void _ZN4java4util6Arrays10nativeSortEJvP6JArrayIxEii(jarray array, jint from,
+                                                       jint to)
+{
+	sort_longs(get_array_data(jlong, array) + from, (size_t)(to - from));
+}
+
+void _ZN4java4util6Arrays10nativeSortEJvP6JArrayIfEii(jarray array, jint from,
+                                                       jint to)
+{
+	sort_floats(get_array_data(jfloat, array) + from, (size_t)(to - from));
+}
+
+void _ZN4java4util6Arrays10nativeSortEJvP6JArrayIdEii(jarray array, jint from,
+                                                       jint to)
+{
+	sort_doubles(get_array_data(jdouble, array) + from, (size_t)(to - from));
+}
@@ -4,6 +4,12 @@
 #include <string.h>
 #include "types.h"
 #include "debug.h"
+#include "exceptions.h"
+#include "heap.h"
+#include "monitor.h"
+#include "output.h"
+#include "string_kernels.h"
+#include "threads.h"
 
 static const utf8_const main_name = { 0x05b9,  4, { "main"                   } };
 static const utf8_const main_sig  = { 0xe82a, 22, { "([Ljava.lang.String;)V" } };
@@ -12,8 +18,14 @@ extern java_lang_Class _ZN4java4lang6String6class$E;
 
 void JvRunMain(java_lang_Class *cls, int argc, const char **argv)
 {
-	// initialize runtime
+	// initialize runtime, the collector scans the stack up to this frame
+	threads_init(__builtin_frame_address(0));
+	heap_init();
+	monitor_init();
 	init_prim_rtti();
+	exceptions_init();
+	string_kernels_init();
+	output_init();
 
 	jv_method *mainm = get_method(cls, &main_name, &main_sig);
 	if (mainm == NULL) {
@@ -31,7 +43,11 @@ void JvRunMain(java_lang_Class *cls, int argc, const char **argv)
 		size_t            len    = strlen(arg);
 		java_lang_String *string = string_from_c_chars(arg, len);
 		data[i] = string;
+		heap_mark_card(&data[i]);
 	}
 
 	mainmethod(args);
+
+	// like the JVM, the program ends when the last thread does
+	threads_wait_for_others();
 }
@@ -0,0 +1,474 @@
+#define _GNU_SOURCE
+#include "monitor.h"
+#include "exceptions.h"
+#include "heap.h"
+#include "threads.h"
+
+#include <limits.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Thin locks which inflate to futex based monitors. Locking an unlocked
+ * object and unlocking it again are inlined by the compiler and cost one
+ * compare and swap, everything else ends up here.
+ *
+ * The inline exit is a plain store, so nobody but the owner may write a
+ * thin lock word while the owner runs. A thread finding a thin lock of
+ * another thread registers the object in inflation_requests, raises
+ * SAFEPOINT_INFLATE and backs off. The owner replaces the word by a monitor
+ * at its next safepoint or before it blocks, the waiting threads then sleep
+ * on the futex of that monitor. Short critical sections usually end before
+ * that and the lock stays thin. An owner which is blocked already (sleep,
+ * join, I/O) can't do that, the waiting thread inflates the lock for it
+ * while thread_call_if_blocked keeps it blocked.
+ *
+ * Monitors are never deflated, objects only get one when there is
+ * contention, deep recursion or wait. The collector frees the monitors of
+ * dead objects (see monitor_update_objects).
+ *
+ * Waiting threads sleep on the futex notify_seq, which notify increments.
+ * Both happen while holding the monitor, so a notify after the waiter
+ * released it changes the value and the futex does not sleep at all.
+ */
+
+/** Requests of at most this many objects are pending at the same time. */
+#define MAX_INFLATION_REQUESTS 64
+/** Backoff rounds which yield before the waiting thread starts sleeping. */
+#define YIELD_ROUNDS           8
+/** Longest sleep between two looks at a contended thin lock. */
+#define MAX_SLEEP_NS           1000000
+
+typedef struct monitor_t {
+	uint32_t  state;       /**< futex word: 0 free, 1 locked, 2 locked and waited for */
+	uintptr_t owner;       /**< token of the owner, 0 if free */
+	uint32_t  count;       /**< number of enters by the owner */
+	uint32_t  notify_seq;  /**< futex word of Object.wait */
+	uint32_t  waiters;     /**< number of threads in Object.wait */
+	jobject   object;      /**< the object, kept up to date by the collector */
+} monitor_t;
+
+typedef struct futex_wait_t {
+	uint32_t              *word;
+	uint32_t               value;
+	const struct timespec *timeout;  /**< relative, NULL for none */
+} futex_wait_t;
+
+typedef struct inflation_request_t {
+	jobject  object;   /**< NULL if the slot is unused */
+	unsigned waiters;
+} inflation_request_t;
+
+static inflation_request_t inflation_requests[MAX_INFLATION_REQUESTS];
+static char                inflation_requests_lock;
+
+/** All monitors, so the collector finds those of dead objects. */
+static monitor_t **monitors;
+static size_t      n_monitors;
+static size_t      monitors_size;
+static char        monitors_lock;
+
+static uintptr_t self_token(void)
+{
+	return (uintptr_t)&_Jv_lock_token;
+}
+
+static void spin_lock(char *lock)
+{
+	while (__atomic_test_and_set(lock, __ATOMIC_ACQUIRE))
+		sched_yield();
+}
+
+static void spin_unlock(char *lock)
+{
+	__atomic_clear(lock, __ATOMIC_RELEASE);
+}
+
+static uintptr_t load_lock(const java_lang_Object *object)
+{
+	return __atomic_load_n(&object->lock, __ATOMIC_ACQUIRE);
+}
+
+static bool is_own_thin_lock(uintptr_t word, uintptr_t token)
+{
+	return (word & ~LOCK_COUNT_MASK) == token;
+}
+
+static monitor_t *get_monitor(uintptr_t word)
+{
+	return (monitor_t*)(word & ~LOCK_INFLATED);
+}
+
+static void __attribute__((noreturn)) illegal_monitor_state(void)
+{
+	exceptions_throw_implicit(IMPLICIT_ILLEGAL_MONITOR_STATE);
+}
+
+static void do_futex_wait(void *data)
+{
+	const futex_wait_t *wait = (const futex_wait_t*)data;
+#ifdef __linux__
+	syscall(SYS_futex, wait->word, FUTEX_WAIT_PRIVATE, wait->value,
+	        wait->timeout, NULL, 0);
+#else
+	(void)wait;
+	sched_yield();
+#endif
+}
+
+/** Sleeps while *@p word equals @p value, spurious wakeups are possible. */
+static void futex_wait(uint32_t *word, uint32_t value,
+                       const struct timespec *timeout)
+{
+	futex_wait_t wait = { word, value, timeout };
+	thread_blocking_call(do_futex_wait, &wait);
+}
+
+static void futex_wake(uint32_t *word, int n_threads)
+{
+#ifdef __linux__
+	syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, n_threads, NULL, NULL, 0);
+#else
+	(void)word;
+	(void)n_threads;
+#endif
+}
+
+/** Mutex of "Futexes Are Tricky" by Ulrich Drepper. */
+static void monitor_lock(monitor_t *monitor)
+{
+	uint32_t state = 0;
+	if (__atomic_compare_exchange_n(&monitor->state, &state, 1, false,
+	                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		return;
+	if (state != 2)
+		state = __atomic_exchange_n(&monitor->state, 2, __ATOMIC_ACQUIRE);
+	while (state != 0) {
+		futex_wait(&monitor->state, 2, NULL);
+		state = __atomic_exchange_n(&monitor->state, 2, __ATOMIC_ACQUIRE);
+	}
+}
+
+static void monitor_unlock(monitor_t *monitor)
+{
+	if (__atomic_exchange_n(&monitor->state, 0, __ATOMIC_RELEASE) == 2)
+		futex_wake(&monitor->state, 1);
+}
+
+static void monitor_enter(monitor_t *monitor, uintptr_t token)
+{
+	if (__atomic_load_n(&monitor->owner, __ATOMIC_RELAXED) == token) {
+		++monitor->count;
+		return;
+	}
+	monitor_lock(monitor);
+	__atomic_store_n(&monitor->owner, token, __ATOMIC_RELAXED);
+	monitor->count = 1;
+}
+
+static void monitor_exit(monitor_t *monitor, uintptr_t token)
+{
+	if (__atomic_load_n(&monitor->owner, __ATOMIC_RELAXED) != token)
+		illegal_monitor_state();
+	if (--monitor->count > 0)
+		return;
+	__atomic_store_n(&monitor->owner, 0, __ATOMIC_RELAXED);
+	monitor_unlock(monitor);
+}
+
+static void panic_out_of_memory(void)
+{
+	fprintf(stderr, "panic: out of memory\n");
+	abort();
+}
+
+static void register_monitor(monitor_t *monitor)
+{
+	spin_lock(&monitors_lock);
+	if (n_monitors == monitors_size) {
+		monitors_size = monitors_size == 0 ? 64 : monitors_size * 2;
+		monitors      = realloc(monitors, monitors_size * sizeof(monitors[0]));
+		if (monitors == NULL)
+			panic_out_of_memory();
+	}
+	monitors[n_monitors++] = monitor;
+	spin_unlock(&monitors_lock);
+}
+
+/**
+ * Replaces the thin lock @p word by a monitor owned by the same thread. That
+ * thread must be the current one or kept blocked.
+ */
+static monitor_t *inflate(jobject object, uintptr_t word)
+{
+	monitor_t *monitor = malloc(sizeof(*monitor));
+	if (monitor == NULL)
+		panic_out_of_memory();
+	monitor->state      = 1;
+	monitor->owner      = word & ~LOCK_COUNT_MASK;
+	monitor->count      = (uint32_t)((word & LOCK_COUNT_MASK) / LOCK_COUNT_ONE) + 1;
+	monitor->notify_seq = 0;
+	monitor->waiters    = 0;
+	monitor->object     = object;
+	register_monitor(monitor);
+	__atomic_store_n(&object->lock, (uintptr_t)monitor | LOCK_INFLATED,
+	                 __ATOMIC_RELEASE);
+	return monitor;
+}
+
+void monitor_update_objects(java_lang_Object *(*update)(java_lang_Object *object))
+{
+	/* a thread using a monitor references its object until the exit, so
+	 * nobody uses the monitor of a dead object */
+	size_t kept = 0;
+	for (size_t i = 0; i < n_monitors; ++i) {
+		monitor_t        *monitor = monitors[i];
+		java_lang_Object *object  = update(monitor->object);
+		if (object == NULL) {
+			free(monitor);
+			continue;
+		}
+		monitor->object  = object;
+		monitors[kept++] = monitor;
+	}
+	n_monitors = kept;
+}
+
+static void lock_inflation_requests(void)
+{
+	spin_lock(&inflation_requests_lock);
+}
+
+static void unlock_inflation_requests(void)
+{
+	spin_unlock(&inflation_requests_lock);
+}
+
+/** Returns NULL if too many objects are contended already. */
+static inflation_request_t *add_inflation_request(jobject object)
+{
+	inflation_request_t *result = NULL;
+	lock_inflation_requests();
+	for (size_t i = 0; i < MAX_INFLATION_REQUESTS; ++i) {
+		inflation_request_t *request = &inflation_requests[i];
+		if (request->object == object) {
+			result = request;
+			break;
+		}
+		if (request->object == NULL && result == NULL)
+			result = request;
+	}
+	if (result != NULL) {
+		result->object = object;
+		++result->waiters;
+	}
+	unlock_inflation_requests();
+	return result;
+}
+
+static void remove_inflation_request(inflation_request_t *request)
+{
+	lock_inflation_requests();
+	if (--request->waiters == 0)
+		request->object = NULL;
+	unlock_inflation_requests();
+}
+
+void monitor_inflate_requested(void)
+{
+	uintptr_t token = self_token();
+	lock_inflation_requests();
+	for (size_t i = 0; i < MAX_INFLATION_REQUESTS; ++i) {
+		jobject object = inflation_requests[i].object;
+		if (object == NULL)
+			continue;
+		uintptr_t word = load_lock(object);
+		if (!(word & LOCK_INFLATED) && is_own_thin_lock(word, token))
+			inflate(object, word);
+	}
+	unlock_inflation_requests();
+}
+
+typedef struct blocked_owner_t {
+	jobject   object;
+	uintptr_t word;    /**< the thin lock word of the owner */
+} blocked_owner_t;
+
+static void inflate_for_owner(void *data)
+{
+	const blocked_owner_t *owner = (const blocked_owner_t*)data;
+	/* another waiting thread may have been faster */
+	if (load_lock(owner->object) == owner->word)
+		inflate(owner->object, owner->word);
+}
+
+static void back_off(unsigned round)
+{
+	if (round < YIELD_ROUNDS) {
+		sched_yield();
+		return;
+	}
+	unsigned shift = round - YIELD_ROUNDS;
+	long     ns    = shift < 10 ? 1000L << shift : MAX_SLEEP_NS;
+	if (ns > MAX_SLEEP_NS)
+		ns = MAX_SLEEP_NS;
+	struct timespec time = { 0, ns };
+	nanosleep(&time, NULL);
+}
+
+/** Waits until another thread's thin lock is released or inflated. */
+static void enter_contended(jobject object, uintptr_t token)
+{
+	inflation_request_t *request = add_inflation_request(object);
+	for (unsigned round = 0; ; ++round) {
+		uintptr_t word = load_lock(object);
+		if (word == 0) {
+			if (__atomic_compare_exchange_n(&object->lock, &word, token, false,
+			                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+				break;
+			continue;
+		}
+		if (word & LOCK_INFLATED) {
+			monitor_enter(get_monitor(word), token);
+			break;
+		}
+		/* the owner may have cleared the flag for another request */
+		if (request != NULL)
+			__atomic_or_fetch(&_Jv_safepoint_requested, SAFEPOINT_INFLATE,
+			                  __ATOMIC_RELEASE);
+		/* the owner may be stopped for a collection which waits for us */
+		if (_Jv_safepoint_requested & SAFEPOINT_COLLECT)
+			thread_stop_for_collection();
+		/* a blocked owner reaches no safepoint, maybe for a long time */
+		if (round >= YIELD_ROUNDS) {
+			blocked_owner_t owner = { object, word };
+			if (thread_call_if_blocked(word & ~LOCK_COUNT_MASK,
+			                           inflate_for_owner, &owner))
+				continue;
+		}
+		back_off(round);
+	}
+	if (request != NULL)
+		remove_inflation_request(request);
+}
+
+void _Jv_MonitorEnter(jobject object)
+{
+	uintptr_t token = self_token();
+	uintptr_t word  = load_lock(object);
+	if (word == 0
+	    && __atomic_compare_exchange_n(&object->lock, &word, token, false,
+	                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		return;
+	if (word & LOCK_INFLATED) {
+		monitor_enter(get_monitor(word), token);
+	} else if (is_own_thin_lock(word, token)) {
+		if ((word & LOCK_COUNT_MASK) != LOCK_COUNT_MASK) {
+			__atomic_store_n(&object->lock, word + LOCK_COUNT_ONE,
+			                 __ATOMIC_RELAXED);
+		} else {
+			++inflate(object, word)->count;
+		}
+	} else {
+		enter_contended(object, token);
+	}
+}
+
+void _Jv_MonitorExit(jobject object)
+{
+	uintptr_t token = self_token();
+	uintptr_t word  = load_lock(object);
+	if (word & LOCK_INFLATED) {
+		monitor_exit(get_monitor(word), token);
+		return;
+	}
+	if (!is_own_thin_lock(word, token))
+		illegal_monitor_state();
+	uintptr_t count = word & LOCK_COUNT_MASK;
+	__atomic_store_n(&object->lock, count != 0 ? word - LOCK_COUNT_ONE : 0,
+	                 __ATOMIC_RELEASE);
+}
+
+/**
+ * Returns the monitor of @p object, which the current thread must own. A
+ * thin lock is inflated if @p inflate_thin is set, otherwise NULL is
+ * returned for it.
+ */
+static monitor_t *owned_monitor(jobject object, uintptr_t token,
+                                bool inflate_thin)
+{
+	uintptr_t word = load_lock(object);
+	if (word & LOCK_INFLATED) {
+		monitor_t *monitor = get_monitor(word);
+		if (__atomic_load_n(&monitor->owner, __ATOMIC_RELAXED) != token)
+			illegal_monitor_state();
+		return monitor;
+	}
+	if (!is_own_thin_lock(word, token))
+		illegal_monitor_state();
+	return inflate_thin ? inflate(object, word) : NULL;
+}
+
+void _ZN4java4lang6Object4waitEJvxi(jobject this_, jlong timeout, jint nanos)
+{
+	if (timeout < 0 || nanos < 0 || nanos > 999999)
+		exceptions_throw_implicit(IMPLICIT_ILLEGAL_ARGUMENT);
+	uintptr_t  token   = self_token();
+	monitor_t *monitor = owned_monitor(this_, token, true);
+	uint32_t   seq     = monitor->notify_seq;
+	uint32_t   count   = monitor->count;
+
+	/* release all enters, waiting here does not keep the monitor */
+	++monitor->waiters;
+	monitor->count = 0;
+	__atomic_store_n(&monitor->owner, 0, __ATOMIC_RELAXED);
+	monitor_unlock(monitor);
+
+	struct timespec time = {
+		(time_t)(timeout / 1000), (long)(timeout % 1000) * 1000000 + nanos
+	};
+	futex_wait(&monitor->notify_seq, seq,
+	           timeout != 0 || nanos != 0 ? &time : NULL);
+
+	monitor_lock(monitor);
+	__atomic_store_n(&monitor->owner, token, __ATOMIC_RELAXED);
+	monitor->count = count;
+	--monitor->waiters;
+}
+
+static void notify(jobject object, int n_threads)
+{
+	/* nobody waits on a thin lock, waiting inflates it */
+	monitor_t *monitor = owned_monitor(object, self_token(), false);
+	if (monitor == NULL || monitor->waiters == 0)
+		return;
+	__atomic_add_fetch(&monitor->notify_seq, 1, __ATOMIC_RELEASE);
+	futex_wake(&monitor->notify_seq, n_threads);
+}
+
+void _ZN4java4lang6Object6notifyEJvv(jobject this_)
+{
+	notify(this_, 1);
+}
+
+void _ZN4java4lang6Object9notifyAllEJvv(jobject this_)
+{
+	notify(this_, INT_MAX);
+}
+
+void monitor_init(void)
+{
+	if (self_token() % LOCK_TOKEN_ALIGN != 0) {
+		fprintf(stderr, "panic: _Jv_lock_token is misaligned\n");
+		abort();
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include <stdint.h>
+
+#include "types.h"
+
+/*
+ * Encoding of java_lang_Object::lock:
+ *  - 0: unlocked.
+ *  - thin lock: the address of the owner's _Jv_lock_token, the bits below
+ *    LOCK_TOKEN_ALIGN count the recursive enters beyond the first in steps
+ *    of LOCK_COUNT_ONE. Only the owner writes a thin lock word.
+ *  - inflated: the address of a monitor_t with LOCK_INFLATED set. Objects
+ *    stay inflated once they are.
+ * The compiler inlines the uncontended cases (see gcji_lower_monitors), a
+ * compare and swap from 0 to the token and a store of 0 if the word equals
+ * the token again.
+ */
+#define LOCK_TOKEN_ALIGN  128
+#define LOCK_INFLATED     ((uintptr_t)1)
+#define LOCK_COUNT_ONE    ((uintptr_t)2)
+#define LOCK_COUNT_MASK   ((uintptr_t)(LOCK_TOKEN_ALIGN - LOCK_COUNT_ONE))
+
+typedef struct lock_token_t {
+	char bytes[LOCK_TOKEN_ALIGN];
+} lock_token_t;
+
+/**
+ * Identifies the current thread as lock owner. It is defined by the compiled
+ * program (see gcji_init) so the inline fast paths can use the cheapest TLS
+ * access model, like _Jv_tlab.
+ */
+extern __thread lock_token_t _Jv_lock_token;
+
+void _Jv_MonitorEnter(jobject object);
+void _Jv_MonitorExit(jobject object);
+
+/** Checks that the compiled program lays out _Jv_lock_token as expected. */
+void monitor_init(void);
+
+/**
+ * Inflates the thin locks of the current thread other threads wait for,
+ * called at safepoints and before the thread blocks.
+ */
+void monitor_inflate_requested(void);
+
+/**
+ * Frees the monitors of objects which died in a collection and records the
+ * new addresses of moved objects. @p update returns the new address of an
+ * object or NULL if it died. Called by the collector with the world stopped.
+ */
+void monitor_update_objects(java_lang_Object *(*update)(java_lang_Object *object));
+
+#endif
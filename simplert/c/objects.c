@@ -7,16 +7,13 @@
 #include <string.h>
 
 #include "debug.h"
+#include "heap.h"
 
 jobject _Jv_AllocObjectNoFinalizer(java_lang_Class *type)
 {
 	jint size = type->size_in_bytes;
 	assert((size_t)size >= sizeof(java_lang_Object));
-	jobject result = calloc(1, size);
-	if (result == 0) {
-		fprintf(stderr, "panic: out of memory\n");
-		abort();
-	}
+	jobject result = heap_alloc(size);
 	result->vptr = type->vtable;
 	return result;
 }
@@ -68,6 +65,12 @@ static java_lang_Class *create_array_class(java_lang_Class *eltype)
 	namecnst->len = idx;
 	namecnst->hash = calc_string_hash(name_chars, idx);
 
+	if (_ZN4java4lang5Class11isPrimitiveEJbv(eltype)) {
+		vtable->gc_descr = gc_array_descr(eltype->size_in_bytes, false);
+	} else {
+		vtable->gc_descr = gc_array_descr(sizeof(jobject), true);
+	}
+
 	arrayclass->base.vptr       = &_ZTVN4java4lang5ClassE.vtable;
 	arrayclass->vtable          = vtable;
 	arrayclass->size_in_bytes   = -1;
@@ -80,15 +83,32 @@ static java_lang_Class *create_array_class(java_lang_Class *eltype)
 
 static java_lang_Class *get_array_class(java_lang_Class *eltype)
 {
-	if (eltype->arrayclass != NULL)
-		return eltype->arrayclass;
+	java_lang_Class *arrayclass
+		= __atomic_load_n(&eltype->arrayclass, __ATOMIC_ACQUIRE);
+	if (arrayclass != NULL)
+		return arrayclass;
+
+	/* another thread may create it at the same time, the first one wins */
+	java_lang_Class *created  = create_array_class(eltype);
+	java_lang_Class *expected = NULL;
+	if (__atomic_compare_exchange_n(&eltype->arrayclass, &expected, created,
+	                                false, __ATOMIC_ACQ_REL,
+	                                __ATOMIC_ACQUIRE))
+		return created;
+	return expected;
+}
 
-	java_lang_Class *arrayclass = create_array_class(eltype);
-	eltype->arrayclass = arrayclass;
-	return arrayclass;
+static size_t array_size(size_t elsize, jint count)
+{
+	assert(count >= 0);
+	if ((size_t)count > (SIZE_MAX - sizeof(array_header_t) - HEAP_GRANULE) / elsize) {
+		fprintf(stderr, "panic: out of memory\n");
+		abort();
+	}
+	return sizeof(array_header_t) + elsize * (size_t)count;
 }
 
-jarray _Jv_NewPrimArray(java_lang_Class *eltype, jint count)
+static jarray new_prim_array(java_lang_Class *eltype, jint count, bool zero)
 {
 	if (__builtin_expect(count < 0, false)) {
 		fprintf(stderr, "throw negative array size\n");
@@ -98,15 +118,26 @@ jarray _Jv_NewPrimArray(java_lang_Class *eltype, jint count)
 	assert(eltype->vtable == (vtable_t*)-1);
 	int elsize = eltype->size_in_bytes;
 	assert(elsize > 0);
-	// TODO: check for overflow
-	size_t size = sizeof(array_header_t) + elsize * count;
+	size_t size = array_size(elsize, count);
 
-	array_header_t *result = calloc(1, size);
+	array_header_t *result
+		= zero ? heap_alloc(size) : heap_alloc_uninitialized(size);
 	result->base.vptr = get_array_class(eltype)->vtable;
+	result->base.lock = 0;
 	result->length    = count;
 	return result;
 }
 
+jarray _Jv_NewPrimArray(java_lang_Class *eltype, jint count)
+{
+	return new_prim_array(eltype, count, true);
+}
+
+jarray _Jv_NewPrimArrayUninitialized(java_lang_Class *eltype, jint count)
+{
+	return new_prim_array(eltype, count, false);
+}
+
 jarray _Jv_NewObjectArray(jsize count, java_lang_Class *eltype, jobject init)
 {
 	(void)eltype;
@@ -116,46 +147,106 @@ jarray _Jv_NewObjectArray(jsize count, java_lang_Class *eltype, jobject init)
 	}
 
 	size_t elsize = sizeof(java_lang_Object*);
-	// TODO: check for overflow
-	size_t size = sizeof(array_header_t) + elsize * count;
+	size_t size   = array_size(elsize, count);
 
-	array_header_t *result = malloc(size);
+	array_header_t *result = heap_alloc(size);
 	result->base.vptr = get_array_class(eltype)->vtable;
 	result->length    = count;
 
-	java_lang_Object **data = get_array_data(java_lang_Object*, result);
-	for (jsize i = 0; i < count; ++i) {
-		data[i] = init;
+	/* heap memory is zeroed already */
+	if (init != NULL) {
+		java_lang_Object **data = get_array_data(java_lang_Object*, result);
+		for (jsize i = 0; i < count; ++i) {
+			data[i] = init;
+		}
+		heap_mark_cards(data, (size_t)count * elsize);
 	}
 	return result;
 }
 
-jarray _Z17_Jv_NewMultiArrayPN4java4lang5ClassEiPi(java_lang_Class *type,
-	jint n_dims, jint *sizes)
+typedef struct multi_array_t {
+	java_lang_Class *type;
+	jint             n_dims;
+	const jint      *sizes;
+} multi_array_t;
+
+static size_t element_size(java_lang_Class *eltype)
 {
-	assert(_ZN4java4lang5Class7isArrayEJbv(type));
-	java_lang_Class *eltype = type->me.element_type;
+	if (_ZN4java4lang5Class11isPrimitiveEJbv(eltype))
+		return (size_t)eltype->size_in_bytes;
+	return sizeof(java_lang_Object*);
+}
 
-	jarray result;
-	if (_ZN4java4lang5Class11isPrimitiveEJbv(eltype)) {
-		assert(n_dims == 1);
-		result = _Jv_NewPrimArray(eltype, sizes[0]);
-	} else {
-		result = _Jv_NewObjectArray(sizes[0], eltype, NULL);
+/**
+ * Returns the size of all arrays of a multianewarray, they are allocated as
+ * one block.
+ */
+static size_t multi_array_size(const multi_array_t *multi)
+{
+	java_lang_Class *type     = multi->type;
+	size_t           total    = 0;
+	size_t           n_arrays = 1;  /* arrays of the current dimension */
+	for (jint d = 0; d < multi->n_dims; ++d) {
+		assert(_ZN4java4lang5Class7isArrayEJbv(type));
+		java_lang_Class *eltype = type->me.element_type;
+		jint             count  = multi->sizes[d];
+		if (__builtin_expect(count < 0, false)) {
+			fprintf(stderr, "throw negative array size\n");
+			abort();
+		}
+		size_t size = heap_align(array_size(element_size(eltype), count));
+		if (n_arrays > (SIZE_MAX - total) / size) {
+			fprintf(stderr, "panic: out of memory\n");
+			abort();
+		}
+		total    += n_arrays * size;
+		/* cannot overflow as size > count */
+		n_arrays *= (size_t)count;
+		type      = eltype;
 	}
+	return total;
+}
 
+/**
+ * Writes an array of @p type and its rows for the remaining @p n_dims sizes
+ * at @p *cursor, each array is directly followed by its rows.
+ */
+static jarray format_multi_array(java_lang_Class *type, jint n_dims,
+                                 const jint *sizes, char **cursor)
+{
+	java_lang_Class *eltype = type->me.element_type;
+	array_header_t  *result = (array_header_t*)*cursor;
+	result->base.vptr = get_array_class(eltype)->vtable;
+	result->length    = sizes[0];
+	*cursor += heap_align(array_size(element_size(eltype), sizes[0]));
+
+	/* the rows are in the same block, the stores need no card marks */
 	if (n_dims > 1) {
 		jarray *contents = get_array_data(jarray, result);
 		for (jint i = 0; i < sizes[0]; ++i) {
-			contents[i]
-				= _Z17_Jv_NewMultiArrayPN4java4lang5ClassEiPi(eltype, n_dims-1,
-				                                              sizes + 1);
+			contents[i] = format_multi_array(eltype, n_dims - 1, sizes + 1,
+			                                 cursor);
 		}
 	}
-
 	return result;
 }
 
+static void format_multi_array_block(char *begin, void *env)
+{
+	const multi_array_t *multi  = (const multi_array_t*)env;
+	char                *cursor = begin;
+	format_multi_array(multi->type, multi->n_dims, multi->sizes, &cursor);
+}
+
+jarray _Z17_Jv_NewMultiArrayPN4java4lang5ClassEiPi(java_lang_Class *type,
+	jint n_dims, jint *sizes)
+{
+	assert(n_dims > 0);
+	multi_array_t multi = { type, n_dims, sizes };
+	size_t        size  = multi_array_size(&multi);
+	return heap_alloc_objects(size, format_multi_array_block, &multi);
+}
+
 java_lang_Class *_Z17_Jv_GetArrayClassPN4java4lang5ClassEPNS0_11ClassLoaderE(
 	java_lang_Class *eltype, jobject loader)
 {
@@ -165,7 +256,7 @@ java_lang_Class *_Z17_Jv_GetArrayClassPN4java4lang5ClassEPNS0_11ClassLoaderE(
 
 jint _ZN4java4lang6Object8hashCodeEJiv(jobject this_)
 {
-	return (jint)(((intptr_t)this_) >> 3);
+	return gc_identity_hash(this_);
 }
 
 java_lang_Class *_ZN4java4lang6Object8getClassEJPNS0_5ClassEv(jobject this_)
@@ -222,20 +313,87 @@ static bool utf8_consts_equal(const utf8_const *c1, const utf8_const *c2)
 	return true;
 }
 
-jv_method *get_method(java_lang_Class *cls, const utf8_const *name,
-                      const utf8_const *signature)
+/** Must match get_method_hash_size in gcj_interface.c. */
+static size_t get_method_hash_size(int16_t method_count)
 {
-	for (int16_t m = 0, n = cls->method_count; m < n; ++m) {
-		jv_method *method = &cls->me.methods[m];
+	if (method_count <= 0)
+		return 0;
+	size_t size = 2;
+	while (size < 2 * (size_t)method_count)
+		size *= 2;
+	return size;
+}
+
+/** Must match get_method_hash_slot in gcj_interface.c. */
+static size_t get_method_hash_slot(const utf8_const *name,
+                                   const utf8_const *signature, size_t size)
+{
+	uint32_t hash = ((uint32_t)name->hash << 16 | signature->hash)
+	              * 0x9E3779B1u;
+	return (hash >> 16) & (size - 1);
+}
+
+jv_method *get_declared_method(java_lang_Class *cls, const utf8_const *name,
+                               const utf8_const *signature)
+{
+	/* the compiler puts a hash table right after the methods */
+	int16_t method_count = cls->method_count;
+	size_t  size         = get_method_hash_size(method_count);
+	if (size == 0)
+		return NULL;
+	jv_method      *methods = cls->me.methods;
+	const uint16_t *slots   = (const uint16_t*)(methods + method_count);
+	for (size_t slot = get_method_hash_slot(name, signature, size); ;
+	     slot = (slot + 1) & (size - 1)) {
+		uint16_t index = slots[slot];
+		if (index == 0)
+			return NULL;
+		jv_method *method = &methods[index - 1];
 		if (utf8_consts_equal(method->name, name)
 		    && utf8_consts_equal(method->signature, signature))
 			return method;
 	}
-	java_lang_Class *superclass = cls->superclass;
-	if (superclass != NULL)
-		return get_method(superclass, name, signature);
-	else
-		return NULL;
+}
+
+/** Number of entries of the get_method cache, a power of two. */
+#define METHOD_CACHE_SIZE 1024
+
+typedef struct method_cache_entry_t {
+	const java_lang_Class *cls;
+	const utf8_const      *name;
+	const utf8_const      *signature;
+	jv_method             *method; /**< NULL if there is none */
+} method_cache_entry_t;
+
+/**
+ * Results of get_method, including the misses. The compiler emits each
+ * utf8 constant once, so comparing the pointers finds the entries. Each
+ * thread has its own cache, the entries are written without locking.
+ */
+static __thread method_cache_entry_t method_cache[METHOD_CACHE_SIZE];
+
+jv_method *get_method(java_lang_Class *cls, const utf8_const *name,
+                      const utf8_const *signature)
+{
+	/* classes are 32 byte aligned */
+	size_t index = ((uintptr_t)cls >> 5
+	               ^ get_method_hash_slot(name, signature, METHOD_CACHE_SIZE))
+	             & (METHOD_CACHE_SIZE - 1);
+	method_cache_entry_t *entry = &method_cache[index];
+	if (entry->cls == cls && entry->name == name
+	    && entry->signature == signature)
+		return entry->method;
+
+	jv_method *method = NULL;
+	for (java_lang_Class *c = cls; c != NULL && method == NULL;
+	     c = c->superclass) {
+		method = get_declared_method(c, name, signature);
+	}
+	entry->cls       = cls;
+	entry->name      = name;
+	entry->signature = signature;
+	entry->method    = method;
+	return method;
 }
 
 void *_Jv_LookupInterfaceMethod(java_lang_Class *cls, const utf8_const *name,
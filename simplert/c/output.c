@@ -0,0 +1,270 @@
+#define _GNU_SOURCE
+#include "output.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "int_format.h"
+#include "string_kernels.h"
+#include "threads.h"
+
+output_t output_stdout = { .fd = 1 };
+output_t output_stderr = { .fd = 2 };
+
+static pthread_mutex_t output_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void output_init(void)
+{
+	output_stdout.flush_lines = isatty(output_stdout.fd);
+	output_stderr.flush_lines = true;
+	atexit(output_flush_all);
+}
+
+static void wait_for_output_lock(void *data)
+{
+	(void)data;
+	pthread_mutex_lock(&output_mutex);
+}
+
+void output_lock(void)
+{
+	/* the holder may be stuck in a write to a full pipe */
+	if (pthread_mutex_trylock(&output_mutex) != 0)
+		thread_blocking_call(wait_for_output_lock, NULL);
+}
+
+void output_unlock(void)
+{
+	pthread_mutex_unlock(&output_mutex);
+}
+
+output_t *output_get(int fd)
+{
+	assert(fd == 1 || fd == 2);
+	return fd == 1 ? &output_stdout : &output_stderr;
+}
+
+output_t *output_open(int fd)
+{
+	if (fd == output_stdout.fd || fd == output_stderr.fd)
+		return output_get(fd);
+	output_t *out = malloc(sizeof(*out));
+	if (out == NULL) {
+		fprintf(stderr, "panic: out of memory\n");
+		abort();
+	}
+	out->fd          = fd;
+	out->flush_lines = false;
+	out->failed      = false;
+	out->len         = 0;
+	return out;
+}
+
+bool output_close(output_t *out)
+{
+	output_flush(out);
+	bool ok = !out->failed;
+	if (out != &output_stdout && out != &output_stderr) {
+		if (close(out->fd) != 0)
+			ok = false;
+		free(out);
+	}
+	return ok;
+}
+
+typedef struct write_request_t {
+	output_t   *out;
+	const char *data;
+	size_t      len;
+} write_request_t;
+
+static void do_write_fully(void *data)
+{
+	write_request_t *request = (write_request_t*)data;
+	output_t        *out     = request->out;
+	while (request->len > 0) {
+		ssize_t written = write(out->fd, request->data, request->len);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			/* like PrintStream, drop the output on errors */
+			out->failed = true;
+			break;
+		}
+		request->data += written;
+		request->len  -= (size_t)written;
+	}
+}
+
+/**
+ * Writes while the thread counts as blocked, a full pipe must not hold up
+ * collections. Large writes come straight from byte arrays, the pointer in
+ * the request pins them meanwhile.
+ */
+static void write_fully(output_t *out, const char *data, size_t len)
+{
+	if (len == 0)
+		return;
+	write_request_t request = { out, data, len };
+	thread_blocking_call(do_write_fully, &request);
+}
+
+void output_flush(output_t *out)
+{
+	write_fully(out, out->data, out->len);
+	out->len = 0;
+}
+
+void output_flush_all(void)
+{
+	output_lock();
+	output_flush(&output_stdout);
+	output_flush(&output_stderr);
+	output_unlock();
+}
+
+/**
+ * Returns the number of bytes left in the buffer of @p out after making
+ * sure there are at least @p size.
+ */
+static size_t reserve(output_t *out, size_t size)
+{
+	/* keep the order of interleaved stdout and stderr output */
+	if (out == &output_stderr && output_stdout.len > 0)
+		output_flush(&output_stdout);
+	if (sizeof(out->data) - out->len < size)
+		output_flush(out);
+	return sizeof(out->data) - out->len;
+}
+
+static char *encode_utf8(char *dst, uint32_t c)
+{
+	if (c < 0x80) {
+		*dst++ = (char)c;
+	} else if (c < 0x800) {
+		*dst++ = (char)(0xC0 | (c >> 6));
+		*dst++ = (char)(0x80 | (c & 0x3F));
+	} else if (c < 0x10000) {
+		*dst++ = (char)(0xE0 | (c >> 12));
+		*dst++ = (char)(0x80 | ((c >> 6) & 0x3F));
+		*dst++ = (char)(0x80 | (c & 0x3F));
+	} else {
+		*dst++ = (char)(0xF0 | (c >> 18));
+		*dst++ = (char)(0x80 | ((c >> 12) & 0x3F));
+		*dst++ = (char)(0x80 | ((c >> 6) & 0x3F));
+		*dst++ = (char)(0x80 | (c & 0x3F));
+	}
+	return dst;
+}
+
+void output_bytes(output_t *out, const char *bytes, size_t len)
+{
+	/* don't copy what would fill the buffer anyway */
+	if (len >= sizeof(out->data)) {
+		reserve(out, sizeof(out->data));
+		write_fully(out, bytes, len);
+		return;
+	}
+	while (len > 0) {
+		size_t room  = reserve(out, 1);
+		size_t block = len < room ? len : room;
+		memcpy(out->data + out->len, bytes, block);
+		out->len += block;
+		bytes    += block;
+		len      -= block;
+	}
+}
+
+static void output_latin1(output_t *out, const uint8_t *chars, size_t n)
+{
+	while (n > 0) {
+		size_t room  = reserve(out, 2);
+		size_t block = n < room ? n : room;
+		char  *dst   = out->data + out->len;
+		if (string_kernels.is_ascii(chars, block)) {
+			memcpy(dst, chars, block);
+			dst += block;
+		} else {
+			/* up to two bytes per char */
+			if (block > room / 2)
+				block = room / 2;
+			for (size_t i = 0; i < block; ++i) {
+				dst = encode_utf8(dst, chars[i]);
+			}
+		}
+		out->len = (size_t)(dst - out->data);
+		chars   += block;
+		n       -= block;
+	}
+}
+
+static bool is_high_surrogate(jchar c)
+{
+	return c >= 0xD800 && c < 0xDC00;
+}
+
+static bool is_low_surrogate(jchar c)
+{
+	return c >= 0xDC00 && c < 0xE000;
+}
+
+static void output_utf16(output_t *out, const jchar *chars, size_t n)
+{
+	while (n > 0) {
+		/* up to three bytes per char, a surrogate pair ending the block
+		 * takes one byte more */
+		size_t room  = (reserve(out, 4) - 1) / 3;
+		size_t block = n < room ? n : room;
+		char  *dst   = out->data + out->len;
+		size_t i     = 0;
+		while (i < block) {
+			jchar c = chars[i++];
+			if (is_high_surrogate(c) && i < n && is_low_surrogate(chars[i])) {
+				uint32_t code = 0x10000 + ((uint32_t)(c - 0xD800) << 10)
+				              + (chars[i++] - 0xDC00);
+				dst = encode_utf8(dst, code);
+			} else if (is_high_surrogate(c) || is_low_surrogate(c)) {
+				*dst++ = '?';
+			} else {
+				dst = encode_utf8(dst, c);
+			}
+		}
+		out->len = (size_t)(dst - out->data);
+		chars   += i;
+		n       -= i;
+	}
+}
+
+void output_string(output_t *out, const java_lang_String *string)
+{
+	if (string->coder == STRING_CODER_LATIN1) {
+		output_latin1(out, string_latin1(string), (size_t)string->count);
+	} else {
+		output_utf16(out, string_utf16(string), (size_t)string->count);
+	}
+}
+
+void output_char(output_t *out, jchar c)
+{
+	output_utf16(out, &c, 1);
+}
+
+void output_long(output_t *out, jlong value)
+{
+	char digits[LONG_FORMAT_SIZE];
+	output_bytes(out, digits, format_long(digits, value));
+}
+
+void output_newline(output_t *out)
+{
+	reserve(out, 1);
+	out->data[out->len++] = '\n';
+	if (out->flush_lines)
+		output_flush(out);
+}
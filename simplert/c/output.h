@@ -0,0 +1,65 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "types.h"
+
+/** Size of the buffer of each output stream. */
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+
+/**
+ * Buffered output to a file descriptor, used by java.io.PrintStream and
+ * FileOutputStream. Java chars are encoded as UTF-8. The buffers are written
+ * with a single write call when full, on flush and at exit.
+ */
+typedef struct output_t {
+	int    fd;
+	bool   flush_lines;  /**< flush after each newline (terminals, stderr) */
+	bool   failed;       /**< a write failed, the output was dropped */
+	size_t len;
+	char   data[OUTPUT_BUFFER_SIZE];
+} output_t;
+
+extern output_t output_stdout;
+extern output_t output_stderr;
+
+/**
+ * Sets up stdout and stderr and makes sure that they are flushed when the
+ * program exits.
+ */
+void output_init(void);
+
+/**
+ * Serializes the output of all threads, the callers of the functions below
+ * (but output_init and output_flush_all) hold it.
+ */
+void output_lock(void);
+void output_unlock(void);
+
+/** Returns the output stream for file descriptor 1 or 2. */
+output_t *output_get(int fd);
+
+/**
+ * Returns a buffered output stream for @p fd, stdout and stderr share the
+ * ones of System.out and System.err.
+ */
+output_t *output_open(int fd);
+
+/**
+ * Flushes @p out and closes its file descriptor unless it is stdout or
+ * stderr. Returns false if any write failed.
+ */
+bool output_close(output_t *out);
+
+void output_bytes(output_t *out, const char *bytes, size_t len);
+void output_string(output_t *out, const java_lang_String *string);
+void output_char(output_t *out, jchar c);
+/** Writes @p value in decimal. */
+void output_long(output_t *out, jlong value);
+void output_newline(output_t *out);
+void output_flush(output_t *out);
+void output_flush_all(void);
+
+#endif
@@ -0,0 +1,774 @@
+/* generated by simplert/tools/gen_ryu_tables.py, do not edit */
+#ifndef RYU_TABLES_H
+#define RYU_TABLES_H
+
+#include <stdint.h>
+
+#define DOUBLE_POW5_INV_BITCOUNT 125
+#define DOUBLE_POW5_BITCOUNT     125
+#define FLOAT_POW5_INV_BITCOUNT  59
+#define FLOAT_POW5_BITCOUNT      61
+
+/** floor(2^(pow5bits(i) - 1 + 125) / 5^i) + 1 */
+static const uint64_t DOUBLE_POW5_INV_SPLIT[342][2] = {
+	{ UINT64_C(1), UINT64_C(2305843009213693952) },
+	{ UINT64_C(11068046444225730970), UINT64_C(1844674407370955161) },
+	{ UINT64_C(5165088340638674453), UINT64_C(1475739525896764129) },
+	{ UINT64_C(7821419487252849886), UINT64_C(1180591620717411303) },
+	{ UINT64_C(8824922364862649494), UINT64_C(1888946593147858085) },
+	{ UINT64_C(7059937891890119595), UINT64_C(1511157274518286468) },
+	{ UINT64_C(13026647942995916322), UINT64_C(1208925819614629174) },
+	{ UINT64_C(9774590264567735146), UINT64_C(1934281311383406679) },
+	{ UINT64_C(11509021026396098440), UINT64_C(1547425049106725343) },
+	{ UINT64_C(16585914450600699399), UINT64_C(1237940039285380274) },
+	{ UINT64_C(15469416676735388068), UINT64_C(1980704062856608439) },
+	{ UINT64_C(16064882156130220778), UINT64_C(1584563250285286751) },
+	{ UINT64_C(9162556910162266299), UINT64_C(1267650600228229401) },
+	{ UINT64_C(7281393426775805432), UINT64_C(2028240960365167042) },
+	{ UINT64_C(16893161185646375315), UINT64_C(1622592768292133633) },
+	{ UINT64_C(2446482504291369283), UINT64_C(1298074214633706907) },
+	{ UINT64_C(7603720821608101175), UINT64_C(2076918743413931051) },
+	{ UINT64_C(2393627842544570617), UINT64_C(1661534994731144841) },
+	{ UINT64_C(16672297533003297786), UINT64_C(1329227995784915872) },
+	{ UINT64_C(11918280793837635165), UINT64_C(2126764793255865396) },
+	{ UINT64_C(5845275820328197809), UINT64_C(1701411834604692317) },
+	{ UINT64_C(15744267100488289217), UINT64_C(1361129467683753853) },
+	{ UINT64_C(3054734472329800808), UINT64_C(2177807148294006166) },
+	{ UINT64_C(17201182836831481939), UINT64_C(1742245718635204932) },
+	{ UINT64_C(6382248639981364905), UINT64_C(1393796574908163946) },
+	{ UINT64_C(2832900194486363201), UINT64_C(2230074519853062314) },
+	{ UINT64_C(5955668970331000884), UINT64_C(1784059615882449851) },
+	{ UINT64_C(1075186361522890384), UINT64_C(1427247692705959881) },
+	{ UINT64_C(12788344622662355584), UINT64_C(2283596308329535809) },
+	{ UINT64_C(13920024512871794791), UINT64_C(1826877046663628647) },
+	{ UINT64_C(3757321980813615186), UINT64_C(1461501637330902918) },
+	{ UINT64_C(10384555214134712795), UINT64_C(1169201309864722334) },
+	{ UINT64_C(5547241898389809503), UINT64_C(1870722095783555735) },
+	{ UINT64_C(4437793518711847602), UINT64_C(1496577676626844588) },
+	{ UINT64_C(10928932444453298728), UINT64_C(1197262141301475670) },
+	{ UINT64_C(17486291911125277965), UINT64_C(1915619426082361072) },
+	{ UINT64_C(6610335899416401726), UINT64_C(1532495540865888858) },
+	{ UINT64_C(12666966349016942027), UINT64_C(1225996432692711086) },
+	{ UINT64_C(12888448528943286597), UINT64_C(1961594292308337738) },
+	{ UINT64_C(17689456452638449924), UINT64_C(1569275433846670190) },
+	{ UINT64_C(14151565162110759939), UINT64_C(1255420347077336152) },
+	{ UINT64_C(7885109000409574610), UINT64_C(2008672555323737844) },
+	{ UINT64_C(9997436015069570011), UINT64_C(1606938044258990275) },
+	{ UINT64_C(7997948812055656009), UINT64_C(1285550435407192220) },
+	{ UINT64_C(12796718099289049614), UINT64_C(2056880696651507552) },
+	{ UINT64_C(2858676849947419045), UINT64_C(1645504557321206042) },
+	{ UINT64_C(13354987924183666206), UINT64_C(1316403645856964833) },
+	{ UINT64_C(17678631863951955605), UINT64_C(2106245833371143733) },
+	{ UINT64_C(3074859046935833515), UINT64_C(1684996666696914987) },
+	{ UINT64_C(13527933681774397782), UINT64_C(1347997333357531989) },
+	{ UINT64_C(10576647446613305481), UINT64_C(2156795733372051183) },
+	{ UINT64_C(15840015586774465031), UINT64_C(1725436586697640946) },
+	{ UINT64_C(8982663654677661702), UINT64_C(1380349269358112757) },
+	{ UINT64_C(18061610662226169046), UINT64_C(2208558830972980411) },
+	{ UINT64_C(10759939715039024913), UINT64_C(1766847064778384329) },
+	{ UINT64_C(12297300586773130254), UINT64_C(1413477651822707463) },
+	{ UINT64_C(15986332124095098083), UINT64_C(2261564242916331941) },
+	{ UINT64_C(9099716884534168143), UINT64_C(1809251394333065553) },
+	{ UINT64_C(14658471137111155161), UINT64_C(1447401115466452442) },
+	{ UINT64_C(4348079280205103483), UINT64_C(1157920892373161954) },
+	{ UINT64_C(14335624477811986218), UINT64_C(1852673427797059126) },
+	{ UINT64_C(7779150767507678651), UINT64_C(1482138742237647301) },
+	{ UINT64_C(2533971799264232598), UINT64_C(1185710993790117841) },
+	{ UINT64_C(15122401323048503126), UINT64_C(1897137590064188545) },
+	{ UINT64_C(12097921058438802501), UINT64_C(1517710072051350836) },
+	{ UINT64_C(5988988032009131678), UINT64_C(1214168057641080669) },
+	{ UINT64_C(16961078480698431330), UINT64_C(1942668892225729070) },
+	{ UINT64_C(13568862784558745064), UINT64_C(1554135113780583256) },
+	{ UINT64_C(7165741412905085728), UINT64_C(1243308091024466605) },
+	{ UINT64_C(11465186260648137165), UINT64_C(1989292945639146568) },
+	{ UINT64_C(16550846638002330379), UINT64_C(1591434356511317254) },
+	{ UINT64_C(16930026125143774626), UINT64_C(1273147485209053803) },
+	{ UINT64_C(4951948911778577463), UINT64_C(2037035976334486086) },
+	{ UINT64_C(272210314680951647), UINT64_C(1629628781067588869) },
+	{ UINT64_C(3907117066486671641), UINT64_C(1303703024854071095) },
+	{ UINT64_C(6251387306378674625), UINT64_C(2085924839766513752) },
+	{ UINT64_C(16069156289328670670), UINT64_C(1668739871813211001) },
+	{ UINT64_C(9165976216721026213), UINT64_C(1334991897450568801) },
+	{ UINT64_C(7286864317269821294), UINT64_C(2135987035920910082) },
+	{ UINT64_C(16897537898041588005), UINT64_C(1708789628736728065) },
+	{ UINT64_C(13518030318433270404), UINT64_C(1367031702989382452) },
+	{ UINT64_C(6871453250525591353), UINT64_C(2187250724783011924) },
+	{ UINT64_C(9186511415162383406), UINT64_C(1749800579826409539) },
+	{ UINT64_C(11038557946871817048), UINT64_C(1399840463861127631) },
+	{ UINT64_C(10282995085511086630), UINT64_C(2239744742177804210) },
+	{ UINT64_C(8226396068408869304), UINT64_C(1791795793742243368) },
+	{ UINT64_C(13959814484210916090), UINT64_C(1433436634993794694) },
+	{ UINT64_C(11267656730511734774), UINT64_C(2293498615990071511) },
+	{ UINT64_C(5324776569667477496), UINT64_C(1834798892792057209) },
+	{ UINT64_C(7949170070475892320), UINT64_C(1467839114233645767) },
+	{ UINT64_C(17427382500606444826), UINT64_C(1174271291386916613) },
+	{ UINT64_C(5747719112518849781), UINT64_C(1878834066219066582) },
+	{ UINT64_C(15666221734240810795), UINT64_C(1503067252975253265) },
+	{ UINT64_C(12532977387392648636), UINT64_C(1202453802380202612) },
+	{ UINT64_C(5295368560860596524), UINT64_C(1923926083808324180) },
+	{ UINT64_C(4236294848688477220), UINT64_C(1539140867046659344) },
+	{ UINT64_C(7078384693692692099), UINT64_C(1231312693637327475) },
+	{ UINT64_C(11325415509908307358), UINT64_C(1970100309819723960) },
+	{ UINT64_C(9060332407926645887), UINT64_C(1576080247855779168) },
+	{ UINT64_C(14626963555825137356), UINT64_C(1260864198284623334) },
+	{ UINT64_C(12335095245094488799), UINT64_C(2017382717255397335) },
+	{ UINT64_C(9868076196075591040), UINT64_C(1613906173804317868) },
+	{ UINT64_C(15273158586344293478), UINT64_C(1291124939043454294) },
+	{ UINT64_C(13369007293925138595), UINT64_C(2065799902469526871) },
+	{ UINT64_C(7005857020398200553), UINT64_C(1652639921975621497) },
+	{ UINT64_C(16672732060544291412), UINT64_C(1322111937580497197) },
+	{ UINT64_C(11918976037903224966), UINT64_C(2115379100128795516) },
+	{ UINT64_C(5845832015580669650), UINT64_C(1692303280103036413) },
+	{ UINT64_C(12055363241948356366), UINT64_C(1353842624082429130) },
+	{ UINT64_C(841837113407818570), UINT64_C(2166148198531886609) },
+	{ UINT64_C(4362818505468165179), UINT64_C(1732918558825509287) },
+	{ UINT64_C(14558301248600263113), UINT64_C(1386334847060407429) },
+	{ UINT64_C(12225235553534690011), UINT64_C(2218135755296651887) },
+	{ UINT64_C(2401490813343931363), UINT64_C(1774508604237321510) },
+	{ UINT64_C(1921192650675145090), UINT64_C(1419606883389857208) },
+	{ UINT64_C(17831303500047873437), UINT64_C(2271371013423771532) },
+	{ UINT64_C(6886345170554478103), UINT64_C(1817096810739017226) },
+	{ UINT64_C(1819727321701672159), UINT64_C(1453677448591213781) },
+	{ UINT64_C(16213177116328979020), UINT64_C(1162941958872971024) },
+	{ UINT64_C(14873036941900635463), UINT64_C(1860707134196753639) },
+	{ UINT64_C(15587778368262418694), UINT64_C(1488565707357402911) },
+	{ UINT64_C(8780873879868024632), UINT64_C(1190852565885922329) },
+	{ UINT64_C(2981351763563108441), UINT64_C(1905364105417475727) },
+	{ UINT64_C(13453127855076217722), UINT64_C(1524291284333980581) },
+	{ UINT64_C(7073153469319063855), UINT64_C(1219433027467184465) },
+	{ UINT64_C(11317045550910502167), UINT64_C(1951092843947495144) },
+	{ UINT64_C(12742985255470312057), UINT64_C(1560874275157996115) },
+	{ UINT64_C(10194388204376249646), UINT64_C(1248699420126396892) },
+	{ UINT64_C(1553625868034358140), UINT64_C(1997919072202235028) },
+	{ UINT64_C(8621598323911307159), UINT64_C(1598335257761788022) },
+	{ UINT64_C(17965325103354776697), UINT64_C(1278668206209430417) },
+	{ UINT64_C(13987124906400001422), UINT64_C(2045869129935088668) },
+	{ UINT64_C(121653480894270168), UINT64_C(1636695303948070935) },
+	{ UINT64_C(97322784715416134), UINT64_C(1309356243158456748) },
+	{ UINT64_C(14913111714512307107), UINT64_C(2094969989053530796) },
+	{ UINT64_C(8241140556867935363), UINT64_C(1675975991242824637) },
+	{ UINT64_C(17660958889720079260), UINT64_C(1340780792994259709) },
+	{ UINT64_C(17189487779326395846), UINT64_C(2145249268790815535) },
+	{ UINT64_C(13751590223461116677), UINT64_C(1716199415032652428) },
+	{ UINT64_C(18379969808252713988), UINT64_C(1372959532026121942) },
+	{ UINT64_C(14650556434236701088), UINT64_C(2196735251241795108) },
+	{ UINT64_C(652398703163629901), UINT64_C(1757388200993436087) },
+	{ UINT64_C(11589965406756634890), UINT64_C(1405910560794748869) },
+	{ UINT64_C(7475898206584884855), UINT64_C(2249456897271598191) },
+	{ UINT64_C(2291369750525997561), UINT64_C(1799565517817278553) },
+	{ UINT64_C(9211793429904618695), UINT64_C(1439652414253822842) },
+	{ UINT64_C(18428218302589300235), UINT64_C(2303443862806116547) },
+	{ UINT64_C(7363877012587619542), UINT64_C(1842755090244893238) },
+	{ UINT64_C(13269799239553916280), UINT64_C(1474204072195914590) },
+	{ UINT64_C(10615839391643133024), UINT64_C(1179363257756731672) },
+	{ UINT64_C(2227947767661371545), UINT64_C(1886981212410770676) },
+	{ UINT64_C(16539753473096738529), UINT64_C(1509584969928616540) },
+	{ UINT64_C(13231802778477390823), UINT64_C(1207667975942893232) },
+	{ UINT64_C(6413489186596184024), UINT64_C(1932268761508629172) },
+	{ UINT64_C(16198837793502678189), UINT64_C(1545815009206903337) },
+	{ UINT64_C(5580372605318321905), UINT64_C(1236652007365522670) },
+	{ UINT64_C(8928596168509315048), UINT64_C(1978643211784836272) },
+	{ UINT64_C(18210923379033183008), UINT64_C(1582914569427869017) },
+	{ UINT64_C(7190041073742725760), UINT64_C(1266331655542295214) },
+	{ UINT64_C(436019273762630246), UINT64_C(2026130648867672343) },
+	{ UINT64_C(7727513048493924843), UINT64_C(1620904519094137874) },
+	{ UINT64_C(9871359253537050198), UINT64_C(1296723615275310299) },
+	{ UINT64_C(4726128361433549347), UINT64_C(2074757784440496479) },
+	{ UINT64_C(7470251503888749801), UINT64_C(1659806227552397183) },
+	{ UINT64_C(13354898832594820487), UINT64_C(1327844982041917746) },
+	{ UINT64_C(13989140502667892133), UINT64_C(2124551971267068394) },
+	{ UINT64_C(14880661216876224029), UINT64_C(1699641577013654715) },
+	{ UINT64_C(11904528973500979224), UINT64_C(1359713261610923772) },
+	{ UINT64_C(4289851098633925465), UINT64_C(2175541218577478036) },
+	{ UINT64_C(18189276137874781665), UINT64_C(1740432974861982428) },
+	{ UINT64_C(3483374466074094362), UINT64_C(1392346379889585943) },
+	{ UINT64_C(1884050330976640656), UINT64_C(2227754207823337509) },
+	{ UINT64_C(5196589079523222848), UINT64_C(1782203366258670007) },
+	{ UINT64_C(15225317707844309248), UINT64_C(1425762693006936005) },
+	{ UINT64_C(5913764258841343181), UINT64_C(2281220308811097609) },
+	{ UINT64_C(8420360221814984868), UINT64_C(1824976247048878087) },
+	{ UINT64_C(17804334621677718864), UINT64_C(1459980997639102469) },
+	{ UINT64_C(17932816512084085415), UINT64_C(1167984798111281975) },
+	{ UINT64_C(10245762345624985047), UINT64_C(1868775676978051161) },
+	{ UINT64_C(4507261061758077715), UINT64_C(1495020541582440929) },
+	{ UINT64_C(7295157664148372495), UINT64_C(1196016433265952743) },
+	{ UINT64_C(7982903447895485668), UINT64_C(1913626293225524389) },
+	{ UINT64_C(10075671573058298858), UINT64_C(1530901034580419511) },
+	{ UINT64_C(4371188443704728763), UINT64_C(1224720827664335609) },
+	{ UINT64_C(14372599139411386667), UINT64_C(1959553324262936974) },
+	{ UINT64_C(15187428126271019657), UINT64_C(1567642659410349579) },
+	{ UINT64_C(15839291315758726049), UINT64_C(1254114127528279663) },
+	{ UINT64_C(3206773216762499739), UINT64_C(2006582604045247462) },
+	{ UINT64_C(13633465017635730761), UINT64_C(1605266083236197969) },
+	{ UINT64_C(14596120828850494932), UINT64_C(1284212866588958375) },
+	{ UINT64_C(4907049252451240275), UINT64_C(2054740586542333401) },
+	{ UINT64_C(236290587219081897), UINT64_C(1643792469233866721) },
+	{ UINT64_C(14946427728742906810), UINT64_C(1315033975387093376) },
+	{ UINT64_C(16535586736504830250), UINT64_C(2104054360619349402) },
+	{ UINT64_C(5849771759720043554), UINT64_C(1683243488495479522) },
+	{ UINT64_C(15747863852001765813), UINT64_C(1346594790796383617) },
+	{ UINT64_C(10439186904235184007), UINT64_C(2154551665274213788) },
+	{ UINT64_C(15730047152871967852), UINT64_C(1723641332219371030) },
+	{ UINT64_C(12584037722297574282), UINT64_C(1378913065775496824) },
+	{ UINT64_C(9066413911450387881), UINT64_C(2206260905240794919) },
+	{ UINT64_C(10942479943902220628), UINT64_C(1765008724192635935) },
+	{ UINT64_C(8753983955121776503), UINT64_C(1412006979354108748) },
+	{ UINT64_C(10317025513452932081), UINT64_C(2259211166966573997) },
+	{ UINT64_C(874922781278525018), UINT64_C(1807368933573259198) },
+	{ UINT64_C(8078635854506640661), UINT64_C(1445895146858607358) },
+	{ UINT64_C(13841606313089133175), UINT64_C(1156716117486885886) },
+	{ UINT64_C(14767872471458792434), UINT64_C(1850745787979017418) },
+	{ UINT64_C(746251532941302978), UINT64_C(1480596630383213935) },
+	{ UINT64_C(597001226353042382), UINT64_C(1184477304306571148) },
+	{ UINT64_C(15712597221132509104), UINT64_C(1895163686890513836) },
+	{ UINT64_C(8880728962164096960), UINT64_C(1516130949512411069) },
+	{ UINT64_C(10793931984473187891), UINT64_C(1212904759609928855) },
+	{ UINT64_C(17270291175157100626), UINT64_C(1940647615375886168) },
+	{ UINT64_C(2748186495899949531), UINT64_C(1552518092300708935) },
+	{ UINT64_C(2198549196719959625), UINT64_C(1242014473840567148) },
+	{ UINT64_C(18275073973719576693), UINT64_C(1987223158144907436) },
+	{ UINT64_C(10930710364233751031), UINT64_C(1589778526515925949) },
+	{ UINT64_C(12433917106128911148), UINT64_C(1271822821212740759) },
+	{ UINT64_C(8826220925580526867), UINT64_C(2034916513940385215) },
+	{ UINT64_C(7060976740464421494), UINT64_C(1627933211152308172) },
+	{ UINT64_C(16716827836597268165), UINT64_C(1302346568921846537) },
+	{ UINT64_C(11989529279587987770), UINT64_C(2083754510274954460) },
+	{ UINT64_C(9591623423670390216), UINT64_C(1667003608219963568) },
+	{ UINT64_C(15051996368420132820), UINT64_C(1333602886575970854) },
+	{ UINT64_C(13015147745246481542), UINT64_C(2133764618521553367) },
+	{ UINT64_C(3033420566713364587), UINT64_C(1707011694817242694) },
+	{ UINT64_C(6116085268112601993), UINT64_C(1365609355853794155) },
+	{ UINT64_C(9785736428980163188), UINT64_C(2184974969366070648) },
+	{ UINT64_C(15207286772667951197), UINT64_C(1747979975492856518) },
+	{ UINT64_C(1097782973908629988), UINT64_C(1398383980394285215) },
+	{ UINT64_C(1756452758253807981), UINT64_C(2237414368630856344) },
+	{ UINT64_C(5094511021344956708), UINT64_C(1789931494904685075) },
+	{ UINT64_C(4075608817075965366), UINT64_C(1431945195923748060) },
+	{ UINT64_C(6520974107321544586), UINT64_C(2291112313477996896) },
+	{ UINT64_C(1527430471115325346), UINT64_C(1832889850782397517) },
+	{ UINT64_C(12289990821117991246), UINT64_C(1466311880625918013) },
+	{ UINT64_C(17210690286378213644), UINT64_C(1173049504500734410) },
+	{ UINT64_C(9090360384495590213), UINT64_C(1876879207201175057) },
+	{ UINT64_C(18340334751822203140), UINT64_C(1501503365760940045) },
+	{ UINT64_C(14672267801457762512), UINT64_C(1201202692608752036) },
+	{ UINT64_C(16096930852848599373), UINT64_C(1921924308174003258) },
+	{ UINT64_C(1809498238053148529), UINT64_C(1537539446539202607) },
+	{ UINT64_C(12515645034668249793), UINT64_C(1230031557231362085) },
+	{ UINT64_C(1578287981759648052), UINT64_C(1968050491570179337) },
+	{ UINT64_C(12330676829633449412), UINT64_C(1574440393256143469) },
+	{ UINT64_C(13553890278448669853), UINT64_C(1259552314604914775) },
+	{ UINT64_C(3239480371808320148), UINT64_C(2015283703367863641) },
+	{ UINT64_C(17348979556414297411), UINT64_C(1612226962694290912) },
+	{ UINT64_C(6500486015647617283), UINT64_C(1289781570155432730) },
+	{ UINT64_C(10400777625036187652), UINT64_C(2063650512248692368) },
+	{ UINT64_C(15699319729512770768), UINT64_C(1650920409798953894) },
+	{ UINT64_C(16248804598352126938), UINT64_C(1320736327839163115) },
+	{ UINT64_C(7551343283653851484), UINT64_C(2113178124542660985) },
+	{ UINT64_C(6041074626923081187), UINT64_C(1690542499634128788) },
+	{ UINT64_C(12211557331022285596), UINT64_C(1352433999707303030) },
+	{ UINT64_C(1091747655926105338), UINT64_C(2163894399531684849) },
+	{ UINT64_C(4562746939482794594), UINT64_C(1731115519625347879) },
+	{ UINT64_C(7339546366328145998), UINT64_C(1384892415700278303) },
+	{ UINT64_C(8053925371383123274), UINT64_C(2215827865120445285) },
+	{ UINT64_C(6443140297106498619), UINT64_C(1772662292096356228) },
+	{ UINT64_C(12533209867169019542), UINT64_C(1418129833677084982) },
+	{ UINT64_C(5295740528502789974), UINT64_C(2269007733883335972) },
+	{ UINT64_C(15304638867027962949), UINT64_C(1815206187106668777) },
+	{ UINT64_C(4865013464138549713), UINT64_C(1452164949685335022) },
+	{ UINT64_C(14960057215536570740), UINT64_C(1161731959748268017) },
+	{ UINT64_C(9178696285890871890), UINT64_C(1858771135597228828) },
+	{ UINT64_C(14721654658196518159), UINT64_C(1487016908477783062) },
+	{ UINT64_C(4398626097073393881), UINT64_C(1189613526782226450) },
+	{ UINT64_C(7037801755317430209), UINT64_C(1903381642851562320) },
+	{ UINT64_C(5630241404253944167), UINT64_C(1522705314281249856) },
+	{ UINT64_C(814844308661245011), UINT64_C(1218164251424999885) },
+	{ UINT64_C(1303750893857992017), UINT64_C(1949062802279999816) },
+	{ UINT64_C(15800395974054034906), UINT64_C(1559250241823999852) },
+	{ UINT64_C(5261619149759407279), UINT64_C(1247400193459199882) },
+	{ UINT64_C(12107939454356961969), UINT64_C(1995840309534719811) },
+	{ UINT64_C(5997002748743659252), UINT64_C(1596672247627775849) },
+	{ UINT64_C(8486951013736837725), UINT64_C(1277337798102220679) },
+	{ UINT64_C(2511075177753209390), UINT64_C(2043740476963553087) },
+	{ UINT64_C(13076906586428298482), UINT64_C(1634992381570842469) },
+	{ UINT64_C(14150874083884549109), UINT64_C(1307993905256673975) },
+	{ UINT64_C(4194654460505726958), UINT64_C(2092790248410678361) },
+	{ UINT64_C(18113118827372222859), UINT64_C(1674232198728542688) },
+	{ UINT64_C(3422448617672047318), UINT64_C(1339385758982834151) },
+	{ UINT64_C(16543964232501006678), UINT64_C(2143017214372534641) },
+	{ UINT64_C(9545822571258895019), UINT64_C(1714413771498027713) },
+	{ UINT64_C(15015355686490936662), UINT64_C(1371531017198422170) },
+	{ UINT64_C(5577825024675947042), UINT64_C(2194449627517475473) },
+	{ UINT64_C(11840957649224578280), UINT64_C(1755559702013980378) },
+	{ UINT64_C(16851463748863483271), UINT64_C(1404447761611184302) },
+	{ UINT64_C(12204946739213931940), UINT64_C(2247116418577894884) },
+	{ UINT64_C(13453306206113055875), UINT64_C(1797693134862315907) },
+	{ UINT64_C(3383947335406624054), UINT64_C(1438154507889852726) },
+	{ UINT64_C(16482362180876329456), UINT64_C(2301047212623764361) },
+	{ UINT64_C(9496540929959153242), UINT64_C(1840837770099011489) },
+	{ UINT64_C(11286581558709232917), UINT64_C(1472670216079209191) },
+	{ UINT64_C(5339916432225476010), UINT64_C(1178136172863367353) },
+	{ UINT64_C(4854517476818851293), UINT64_C(1885017876581387765) },
+	{ UINT64_C(3883613981455081034), UINT64_C(1508014301265110212) },
+	{ UINT64_C(14174937629389795797), UINT64_C(1206411441012088169) },
+	{ UINT64_C(11611853762797942306), UINT64_C(1930258305619341071) },
+	{ UINT64_C(5600134195496443521), UINT64_C(1544206644495472857) },
+	{ UINT64_C(15548153800622885787), UINT64_C(1235365315596378285) },
+	{ UINT64_C(6430302007287065643), UINT64_C(1976584504954205257) },
+	{ UINT64_C(16212288050055383484), UINT64_C(1581267603963364205) },
+	{ UINT64_C(12969830440044306787), UINT64_C(1265014083170691364) },
+	{ UINT64_C(9683682259845159889), UINT64_C(2024022533073106183) },
+	{ UINT64_C(15125643437359948558), UINT64_C(1619218026458484946) },
+	{ UINT64_C(8411165935146048523), UINT64_C(1295374421166787957) },
+	{ UINT64_C(17147214310975587960), UINT64_C(2072599073866860731) },
+	{ UINT64_C(10028422634038560045), UINT64_C(1658079259093488585) },
+	{ UINT64_C(8022738107230848036), UINT64_C(1326463407274790868) },
+	{ UINT64_C(9147032156827446534), UINT64_C(2122341451639665389) },
+	{ UINT64_C(11006974540203867551), UINT64_C(1697873161311732311) },
+	{ UINT64_C(5116230817421183718), UINT64_C(1358298529049385849) },
+	{ UINT64_C(15564666937357714594), UINT64_C(2173277646479017358) },
+	{ UINT64_C(1383687105660440706), UINT64_C(1738622117183213887) },
+	{ UINT64_C(12174996128754083534), UINT64_C(1390897693746571109) },
+	{ UINT64_C(8411947361780802685), UINT64_C(2225436309994513775) },
+	{ UINT64_C(6729557889424642148), UINT64_C(1780349047995611020) },
+	{ UINT64_C(5383646311539713719), UINT64_C(1424279238396488816) },
+	{ UINT64_C(1235136468979721303), UINT64_C(2278846781434382106) },
+	{ UINT64_C(15745504434151418335), UINT64_C(1823077425147505684) },
+	{ UINT64_C(16285752362063044992), UINT64_C(1458461940118004547) },
+	{ UINT64_C(5649904260166615347), UINT64_C(1166769552094403638) },
+	{ UINT64_C(5350498001524674232), UINT64_C(1866831283351045821) },
+	{ UINT64_C(591049586477829062), UINT64_C(1493465026680836657) },
+	{ UINT64_C(11540886113407994219), UINT64_C(1194772021344669325) },
+	{ UINT64_C(18673707743239135), UINT64_C(1911635234151470921) },
+	{ UINT64_C(14772334225162232601), UINT64_C(1529308187321176736) },
+	{ UINT64_C(8128518565387875758), UINT64_C(1223446549856941389) },
+	{ UINT64_C(1937583260394870242), UINT64_C(1957514479771106223) },
+	{ UINT64_C(8928764237799716840), UINT64_C(1566011583816884978) },
+	{ UINT64_C(14521709019723594119), UINT64_C(1252809267053507982) },
+	{ UINT64_C(8477339172590109297), UINT64_C(2004494827285612772) },
+	{ UINT64_C(17849917782297818407), UINT64_C(1603595861828490217) },
+	{ UINT64_C(6901236596354434079), UINT64_C(1282876689462792174) },
+	{ UINT64_C(18420676183650915173), UINT64_C(2052602703140467478) },
+	{ UINT64_C(3668494502695001169), UINT64_C(1642082162512373983) },
+	{ UINT64_C(10313493231639821582), UINT64_C(1313665730009899186) },
+	{ UINT64_C(9122891541139893884), UINT64_C(2101865168015838698) },
+	{ UINT64_C(14677010862395735754), UINT64_C(1681492134412670958) },
+	{ UINT64_C(673562245690857633), UINT64_C(1345193707530136767) },
+};
+
+/** 5^i normalized to 125 bits */
+static const uint64_t DOUBLE_POW5_SPLIT[326][2] = {
+	{ UINT64_C(0), UINT64_C(1152921504606846976) },
+	{ UINT64_C(0), UINT64_C(1441151880758558720) },
+	{ UINT64_C(0), UINT64_C(1801439850948198400) },
+	{ UINT64_C(0), UINT64_C(2251799813685248000) },
+	{ UINT64_C(0), UINT64_C(1407374883553280000) },
+	{ UINT64_C(0), UINT64_C(1759218604441600000) },
+	{ UINT64_C(0), UINT64_C(2199023255552000000) },
+	{ UINT64_C(0), UINT64_C(1374389534720000000) },
+	{ UINT64_C(0), UINT64_C(1717986918400000000) },
+	{ UINT64_C(0), UINT64_C(2147483648000000000) },
+	{ UINT64_C(0), UINT64_C(1342177280000000000) },
+	{ UINT64_C(0), UINT64_C(1677721600000000000) },
+	{ UINT64_C(0), UINT64_C(2097152000000000000) },
+	{ UINT64_C(0), UINT64_C(1310720000000000000) },
+	{ UINT64_C(0), UINT64_C(1638400000000000000) },
+	{ UINT64_C(0), UINT64_C(2048000000000000000) },
+	{ UINT64_C(0), UINT64_C(1280000000000000000) },
+	{ UINT64_C(0), UINT64_C(1600000000000000000) },
+	{ UINT64_C(0), UINT64_C(2000000000000000000) },
+	{ UINT64_C(0), UINT64_C(1250000000000000000) },
+	{ UINT64_C(0), UINT64_C(1562500000000000000) },
+	{ UINT64_C(0), UINT64_C(1953125000000000000) },
+	{ UINT64_C(0), UINT64_C(1220703125000000000) },
+	{ UINT64_C(0), UINT64_C(1525878906250000000) },
+	{ UINT64_C(0), UINT64_C(1907348632812500000) },
+	{ UINT64_C(0), UINT64_C(1192092895507812500) },
+	{ UINT64_C(0), UINT64_C(1490116119384765625) },
+	{ UINT64_C(4611686018427387904), UINT64_C(1862645149230957031) },
+	{ UINT64_C(9799832789158199296), UINT64_C(1164153218269348144) },
+	{ UINT64_C(12249790986447749120), UINT64_C(1455191522836685180) },
+	{ UINT64_C(15312238733059686400), UINT64_C(1818989403545856475) },
+	{ UINT64_C(14528612397897220096), UINT64_C(2273736754432320594) },
+	{ UINT64_C(13692068767113150464), UINT64_C(1421085471520200371) },
+	{ UINT64_C(12503399940464050176), UINT64_C(1776356839400250464) },
+	{ UINT64_C(15629249925580062720), UINT64_C(2220446049250313080) },
+	{ UINT64_C(9768281203487539200), UINT64_C(1387778780781445675) },
+	{ UINT64_C(7598665485932036096), UINT64_C(1734723475976807094) },
+	{ UINT64_C(274959820560269312), UINT64_C(2168404344971008868) },
+	{ UINT64_C(9395221924704944128), UINT64_C(1355252715606880542) },
+	{ UINT64_C(2520655369026404352), UINT64_C(1694065894508600678) },
+	{ UINT64_C(12374191248137781248), UINT64_C(2117582368135750847) },
+	{ UINT64_C(14651398557727195136), UINT64_C(1323488980084844279) },
+	{ UINT64_C(13702562178731606016), UINT64_C(1654361225106055349) },
+	{ UINT64_C(3293144668132343808), UINT64_C(2067951531382569187) },
+	{ UINT64_C(18199116482078572544), UINT64_C(1292469707114105741) },
+	{ UINT64_C(8913837547316051968), UINT64_C(1615587133892632177) },
+	{ UINT64_C(15753982952572452864), UINT64_C(2019483917365790221) },
+	{ UINT64_C(12152082354571476992), UINT64_C(1262177448353618888) },
+	{ UINT64_C(15190102943214346240), UINT64_C(1577721810442023610) },
+	{ UINT64_C(9764256642163156992), UINT64_C(1972152263052529513) },
+	{ UINT64_C(17631875447420442880), UINT64_C(1232595164407830945) },
+	{ UINT64_C(8204786253993389888), UINT64_C(1540743955509788682) },
+	{ UINT64_C(1032610780636961552), UINT64_C(1925929944387235853) },
+	{ UINT64_C(2951224747111794922), UINT64_C(1203706215242022408) },
+	{ UINT64_C(3689030933889743652), UINT64_C(1504632769052528010) },
+	{ UINT64_C(13834660704216955373), UINT64_C(1880790961315660012) },
+	{ UINT64_C(17870034976990372916), UINT64_C(1175494350822287507) },
+	{ UINT64_C(17725857702810578241), UINT64_C(1469367938527859384) },
+	{ UINT64_C(3710578054803671186), UINT64_C(1836709923159824231) },
+	{ UINT64_C(26536550077201078), UINT64_C(2295887403949780289) },
+	{ UINT64_C(11545800389866720434), UINT64_C(1434929627468612680) },
+	{ UINT64_C(14432250487333400542), UINT64_C(1793662034335765850) },
+	{ UINT64_C(8816941072311974870), UINT64_C(2242077542919707313) },
+	{ UINT64_C(17039803216263454053), UINT64_C(1401298464324817070) },
+	{ UINT64_C(12076381983474541759), UINT64_C(1751623080406021338) },
+	{ UINT64_C(5872105442488401391), UINT64_C(2189528850507526673) },
+	{ UINT64_C(15199280947623720629), UINT64_C(1368455531567204170) },
+	{ UINT64_C(9775729147674874978), UINT64_C(1710569414459005213) },
+	{ UINT64_C(16831347453020981627), UINT64_C(2138211768073756516) },
+	{ UINT64_C(1296220121283337709), UINT64_C(1336382355046097823) },
+	{ UINT64_C(15455333206886335848), UINT64_C(1670477943807622278) },
+	{ UINT64_C(10095794471753144002), UINT64_C(2088097429759527848) },
+	{ UINT64_C(6309871544845715001), UINT64_C(1305060893599704905) },
+	{ UINT64_C(12499025449484531656), UINT64_C(1631326116999631131) },
+	{ UINT64_C(11012095793428276666), UINT64_C(2039157646249538914) },
+	{ UINT64_C(11494245889320060820), UINT64_C(1274473528905961821) },
+	{ UINT64_C(532749306367912313), UINT64_C(1593091911132452277) },
+	{ UINT64_C(5277622651387278295), UINT64_C(1991364888915565346) },
+	{ UINT64_C(7910200175544436838), UINT64_C(1244603055572228341) },
+	{ UINT64_C(14499436237857933952), UINT64_C(1555753819465285426) },
+	{ UINT64_C(8900923260467641632), UINT64_C(1944692274331606783) },
+	{ UINT64_C(12480606065433357876), UINT64_C(1215432671457254239) },
+	{ UINT64_C(10989071563364309441), UINT64_C(1519290839321567799) },
+	{ UINT64_C(9124653435777998898), UINT64_C(1899113549151959749) },
+	{ UINT64_C(8008751406574943263), UINT64_C(1186945968219974843) },
+	{ UINT64_C(5399253239791291175), UINT64_C(1483682460274968554) },
+	{ UINT64_C(15972438586593889776), UINT64_C(1854603075343710692) },
+	{ UINT64_C(759402079766405302), UINT64_C(1159126922089819183) },
+	{ UINT64_C(14784310654990170340), UINT64_C(1448908652612273978) },
+	{ UINT64_C(9257016281882937117), UINT64_C(1811135815765342473) },
+	{ UINT64_C(16182956370781059300), UINT64_C(2263919769706678091) },
+	{ UINT64_C(7808504722524468110), UINT64_C(1414949856066673807) },
+	{ UINT64_C(5148944884728197234), UINT64_C(1768687320083342259) },
+	{ UINT64_C(1824495087482858639), UINT64_C(2210859150104177824) },
+	{ UINT64_C(1140309429676786649), UINT64_C(1381786968815111140) },
+	{ UINT64_C(1425386787095983311), UINT64_C(1727233711018888925) },
+	{ UINT64_C(6393419502297367043), UINT64_C(2159042138773611156) },
+	{ UINT64_C(13219259225790630210), UINT64_C(1349401336733506972) },
+	{ UINT64_C(16524074032238287762), UINT64_C(1686751670916883715) },
+	{ UINT64_C(16043406521870471799), UINT64_C(2108439588646104644) },
+	{ UINT64_C(803757039314269066), UINT64_C(1317774742903815403) },
+	{ UINT64_C(14839754354425000045), UINT64_C(1647218428629769253) },
+	{ UINT64_C(4714634887749086344), UINT64_C(2059023035787211567) },
+	{ UINT64_C(9864175832484260821), UINT64_C(1286889397367007229) },
+	{ UINT64_C(16941905809032713930), UINT64_C(1608611746708759036) },
+	{ UINT64_C(2730638187581340797), UINT64_C(2010764683385948796) },
+	{ UINT64_C(10930020904093113806), UINT64_C(1256727927116217997) },
+	{ UINT64_C(18274212148543780162), UINT64_C(1570909908895272496) },
+	{ UINT64_C(4396021111970173586), UINT64_C(1963637386119090621) },
+	{ UINT64_C(5053356204195052443), UINT64_C(1227273366324431638) },
+	{ UINT64_C(15540067292098591362), UINT64_C(1534091707905539547) },
+	{ UINT64_C(14813398096695851299), UINT64_C(1917614634881924434) },
+	{ UINT64_C(13870059828862294966), UINT64_C(1198509146801202771) },
+	{ UINT64_C(12725888767650480803), UINT64_C(1498136433501503464) },
+	{ UINT64_C(15907360959563101004), UINT64_C(1872670541876879330) },
+	{ UINT64_C(14553786618154326031), UINT64_C(1170419088673049581) },
+	{ UINT64_C(4357175217410743827), UINT64_C(1463023860841311977) },
+	{ UINT64_C(10058155040190817688), UINT64_C(1828779826051639971) },
+	{ UINT64_C(7961007781811134206), UINT64_C(2285974782564549964) },
+	{ UINT64_C(14199001900486734687), UINT64_C(1428734239102843727) },
+	{ UINT64_C(13137066357181030455), UINT64_C(1785917798878554659) },
+	{ UINT64_C(11809646928048900164), UINT64_C(2232397248598193324) },
+	{ UINT64_C(16604401366885338411), UINT64_C(1395248280373870827) },
+	{ UINT64_C(16143815690179285109), UINT64_C(1744060350467338534) },
+	{ UINT64_C(10956397575869330579), UINT64_C(2180075438084173168) },
+	{ UINT64_C(6847748484918331612), UINT64_C(1362547148802608230) },
+	{ UINT64_C(17783057643002690323), UINT64_C(1703183936003260287) },
+	{ UINT64_C(17617136035325974999), UINT64_C(2128979920004075359) },
+	{ UINT64_C(17928239049719816230), UINT64_C(1330612450002547099) },
+	{ UINT64_C(17798612793722382384), UINT64_C(1663265562503183874) },
+	{ UINT64_C(13024893955298202172), UINT64_C(2079081953128979843) },
+	{ UINT64_C(5834715712847682405), UINT64_C(1299426220705612402) },
+	{ UINT64_C(16516766677914378815), UINT64_C(1624282775882015502) },
+	{ UINT64_C(11422586310538197711), UINT64_C(2030353469852519378) },
+	{ UINT64_C(11750802462513761473), UINT64_C(1268970918657824611) },
+	{ UINT64_C(10076817059714813937), UINT64_C(1586213648322280764) },
+	{ UINT64_C(12596021324643517422), UINT64_C(1982767060402850955) },
+	{ UINT64_C(5566670318688504437), UINT64_C(1239229412751781847) },
+	{ UINT64_C(2346651879933242642), UINT64_C(1549036765939727309) },
+	{ UINT64_C(7545000868343941206), UINT64_C(1936295957424659136) },
+	{ UINT64_C(4715625542714963254), UINT64_C(1210184973390411960) },
+	{ UINT64_C(5894531928393704067), UINT64_C(1512731216738014950) },
+	{ UINT64_C(16591536947346905892), UINT64_C(1890914020922518687) },
+	{ UINT64_C(17287239619732898039), UINT64_C(1181821263076574179) },
+	{ UINT64_C(16997363506238734644), UINT64_C(1477276578845717724) },
+	{ UINT64_C(2799960309088866689), UINT64_C(1846595723557147156) },
+	{ UINT64_C(10973347230035317489), UINT64_C(1154122327223216972) },
+	{ UINT64_C(13716684037544146861), UINT64_C(1442652909029021215) },
+	{ UINT64_C(12534169028502795672), UINT64_C(1803316136286276519) },
+	{ UINT64_C(11056025267201106687), UINT64_C(2254145170357845649) },
+	{ UINT64_C(18439230838069161439), UINT64_C(1408840731473653530) },
+	{ UINT64_C(13825666510731675991), UINT64_C(1761050914342066913) },
+	{ UINT64_C(3447025083132431277), UINT64_C(2201313642927583642) },
+	{ UINT64_C(6766076695385157452), UINT64_C(1375821026829739776) },
+	{ UINT64_C(8457595869231446815), UINT64_C(1719776283537174720) },
+	{ UINT64_C(10571994836539308519), UINT64_C(2149720354421468400) },
+	{ UINT64_C(6607496772837067824), UINT64_C(1343575221513417750) },
+	{ UINT64_C(17482743002901110588), UINT64_C(1679469026891772187) },
+	{ UINT64_C(17241742735199000331), UINT64_C(2099336283614715234) },
+	{ UINT64_C(15387775227926763111), UINT64_C(1312085177259197021) },
+	{ UINT64_C(5399660979626290177), UINT64_C(1640106471573996277) },
+	{ UINT64_C(11361262242960250625), UINT64_C(2050133089467495346) },
+	{ UINT64_C(11712474920277544544), UINT64_C(1281333180917184591) },
+	{ UINT64_C(10028907631919542777), UINT64_C(1601666476146480739) },
+	{ UINT64_C(7924448521472040567), UINT64_C(2002083095183100924) },
+	{ UINT64_C(14176152362774801162), UINT64_C(1251301934489438077) },
+	{ UINT64_C(3885132398186337741), UINT64_C(1564127418111797597) },
+	{ UINT64_C(9468101516160310080), UINT64_C(1955159272639746996) },
+	{ UINT64_C(15140935484454969608), UINT64_C(1221974545399841872) },
+	{ UINT64_C(479425281859160394), UINT64_C(1527468181749802341) },
+	{ UINT64_C(5210967620751338397), UINT64_C(1909335227187252926) },
+	{ UINT64_C(17091912818251750210), UINT64_C(1193334516992033078) },
+	{ UINT64_C(12141518985959911954), UINT64_C(1491668146240041348) },
+	{ UINT64_C(15176898732449889943), UINT64_C(1864585182800051685) },
+	{ UINT64_C(11791404716994875166), UINT64_C(1165365739250032303) },
+	{ UINT64_C(10127569877816206054), UINT64_C(1456707174062540379) },
+	{ UINT64_C(8047776328842869663), UINT64_C(1820883967578175474) },
+	{ UINT64_C(836348374198811271), UINT64_C(2276104959472719343) },
+	{ UINT64_C(7440246761515338900), UINT64_C(1422565599670449589) },
+	{ UINT64_C(13911994470321561530), UINT64_C(1778206999588061986) },
+	{ UINT64_C(8166621051047176104), UINT64_C(2222758749485077483) },
+	{ UINT64_C(2798295147690791113), UINT64_C(1389224218428173427) },
+	{ UINT64_C(17332926989895652603), UINT64_C(1736530273035216783) },
+	{ UINT64_C(17054472718942177850), UINT64_C(2170662841294020979) },
+	{ UINT64_C(8353202440125167204), UINT64_C(1356664275808763112) },
+	{ UINT64_C(10441503050156459005), UINT64_C(1695830344760953890) },
+	{ UINT64_C(3828506775840797949), UINT64_C(2119787930951192363) },
+	{ UINT64_C(86973725686804766), UINT64_C(1324867456844495227) },
+	{ UINT64_C(13943775212390669669), UINT64_C(1656084321055619033) },
+	{ UINT64_C(3594660960206173375), UINT64_C(2070105401319523792) },
+	{ UINT64_C(2246663100128858359), UINT64_C(1293815875824702370) },
+	{ UINT64_C(12031700912015848757), UINT64_C(1617269844780877962) },
+	{ UINT64_C(5816254103165035138), UINT64_C(2021587305976097453) },
+	{ UINT64_C(5941001823691840913), UINT64_C(1263492066235060908) },
+	{ UINT64_C(7426252279614801142), UINT64_C(1579365082793826135) },
+	{ UINT64_C(4671129331091113523), UINT64_C(1974206353492282669) },
+	{ UINT64_C(5225298841145639904), UINT64_C(1233878970932676668) },
+	{ UINT64_C(6531623551432049880), UINT64_C(1542348713665845835) },
+	{ UINT64_C(3552843420862674446), UINT64_C(1927935892082307294) },
+	{ UINT64_C(16055585193321335241), UINT64_C(1204959932551442058) },
+	{ UINT64_C(10846109454796893243), UINT64_C(1506199915689302573) },
+	{ UINT64_C(18169322836923504458), UINT64_C(1882749894611628216) },
+	{ UINT64_C(11355826773077190286), UINT64_C(1176718684132267635) },
+	{ UINT64_C(9583097447919099954), UINT64_C(1470898355165334544) },
+	{ UINT64_C(11978871809898874942), UINT64_C(1838622943956668180) },
+	{ UINT64_C(14973589762373593678), UINT64_C(2298278679945835225) },
+	{ UINT64_C(2440964573842414192), UINT64_C(1436424174966147016) },
+	{ UINT64_C(3051205717303017741), UINT64_C(1795530218707683770) },
+	{ UINT64_C(13037379183483547984), UINT64_C(2244412773384604712) },
+	{ UINT64_C(8148361989677217490), UINT64_C(1402757983365377945) },
+	{ UINT64_C(14797138505523909766), UINT64_C(1753447479206722431) },
+	{ UINT64_C(13884737113477499304), UINT64_C(2191809349008403039) },
+	{ UINT64_C(15595489723564518921), UINT64_C(1369880843130251899) },
+	{ UINT64_C(14882676136028260747), UINT64_C(1712351053912814874) },
+	{ UINT64_C(9379973133180550126), UINT64_C(2140438817391018593) },
+	{ UINT64_C(17391698254306313589), UINT64_C(1337774260869386620) },
+	{ UINT64_C(3292878744173340370), UINT64_C(1672217826086733276) },
+	{ UINT64_C(4116098430216675462), UINT64_C(2090272282608416595) },
+	{ UINT64_C(266718509671728212), UINT64_C(1306420176630260372) },
+	{ UINT64_C(333398137089660265), UINT64_C(1633025220787825465) },
+	{ UINT64_C(5028433689789463235), UINT64_C(2041281525984781831) },
+	{ UINT64_C(10060300083759496378), UINT64_C(1275800953740488644) },
+	{ UINT64_C(12575375104699370472), UINT64_C(1594751192175610805) },
+	{ UINT64_C(1884160825592049379), UINT64_C(1993438990219513507) },
+	{ UINT64_C(17318501580490888525), UINT64_C(1245899368887195941) },
+	{ UINT64_C(7813068920331446945), UINT64_C(1557374211108994927) },
+	{ UINT64_C(5154650131986920777), UINT64_C(1946717763886243659) },
+	{ UINT64_C(915813323278131534), UINT64_C(1216698602428902287) },
+	{ UINT64_C(14979824709379828129), UINT64_C(1520873253036127858) },
+	{ UINT64_C(9501408849870009354), UINT64_C(1901091566295159823) },
+	{ UINT64_C(12855909558809837702), UINT64_C(1188182228934474889) },
+	{ UINT64_C(2234828893230133415), UINT64_C(1485227786168093612) },
+	{ UINT64_C(2793536116537666769), UINT64_C(1856534732710117015) },
+	{ UINT64_C(8663489100477123587), UINT64_C(1160334207943823134) },
+	{ UINT64_C(1605989338741628675), UINT64_C(1450417759929778918) },
+	{ UINT64_C(11230858710281811652), UINT64_C(1813022199912223647) },
+	{ UINT64_C(9426887369424876662), UINT64_C(2266277749890279559) },
+	{ UINT64_C(12809333633531629769), UINT64_C(1416423593681424724) },
+	{ UINT64_C(16011667041914537212), UINT64_C(1770529492101780905) },
+	{ UINT64_C(6179525747111007803), UINT64_C(2213161865127226132) },
+	{ UINT64_C(13085575628799155685), UINT64_C(1383226165704516332) },
+	{ UINT64_C(16356969535998944606), UINT64_C(1729032707130645415) },
+	{ UINT64_C(15834525901571292854), UINT64_C(2161290883913306769) },
+	{ UINT64_C(2979049660840976177), UINT64_C(1350806802445816731) },
+	{ UINT64_C(17558870131333383934), UINT64_C(1688508503057270913) },
+	{ UINT64_C(8113529608884566205), UINT64_C(2110635628821588642) },
+	{ UINT64_C(9682642023980241782), UINT64_C(1319147268013492901) },
+	{ UINT64_C(16714988548402690132), UINT64_C(1648934085016866126) },
+	{ UINT64_C(11670363648648586857), UINT64_C(2061167606271082658) },
+	{ UINT64_C(11905663298832754689), UINT64_C(1288229753919426661) },
+	{ UINT64_C(1047021068258779650), UINT64_C(1610287192399283327) },
+	{ UINT64_C(15143834390605638274), UINT64_C(2012858990499104158) },
+	{ UINT64_C(4853210475701136017), UINT64_C(1258036869061940099) },
+	{ UINT64_C(1454827076199032118), UINT64_C(1572546086327425124) },
+	{ UINT64_C(1818533845248790147), UINT64_C(1965682607909281405) },
+	{ UINT64_C(3442426662494187794), UINT64_C(1228551629943300878) },
+	{ UINT64_C(13526405364972510550), UINT64_C(1535689537429126097) },
+	{ UINT64_C(3072948650933474476), UINT64_C(1919611921786407622) },
+	{ UINT64_C(15755650962115585259), UINT64_C(1199757451116504763) },
+	{ UINT64_C(15082877684217093670), UINT64_C(1499696813895630954) },
+	{ UINT64_C(9630225068416591280), UINT64_C(1874621017369538693) },
+	{ UINT64_C(8324733676974063502), UINT64_C(1171638135855961683) },
+	{ UINT64_C(5794231077790191473), UINT64_C(1464547669819952104) },
+	{ UINT64_C(7242788847237739342), UINT64_C(1830684587274940130) },
+	{ UINT64_C(18276858095901949986), UINT64_C(2288355734093675162) },
+	{ UINT64_C(16034722328366106645), UINT64_C(1430222333808546976) },
+	{ UINT64_C(1596658836748081690), UINT64_C(1787777917260683721) },
+	{ UINT64_C(6607509564362490017), UINT64_C(2234722396575854651) },
+	{ UINT64_C(1823850468512862308), UINT64_C(1396701497859909157) },
+	{ UINT64_C(6891499104068465790), UINT64_C(1745876872324886446) },
+	{ UINT64_C(17837745916940358045), UINT64_C(2182346090406108057) },
+	{ UINT64_C(4231062170446641922), UINT64_C(1363966306503817536) },
+	{ UINT64_C(5288827713058302403), UINT64_C(1704957883129771920) },
+	{ UINT64_C(6611034641322878003), UINT64_C(2131197353912214900) },
+	{ UINT64_C(13355268687681574560), UINT64_C(1331998346195134312) },
+	{ UINT64_C(16694085859601968200), UINT64_C(1664997932743917890) },
+	{ UINT64_C(11644235287647684442), UINT64_C(2081247415929897363) },
+	{ UINT64_C(4971804045566108824), UINT64_C(1300779634956185852) },
+	{ UINT64_C(6214755056957636030), UINT64_C(1625974543695232315) },
+	{ UINT64_C(3156757802769657134), UINT64_C(2032468179619040394) },
+	{ UINT64_C(6584659645158423613), UINT64_C(1270292612261900246) },
+	{ UINT64_C(17454196593302805324), UINT64_C(1587865765327375307) },
+	{ UINT64_C(17206059723201118751), UINT64_C(1984832206659219134) },
+	{ UINT64_C(6142101308573311315), UINT64_C(1240520129162011959) },
+	{ UINT64_C(3065940617289251240), UINT64_C(1550650161452514949) },
+	{ UINT64_C(8444111790038951954), UINT64_C(1938312701815643686) },
+	{ UINT64_C(665883850346957067), UINT64_C(1211445438634777304) },
+	{ UINT64_C(832354812933696334), UINT64_C(1514306798293471630) },
+	{ UINT64_C(10263815553021896226), UINT64_C(1892883497866839537) },
+	{ UINT64_C(17944099766707154901), UINT64_C(1183052186166774710) },
+	{ UINT64_C(13206752671529167818), UINT64_C(1478815232708468388) },
+	{ UINT64_C(16508440839411459773), UINT64_C(1848519040885585485) },
+	{ UINT64_C(12623618533845856310), UINT64_C(1155324400553490928) },
+	{ UINT64_C(15779523167307320387), UINT64_C(1444155500691863660) },
+	{ UINT64_C(1277659885424598868), UINT64_C(1805194375864829576) },
+	{ UINT64_C(1597074856780748586), UINT64_C(2256492969831036970) },
+	{ UINT64_C(5609857803915355770), UINT64_C(1410308106144398106) },
+	{ UINT64_C(16235694291748970521), UINT64_C(1762885132680497632) },
+	{ UINT64_C(1847873790976661535), UINT64_C(2203606415850622041) },
+	{ UINT64_C(12684136165428883219), UINT64_C(1377254009906638775) },
+	{ UINT64_C(11243484188358716120), UINT64_C(1721567512383298469) },
+	{ UINT64_C(219297180166231438), UINT64_C(2151959390479123087) },
+	{ UINT64_C(7054589765244976505), UINT64_C(1344974619049451929) },
+	{ UINT64_C(13429923224983608535), UINT64_C(1681218273811814911) },
+	{ UINT64_C(12175718012802122765), UINT64_C(2101522842264768639) },
+	{ UINT64_C(14527352785642408584), UINT64_C(1313451776415480399) },
+	{ UINT64_C(13547504963625622826), UINT64_C(1641814720519350499) },
+	{ UINT64_C(12322695186104640628), UINT64_C(2052268400649188124) },
+	{ UINT64_C(16925056528170176201), UINT64_C(1282667750405742577) },
+	{ UINT64_C(7321262604930556539), UINT64_C(1603334688007178222) },
+	{ UINT64_C(18374950293017971482), UINT64_C(2004168360008972777) },
+	{ UINT64_C(4566814905495150320), UINT64_C(1252605225005607986) },
+	{ UINT64_C(14931890668723713708), UINT64_C(1565756531257009982) },
+	{ UINT64_C(9441491299049866327), UINT64_C(1957195664071262478) },
+	{ UINT64_C(1289246043478778550), UINT64_C(1223247290044539049) },
+	{ UINT64_C(6223243572775861092), UINT64_C(1529059112555673811) },
+	{ UINT64_C(3167368447542438461), UINT64_C(1911323890694592264) },
+	{ UINT64_C(1979605279714024038), UINT64_C(1194577431684120165) },
+	{ UINT64_C(7086192618069917952), UINT64_C(1493221789605150206) },
+	{ UINT64_C(18081112809442173248), UINT64_C(1866527237006437757) },
+	{ UINT64_C(13606538515115052232), UINT64_C(1166579523129023598) },
+	{ UINT64_C(7784801107039039482), UINT64_C(1458224403911279498) },
+	{ UINT64_C(507629346944023544), UINT64_C(1822780504889099373) },
+	{ UINT64_C(5246222702107417334), UINT64_C(2278475631111374216) },
+	{ UINT64_C(3278889188817135834), UINT64_C(1424047269444608885) },
+	{ UINT64_C(8710297504448807696), UINT64_C(1780059086805761106) },
+};
+
+/** floor(2^(pow5bits(i) - 1 + 59) / 5^i) + 1 */
+static const uint64_t FLOAT_POW5_INV_SPLIT[31] = {
+	UINT64_C(576460752303423489),
+	UINT64_C(461168601842738791),
+	UINT64_C(368934881474191033),
+	UINT64_C(295147905179352826),
+	UINT64_C(472236648286964522),
+	UINT64_C(377789318629571618),
+	UINT64_C(302231454903657294),
+	UINT64_C(483570327845851670),
+	UINT64_C(386856262276681336),
+	UINT64_C(309485009821345069),
+	UINT64_C(495176015714152110),
+	UINT64_C(396140812571321688),
+	UINT64_C(316912650057057351),
+	UINT64_C(507060240091291761),
+	UINT64_C(405648192073033409),
+	UINT64_C(324518553658426727),
+	UINT64_C(519229685853482763),
+	UINT64_C(415383748682786211),
+	UINT64_C(332306998946228969),
+	UINT64_C(531691198313966350),
+	UINT64_C(425352958651173080),
+	UINT64_C(340282366920938464),
+	UINT64_C(544451787073501542),
+	UINT64_C(435561429658801234),
+	UINT64_C(348449143727040987),
+	UINT64_C(557518629963265579),
+	UINT64_C(446014903970612463),
+	UINT64_C(356811923176489971),
+	UINT64_C(570899077082383953),
+	UINT64_C(456719261665907162),
+	UINT64_C(365375409332725730),
+};
+
+/** 5^i normalized to 61 bits */
+static const uint64_t FLOAT_POW5_SPLIT[47] = {
+	UINT64_C(1152921504606846976),
+	UINT64_C(1441151880758558720),
+	UINT64_C(1801439850948198400),
+	UINT64_C(2251799813685248000),
+	UINT64_C(1407374883553280000),
+	UINT64_C(1759218604441600000),
+	UINT64_C(2199023255552000000),
+	UINT64_C(1374389534720000000),
+	UINT64_C(1717986918400000000),
+	UINT64_C(2147483648000000000),
+	UINT64_C(1342177280000000000),
+	UINT64_C(1677721600000000000),
+	UINT64_C(2097152000000000000),
+	UINT64_C(1310720000000000000),
+	UINT64_C(1638400000000000000),
+	UINT64_C(2048000000000000000),
+	UINT64_C(1280000000000000000),
+	UINT64_C(1600000000000000000),
+	UINT64_C(2000000000000000000),
+	UINT64_C(1250000000000000000),
+	UINT64_C(1562500000000000000),
+	UINT64_C(1953125000000000000),
+	UINT64_C(1220703125000000000),
+	UINT64_C(1525878906250000000),
+	UINT64_C(1907348632812500000),
+	UINT64_C(1192092895507812500),
+	UINT64_C(1490116119384765625),
+	UINT64_C(1862645149230957031),
+	UINT64_C(1164153218269348144),
+	UINT64_C(1455191522836685180),
+	UINT64_C(1818989403545856475),
+	UINT64_C(2273736754432320594),
+	UINT64_C(1421085471520200371),
+	UINT64_C(1776356839400250464),
+	UINT64_C(2220446049250313080),
+	UINT64_C(1387778780781445675),
+	UINT64_C(1734723475976807094),
+	UINT64_C(2168404344971008868),
+	UINT64_C(1355252715606880542),
+	UINT64_C(1694065894508600678),
+	UINT64_C(2117582368135750847),
+	UINT64_C(1323488980084844279),
+	UINT64_C(1654361225106055349),
+	UINT64_C(2067951531382569187),
+	UINT64_C(1292469707114105741),
+	UINT64_C(1615587133892632177),
+	UINT64_C(2019483917365790221),
+};
+
+#endif
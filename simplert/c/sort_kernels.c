@@ -0,0 +1,314 @@
+#include "sort_kernels.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Partitions of at most this many elements are insertion sorted. */
+#define INSERTION_SORT_SIZE 24
+/** Partitions longer than this take Tukey's ninther as pivot. */
+#define NINTHER_SIZE        128
+/** Byte arrays longer than this are counting sorted. */
+#define COUNTING_SORT_BYTES 64
+/** Char arrays at least this long are counting sorted. */
+#define COUNTING_SORT_CHARS (1 << 15)
+
+static unsigned depth_limit(size_t n)
+{
+	unsigned depth = 0;
+	for (; n > 1; n >>= 1)
+		depth += 2;
+	return depth;
+}
+
+/*
+ * Introsort: quicksort with Hoare partitioning, which splits runs of equal
+ * values evenly. The pivot is the median of the first, middle and last
+ * value, or of three such medians for long partitions, which organ pipes
+ * and sawtooth patterns don't fool. Partitions which get split too often
+ * are heap sorted, small ones are insertion sorted.
+ *
+ * As in pdqsort, an unbalanced partition swaps some values around so a
+ * pattern doesn't cause the next one, and a partition whose pivot equals
+ * the value in front of it (a lower bound of all its values) moves the
+ * values equal to the pivot to the front and is done with them, so few
+ * distinct values take few passes. Presorted and reversed arrays are
+ * recognized in one pass.
+ */
+#define DEFINE_INTRO_SORT(T)                                                   \
+static void swap_##T(T *values, size_t a, size_t b)                            \
+{                                                                              \
+	T tmp     = values[a];                                                 \
+	values[a] = values[b];                                                 \
+	values[b] = tmp;                                                       \
+}                                                                              \
+                                                                               \
+static void insertion_sort_##T(T *values, size_t n)                            \
+{                                                                              \
+	for (size_t i = 1; i < n; ++i) {                                       \
+		T      value = values[i];                                      \
+		size_t j     = i;                                              \
+		for (; j > 0 && value < values[j - 1]; --j)                    \
+			values[j] = values[j - 1];                             \
+		values[j] = value;                                             \
+	}                                                                      \
+}                                                                              \
+                                                                               \
+static void sift_down_##T(T *values, size_t root, size_t n)                    \
+{                                                                              \
+	T value = values[root];                                                \
+	for (size_t child; (child = 2 * root + 1) < n; root = child) {         \
+		if (child + 1 < n && values[child] < values[child + 1])        \
+			++child;                                               \
+		if (!(value < values[child]))                                  \
+			break;                                                 \
+		values[root] = values[child];                                  \
+	}                                                                      \
+	values[root] = value;                                                  \
+}                                                                              \
+                                                                               \
+static void heap_sort_##T(T *values, size_t n)                                 \
+{                                                                              \
+	for (size_t i = n / 2; i-- > 0; )                                      \
+		sift_down_##T(values, i, n);                                   \
+	for (size_t end = n; end-- > 1; ) {                                    \
+		swap_##T(values, 0, end);                                      \
+		sift_down_##T(values, 0, end);                                 \
+	}                                                                      \
+}                                                                              \
+                                                                               \
+/** Returns the index of the median of the values at @p a, @p b and @p c. */   \
+static size_t median_##T(const T *values, size_t a, size_t b, size_t c)        \
+{                                                                              \
+	if (values[a] < values[b]) {                                           \
+		return values[b] < values[c] ? b                               \
+		     : values[a] < values[c] ? c : a;                          \
+	}                                                                      \
+	return values[a] < values[c] ? a                                      \
+	     : values[b] < values[c] ? c : b;                                  \
+}                                                                              \
+                                                                               \
+/** Moves the pivot to the front. */                                           \
+static void move_pivot_##T(T *values, size_t n)                                \
+{                                                                              \
+	size_t mid = n / 2;                                                    \
+	size_t median;                                                         \
+	if (n > NINTHER_SIZE) {                                                \
+		size_t step = n / 8;                                           \
+		median = median_##T(values,                                    \
+			median_##T(values, 0, step, 2 * step),                 \
+			median_##T(values, mid - step, mid, mid + step),       \
+			median_##T(values, n - 1 - 2 * step, n - 1 - step,     \
+			           n - 1));                                    \
+	} else {                                                               \
+		median = median_##T(values, 0, mid, n - 1);                    \
+	}                                                                      \
+	swap_##T(values, 0, median);                                           \
+}                                                                              \
+                                                                               \
+/** Swaps the values at the pivot samples with pseudo random ones. */          \
+static void break_pattern_##T(T *values, size_t n)                             \
+{                                                                              \
+	uint64_t random = n;                                                   \
+	size_t   step   = n / 8;                                               \
+	for (size_t k = 0; k < 8; ++k) {                                       \
+		random ^= random << 13;                                        \
+		random ^= random >> 7;                                         \
+		random ^= random << 17;                                        \
+		swap_##T(values, k * step, (size_t)(random % n));              \
+	}                                                                      \
+}                                                                              \
+                                                                               \
+/**                                                                            \
+ * Sorts @p values, if @p bounded is set values[-1] is not greater than any    \
+ * of them.                                                                    \
+ */                                                                            \
+static void intro_sort_##T(T *values, size_t n, unsigned depth, bool bounded) \
+{                                                                              \
+	while (n > INSERTION_SORT_SIZE) {                                      \
+		if (depth == 0) {                                              \
+			heap_sort_##T(values, n);                              \
+			return;                                                \
+		}                                                              \
+		--depth;                                                       \
+                                                                               \
+		move_pivot_##T(values, n);                                     \
+		T pivot = values[0];                                           \
+		if (bounded && !(values[-1] < pivot)) {                        \
+			/* the pivot is the minimum, skip all its copies */    \
+			size_t equal = 0;                                      \
+			for (size_t k = 0; k < n; ++k) {                       \
+				if (!(pivot < values[k]))                      \
+					swap_##T(values, equal++, k);          \
+			}                                                      \
+			values += equal;                                       \
+			n      -= equal;                                       \
+			continue;                                              \
+		}                                                              \
+                                                                               \
+		/* the pivot at the front stops both scans */                  \
+		size_t i = 0;                                                  \
+		size_t j = n;                                                  \
+		for (;;) {                                                     \
+			while (values[i] < pivot)                              \
+				++i;                                           \
+			do {                                                   \
+				--j;                                           \
+			} while (pivot < values[j]);                           \
+			if (i >= j)                                            \
+				break;                                         \
+			swap_##T(values, i, j);                                \
+			++i;                                                   \
+		}                                                              \
+                                                                               \
+		/* [0, j] and [j+1, n), values[j] bounds the right part */     \
+		size_t left = j + 1;                                           \
+		if ((left < n - left ? left : n - left) < n / 8) {             \
+			if (left > INSERTION_SORT_SIZE)                        \
+				break_pattern_##T(values, left);               \
+			if (n - left > INSERTION_SORT_SIZE)                    \
+				break_pattern_##T(values + left, n - left);    \
+		}                                                              \
+		/* recurse into the smaller part */                            \
+		if (left < n - left) {                                         \
+			intro_sort_##T(values, left, depth, bounded);          \
+			values  += left;                                       \
+			n       -= left;                                       \
+			bounded  = true;                                       \
+		} else {                                                       \
+			intro_sort_##T(values + left, n - left, depth, true);  \
+			n = left;                                              \
+		}                                                              \
+	}                                                                      \
+	insertion_sort_##T(values, n);                                         \
+}                                                                              \
+                                                                               \
+static void sort_##T(T *values, size_t n)                                      \
+{                                                                              \
+	size_t run = 1;                                                        \
+	while (run < n && !(values[run] < values[run - 1]))                    \
+		++run;                                                         \
+	if (run >= n)                                                          \
+		return;                                                        \
+	if (run == 1) {                                                        \
+		while (run < n && !(values[run - 1] < values[run]))            \
+			++run;                                                 \
+		if (run == n) {                                                \
+			for (size_t i = 0; i < n / 2; ++i)                     \
+				swap_##T(values, i, n - 1 - i);                \
+			return;                                                \
+		}                                                              \
+	}                                                                      \
+	intro_sort_##T(values, n, depth_limit(n), false);                      \
+}
+
+DEFINE_INTRO_SORT(jbyte)
+DEFINE_INTRO_SORT(jchar)
+DEFINE_INTRO_SORT(jshort)
+DEFINE_INTRO_SORT(jint)
+DEFINE_INTRO_SORT(jlong)
+
+void sort_bytes(jbyte *values, size_t n)
+{
+	if (n <= COUNTING_SORT_BYTES) {
+		sort_jbyte(values, n);
+		return;
+	}
+
+	/* array lengths are jints, the counts can't overflow */
+	uint32_t counts[256];
+	memset(counts, 0, sizeof(counts));
+	for (size_t i = 0; i < n; ++i) {
+		++counts[(uint8_t)values[i] ^ 0x80];
+	}
+	jbyte *out = values;
+	for (unsigned v = 0; v < 256; ++v) {
+		memset(out, (int)(v ^ 0x80), counts[v]);
+		out += counts[v];
+	}
+}
+
+void sort_chars(jchar *values, size_t n)
+{
+	uint32_t *counts = n >= COUNTING_SORT_CHARS
+	                 ? calloc(UINT16_MAX + 1, sizeof(uint32_t)) : NULL;
+	if (counts == NULL) {
+		sort_jchar(values, n);
+		return;
+	}
+
+	for (size_t i = 0; i < n; ++i) {
+		++counts[values[i]];
+	}
+	jchar *out = values;
+	for (uint32_t v = 0; v <= UINT16_MAX; ++v) {
+		for (uint32_t c = counts[v]; c > 0; --c) {
+			*out++ = (jchar)v;
+		}
+	}
+	free(counts);
+}
+
+void sort_shorts(jshort *values, size_t n)
+{
+	sort_jshort(values, n);
+}
+
+void sort_ints(jint *values, size_t n)
+{
+	sort_jint(values, n);
+}
+
+void sort_longs(jlong *values, size_t n)
+{
+	sort_jlong(values, n);
+}
+
+/*
+ * Floating point values are sorted as integers: flipping all bits but the
+ * sign of negative values makes the integer order of the bit patterns match
+ * the order of Double.compareTo, including -0.0 < 0.0. The transformation
+ * is its own inverse. NaNs would end up on both sides, they are moved to
+ * the end first. The values are only accessed as integers.
+ */
+
+void sort_floats(jfloat *values, size_t n)
+{
+	int32_t *keys = (int32_t*)values;
+	size_t   end  = n;
+	for (size_t i = 0; i < end; ) {
+		int32_t bits = keys[i];
+		if ((bits & INT32_MAX) > 0x7f800000) {
+			keys[i]   = keys[--end];
+			keys[end] = bits;
+		} else {
+			keys[i] = bits ^ (int32_t)((uint32_t)(bits >> 31) >> 1);
+			++i;
+		}
+	}
+	sort_ints(keys, end);
+	for (size_t i = 0; i < end; ++i) {
+		keys[i] ^= (int32_t)((uint32_t)(keys[i] >> 31) >> 1);
+	}
+}
+
+void sort_doubles(jdouble *values, size_t n)
+{
+	int64_t *keys = (int64_t*)values;
+	size_t   end  = n;
+	for (size_t i = 0; i < end; ) {
+		int64_t bits = keys[i];
+		if ((bits & INT64_MAX) > 0x7ff0000000000000) {
+			keys[i]   = keys[--end];
+			keys[end] = bits;
+		} else {
+			keys[i] = bits ^ (int64_t)((uint64_t)(bits >> 63) >> 1);
+			++i;
+		}
+	}
+	sort_longs(keys, end);
+	for (size_t i = 0; i < end; ++i) {
+		keys[i] ^= (int64_t)((uint64_t)(keys[i] >> 63) >> 1);
+	}
+}
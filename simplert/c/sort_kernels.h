@@ -0,0 +1,21 @@
+#ifndef SORT_KERNELS_H
+#define SORT_KERNELS_H
+
+#include <stddef.h>
+
+#include "types.h"
+
+/*
+ * Ascending sorts of primitive values for java.util.Arrays.sort. Floating
+ * point values are ordered like Double.compareTo does: -0.0 comes before
+ * 0.0 and NaNs come last.
+ */
+void sort_bytes(jbyte *values, size_t n);
+void sort_chars(jchar *values, size_t n);
+void sort_shorts(jshort *values, size_t n);
+void sort_ints(jint *values, size_t n);
+void sort_longs(jlong *values, size_t n);
+void sort_floats(jfloat *values, size_t n);
+void sort_doubles(jdouble *values, size_t n);
+
+#endif
@@ -0,0 +1,501 @@
+#include "string_kernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+string_kernels_t string_kernels;
+
+/* powers of the hash multiplier, unsigned arithmetic wraps like jint */
+#define HASH_P1 ((uint32_t)STRING_HASH_MULTIPLIER)
+#define HASH_P2 (HASH_P1 * HASH_P1)
+#define HASH_P4 (HASH_P2 * HASH_P2)
+static const uint32_t hash_powers[] = {
+	1, HASH_P1, HASH_P2, HASH_P2 * HASH_P1, HASH_P4, HASH_P4 * HASH_P1,
+	HASH_P4 * HASH_P2, HASH_P4 * HASH_P2 * HASH_P1, HASH_P4 * HASH_P4
+};
+
+/**
+ * The vector hash loops keep one hash per lane, lane l covering the chars
+ * at positions l, l + n_lanes, ... Lane l is then weighted with
+ * multiplier^(n_lanes - 1 - l).
+ */
+static uint32_t combine_hash_lanes(const uint32_t *lanes, unsigned n_lanes)
+{
+	uint32_t hash = 0;
+	for (unsigned l = 0; l < n_lanes; ++l) {
+		hash += lanes[l] * hash_powers[n_lanes - 1 - l];
+	}
+	return hash;
+}
+
+/*
+ * Scalar kernels
+ */
+
+static size_t mismatch_latin1_scalar(const uint8_t *a, const uint8_t *b,
+                                     size_t n)
+{
+	size_t i = 0;
+	while (i < n && a[i] == b[i])
+		++i;
+	return i;
+}
+
+static size_t mismatch_utf16_scalar(const jchar *a, const jchar *b, size_t n)
+{
+	size_t i = 0;
+	while (i < n && a[i] == b[i])
+		++i;
+	return i;
+}
+
+static size_t find_latin1_scalar(const uint8_t *chars, size_t n, uint8_t c)
+{
+	size_t i = 0;
+	while (i < n && chars[i] != c)
+		++i;
+	return i;
+}
+
+static size_t find_utf16_scalar(const jchar *chars, size_t n, jchar c)
+{
+	size_t i = 0;
+	while (i < n && chars[i] != c)
+		++i;
+	return i;
+}
+
+static bool is_ascii_scalar(const uint8_t *bytes, size_t n)
+{
+	uint8_t bits = 0;
+	for (size_t i = 0; i < n; ++i) {
+		bits |= bytes[i];
+	}
+	return bits < 0x80;
+}
+
+static bool is_latin1_scalar(const jchar *chars, size_t n)
+{
+	jchar bits = 0;
+	for (size_t i = 0; i < n; ++i) {
+		bits |= chars[i];
+	}
+	return bits <= 0xFF;
+}
+
+static void widen_scalar(jchar *dst, const uint8_t *src, size_t n)
+{
+	for (size_t i = 0; i < n; ++i) {
+		dst[i] = src[i];
+	}
+}
+
+static void narrow_scalar(uint8_t *dst, const jchar *src, size_t n)
+{
+	for (size_t i = 0; i < n; ++i) {
+		dst[i] = (uint8_t)src[i];
+	}
+}
+
+static jint hash_latin1_scalar(jint hash, const uint8_t *chars, size_t n)
+{
+	uint32_t h = (uint32_t)hash;
+	for (size_t i = 0; i < n; ++i) {
+		h = h * STRING_HASH_MULTIPLIER + chars[i];
+	}
+	return (jint)h;
+}
+
+static jint hash_utf16_scalar(jint hash, const jchar *chars, size_t n)
+{
+	uint32_t h = (uint32_t)hash;
+	for (size_t i = 0; i < n; ++i) {
+		h = h * STRING_HASH_MULTIPLIER + chars[i];
+	}
+	return (jint)h;
+}
+
+const string_kernels_t string_kernels_scalar = {
+	"scalar",
+	mismatch_latin1_scalar, mismatch_utf16_scalar,
+	find_latin1_scalar, find_utf16_scalar,
+	is_ascii_scalar, is_latin1_scalar,
+	widen_scalar, narrow_scalar,
+	hash_latin1_scalar, hash_utf16_scalar
+};
+
+#if defined(__x86_64__)
+
+/*
+ * SSE2 kernels, SSE2 is part of x86-64 so they need no check.
+ */
+
+static size_t mismatch_latin1_sse2(const uint8_t *a, const uint8_t *b,
+                                   size_t n)
+{
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i  va   = _mm_loadu_si128((const __m128i*)(a + i));
+		__m128i  vb   = _mm_loadu_si128((const __m128i*)(b + i));
+		unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+		if (mask != 0xFFFF)
+			return i + __builtin_ctz(~mask);
+	}
+	return i + mismatch_latin1_scalar(a + i, b + i, n - i);
+}
+
+static size_t mismatch_utf16_sse2(const jchar *a, const jchar *b, size_t n)
+{
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i  va   = _mm_loadu_si128((const __m128i*)(a + i));
+		__m128i  vb   = _mm_loadu_si128((const __m128i*)(b + i));
+		unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(va, vb));
+		if (mask != 0xFFFF)
+			return i + __builtin_ctz(~mask) / 2;
+	}
+	return i + mismatch_utf16_scalar(a + i, b + i, n - i);
+}
+
+static size_t find_latin1_sse2(const uint8_t *chars, size_t n, uint8_t c)
+{
+	__m128i needle = _mm_set1_epi8((char)c);
+	size_t  i      = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i  v    = _mm_loadu_si128((const __m128i*)(chars + i));
+		unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle));
+		if (mask != 0)
+			return i + __builtin_ctz(mask);
+	}
+	return i + find_latin1_scalar(chars + i, n - i, c);
+}
+
+static size_t find_utf16_sse2(const jchar *chars, size_t n, jchar c)
+{
+	__m128i needle = _mm_set1_epi16((short)c);
+	size_t  i      = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i  v    = _mm_loadu_si128((const __m128i*)(chars + i));
+		unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(v, needle));
+		if (mask != 0)
+			return i + __builtin_ctz(mask) / 2;
+	}
+	return i + find_utf16_scalar(chars + i, n - i, c);
+}
+
+static bool is_ascii_sse2(const uint8_t *bytes, size_t n)
+{
+	__m128i bits = _mm_setzero_si128();
+	size_t  i    = 0;
+	for (; i + 16 <= n; i += 16) {
+		bits = _mm_or_si128(bits,
+		                    _mm_loadu_si128((const __m128i*)(bytes + i)));
+	}
+	return _mm_movemask_epi8(bits) == 0 && is_ascii_scalar(bytes + i, n - i);
+}
+
+static bool is_latin1_sse2(const jchar *chars, size_t n)
+{
+	__m128i bits = _mm_setzero_si128();
+	size_t  i    = 0;
+	for (; i + 8 <= n; i += 8) {
+		bits = _mm_or_si128(bits,
+		                    _mm_loadu_si128((const __m128i*)(chars + i)));
+	}
+	__m128i high = _mm_and_si128(bits, _mm_set1_epi16((short)0xFF00));
+	__m128i zero = _mm_cmpeq_epi8(high, _mm_setzero_si128());
+	return _mm_movemask_epi8(zero) == 0xFFFF
+	    && is_latin1_scalar(chars + i, n - i);
+}
+
+static void widen_sse2(jchar *dst, const uint8_t *src, size_t n)
+{
+	__m128i zero = _mm_setzero_si128();
+	size_t  i    = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(v, zero));
+		_mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+	}
+	widen_scalar(dst + i, src + i, n - i);
+}
+
+static void narrow_sse2(uint8_t *dst, const jchar *src, size_t n)
+{
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i lo = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i hi = _mm_loadu_si128((const __m128i*)(src + i + 8));
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+	}
+	narrow_scalar(dst + i, src + i, n - i);
+}
+
+/** 32 bit lane multiplication, pmulld is SSE4.1. */
+static inline __m128i mullo_epi32_sse2(__m128i a, __m128i b)
+{
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+	                          _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static jint hash_latin1_sse2(jint hash, const uint8_t *chars, size_t n)
+{
+	if (n < 16)
+		return hash_latin1_scalar(hash, chars, n);
+
+	__m128i zero = _mm_setzero_si128();
+	__m128i mul  = _mm_set1_epi32((int)hash_powers[4]);
+	__m128i acc  = _mm_setr_epi32(0, 0, 0, hash);
+	size_t  i    = 0;
+	for (; i + 4 <= n; i += 4) {
+		int32_t word;
+		memcpy(&word, chars + i, sizeof(word));
+		__m128i c = _mm_unpacklo_epi8(_mm_cvtsi32_si128(word), zero);
+		c   = _mm_unpacklo_epi16(c, zero);
+		acc = _mm_add_epi32(mullo_epi32_sse2(acc, mul), c);
+	}
+	uint32_t lanes[4];
+	_mm_storeu_si128((__m128i*)lanes, acc);
+	jint h = (jint)combine_hash_lanes(lanes, 4);
+	return hash_latin1_scalar(h, chars + i, n - i);
+}
+
+static jint hash_utf16_sse2(jint hash, const jchar *chars, size_t n)
+{
+	if (n < 16)
+		return hash_utf16_scalar(hash, chars, n);
+
+	__m128i zero = _mm_setzero_si128();
+	__m128i mul  = _mm_set1_epi32((int)hash_powers[4]);
+	__m128i acc  = _mm_setr_epi32(0, 0, 0, hash);
+	size_t  i    = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i c = _mm_loadl_epi64((const __m128i*)(chars + i));
+		c   = _mm_unpacklo_epi16(c, zero);
+		acc = _mm_add_epi32(mullo_epi32_sse2(acc, mul), c);
+	}
+	uint32_t lanes[4];
+	_mm_storeu_si128((__m128i*)lanes, acc);
+	jint h = (jint)combine_hash_lanes(lanes, 4);
+	return hash_utf16_scalar(h, chars + i, n - i);
+}
+
+const string_kernels_t string_kernels_sse2 = {
+	"sse2",
+	mismatch_latin1_sse2, mismatch_utf16_sse2,
+	find_latin1_sse2, find_utf16_sse2,
+	is_ascii_sse2, is_latin1_sse2,
+	widen_sse2, narrow_sse2,
+	hash_latin1_sse2, hash_utf16_sse2
+};
+
+/*
+ * AVX2 kernels, only used if CPUID reports AVX2. They hand the tails to the
+ * SSE2 kernels, which must not run with dirty upper register halves.
+ */
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static size_t mismatch_latin1_avx2(const uint8_t *a, const uint8_t *b,
+                                        size_t n)
+{
+	size_t i = 0;
+	for (; i + 32 <= n; i += 32) {
+		__m256i  va   = _mm256_loadu_si256((const __m256i*)(a + i));
+		__m256i  vb   = _mm256_loadu_si256((const __m256i*)(b + i));
+		unsigned mask
+			= (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+		if (mask != 0xFFFFFFFFu)
+			return i + __builtin_ctz(~mask);
+	}
+	_mm256_zeroupper();
+	return i + mismatch_latin1_sse2(a + i, b + i, n - i);
+}
+
+AVX2 static size_t mismatch_utf16_avx2(const jchar *a, const jchar *b,
+                                       size_t n)
+{
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m256i  va   = _mm256_loadu_si256((const __m256i*)(a + i));
+		__m256i  vb   = _mm256_loadu_si256((const __m256i*)(b + i));
+		unsigned mask
+			= (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi16(va, vb));
+		if (mask != 0xFFFFFFFFu)
+			return i + __builtin_ctz(~mask) / 2;
+	}
+	_mm256_zeroupper();
+	return i + mismatch_utf16_sse2(a + i, b + i, n - i);
+}
+
+AVX2 static size_t find_latin1_avx2(const uint8_t *chars, size_t n, uint8_t c)
+{
+	__m256i needle = _mm256_set1_epi8((char)c);
+	size_t  i      = 0;
+	for (; i + 32 <= n; i += 32) {
+		__m256i  v    = _mm256_loadu_si256((const __m256i*)(chars + i));
+		unsigned mask
+			= (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle));
+		if (mask != 0)
+			return i + __builtin_ctz(mask);
+	}
+	_mm256_zeroupper();
+	return i + find_latin1_sse2(chars + i, n - i, c);
+}
+
+AVX2 static size_t find_utf16_avx2(const jchar *chars, size_t n, jchar c)
+{
+	__m256i needle = _mm256_set1_epi16((short)c);
+	size_t  i      = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m256i  v    = _mm256_loadu_si256((const __m256i*)(chars + i));
+		unsigned mask
+			= (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi16(v, needle));
+		if (mask != 0)
+			return i + __builtin_ctz(mask) / 2;
+	}
+	_mm256_zeroupper();
+	return i + find_utf16_sse2(chars + i, n - i, c);
+}
+
+AVX2 static bool is_ascii_avx2(const uint8_t *bytes, size_t n)
+{
+	__m256i bits = _mm256_setzero_si256();
+	size_t  i    = 0;
+	for (; i + 32 <= n; i += 32) {
+		bits = _mm256_or_si256(bits,
+		                       _mm256_loadu_si256((const __m256i*)(bytes + i)));
+	}
+	bool ascii = _mm256_movemask_epi8(bits) == 0;
+	_mm256_zeroupper();
+	return ascii && is_ascii_sse2(bytes + i, n - i);
+}
+
+AVX2 static bool is_latin1_avx2(const jchar *chars, size_t n)
+{
+	__m256i bits = _mm256_setzero_si256();
+	size_t  i    = 0;
+	for (; i + 16 <= n; i += 16) {
+		bits = _mm256_or_si256(bits,
+		                       _mm256_loadu_si256((const __m256i*)(chars + i)));
+	}
+	__m256i high   = _mm256_set1_epi16((short)0xFF00);
+	bool    latin1 = _mm256_testz_si256(bits, high);
+	_mm256_zeroupper();
+	return latin1 && is_latin1_sse2(chars + i, n - i);
+}
+
+AVX2 static void widen_avx2(jchar *dst, const uint8_t *src, size_t n)
+{
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+		_mm256_storeu_si256((__m256i*)(dst + i), _mm256_cvtepu8_epi16(v));
+	}
+	widen_scalar(dst + i, src + i, n - i);
+}
+
+AVX2 static void narrow_avx2(uint8_t *dst, const jchar *src, size_t n)
+{
+	size_t i = 0;
+	for (; i + 32 <= n; i += 32) {
+		__m256i lo     = _mm256_loadu_si256((const __m256i*)(src + i));
+		__m256i hi     = _mm256_loadu_si256((const __m256i*)(src + i + 16));
+		/* packus works on 128 bit halves, restore the order of the quads */
+		__m256i packed = _mm256_packus_epi16(lo, hi);
+		packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+		_mm256_storeu_si256((__m256i*)(dst + i), packed);
+	}
+	_mm256_zeroupper();
+	narrow_sse2(dst + i, src + i, n - i);
+}
+
+AVX2 static jint hash_latin1_avx2(jint hash, const uint8_t *chars, size_t n)
+{
+	if (n < 32)
+		return hash_latin1_sse2(hash, chars, n);
+
+	__m256i mul = _mm256_set1_epi32((int)hash_powers[8]);
+	__m256i acc = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 0, hash);
+	size_t  i   = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i bytes = _mm_loadl_epi64((const __m128i*)(chars + i));
+		__m256i c     = _mm256_cvtepu8_epi32(bytes);
+		acc = _mm256_add_epi32(_mm256_mullo_epi32(acc, mul), c);
+	}
+	uint32_t lanes[8];
+	_mm256_storeu_si256((__m256i*)lanes, acc);
+	jint h = (jint)combine_hash_lanes(lanes, 8);
+	return hash_latin1_scalar(h, chars + i, n - i);
+}
+
+AVX2 static jint hash_utf16_avx2(jint hash, const jchar *chars, size_t n)
+{
+	if (n < 32)
+		return hash_utf16_sse2(hash, chars, n);
+
+	__m256i mul = _mm256_set1_epi32((int)hash_powers[8]);
+	__m256i acc = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 0, hash);
+	size_t  i   = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i units = _mm_loadu_si128((const __m128i*)(chars + i));
+		__m256i c     = _mm256_cvtepu16_epi32(units);
+		acc = _mm256_add_epi32(_mm256_mullo_epi32(acc, mul), c);
+	}
+	uint32_t lanes[8];
+	_mm256_storeu_si256((__m256i*)lanes, acc);
+	jint h = (jint)combine_hash_lanes(lanes, 8);
+	return hash_utf16_scalar(h, chars + i, n - i);
+}
+
+const string_kernels_t string_kernels_avx2 = {
+	"avx2",
+	mismatch_latin1_avx2, mismatch_utf16_avx2,
+	find_latin1_avx2, find_utf16_avx2,
+	is_ascii_avx2, is_latin1_avx2,
+	widen_avx2, narrow_avx2,
+	hash_latin1_avx2, hash_utf16_avx2
+};
+
+#endif
+
+const string_kernels_t *const *string_kernels_available(void)
+{
+	static const string_kernels_t *available[4];
+	if (available[0] == NULL) {
+		size_t n = 0;
+		available[n++] = &string_kernels_scalar;
+#if defined(__x86_64__)
+		available[n++] = &string_kernels_sse2;
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			available[n++] = &string_kernels_avx2;
+#endif
+		available[n] = NULL;
+	}
+	return available;
+}
+
+void string_kernels_init(void)
+{
+	const string_kernels_t *const *available = string_kernels_available();
+	const char *name = getenv("SIMPLERT_STRING_KERNELS");
+
+	const string_kernels_t *selected = NULL;
+	for (size_t i = 0; available[i] != NULL; ++i) {
+		if (name == NULL || strcmp(available[i]->name, name) == 0)
+			selected = available[i];
+	}
+	if (selected == NULL) {
+		fprintf(stderr, "string kernels '%s' not available\n", name);
+		exit(1);
+	}
+	string_kernels = *selected;
+}
@@ -0,0 +1,60 @@
+#ifndef STRING_KERNELS_H
+#define STRING_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "types.h"
+
+/** String.hashCode computes hash * STRING_HASH_MULTIPLIER + c per char. */
+#define STRING_HASH_MULTIPLIER 31
+
+/**
+ * The loops over string contents. There is a scalar, an SSE2 and an AVX2
+ * implementation of each, string_kernels_init selects the best one the CPU
+ * supports. All lengths are counted in elements, not bytes.
+ */
+typedef struct string_kernels_t {
+	const char *name;
+	/** Returns the index of the first differing byte or @p n. */
+	size_t (*mismatch_latin1)(const uint8_t *a, const uint8_t *b, size_t n);
+	/** Returns the index of the first differing char or @p n. */
+	size_t (*mismatch_utf16)(const jchar *a, const jchar *b, size_t n);
+	/** Returns the index of the first @p c in @p chars or @p n. */
+	size_t (*find_latin1)(const uint8_t *chars, size_t n, uint8_t c);
+	size_t (*find_utf16)(const jchar *chars, size_t n, jchar c);
+	/** Returns true if no byte has its highest bit set. */
+	bool   (*is_ascii)(const uint8_t *bytes, size_t n);
+	/** Returns true if all chars are below 0x100. */
+	bool   (*is_latin1)(const jchar *chars, size_t n);
+	void   (*widen)(jchar *dst, const uint8_t *src, size_t n);
+	/** Truncates the chars to bytes, only valid if is_latin1 holds. */
+	void   (*narrow)(uint8_t *dst, const jchar *src, size_t n);
+	/** Continues the polynomial string hash @p hash over the chars. */
+	jint   (*hash_latin1)(jint hash, const uint8_t *chars, size_t n);
+	jint   (*hash_utf16)(jint hash, const jchar *chars, size_t n);
+} string_kernels_t;
+
+/** The kernels used by the runtime, valid after string_kernels_init. */
+extern string_kernels_t string_kernels;
+
+extern const string_kernels_t string_kernels_scalar;
+#if defined(__x86_64__)
+extern const string_kernels_t string_kernels_sse2;
+extern const string_kernels_t string_kernels_avx2;
+#endif
+
+/**
+ * Returns NULL terminated list of the kernel sets which the CPU supports,
+ * the fastest one last.
+ */
+const string_kernels_t *const *string_kernels_available(void);
+
+/**
+ * Selects the kernels, SIMPLERT_STRING_KERNELS may name one of the
+ * available sets to override the choice.
+ */
+void string_kernels_init(void);
+
+#endif
@@ -0,0 +1,239 @@
+#define _GNU_SOURCE
+#include "threads.h"
+
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "exceptions.h"
+#include "monitor.h"
+
+typedef struct start_t {
+	thread_t *thread;
+	void    (*run)(thread_t *thread);
+} start_t;
+
+thread_t *threads;
+
+static __thread thread_t *current_thread;
+static thread_t           main_thread;
+
+/** Protects the list of threads, their blocked flags and world_stopped. */
+static pthread_mutex_t threads_lock    = PTHREAD_MUTEX_INITIALIZER;
+/** Signalled when a thread blocks or exits. */
+static pthread_cond_t  threads_changed = PTHREAD_COND_INITIALIZER;
+/** Signalled when the collector is done. */
+static pthread_cond_t  world_resumed   = PTHREAD_COND_INITIALIZER;
+static bool            world_stopped;
+
+static void panic_errno(const char *what, int error)
+{
+	fprintf(stderr, "panic: %s failed (error %d)\n", what, error);
+	abort();
+}
+
+static void *checked_malloc(size_t size)
+{
+	void *result = malloc(size);
+	if (result == NULL) {
+		fprintf(stderr, "panic: out of memory\n");
+		abort();
+	}
+	return result;
+}
+
+void threads_init(void *stack_bottom)
+{
+	main_thread.tlab         = &_Jv_tlab;
+	main_thread.exception    = &_Jv_exception;
+	main_thread.stack_bottom = stack_bottom;
+	main_thread.lock_token   = (uintptr_t)&_Jv_lock_token;
+	threads                  = &main_thread;
+	current_thread           = &main_thread;
+}
+
+thread_t *thread_current(void)
+{
+	return current_thread;
+}
+
+static void block(thread_t *self, char *stack_top)
+{
+	pthread_mutex_lock(&threads_lock);
+	self->stack_top = stack_top;
+	self->blocked   = true;
+	pthread_cond_broadcast(&threads_changed);
+	pthread_mutex_unlock(&threads_lock);
+}
+
+static void unblock(thread_t *self)
+{
+	pthread_mutex_lock(&threads_lock);
+	while (world_stopped)
+		pthread_cond_wait(&world_resumed, &threads_lock);
+	self->blocked = false;
+	pthread_mutex_unlock(&threads_lock);
+}
+
+void __attribute__((noinline)) thread_blocking_call(
+	void (*function)(void *data), void *data)
+{
+	thread_t *self = current_thread;
+	if (self == NULL) {
+		function(data);
+		return;
+	}
+
+	/* the collector scans the registers saved here, see scan_stack */
+	__builtin_unwind_init();
+	jmp_buf registers;
+	setjmp(registers);
+	/* threads waiting for our locks can't wait for our next safepoint */
+	if (_Jv_safepoint_requested & SAFEPOINT_INFLATE)
+		monitor_inflate_requested();
+	block(self, (char*)&registers);
+	function(data);
+	unblock(self);
+}
+
+bool thread_call_if_blocked(uintptr_t lock_token,
+                            void (*function)(void *data), void *data)
+{
+	/* unblock needs the lock, the thread stays blocked until we return */
+	pthread_mutex_lock(&threads_lock);
+	bool blocked = false;
+	for (thread_t *thread = threads; thread != NULL; thread = thread->next) {
+		if (thread->lock_token == lock_token) {
+			blocked = thread->blocked;
+			break;
+		}
+	}
+	if (blocked)
+		function(data);
+	pthread_mutex_unlock(&threads_lock);
+	return blocked;
+}
+
+static void do_nothing(void *data)
+{
+	(void)data;
+}
+
+void thread_stop_for_collection(void)
+{
+	thread_blocking_call(do_nothing, NULL);
+}
+
+static void *thread_main(void *data)
+{
+	start_t   start = *(start_t*)data;
+	thread_t *self  = start.thread;
+	free(data);
+
+	/* the collector may look at the thread until it is unblocked */
+	current_thread = self;
+	pthread_mutex_lock(&threads_lock);
+	while (world_stopped)
+		pthread_cond_wait(&world_resumed, &threads_lock);
+	self->tlab         = &_Jv_tlab;
+	self->exception    = &_Jv_exception;
+	self->stack_bottom = __builtin_frame_address(0);
+	self->lock_token   = (uintptr_t)&_Jv_lock_token;
+	self->blocked      = false;
+	pthread_mutex_unlock(&threads_lock);
+
+	start.run(self);
+
+	/* the TLAB is freed with the thread */
+	heap_lock();
+	heap_retire_tlab(self->tlab);
+	heap_unlock();
+
+	pthread_mutex_lock(&threads_lock);
+	thread_t **anchor = &threads;
+	while (*anchor != self)
+		anchor = &(*anchor)->next;
+	*anchor = self->next;
+	pthread_cond_broadcast(&threads_changed);
+	pthread_mutex_unlock(&threads_lock);
+	free(self);
+	return NULL;
+}
+
+void thread_start(jobject object, void (*run)(thread_t *thread))
+{
+	thread_t *thread = checked_malloc(sizeof(*thread));
+	thread->object       = object;
+	thread->tlab         = NULL;
+	thread->exception    = NULL;
+	thread->stack_bottom = NULL;
+	thread->stack_top    = NULL;
+	thread->lock_token   = 0;
+	thread->blocked      = true;
+
+	start_t *start = checked_malloc(sizeof(*start));
+	start->thread = thread;
+	start->run    = run;
+
+	/* the current thread runs, so the collector does not walk the list */
+	pthread_mutex_lock(&threads_lock);
+	thread->next = threads;
+	threads      = thread;
+	pthread_mutex_unlock(&threads_lock);
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	pthread_t pthread;
+	int       error = pthread_create(&pthread, &attr, thread_main, start);
+	if (error != 0)
+		panic_errno("pthread_create", error);
+	pthread_attr_destroy(&attr);
+}
+
+static bool others_blocked(const thread_t *self)
+{
+	for (const thread_t *thread = threads; thread != NULL;
+	     thread = thread->next) {
+		if (thread != self && !thread->blocked)
+			return false;
+	}
+	return true;
+}
+
+void threads_stop_world(void)
+{
+	thread_t *self = current_thread;
+	pthread_mutex_lock(&threads_lock);
+	world_stopped = true;
+	__atomic_or_fetch(&_Jv_safepoint_requested, SAFEPOINT_COLLECT,
+	                  __ATOMIC_RELEASE);
+	while (!others_blocked(self))
+		pthread_cond_wait(&threads_changed, &threads_lock);
+	pthread_mutex_unlock(&threads_lock);
+}
+
+void threads_resume_world(void)
+{
+	pthread_mutex_lock(&threads_lock);
+	world_stopped = false;
+	__atomic_and_fetch(&_Jv_safepoint_requested, ~SAFEPOINT_COLLECT,
+	                   __ATOMIC_RELEASE);
+	pthread_cond_broadcast(&world_resumed);
+	pthread_mutex_unlock(&threads_lock);
+}
+
+static void wait_for_others(void *data)
+{
+	(void)data;
+	pthread_mutex_lock(&threads_lock);
+	while (threads->next != NULL)
+		pthread_cond_wait(&threads_changed, &threads_lock);
+	pthread_mutex_unlock(&threads_lock);
+}
+
+void threads_wait_for_others(void)
+{
+	thread_blocking_call(wait_for_others, NULL);
+}
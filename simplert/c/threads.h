@@ -0,0 +1,80 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "types.h"
+#include "heap.h"
+
+/*
+ * Every thread running Java code is registered in threads. The collector
+ * stops the world before it collects: it raises SAFEPOINT_COLLECT and waits
+ * until all other threads are blocked, either at a safepoint or in one of
+ * the blocking operations of the runtime (thread_blocking_call). A blocked
+ * thread does not touch the heap, its stack is scanned from stack_top to
+ * stack_bottom and it does not continue before the world is resumed.
+ */
+typedef struct thread_t thread_t;
+struct thread_t {
+	thread_t *next;
+	jobject   object;        /**< the java.lang.Thread or NULL, a root */
+	jobject  *exception;     /**< its _Jv_exception, a root, NULL until it runs */
+	tlab_t   *tlab;          /**< _Jv_tlab of the thread, NULL until it runs */
+	char     *stack_bottom;  /**< outermost frame, NULL until it runs */
+	char     *stack_top;     /**< lowest stack address in use while blocked */
+	uintptr_t lock_token;    /**< its lock owner token, 0 until it runs */
+	bool      blocked;       /**< protected by the threads lock */
+};
+
+/**
+ * All registered threads. The list only changes while the world runs, the
+ * collector walks it without locking.
+ */
+extern thread_t *threads;
+
+/**
+ * Registers the main thread, @p stack_bottom is the outermost stack address
+ * the collector has to scan.
+ */
+void threads_init(void *stack_bottom);
+
+/** Returns the current thread or NULL before threads_init. */
+thread_t *thread_current(void);
+
+/**
+ * Calls @p function with @p data in the blocked state, so the collector
+ * does not wait for the current thread meanwhile. @p function must not
+ * access the heap. Returns once the world runs again.
+ */
+void thread_blocking_call(void (*function)(void *data), void *data);
+
+/**
+ * Calls @p function with @p data if the thread owning @p lock_token is
+ * blocked and keeps it blocked meanwhile. Returns whether it was.
+ */
+bool thread_call_if_blocked(uintptr_t lock_token,
+                            void (*function)(void *data), void *data);
+
+/** Blocks the current thread until a requested collection is finished. */
+void thread_stop_for_collection(void);
+
+/**
+ * Starts a new thread which calls @p run with the thread, @p object is its
+ * java.lang.Thread.
+ */
+void thread_start(jobject object, void (*run)(thread_t *thread));
+
+/**
+ * Waits until all other threads are blocked, called by the collector with
+ * the heap lock held.
+ */
+void threads_stop_world(void);
+
+/** Lets the threads stopped by threads_stop_world continue. */
+void threads_resume_world(void);
+
+/** Waits until the current thread is the only one left. */
+void threads_wait_for_others(void);
+
+#endif
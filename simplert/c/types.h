@@ -40,7 +40,8 @@ typedef struct utf8_const {
 } utf8_const;
 
 struct java_lang_Object {
-	vtable_t *vptr;
+	vtable_t  *vptr;
+	uintptr_t  lock;  /**< thin lock or monitor, see monitor.h */
 };
 
 typedef struct jv_constants {
@@ -108,11 +109,26 @@ struct java_lang_Class {
 
 typedef struct java_lang_String {
 	java_lang_Object  base;
-	jchar            *data;
+	jarray            data;
 	jint              boffset;
 	jint              count;
+	jbyte             coder;
+	jboolean          chars_inline; /**< chars follow the object, data is it */
+	jint              cached_hash;  /**< hashCode or 0 if not computed yet */
 } java_lang_String;
 
+/**
+ * Values of java_lang_String::coder. Strings whose chars all fit into
+ * Latin-1 keep them as bytes, the others as chars. Most strings store them
+ * right after the object itself (chars_inline), substrings point into the
+ * byte or char array or the String they share the chars with. boffset is the
+ * byte offset of the first char from data in all cases.
+ */
+enum {
+	STRING_CODER_LATIN1 = 0,
+	STRING_CODER_UTF16  = 1
+};
+
 typedef struct array_header_t {
 	java_lang_Object base;
 	jint             length;
@@ -131,8 +147,10 @@ union u1 {
 };
 
 enum {
-	JV_STATE_NOTHING = 0,
-	JV_STATE_DONE    = 14
+	JV_STATE_NOTHING     = 0,
+	JV_STATE_IN_PROGRESS = 10,  /**< java_lang_Class::thread initializes it */
+	JV_STATE_ERROR       = 12,  /**< an initializer threw an exception */
+	JV_STATE_DONE        = 14
 };
 
 typedef enum access_flags_t {
@@ -151,23 +169,134 @@ typedef enum access_flags_t {
 } access_flags_t;
 
 void init_prim_rtti(void);
+/** Runs the static initializers of @p cls unless that happened already. */
+void _Jv_InitClass(java_lang_Class *cls);
 jobject _Jv_AllocObjectNoFinalizer(java_lang_Class *type);
+/**
+ * Finds a method of @p cls or its superclasses, the results are cached.
+ * Returns NULL if there is none.
+ */
 jv_method *get_method(java_lang_Class *cls, const utf8_const *name,
                       const utf8_const *signature);
+/** Like get_method, but only finds methods declared by @p cls itself. */
+jv_method *get_declared_method(java_lang_Class *cls, const utf8_const *name,
+                               const utf8_const *signature);
 
+jarray _Jv_NewPrimArray(java_lang_Class *eltype, jint count);
+/**
+ * Allocates a primitive array without clearing its elements. The compiler
+ * uses it for arrays which are filled by a copy before they can be read, see
+ * gcji_elide_array_zeroing.
+ */
+jarray _Jv_NewPrimArrayUninitialized(java_lang_Class *eltype, jint count);
+/**
+ * System.arraycopy into an array from _Jv_NewPrimArrayUninitialized, the
+ * elements outside of the copied range are zeroed.
+ */
+void _Jv_InitArrayCopy(jobject src, jint srcpos, jobject dst, jint dstpos,
+                       jint length);
 jarray _Jv_NewObjectArray(jsize count, java_lang_Class *eltype, jobject init);
 
 java_lang_String *string_from_c_chars(const char *chars, size_t len);
+/**
+ * Returns the UTF-8 encoding of @p string as a NUL terminated string, the
+ * caller frees it.
+ */
+char *string_to_c_chars(const java_lang_String *string);
+/**
+ * Creates a Latin-1 string of @p count chars stored in the string itself and
+ * returns them in @p chars, the caller writes all of them.
+ */
+java_lang_String *string_alloc_latin1(size_t count, char **chars);
+/**
+ * Returns the chars of @p string as bytes for the number parsers, or NULL if
+ * some do not fit into Latin-1. UTF-16 strings are narrowed into @p buffer
+ * of @p size bytes, longer ones into a copy returned in @p allocated as
+ * well, which the caller frees.
+ */
+const char *string_narrow_chars(const java_lang_String *string, char *buffer,
+                                size_t size, char **allocated);
+/**
+ * Concatenates @p parts into a new string, the compiler replaces
+ * StringBuilder append chains by it (see gcji_fuse_string_concat). A part
+ * with the lowest bit set is a char c encoded as (c << 1) | 1, a NULL part
+ * is converted to "null".
+ */
+java_lang_String *_Jv_StringConcat(jint n_parts,
+                                   java_lang_String *const *parts);
 java_lang_String *_Z22_Jv_NewStringUtf8ConstP13_Jv_Utf8Const(const utf8_const *cnst);
+/**
+ * Creates the string object of a literal, the compiler passes its hash code
+ * (see string_literal_hashes).
+ */
+java_lang_String *_Jv_NewStringUtf8ConstHashed(const utf8_const *cnst,
+                                               jint hash);
 
 jboolean _ZN4java4lang5Class11isPrimitiveEJbv(const java_lang_Class *cls);
 jboolean _ZN4java4lang5Class7isArrayEJbv(const java_lang_Class *this_);
 
 java_lang_String *double_to_string(jdouble value, bool is_float);
+/**
+ * Parses @p string like Double.parseDouble or Float.parseFloat. Returns NaN
+ * for malformed strings as well, the Java side tells them from "NaN".
+ */
+jdouble parse_string_double(const java_lang_String *string, bool is_float);
+
+java_lang_String *long_to_string(jlong value);
+/**
+ * Parses @p string like Long.parseLong with @p radix, returns false if it is
+ * malformed or the value is outside of [@p min, @p max].
+ */
+bool parse_string_long(const java_lang_String *string, jint radix, jlong min,
+                       jlong max, jlong *result);
 
 unsigned calc_string_hash(const char *chars, size_t len);
 
 #define get_array_data(type, array) \
 	((type*)(((char*)array) + sizeof(array_header_t)))
 
+static inline size_t string_char_size(const java_lang_String *string)
+{
+	return string->coder == STRING_CODER_LATIN1 ? 1 : sizeof(jchar);
+}
+
+/**
+ * Returns the number of bytes of chars stored in @p string itself, the heap
+ * adds it to the size of the String class.
+ */
+static inline size_t string_inline_size(const java_lang_String *string)
+{
+	if (!string->chars_inline)
+		return 0;
+	return (size_t)string->count * string_char_size(string);
+}
+
+/**
+ * Returns the address of the chars. Inline chars directly follow the
+ * String, which saves loading data.
+ */
+static inline const char *string_chars(const java_lang_String *string)
+{
+	if (string->chars_inline)
+		return (const char*)(string + 1);
+	return (const char*)string->data + string->boffset;
+}
+
+static inline const uint8_t *string_latin1(const java_lang_String *string)
+{
+	return (const uint8_t*)string_chars(string);
+}
+
+static inline const jchar *string_utf16(const java_lang_String *string)
+{
+	return (const jchar*)string_chars(string);
+}
+
+static inline jchar string_char_at(const java_lang_String *string, jint index)
+{
+	if (string->coder == STRING_CODER_LATIN1)
+		return string_latin1(string)[index];
+	return string_utf16(string)[index];
+}
+
 #endif
@@ -0,0 +1,114 @@
+package java.io;
+
+public class BufferedReader extends Reader {
+	private static final int DEFAULT_SIZE = 8192;
+
+	private Reader  in;
+	private char[]  buffer;
+	private int     pos;
+	private int     end;
+	/** the last line ended with '\r', a following '\n' belongs to it */
+	private boolean skipLF;
+
+	public BufferedReader(Reader in) {
+		this(in, DEFAULT_SIZE);
+	}
+
+	public BufferedReader(Reader in, int size) {
+		if (size <= 0)
+			throw new IllegalArgumentException("buffer size <= 0");
+		this.in     = in;
+		this.buffer = new char[size];
+	}
+
+	/** Reads more chars into the empty buffer, returns false at the end. */
+	private boolean fill() throws IOException {
+		int n = in.read(buffer, 0, buffer.length);
+		if (n <= 0)
+			return false;
+		pos = 0;
+		end = n;
+		return true;
+	}
+
+	/**
+	 * Makes sure that the buffer is not empty, dropping a '\n' that follows
+	 * a '\r'. Returns false at the end of the input.
+	 */
+	private boolean ensureChars() throws IOException {
+		if (pos == end && !fill())
+			return false;
+		if (skipLF) {
+			skipLF = false;
+			if (buffer[pos] == '\n') {
+				++pos;
+				if (pos == end && !fill())
+					return false;
+			}
+		}
+		return true;
+	}
+
+	public int read() throws IOException {
+		if (!ensureChars())
+			return -1;
+		return buffer[pos++];
+	}
+
+	public int read(char[] cbuf, int off, int len) throws IOException {
+		if (off < 0 || len < 0 || len > cbuf.length - off)
+			throw new IndexOutOfBoundsException();
+		if (len == 0)
+			return 0;
+		/* large reads bypass the buffer */
+		if (pos == end && !skipLF && len >= buffer.length)
+			return in.read(cbuf, off, len);
+		if (!ensureChars())
+			return -1;
+		int n = Math.min(len, end - pos);
+		System.arraycopy(buffer, pos, cbuf, off, n);
+		pos += n;
+		return n;
+	}
+
+	/**
+	 * Returns the next line without its terminator "\n", "\r" or "\r\n", or
+	 * null at the end of the input.
+	 */
+	public String readLine() throws IOException {
+		StringBuilder line = null;
+		for (;;) {
+			if (!ensureChars())
+				return line == null ? null : line.toString();
+			int start = pos;
+			while (pos < end) {
+				char c = buffer[pos];
+				if (c == '\n' || c == '\r') {
+					String result;
+					if (line == null) {
+						result = String.valueOf(buffer, start, pos - start);
+					} else {
+						line.append(buffer, start, pos - start);
+						result = line.toString();
+					}
+					++pos;
+					skipLF = c == '\r';
+					return result;
+				}
+				++pos;
+			}
+			/* the line continues in the next block */
+			if (line == null)
+				line = new StringBuilder(2 * (pos - start) + 16);
+			line.append(buffer, start, pos - start);
+		}
+	}
+
+	public boolean ready() throws IOException {
+		return pos < end || in.ready();
+	}
+
+	public void close() throws IOException {
+		in.close();
+	}
+}
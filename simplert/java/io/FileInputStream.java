@@ -0,0 +1,85 @@
+package java.io;
+
+public class FileInputStream extends InputStream {
+	/** return values of the natives besides byte counts */
+	private static final int EOF   = -1;
+	private static final int ERROR = -2;
+
+	/** input_file_t of the C side, 0 once closed */
+	private long handle;
+
+	/**
+	 * Opens the file <code>name</code> for reading. Big regular files are
+	 * mapped into memory, the others read in large blocks, see
+	 * simplert/c/java_io_file.c.
+	 */
+	public FileInputStream(String name) throws FileNotFoundException {
+		handle = open(name);
+		if (handle == 0)
+			throw new FileNotFoundException(name);
+	}
+
+	public FileInputStream(FileDescriptor fdObj) {
+		handle = openFd(fdObj.fd);
+	}
+
+	private static native long open(String name);
+
+	private static native long openFd(int fd);
+
+	private static native int readByte(long handle);
+
+	private static native int readBytes(long handle, byte[] b, int off,
+	                                    int len);
+
+	private static native long skipBytes(long handle, long n);
+
+	private static native int availableBytes(long handle);
+
+	private static native int closeHandle(long handle);
+
+	private static int check(int result) throws IOException {
+		if (result == ERROR)
+			throw new IOException("read failed");
+		return result;
+	}
+
+	private long getHandle() throws IOException {
+		if (handle == 0)
+			throw new IOException("stream closed");
+		return handle;
+	}
+
+	public int read() throws IOException {
+		return check(readByte(getHandle()));
+	}
+
+	public int read(byte[] b, int off, int len) throws IOException {
+		if (off < 0 || len < 0 || len > b.length - off)
+			throw new IndexOutOfBoundsException();
+		if (len == 0)
+			return 0;
+		return check(readBytes(getHandle(), b, off, len));
+	}
+
+	public long skip(long n) throws IOException {
+		if (n <= 0)
+			return 0;
+		long skipped = skipBytes(getHandle(), n);
+		if (skipped < 0)
+			throw new IOException("skip failed");
+		return skipped;
+	}
+
+	public int available() throws IOException {
+		return check(availableBytes(getHandle()));
+	}
+
+	public void close() throws IOException {
+		if (handle == 0)
+			return;
+		int result = closeHandle(handle);
+		handle = 0;
+		check(result);
+	}
+}
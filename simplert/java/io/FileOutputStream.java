@@ -0,0 +1,77 @@
+package java.io;
+
+public class FileOutputStream extends OutputStream {
+	private static final int ERROR = -2;
+
+	/** output_t of the C side, 0 once closed */
+	private long handle;
+
+	public FileOutputStream(String name) throws FileNotFoundException {
+		this(name, false);
+	}
+
+	/**
+	 * Opens the file <code>name</code> for writing. The output is buffered
+	 * like the one of PrintStream, see simplert/c/output.c.
+	 */
+	public FileOutputStream(String name, boolean append)
+		throws FileNotFoundException {
+		handle = open(name, append);
+		if (handle == 0)
+			throw new FileNotFoundException(name);
+	}
+
+	/**
+	 * Creates a stream writing to <code>fdObj</code>, FileDescriptor.out and
+	 * FileDescriptor.err share their buffers with System.out and System.err.
+	 */
+	public FileOutputStream(FileDescriptor fdObj) {
+		handle = openFd(fdObj.fd);
+	}
+
+	private static native long open(String name, boolean append);
+
+	private static native long openFd(int fd);
+
+	private static native int writeByte(long handle, int b);
+
+	private static native int writeBytes(long handle, byte[] b, int off,
+	                                     int len);
+
+	private static native int flushHandle(long handle);
+
+	private static native int closeHandle(long handle);
+
+	private static void check(int result) throws IOException {
+		if (result == ERROR)
+			throw new IOException("write failed");
+	}
+
+	private long getHandle() throws IOException {
+		if (handle == 0)
+			throw new IOException("stream closed");
+		return handle;
+	}
+
+	public void write(int b) throws IOException {
+		check(writeByte(getHandle(), b));
+	}
+
+	public void write(byte[] b, int off, int len) throws IOException {
+		if (off < 0 || len < 0 || len > b.length - off)
+			throw new IndexOutOfBoundsException();
+		check(writeBytes(getHandle(), b, off, len));
+	}
+
+	public void flush() throws IOException {
+		check(flushHandle(getHandle()));
+	}
+
+	public void close() throws IOException {
+		if (handle == 0)
+			return;
+		int result = closeHandle(handle);
+		handle = 0;
+		check(result);
+	}
+}
@@ -0,0 +1,42 @@
+package java.io;
+
+public abstract class InputStream {
+	public abstract int read() throws IOException;
+
+	public int read(byte[] b) throws IOException {
+		return read(b, 0, b.length);
+	}
+
+	public int read(byte[] b, int off, int len) throws IOException {
+		if (off < 0 || len < 0 || len > b.length - off)
+			throw new IndexOutOfBoundsException();
+		if (len == 0)
+			return 0;
+		int c = read();
+		if (c < 0)
+			return -1;
+		b[off] = (byte) c;
+		int n = 1;
+		for (; n < len; ++n) {
+			c = read();
+			if (c < 0)
+				break;
+			b[off + n] = (byte) c;
+		}
+		return n;
+	}
+
+	public long skip(long n) throws IOException {
+		long skipped = 0;
+		while (skipped < n && read() >= 0)
+			++skipped;
+		return skipped;
+	}
+
+	public int available() throws IOException {
+		return 0;
+	}
+
+	public void close() throws IOException {
+	}
+}
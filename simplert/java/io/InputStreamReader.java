@@ -0,0 +1,138 @@
+package java.io;
+
+/**
+ * Decodes UTF-8, the only charset simplert supports. Malformed input is
+ * replaced by U+FFFD.
+ */
+public class InputStreamReader extends Reader {
+	private static final int  BUFFER_SIZE = 8192;
+	private static final char REPLACEMENT = '\uFFFD';
+
+	private InputStream in;
+	private byte[]      bytes = new byte[BUFFER_SIZE];
+	private int         pos;
+	private int         end;
+	private boolean     eof;
+	/** low surrogate of a pair that did not fit into the last read, or 0 */
+	private char        pendingLow;
+
+	public InputStreamReader(InputStream in) {
+		this.in = in;
+	}
+
+	/**
+	 * Moves the bytes of an incomplete sequence to the start of the buffer
+	 * and reads more. Returns false at the end of the input.
+	 */
+	private boolean fill() throws IOException {
+		int left = end - pos;
+		System.arraycopy(bytes, pos, bytes, 0, left);
+		pos = 0;
+		end = left;
+		int n = in.read(bytes, end, bytes.length - end);
+		if (n < 0) {
+			eof = true;
+			return false;
+		}
+		end += n;
+		return true;
+	}
+
+	private static boolean isContinuation(byte b) {
+		return (b & 0xC0) == 0x80;
+	}
+
+	public int read(char[] cbuf, int off, int len) throws IOException {
+		if (off < 0 || len < 0 || len > cbuf.length - off)
+			throw new IndexOutOfBoundsException();
+		if (len == 0)
+			return 0;
+		int n = 0;
+		if (pendingLow != 0) {
+			cbuf[off] = pendingLow;
+			pendingLow = 0;
+			n = 1;
+		}
+		while (n < len) {
+			/* ASCII fast path */
+			while (n < len && pos < end && bytes[pos] >= 0)
+				cbuf[off + n++] = (char) bytes[pos++];
+			if (n == len)
+				break;
+			if (pos == end) {
+				/* only block if nothing was decoded yet */
+				if (n > 0)
+					break;
+				if (eof || !fill())
+					return -1;
+				continue;
+			}
+
+			int lead = bytes[pos] & 0xFF;
+			int need;
+			int c;
+			int min;
+			if (lead >= 0xC2 && lead < 0xE0) {
+				need = 1;
+				c    = lead & 0x1F;
+				min  = 0x80;
+			} else if (lead >= 0xE0 && lead < 0xF0) {
+				need = 2;
+				c    = lead & 0x0F;
+				min  = 0x800;
+			} else if (lead >= 0xF0 && lead < 0xF5) {
+				need = 3;
+				c    = lead & 0x07;
+				min  = 0x10000;
+			} else {
+				cbuf[off + n++] = REPLACEMENT;
+				++pos;
+				continue;
+			}
+
+			if (end - pos <= need && !eof) {
+				if (n > 0)
+					break;
+				fill();
+				continue;
+			}
+			int i = 1;
+			for (; i <= need && pos + i < end; ++i) {
+				byte b = bytes[pos + i];
+				if (!isContinuation(b))
+					break;
+				c = (c << 6) | (b & 0x3F);
+			}
+			if (i <= need || c < min || (c >= 0xD800 && c < 0xE000)
+			    || c > 0x10FFFF) {
+				/* skip the lead byte, the continuation bytes are replaced
+				 * one by one */
+				cbuf[off + n++] = REPLACEMENT;
+				++pos;
+				continue;
+			}
+			pos += need + 1;
+			if (c < 0x10000) {
+				cbuf[off + n++] = (char) c;
+			} else {
+				c -= 0x10000;
+				cbuf[off + n++] = (char) (0xD800 + (c >> 10));
+				char low = (char) (0xDC00 + (c & 0x3FF));
+				if (n < len) {
+					cbuf[off + n++] = low;
+				} else {
+					pendingLow = low;
+				}
+			}
+		}
+		return n;
+	}
+
+	public boolean ready() throws IOException {
+		return pendingLow != 0 || pos < end || in.available() > 0;
+	}
+
+	public void close() throws IOException {
+		in.close();
+	}
+}
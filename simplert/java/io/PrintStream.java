@@ -1,19 +1,26 @@
 package java.io;
 
 public class PrintStream {
-	private static native void putchar(char c);
+	/** file descriptor the natives write to, 1 or 2 */
+	private int fd;
 
-	public void println() {
-		putchar('\n');
+	/**
+	 * Creates a stream writing to the file descriptor <code>fd</code>. The
+	 * output is buffered, see simplert/c/output.c. Each native call is
+	 * atomic, the println methods taking a value are synchronized so the
+	 * line of one thread stays together.
+	 */
+	public PrintStream(int fd) {
+		this.fd = fd;
 	}
 
+	public native void flush();
+
+	public native void println();
+
 	public native void print(int i);
 
-	public void print(String s) {
-		for (int i = 0; i < s.length(); ++i) {
-			putchar(s.charAt(i));
-		}
-	}
+	public native void print(String s);
 
 	public void print(Object o) {
 		print(o.toString());
@@ -23,13 +30,9 @@ public class PrintStream {
 		print(b ? "true" : "false");
 	}
 
-	public void print(char c) {
-		putchar(c);
-	}
+	public native void print(char c);
 
-	public void print(long l) {
-		print(Long.toString(l));
-	}
+	public native void print(long l);
 
 	public final void print(float f) {
 		print(Float.toString(f));
@@ -39,42 +42,42 @@ public class PrintStream {
 		print(Double.toString(d));
 	}
 
-	public void println(String s) {
+	public synchronized void println(String s) {
 		print(s);
 		println();
 	}
 
-	public void println(int i) {
+	public synchronized void println(int i) {
 		print(i);
 		println();
 	}
 
 	public void println(Object o) {
-		print(o);
-		println();
+		/* toString runs without holding the lock */
+		println(o.toString());
 	}
 
-	public void println(boolean b) {
+	public synchronized void println(boolean b) {
 		print(b);
 		println();
 	}
 
-	public void println(char c) {
+	public synchronized void println(char c) {
 		print(c);
 		println();
 	}
 
-	public void println(long l) {
+	public synchronized void println(long l) {
 		print(l);
 		println();
 	}
 
-	public final void println(float f) {
+	public final synchronized void println(float f) {
 		print(f);
 		println();
 	}
 
-	public void println(double d) {
+	public synchronized void println(double d) {
 		print(d);
 		println();
 	}
@@ -0,0 +1,164 @@
+package java.io;
+
+public class RandomAccessFile {
+	private static final int ERROR = -2;
+
+	/** file descriptor of the C side, -1 once closed */
+	private int fd;
+
+	/**
+	 * Opens the file <code>name</code>, <code>mode</code> is "r" or one of
+	 * the "rw" modes. Accesses are not buffered, each read and write is a
+	 * system call, see simplert/c/java_io_file.c.
+	 */
+	public RandomAccessFile(String name, String mode)
+		throws FileNotFoundException {
+		boolean write;
+		if (mode.equals("r")) {
+			write = false;
+		} else if (mode.equals("rw") || mode.equals("rws")
+		           || mode.equals("rwd")) {
+			write = true;
+		} else {
+			throw new IllegalArgumentException("invalid mode " + mode);
+		}
+		fd = open(name, write);
+		if (fd < 0)
+			throw new FileNotFoundException(name);
+	}
+
+	private static native int open(String name, boolean write);
+
+	private static native int readByte(int fd);
+
+	private static native int readBytes(int fd, byte[] b, int off, int len);
+
+	private static native int writeByte(int fd, int b);
+
+	private static native int writeBytes(int fd, byte[] b, int off, int len);
+
+	private static native long seekTo(int fd, long pos);
+
+	private static native long position(int fd);
+
+	private static native long fileLength(int fd);
+
+	private static native int closeFd(int fd);
+
+	private int getFd() throws IOException {
+		if (fd < 0)
+			throw new IOException("file closed");
+		return fd;
+	}
+
+	private static long check(long result) throws IOException {
+		if (result == ERROR)
+			throw new IOException("I/O error");
+		return result;
+	}
+
+	private static void checkBounds(byte[] b, int off, int len) {
+		if (off < 0 || len < 0 || len > b.length - off)
+			throw new IndexOutOfBoundsException();
+	}
+
+	public int read() throws IOException {
+		return (int) check(readByte(getFd()));
+	}
+
+	public int read(byte[] b) throws IOException {
+		return read(b, 0, b.length);
+	}
+
+	public int read(byte[] b, int off, int len) throws IOException {
+		checkBounds(b, off, len);
+		if (len == 0)
+			return 0;
+		return (int) check(readBytes(getFd(), b, off, len));
+	}
+
+	public final void readFully(byte[] b) throws IOException {
+		readFully(b, 0, b.length);
+	}
+
+	public final void readFully(byte[] b, int off, int len)
+		throws IOException {
+		checkBounds(b, off, len);
+		while (len > 0) {
+			int n = read(b, off, len);
+			if (n < 0)
+				throw new EOFException();
+			off += n;
+			len -= n;
+		}
+	}
+
+	/**
+	 * Reads a line of Latin-1 chars ended by "\n", "\r" or "\r\n" like
+	 * DataInput.readLine.
+	 */
+	public final String readLine() throws IOException {
+		StringBuilder line = new StringBuilder();
+		int c = read();
+		if (c < 0)
+			return null;
+		while (c >= 0 && c != '\n') {
+			if (c == '\r') {
+				long pos = getFilePointer();
+				if (read() != '\n')
+					seek(pos);
+				break;
+			}
+			line.append((char) c);
+			c = read();
+		}
+		return line.toString();
+	}
+
+	public void write(int b) throws IOException {
+		check(writeByte(getFd(), b));
+	}
+
+	public void write(byte[] b) throws IOException {
+		write(b, 0, b.length);
+	}
+
+	public void write(byte[] b, int off, int len) throws IOException {
+		checkBounds(b, off, len);
+		check(writeBytes(getFd(), b, off, len));
+	}
+
+	public void seek(long pos) throws IOException {
+		if (pos < 0)
+			throw new IOException("negative seek offset");
+		check(seekTo(getFd(), pos));
+	}
+
+	public long getFilePointer() throws IOException {
+		return check(position(getFd()));
+	}
+
+	public long length() throws IOException {
+		return check(fileLength(getFd()));
+	}
+
+	public int skipBytes(int n) throws IOException {
+		if (n <= 0)
+			return 0;
+		long pos    = getFilePointer();
+		long length = length();
+		long target = Math.min(pos + n, length);
+		if (target <= pos)
+			return 0;
+		seek(target);
+		return (int) (target - pos);
+	}
+
+	public void close() throws IOException {
+		if (fd < 0)
+			return;
+		int result = closeFd(fd);
+		fd = -1;
+		check(result);
+	}
+}
@@ -0,0 +1,21 @@
+package java.io;
+
+public abstract class Reader {
+	public int read() throws IOException {
+		char[] c = new char[1];
+		return read(c, 0, 1) < 0 ? -1 : c[0];
+	}
+
+	public int read(char[] cbuf) throws IOException {
+		return read(cbuf, 0, cbuf.length);
+	}
+
+	public abstract int read(char[] cbuf, int off, int len)
+		throws IOException;
+
+	public boolean ready() throws IOException {
+		return false;
+	}
+
+	public abstract void close() throws IOException;
+}
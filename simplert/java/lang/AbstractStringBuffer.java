@@ -438,7 +438,7 @@ abstract class AbstractStringBuffer
    */
   public AbstractStringBuffer append (int inum)
   {
-    return append(Integer.toString(inum, 10));
+    return append((long) inum);
   }
 
   /**
@@ -452,7 +452,11 @@ abstract class AbstractStringBuffer
    */
   public AbstractStringBuffer append(long lnum)
   {
-    return append(Long.toString(lnum, 10));
+    // a long takes at most 20 chars, only measure it if they don't fit
+    if (count + 20 > value.length)
+      ensureCapacity_unsynchronized(count + Long.decimalSize(lnum));
+    count = Long.getChars(lnum, value, count);
+    return this;
   }
 
   /**
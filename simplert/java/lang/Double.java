@@ -141,10 +141,10 @@ public final class Double extends Number // implements Comparable<Double>
    * @throws NullPointerException if <code>s</code> is null
    * @see #parseDouble(String)
    */
-//  public Double(String s)
-//  {
-//    value = parseDouble(s);
-//  }
+  public Double(String s)
+  {
+    value = parseDouble(s);
+  }
 
   /**
    * Convert the <code>double</code> to a <code>String</code>.
@@ -286,10 +286,10 @@ public final class Double extends Number // implements Comparable<Double>
    * @throws NullPointerException if <code>s</code> is null.
    * @see #parseDouble(String)
    */
-//  public static Double valueOf(String s)
-//  {
-//    return valueOf(parseDouble(s));
-//  }
+  public static Double valueOf(String s)
+  {
+    return valueOf(parseDouble(s));
+  }
 
   /**
    * Parse the specified <code>String</code> as a <code>double</code>. The
@@ -340,10 +340,36 @@ public final class Double extends Number // implements Comparable<Double>
    * @see #NEGATIVE_INFINITY
    * @since 1.2
    */
-//  public static double parseDouble(String str)
-//  {
-//    return VMDouble.parseDouble(str);
-//  }
+  public static double parseDouble(String str)
+  {
+    double result = nativeParseDouble(str);
+    if (isNaN(result) && !isNaNLiteral(str))
+      throw new NumberFormatException("For input string: \"" + str + "\"");
+    return result;
+  }
+
+  /**
+   * Parses <code>str</code> in simplert/c/double_format.c, malformed
+   * strings give NaN.
+   */
+  private static native double nativeParseDouble(String str);
+
+  /**
+   * Returns whether <code>str</code> is "NaN" with an optional sign and
+   * surrounding whitespace, used by parseDouble and Float.parseFloat.
+   */
+  static boolean isNaNLiteral(String str)
+  {
+    int begin = 0;
+    int end = str.length();
+    while (begin < end && str.charAt(begin) <= ' ')
+      begin++;
+    while (end > begin && str.charAt(end - 1) <= ' ')
+      end--;
+    if (begin < end && (str.charAt(begin) == '+' || str.charAt(begin) == '-'))
+      begin++;
+    return str.substring(begin, end).equals("NaN");
+  }
 
   /**
    * Return <code>true</code> if the <code>double</code> has the same
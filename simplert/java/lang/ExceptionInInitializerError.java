@@ -0,0 +1,28 @@
+package java.lang;
+
+/**
+ * Wraps an exception thrown by a static initializer which is not an Error.
+ * The runtime creates it with the constructor taking the exception (see
+ * simplert/c/init.c).
+ */
+public class ExceptionInInitializerError extends LinkageError {
+	private final Throwable exception;
+
+	public ExceptionInInitializerError() {
+		exception = null;
+	}
+
+	public ExceptionInInitializerError(String message) {
+		super(message);
+		exception = null;
+	}
+
+	public ExceptionInInitializerError(Throwable thrown) {
+		super(null, thrown);
+		exception = thrown;
+	}
+
+	public Throwable getException() {
+		return exception;
+	}
+}
@@ -152,10 +152,10 @@ public final class Float extends Number // implements Comparable<Float>
    * @throws NullPointerException if <code>s</code> is null
    * @see #parseFloat(String)
    */
-//  public Float(String s)
-//  {
-//    value = parseFloat(s);
-//  }
+  public Float(String s)
+  {
+    value = parseFloat(s);
+  }
 
   /**
    * Convert the <code>float</code> to a <code>String</code>.
@@ -280,10 +280,10 @@ public final class Float extends Number // implements Comparable<Float>
    * @throws NullPointerException if <code>s</code> is null
    * @see #parseFloat(String)
    */
-//  public static Float valueOf(String s)
-//  {
-//    return valueOf(parseFloat(s));
-//  }
+  public static Float valueOf(String s)
+  {
+    return valueOf(parseFloat(s));
+  }
 
   /**
    * Returns a <code>Float</code> object wrapping the value.
@@ -353,10 +353,19 @@ public final class Float extends Number // implements Comparable<Float>
    * @see #NEGATIVE_INFINITY
    * @since 1.2
    */
-//  public static float parseFloat(String str)
-//  {
-//    return VMFloat.parseFloat(str);
-//  }
+  public static float parseFloat(String str)
+  {
+    float result = nativeParseFloat(str);
+    if (isNaN(result) && !Double.isNaNLiteral(str))
+      throw new NumberFormatException("For input string: \"" + str + "\"");
+    return result;
+  }
+
+  /**
+   * Parses <code>str</code> in simplert/c/double_format.c, rounding only
+   * once. Malformed strings give NaN.
+   */
+  private static native float nativeParseFloat(String str);
 
   /**
    * Return <code>true</code> if the <code>float</code> has the same
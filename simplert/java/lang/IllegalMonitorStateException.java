@@ -0,0 +1,15 @@
+package java.lang;
+
+/**
+ * Thrown by monitorexit, wait and notify when the current thread does not
+ * own the monitor. The runtime throws a preallocated instance without a
+ * message.
+ */
+public class IllegalMonitorStateException extends RuntimeException {
+	public IllegalMonitorStateException() {
+	}
+
+	public IllegalMonitorStateException(String message) {
+		super(message);
+	}
+}
@@ -126,10 +126,10 @@ public final class Integer extends Number // implements Comparable<Integer>
    * @throws NumberFormatException if the String does not contain an int
    * @see #valueOf(String)
    */
-//  public Integer(String s)
-//  {
-//    value = parseInt(s, 10, false);
-//  }
+  public Integer(String s)
+  {
+    value = parseInt(s, 10);
+  }
 
   /**
    * Return the size of a string large enough to hold the given number
@@ -186,6 +186,8 @@ public final class Integer extends Number // implements Comparable<Integer>
   {
     if (radix < Character.MIN_RADIX || radix > Character.MAX_RADIX)
       radix = 10;
+    if (radix == 10)
+      return toString(num);
 
     // Is the value negative?
     boolean isNeg = num < 0;
@@ -281,13 +283,7 @@ public final class Integer extends Number // implements Comparable<Integer>
    * @return the <code>String</code> representation of the argument
    * @see #toString(int, int)
    */
-  public static String toString(int i)
-  {
-    // This is tricky: in libgcj, String.valueOf(int) is a fast native
-    // implementation.  In Classpath it just calls back to
-    // Integer.toString(int, int).
-    return toString(i, 10);
-  }
+  public static native String toString(int i);
 
   /**
    * Converts the specified <code>String</code> into an <code>int</code>
@@ -305,10 +301,21 @@ public final class Integer extends Number // implements Comparable<Integer>
    * @throws NumberFormatException if <code>s</code> cannot be parsed as an
    *         <code>int</code>
    */
-//  public static int parseInt(String str, int radix)
-//  {
-//    return parseInt(str, radix, false);
-//  }
+  public static int parseInt(String str, int radix)
+  {
+    if (str == null)
+      throw new NumberFormatException("null");
+    long result = nativeParseInt(str, radix);
+    if (result == Long.MIN_VALUE)
+      throw new NumberFormatException("For input string: \"" + str + "\"");
+    return (int) result;
+  }
+
+  /**
+   * Parses <code>str</code> in simplert/c/int_format.c, returns
+   * <code>Long.MIN_VALUE</code> if it is malformed or out of range.
+   */
+  private static native long nativeParseInt(String str, int radix);
 
   /**
    * Converts the specified <code>String</code> into an <code>int</code>.
@@ -320,10 +327,10 @@ public final class Integer extends Number // implements Comparable<Integer>
    *         <code>int</code>
    * @see #parseInt(String, int)
    */
-//  public static int parseInt(String s)
-//  {
-//    return parseInt(s, 10, false);
-//  }
+  public static int parseInt(String s)
+  {
+    return parseInt(s, 10);
+  }
 
   /**
    * Creates a new <code>Integer</code> object using the <code>String</code>
@@ -336,10 +343,10 @@ public final class Integer extends Number // implements Comparable<Integer>
    *         <code>int</code>
    * @see #parseInt(String, int)
    */
-//  public static Integer valueOf(String s, int radix)
-//  {
-//    return valueOf(parseInt(s, radix, false));
-//  }
+  public static Integer valueOf(String s, int radix)
+  {
+    return valueOf(parseInt(s, radix));
+  }
 
   /**
    * Creates a new <code>Integer</code> object using the <code>String</code>,
@@ -352,10 +359,10 @@ public final class Integer extends Number // implements Comparable<Integer>
    * @see #Integer(String)
    * @see #parseInt(String)
    */
-//  public static Integer valueOf(String s)
-//  {
-//    return valueOf(parseInt(s, 10, false));
-//  }
+  public static Integer valueOf(String s)
+  {
+    return valueOf(parseInt(s, 10));
+  }
 
   /**
    * Returns an <code>Integer</code> object wrapping the value.
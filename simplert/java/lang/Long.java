@@ -125,10 +125,10 @@ public final class Long extends Number // implements Comparable<Long>
    * @throws NumberFormatException if the String does not contain a long
    * @see #valueOf(String)
    */
-//  public Long(String s)
-//  {
-//    value = parseLong(s, 10, false);
-//  }
+  public Long(String s)
+  {
+    value = parseLong(s, 10);
+  }
 
   /**
    * Return the size of a string large enough to hold the given number
@@ -185,6 +185,8 @@ public final class Long extends Number // implements Comparable<Long>
   {
     if (radix < Character.MIN_RADIX || radix > Character.MAX_RADIX)
       radix = 10;
+    if (radix == 10)
+      return toString(num);
 
     // Is the value negative?
     boolean isNeg = num < 0;
@@ -280,9 +282,41 @@ public final class Long extends Number // implements Comparable<Long>
    * @return the <code>String</code> representation of the argument
    * @see #toString(long, int)
    */
-  public static String toString(long num)
+  public static native String toString(long num);
+
+  /**
+   * Writes the decimal digits of <code>num</code> like
+   * <code>toString(long)</code> into <code>buf</code>, starting at
+   * <code>offset</code>. Used by StringBuilder to append numbers without
+   * creating a String.
+   *
+   * @param num the <code>long</code> to convert
+   * @param buf the buffer, must have room for <code>decimalSize(num)</code>
+   *        chars after <code>offset</code>
+   * @param offset the index of the first char
+   * @return the index after the last char
+   */
+  static native int getChars(long num, char[] buf, int offset);
+
+  /**
+   * Returns the number of chars of the decimal representation of
+   * <code>num</code>.
+   *
+   * @param num the <code>long</code> to measure
+   * @return the length of <code>toString(num)</code>
+   */
+  static int decimalSize(long num)
   {
-    return toString(num, 10);
+    int size = num < 0 ? 2 : 1;
+    // count in the negative range, MIN_VALUE has no positive counterpart
+    if (num > 0)
+      num = -num;
+    while (num <= -10)
+      {
+        num /= 10;
+        size++;
+      }
+    return size;
   }
 
   /**
@@ -303,10 +337,28 @@ public final class Long extends Number // implements Comparable<Long>
    * @throws NumberFormatException if <code>s</code> cannot be parsed as a
    *         <code>long</code>
    */
-//  public static long parseLong(String str, int radix)
-//  {
-//    return parseLong(str, radix, false);
-//  }
+  public static long parseLong(String str, int radix)
+  {
+    if (str == null)
+      throw new NumberFormatException("null");
+    long result = nativeParseLong(str, radix);
+    // MIN_VALUE is the error result as well, only then check again
+    if (result == MIN_VALUE && !nativeIsLong(str, radix))
+      throw new NumberFormatException("For input string: \"" + str + "\"");
+    return result;
+  }
+
+  /**
+   * Parses <code>str</code> in simplert/c/int_format.c, returns
+   * <code>MIN_VALUE</code> if it is malformed or out of range.
+   */
+  private static native long nativeParseLong(String str, int radix);
+
+  /**
+   * Returns whether <code>str</code> is a valid <code>long</code>, tells
+   * <code>MIN_VALUE</code> from errors of <code>nativeParseLong</code>.
+   */
+  private static native boolean nativeIsLong(String str, int radix);
 
   /**
    * Converts the specified <code>String</code> into a <code>long</code>.
@@ -318,10 +370,10 @@ public final class Long extends Number // implements Comparable<Long>
    *         <code>long</code>
    * @see #parseLong(String, int)
    */
-//  public static long parseLong(String s)
-//  {
-//    return parseLong(s, 10, false);
-//  }
+  public static long parseLong(String s)
+  {
+    return parseLong(s, 10);
+  }
 
   /**
    * Creates a new <code>Long</code> object using the <code>String</code>
@@ -334,10 +386,10 @@ public final class Long extends Number // implements Comparable<Long>
    *         <code>long</code>
    * @see #parseLong(String, int)
    */
-//  public static Long valueOf(String s, int radix)
-//  {
-//    return valueOf(parseLong(s, radix, false));
-//  }
+  public static Long valueOf(String s, int radix)
+  {
+    return valueOf(parseLong(s, radix));
+  }
 
   /**
    * Creates a new <code>Long</code> object using the <code>String</code>,
@@ -350,10 +402,10 @@ public final class Long extends Number // implements Comparable<Long>
    * @see #Long(String)
    * @see #parseLong(String)
    */
-//  public static Long valueOf(String s)
-//  {
-//    return valueOf(parseLong(s, 10, false));
-//  }
+  public static Long valueOf(String s)
+  {
+    return valueOf(parseLong(s, 10));
+  }
 
   /**
    * Returns a <code>Long</code> object wrapping the value.
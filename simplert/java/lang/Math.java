@@ -444,7 +444,7 @@ public final class Math
    * @return the square root of the argument
    * @see #pow(double, double)
    */
-//  public static native double sqrt(double a);
+  public static native double sqrt(double a);
 
   /**
    * Raise a number to a power. Special cases:<ul>
@@ -541,7 +541,7 @@ public final class Math
    * @param a the value to act upon
    * @return the nearest integer &gt;= <code>a</code>
    */
-//  public static native double ceil(double a);
+  public static native double ceil(double a);
 
   /**
    * Take the nearest integer that is that is less than or equal to the
@@ -551,7 +551,7 @@ public final class Math
    * @param a the value to act upon
    * @return the nearest integer &lt;= <code>a</code>
    */
-//  public static native double floor(double a);
+  public static native double floor(double a);
 
   /**
    * Take the nearest integer to the argument.  If it is exactly between
@@ -561,45 +561,56 @@ public final class Math
    * @param a the value to act upon
    * @return the nearest integer to <code>a</code>
    */
-//  public static native double rint(double a);
+  public static native double rint(double a);
 
   /**
-   * Take the nearest integer to the argument.  This is equivalent to
-   * <code>(int) Math.floor(a + 0.5f)</code>. If the argument is NaN, the result
-   * is 0; otherwise if the argument is outside the range of int, the result
-   * will be Integer.MIN_VALUE or Integer.MAX_VALUE, as appropriate.
+   * Take the nearest integer to the argument, rounding ties towards positive
+   * infinity. If the argument is NaN, the result is 0; otherwise if the
+   * argument is outside the range of int, the result will be
+   * Integer.MIN_VALUE or Integer.MAX_VALUE, as appropriate.
    *
    * @param a the argument to round
    * @return the nearest integer to the argument
    * @see Integer#MIN_VALUE
    * @see Integer#MAX_VALUE
    */
-//  public static int round(float a)
-//  {
-//    // this check for NaN, from JLS 15.21.1, saves a method call
-//    if (a != a)
-//      return 0;
-//    return (int) floor(a + 0.5f);
-//  }
+  public static int round(float a)
+  {
+    // this check for NaN, from JLS 15.21.1, saves a method call
+    if (a != a)
+      return 0;
+    // a + 0.5f can round up, as for 0.49999997f or 2^23 + 1. The fraction
+    // a - floor(a) is exact, and only nonzero when the result can't overflow.
+    double down = floor(a);
+    int round = (int) down;
+    if (a - down >= 0.5)
+      ++round;
+    return round;
+  }
 
   /**
-   * Take the nearest long to the argument.  This is equivalent to
-   * <code>(long) Math.floor(a + 0.5)</code>. If the argument is NaN, the
-   * result is 0; otherwise if the argument is outside the range of long, the
-   * result will be Long.MIN_VALUE or Long.MAX_VALUE, as appropriate.
+   * Take the nearest long to the argument, rounding ties towards positive
+   * infinity. If the argument is NaN, the result is 0; otherwise if the
+   * argument is outside the range of long, the result will be
+   * Long.MIN_VALUE or Long.MAX_VALUE, as appropriate.
    *
    * @param a the argument to round
    * @return the nearest long to the argument
    * @see Long#MIN_VALUE
    * @see Long#MAX_VALUE
    */
-//  public static long round(double a)
-//  {
-//    // this check for NaN, from JLS 15.21.1, saves a method call
-//    if (a != a)
-//      return 0;
-//    return (long) floor(a + 0.5d);
-//  }
+  public static long round(double a)
+  {
+    // this check for NaN, from JLS 15.21.1, saves a method call
+    if (a != a)
+      return 0;
+    // see round(float)
+    double down = floor(a);
+    long round = (long) down;
+    if (a - down >= 0.5)
+      ++round;
+    return round;
+  }
 
   /**
    * Get a random number.  This behaves like Random.nextDouble(), seeded by
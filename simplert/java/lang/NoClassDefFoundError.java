@@ -0,0 +1,14 @@
+package java.lang;
+
+/**
+ * Thrown when a class whose static initializer failed before is used again.
+ * The runtime throws a preallocated instance without a message.
+ */
+public class NoClassDefFoundError extends LinkageError {
+	public NoClassDefFoundError() {
+	}
+
+	public NoClassDefFoundError(String message) {
+		super(message);
+	}
+}
@@ -195,7 +195,7 @@ public class Object
    * @see #wait(long, int)
    * @see Thread
    */
-  //public final native void notify();
+  public final native void notify();
   
   /**
    * Wakes up all of the {@link Thread}s that have called
@@ -221,7 +221,7 @@ public class Object
    * @see #wait(long, int)
    * @see Thread
    */
-  //public final native void notifyAll();
+  public final native void notifyAll();
 
   /**
    * Waits a specified amount of time (or indefinitely if
@@ -263,10 +263,8 @@ public class Object
    * @see #wait(long)
    * @see Thread
    */
-  /*
   public final native void wait(long timeout, int nanos)
     throws InterruptedException;
-  */
 
   /**
    * Determine whether this Object is semantically equal
@@ -404,12 +402,10 @@ public class Object
    * @see #wait(long, int)
    * @see Thread
    */
-  /*
   public final void wait() throws InterruptedException
   {
     wait(0, 0);
   }
-  */
 
   /**
    * Waits a specified amount of time (or indefinitely if
@@ -451,12 +447,10 @@ public class Object
    * @see #wait(long, int)
    * @see Thread
    */
-  /*
   public final void wait(long timeout) throws InterruptedException
   {
     wait(timeout, 0);
   }
-  */
 
   /**
    * This method may be called to create a new copy of the
@@ -0,0 +1,69 @@
+package java.lang;
+
+/**
+ * A frame of a stack trace. simplert knows neither source files nor line
+ * numbers, only the class and the method.
+ */
+public final class StackTraceElement {
+	private final String declaringClass;
+	private final String methodName;
+	private final String fileName;
+	private final int lineNumber;
+
+	public StackTraceElement(String declaringClass, String methodName,
+	                         String fileName, int lineNumber) {
+		if (declaringClass == null || methodName == null)
+			throw new NullPointerException();
+		this.declaringClass = declaringClass;
+		this.methodName = methodName;
+		this.fileName = fileName;
+		this.lineNumber = lineNumber;
+	}
+
+	public String getClassName() {
+		return declaringClass;
+	}
+
+	public String getMethodName() {
+		return methodName;
+	}
+
+	public String getFileName() {
+		return fileName;
+	}
+
+	public int getLineNumber() {
+		return lineNumber;
+	}
+
+	public boolean isNativeMethod() {
+		return lineNumber == -2;
+	}
+
+	public boolean equals(Object o) {
+		if (!(o instanceof StackTraceElement))
+			return false;
+		StackTraceElement e = (StackTraceElement) o;
+		return declaringClass.equals(e.declaringClass)
+			&& methodName.equals(e.methodName)
+			&& (fileName == null ? e.fileName == null : fileName.equals(e.fileName))
+			&& lineNumber == e.lineNumber;
+	}
+
+	public int hashCode() {
+		return 31 * declaringClass.hashCode() + methodName.hashCode();
+	}
+
+	public String toString() {
+		String location;
+		if (isNativeMethod())
+			location = "Native Method";
+		else if (fileName == null)
+			location = "Unknown Source";
+		else if (lineNumber >= 0)
+			location = fileName + ":" + lineNumber;
+		else
+			location = fileName;
+		return declaringClass + "." + methodName + "(" + location + ")";
+	}
+}
@@ -93,9 +93,9 @@ public final class String
 
   /**
    * This is the object that holds the characters that make up the
-   * String.  It might be a char[], or it could be String.  It could
-   * even be `this'.  The actual characters can't be located using
-   * pure Java code.
+   * String.  It is a byte[] of Latin-1 characters or a char[], see
+   * coder, or a String with inline characters.  The actual characters
+   * can't be located using pure Java code.
    * @see #boffset
    */
   private Object data;
@@ -113,11 +113,23 @@ public final class String
    */
   int count;
 
+  /**
+   * Whether the characters are stored as Latin-1 bytes or as UTF-16 chars.
+   * Don't use this field in Java code.
+   */
+  private byte coder;
+
+  /**
+   * Whether the characters are stored right after this object, data is the
+   * String itself then.  Don't use this field in Java code.
+   */
+  private boolean charsInline;
+
   /**
    * Caches the result of hashCode().  If this value is zero, the hashcode
    * is considered uncached (even if 0 is the correct hash value).
    */
-//  private int cachedHashCode;
+  private int cachedHashCode;
 
 //  /**
 //   * An implementation for {@link #CASE_INSENSITIVE_ORDER}.
@@ -173,8 +185,9 @@ public final class String
   public String()
   {
     data = "".data;
-    boffset = 0;
+    boffset = "".boffset;
     count = 0;
+    coder = "".coder;
   }
 
   /**
@@ -189,7 +202,8 @@ public final class String
     data = str.data;
     boffset = str.boffset;
     count = str.count;
-//    cachedHashCode = str.cachedHashCode;
+    coder = str.coder;
+    cachedHashCode = str.cachedHashCode;
   }
 
   /**
@@ -649,17 +663,17 @@ public final class String
    * @return the comparison
    * @throws NullPointerException if anotherString is null
    */
-//  public int compareTo(String anotherString)
-//  {
-//    return nativeCompareTo(anotherString);
-//  }
+  public int compareTo(String anotherString)
+  {
+    return nativeCompareTo(anotherString);
+  }
 
   /**
    * The native implementation of compareTo(). Must be named different
    * since cni doesn't understand the bridge method generated from
    * the compareTo() method because of the Comparable<String> interface.
    */
-//  private native int nativeCompareTo(String anotherString);
+  private native int nativeCompareTo(String anotherString);
 
 //  /**
 //   * Compares this String and another String (case insensitive). This
@@ -768,28 +782,28 @@ public final class String
    */
   public native int hashCode();
 
-//  /**
-//   * Finds the first instance of a character in this String.
-//   *
-//   * @param ch character to find
-//   * @return location (base 0) of the character, or -1 if not found
-//   */
-//  public int indexOf(int ch)
-//  {
-//    return indexOf(ch, 0);
-//  }
-//
-//  /**
-//   * Finds the first instance of a character in this String, starting at
-//   * a given index.  If starting index is less than 0, the search
-//   * starts at the beginning of this String.  If the starting index
-//   * is greater than the length of this String, -1 is returned.
-//   *
-//   * @param ch character to find
-//   * @param fromIndex index to start the search
-//   * @return location (base 0) of the character, or -1 if not found
-//   */
-//  public native int indexOf(int ch, int fromIndex);
+  /**
+   * Finds the first instance of a character in this String.
+   *
+   * @param ch character to find
+   * @return location (base 0) of the character, or -1 if not found
+   */
+  public int indexOf(int ch)
+  {
+    return indexOf(ch, 0);
+  }
+
+  /**
+   * Finds the first instance of a character in this String, starting at
+   * a given index.  If starting index is less than 0, the search
+   * starts at the beginning of this String.  If the starting index
+   * is greater than the length of this String, -1 is returned.
+   *
+   * @param ch character to find
+   * @param fromIndex index to start the search
+   * @return location (base 0) of the character, or -1 if not found
+   */
+  public native int indexOf(int ch, int fromIndex);
 //
 //  /**
 //   * Finds the last instance of a character in this String.
@@ -1175,10 +1189,10 @@ public final class String
 //   * @see #valueOf(char[], int, int)
 //   * @see #String(char[])
 //   */
-//  public static String valueOf(char[] data)
-//  {
-//    return valueOf (data, 0, data.length);
-//  }
+  public static String valueOf(char[] data)
+  {
+    return valueOf(data, 0, data.length);
+  }
 //
 //  /**
 //   * Returns a String representing the character sequence of the char array,
@@ -1195,7 +1209,7 @@ public final class String
 //   *         (while unspecified, this is a StringIndexOutOfBoundsException)
 //   * @see #String(char[], int, int)
 //   */
-//  public static native String valueOf(char[] data, int offset, int count);
+  public static native String valueOf(char[] data, int offset, int count);
 //
 //  /**
 //   * Returns a String representing the character sequence of the char array,
@@ -1241,10 +1255,10 @@ public final class String
 //   * @param b the boolean
 //   * @return "true" if b is true, else "false"
 //   */
-//  public static String valueOf(boolean b)
-//  {
-//    return b ? "true" : "false";
-//  }
+  public static String valueOf(boolean b)
+  {
+    return b ? "true" : "false";
+  }
 //
 //  /**
 //   * Returns a String representing a character.
@@ -1261,7 +1275,10 @@ public final class String
 //   * @return String containing the integer in base 10
 //   * @see Integer#toString(int)
 //   */
-//  public static native String valueOf(int i);
+  public static String valueOf(int i)
+  {
+    return Integer.toString(i);
+  }
 //
 //  /**
 //   * Returns a String representing a long.
@@ -1270,10 +1287,10 @@ public final class String
 //   * @return String containing the long in base 10
 //   * @see Long#toString(long)
 //   */
-//  public static String valueOf(long l)
-//  {
-//    return Long.toString(l);
-//  }
+  public static String valueOf(long l)
+  {
+    return Long.toString(l);
+  }
 //
 //  /**
 //   * Returns a String representing a float.
@@ -1282,10 +1299,10 @@ public final class String
 //   * @return String containing the float
 //   * @see Float#toString(float)
 //   */
-//  public static String valueOf(float f)
-//  {
-//    return Float.toString(f);
-//  }
+  public static String valueOf(float f)
+  {
+    return Float.toString(f);
+  }
 //
 //  /**
 //   * Returns a String representing a double.
@@ -1294,10 +1311,10 @@ public final class String
 //   * @return String containing the double
 //   * @see Double#toString(double)
 //   */
-//  public static String valueOf(double d)
-//  {
-//    return Double.toString(d);
-//  }
+  public static String valueOf(double d)
+  {
+    return Double.toString(d);
+  }
 //
 //
 //  /** @since 1.5 */
@@ -699,7 +699,7 @@ public final class StringBuilder
    */
   public String toString()
   {
-    return new String(this);
+    return String.valueOf(value, 0, count);
   }
 
 }
@@ -43,11 +43,11 @@ package java.lang;
 //
 //import java.io.BufferedInputStream;
 //import java.io.BufferedOutputStream;
-//import java.io.FileDescriptor;
-//import java.io.FileInputStream;
+import java.io.FileDescriptor;
+import java.io.FileInputStream;
 //import java.io.FileOutputStream;
 //import java.io.IOException;
-//import java.io.InputStream;
+import java.io.InputStream;
 import java.io.PrintStream;
 //import java.nio.channels.Channel;
 //import java.nio.channels.spi.SelectorProvider;
@@ -77,7 +77,9 @@ public final class System
   // WARNING: System is a CORE class in the bootstrap cycle. See the comments
   // in vm/reference/java/lang/Runtime for implications of this fact.
   //
-  public static final PrintStream out = new PrintStream();
+  public static final InputStream in = new FileInputStream(FileDescriptor.in);
+  public static final PrintStream out = new PrintStream(1);
+  public static final PrintStream err = new PrintStream(2);
 
 //  /**
 //   * The standard InputStream. This is assigned at startup and starts its
@@ -221,15 +223,15 @@ public final class System
 //   */
 //  public static native long currentTimeMillis();
 //
-//  /**
-//   * Get the current time, measured in nanoseconds.  The result is as
-//   * precise as possible, and is measured against a fixed epoch.
-//   * However, unlike currentTimeMillis(), the epoch chosen is
-//   * arbitrary and may vary by platform, etc.
-//   * @since 1.5
-//   */
-//  public static native long nanoTime();
-//
+  /**
+   * Get the current time, measured in nanoseconds.  The result is as
+   * precise as possible, and is measured against a fixed epoch.
+   * However, unlike currentTimeMillis(), the epoch chosen is
+   * arbitrary and may vary by platform, etc.
+   * @since 1.5
+   */
+  public static native long nanoTime();
+
 //  /**
 //   * Copy one array onto another from <code>src[srcStart]</code> ...
 //   * <code>src[srcStart+len-1]</code> to <code>dest[destStart]</code> ...
@@ -255,19 +257,19 @@ public final class System
 //   */
   public static native void arraycopy(Object src, int srcStart,
 				      Object dest, int destStart, int len);
-//
-//  /**
-//   * Get a hash code computed by the VM for the Object. This hash code will
-//   * be the same as Object's hashCode() method.  It is usually some
-//   * convolution of the pointer to the Object internal to the VM.  It
-//   * follows standard hash code rules, in that it will remain the same for a
-//   * given Object for the lifetime of that Object.
-//   *
-//   * @param o the Object to get the hash code for
-//   * @return the VM-dependent hash code for this Object
-//   * @since 1.1
-//   */
-//  public static native int identityHashCode(Object o);
+
+  /**
+   * Get a hash code computed by the VM for the Object. This hash code will
+   * be the same as Object's hashCode() method.  It is usually some
+   * convolution of the pointer to the Object internal to the VM.  It
+   * follows standard hash code rules, in that it will remain the same for a
+   * given Object for the lifetime of that Object.
+   *
+   * @param o the Object to get the hash code for
+   * @return the VM-dependent hash code for this Object
+   * @since 1.1
+   */
+  public static native int identityHashCode(Object o);
 //
 //  /**
 //   * Get all the system properties at once. A security check may be performed,
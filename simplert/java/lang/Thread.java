@@ -0,0 +1,102 @@
+package java.lang;
+
+/**
+ * Threads run on pthreads, see simplert/c/threads.c. The runtime calls
+ * runThread on the new thread, join waits on the Thread object itself like
+ * in the JDK. There are no daemon threads, the program ends when the last
+ * thread does, and no interrupts.
+ */
+public class Thread implements Runnable {
+	private static int threadCount;
+
+	private Runnable target;
+	private String   name;
+	private boolean  started;
+	/** protected by the lock of the Thread */
+	private boolean  alive;
+
+	public Thread() {
+		this(null, null);
+	}
+
+	public Thread(Runnable target) {
+		this(target, null);
+	}
+
+	public Thread(String name) {
+		this(null, name);
+	}
+
+	public Thread(Runnable target, String name) {
+		this.target = target;
+		this.name   = name != null ? name : "Thread-" + nextThreadNumber();
+	}
+
+	private static synchronized int nextThreadNumber() {
+		return threadCount++;
+	}
+
+	public void run() {
+		if (target != null)
+			target.run();
+	}
+
+	public synchronized void start() {
+		if (started)
+			throw new IllegalThreadStateException();
+		started = true;
+		alive   = true;
+		start0();
+	}
+
+	private native void start0();
+
+	/** Called by the runtime on the new thread. */
+	private void runThread() {
+		run();
+		synchronized (this) {
+			alive = false;
+			notifyAll();
+		}
+	}
+
+	public final synchronized boolean isAlive() {
+		return alive;
+	}
+
+	public final synchronized void join() throws InterruptedException {
+		while (alive)
+			wait();
+	}
+
+	public final String getName() {
+		return name;
+	}
+
+	public String toString() {
+		return "Thread[" + name + "]";
+	}
+
+	/**
+	 * Returns the Thread of the current thread, the one of the main thread
+	 * is created on first use.
+	 */
+	public static Thread currentThread() {
+		Thread current = nativeCurrentThread();
+		if (current == null) {
+			current         = new Thread("main");
+			current.started = true;
+			current.alive   = true;
+			nativeAttach(current);
+		}
+		return current;
+	}
+
+	private static native Thread nativeCurrentThread();
+
+	private static native void nativeAttach(Thread thread);
+
+	public static native void sleep(long millis) throws InterruptedException;
+
+	public static native void yield();
+}
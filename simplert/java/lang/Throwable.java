@@ -41,7 +41,7 @@ package java.lang;
 
 //import gnu.java.lang.CPStringBuilder;
 
-//import java.io.PrintStream;
+import java.io.PrintStream;
 //import java.io.PrintWriter;
 import java.io.Serializable;
 
@@ -137,7 +137,7 @@ public class Throwable implements Serializable
    *         no null entries
    * @since 1.4
    */
-//  private StackTraceElement[] stackTrace;
+  private StackTraceElement[] stackTrace;
 
   /**
    * Instantiate this Throwable with an empty message. The cause remains
@@ -158,7 +158,7 @@ public class Throwable implements Serializable
    */
   public Throwable(String message)
   {
-//    fillInStackTrace();
+    fillInStackTrace();
     detailMessage = message;
   }
 
@@ -261,7 +261,7 @@ public class Throwable implements Serializable
   public String toString()
   {
     String msg = getLocalizedMessage();
-    return /*getClass().getName() + */(msg == null ? "" : ": " + msg);
+    return getClass().getName() + (msg == null ? "" : ": " + msg);
   }
 
   /**
@@ -349,10 +349,10 @@ public class Throwable implements Serializable
    *          ... 3 more
    * </pre>
    */
-//  public void printStackTrace()
-//  {
-//    printStackTrace(System.err);
-//  }
+  public void printStackTrace()
+  {
+    printStackTrace(System.err);
+  }
 
   /**
    * Print a stack trace to the specified PrintStream. See
@@ -360,10 +360,10 @@ public class Throwable implements Serializable
    *
    * @param s the PrintStream to write the trace to
    */
-//  public void printStackTrace(PrintStream s)
-//  {
-//    s.print(stackTraceString());
-//  }
+  public void printStackTrace(PrintStream s)
+  {
+    s.print(stackTraceString());
+  }
 
   /**
    * Prints the exception, the detailed message and the stack trace
@@ -411,83 +411,83 @@ public class Throwable implements Serializable
   // Create whole stack trace in a stringbuffer so we don't have to print
   // it line by line. This prevents printing multiple stack traces from
   // different threads to get mixed up when written to the same PrintWriter.
-//  private String stackTraceString()
-//  {
-//    CPStringBuilder sb = new CPStringBuilder();
-//
-//    // Main stacktrace
-//    StackTraceElement[] stack = getStackTrace();
-//    stackTraceStringBuffer(sb, this.toString(), stack, 0);
-//
-//    // The cause(s)
-//    Throwable cause = getCause();
-//    while (cause != null)
-//      {
-//        // Cause start first line
-//        sb.append("Caused by: ");
-//
-//        // Cause stacktrace
-//        StackTraceElement[] parentStack = stack;
-//        stack = cause.getStackTrace();
-//        if (parentStack == null || parentStack.length == 0)
-//          stackTraceStringBuffer(sb, cause.toString(), stack, 0);
-//        else
-//          {
-//            int equal = 0; // Count how many of the last stack frames are equal
-//            int frame = stack.length-1;
-//            int parentFrame = parentStack.length-1;
-//            while (frame > 0 && parentFrame > 0)
-//              {
-//                if (stack[frame].equals(parentStack[parentFrame]))
-//                  {
-//                    equal++;
-//                    frame--;
-//                    parentFrame--;
-//                  }
-//                else
-//                  break;
-//              }
-//            stackTraceStringBuffer(sb, cause.toString(), stack, equal);
-//          }
-//        cause = cause.getCause();
-//      }
-//
-//    return sb.toString();
-//  }
+  private String stackTraceString()
+  {
+    StringBuilder sb = new StringBuilder();
+
+    // Main stacktrace
+    StackTraceElement[] stack = getStackTrace();
+    stackTraceStringBuffer(sb, this.toString(), stack, 0);
+
+    // The cause(s)
+    Throwable cause = getCause();
+    while (cause != null)
+      {
+        // Cause start first line
+        sb.append("Caused by: ");
+
+        // Cause stacktrace
+        StackTraceElement[] parentStack = stack;
+        stack = cause.getStackTrace();
+        if (parentStack == null || parentStack.length == 0)
+          stackTraceStringBuffer(sb, cause.toString(), stack, 0);
+        else
+          {
+            int equal = 0; // Count how many of the last stack frames are equal
+            int frame = stack.length-1;
+            int parentFrame = parentStack.length-1;
+            while (frame > 0 && parentFrame > 0)
+              {
+                if (stack[frame].equals(parentStack[parentFrame]))
+                  {
+                    equal++;
+                    frame--;
+                    parentFrame--;
+                  }
+                else
+                  break;
+              }
+            stackTraceStringBuffer(sb, cause.toString(), stack, equal);
+          }
+        cause = cause.getCause();
+      }
+
+    return sb.toString();
+  }
 
   // Adds to the given StringBuffer a line containing the name and
   // all stacktrace elements minus the last equal ones.
-//  private static void stackTraceStringBuffer(CPStringBuilder sb, String name,
-//                                        StackTraceElement[] stack, int equal)
-//  {
-//    String nl = StaticData.nl;
-//    // (finish) first line
-//    sb.append(name);
-//    sb.append(nl);
-//
-//    // The stacktrace
-//    if (stack == null || stack.length == 0)
-//      {
-//        sb.append("   <<No stacktrace available>>");
-//        sb.append(nl);
-//      }
-//    else
-//      {
-//        for (int i = 0; i < stack.length-equal; i++)
-//          {
-//            sb.append("   at ");
-//            sb.append(stack[i] == null ? "<<Unknown>>" : stack[i].toString());
-//            sb.append(nl);
-//          }
-//        if (equal > 0)
-//          {
-//            sb.append("   ...");
-//            sb.append(equal);
-//            sb.append(" more");
-//            sb.append(nl);
-//          }
-//      }
-//  }
+  private static void stackTraceStringBuffer(StringBuilder sb, String name,
+                                        StackTraceElement[] stack, int equal)
+  {
+    String nl = "\n";
+    // (finish) first line
+    sb.append(name);
+    sb.append(nl);
+
+    // The stacktrace
+    if (stack == null || stack.length == 0)
+      {
+        sb.append("\t<<No stacktrace available>>");
+        sb.append(nl);
+      }
+    else
+      {
+        for (int i = 0; i < stack.length-equal; i++)
+          {
+            sb.append("\tat ");
+            sb.append(stack[i] == null ? "<<Unknown>>" : stack[i].toString());
+            sb.append(nl);
+          }
+        if (equal > 0)
+          {
+            sb.append("\t... ");
+            sb.append(equal);
+            sb.append(" more");
+            sb.append(nl);
+          }
+      }
+  }
 
   /**
    * Fill in the stack trace with the current execution stack.
@@ -495,13 +495,13 @@ public class Throwable implements Serializable
    * @return this same throwable
    * @see #printStackTrace()
    */
-//  public Throwable fillInStackTrace()
-//  {
-//    vmState = VMThrowable.fillInStackTrace(this);
-//    stackTrace = null; // Should be regenerated when used.
-//
-//    return this;
-//  }
+  public Throwable fillInStackTrace()
+  {
+    vmState = VMThrowable.fillInStackTrace(this);
+    stackTrace = null; // Should be regenerated when used.
+
+    return this;
+  }
 
   /**
    * Provides access to the information printed in {@link #printStackTrace()}.
@@ -514,19 +514,19 @@ public class Throwable implements Serializable
    * @return an array of stack trace information, as available from the VM
    * @since 1.4
    */
-//  public StackTraceElement[] getStackTrace()
-//  {
-//    if (stackTrace == null)
-//      if (vmState == null)
-//        stackTrace = new StackTraceElement[0];
-//      else
-//        {
-//          stackTrace = vmState.getStackTrace(this);
-//          vmState = null; // No longer needed
-//        }
-//
-//    return stackTrace;
-//  }
+  public StackTraceElement[] getStackTrace()
+  {
+    if (stackTrace == null)
+      if (vmState == null)
+        stackTrace = new StackTraceElement[0];
+      else
+        {
+          stackTrace = vmState.getStackTrace(this);
+          vmState = null; // No longer needed
+        }
+
+    return stackTrace;
+  }
 
   /**
    * Change the stack trace manually. This method is designed for remote
@@ -541,25 +541,25 @@ public class Throwable implements Serializable
    * @throws NullPointerException if stackTrace is null or has null elements
    * @since 1.4
    */
-//  public void setStackTrace(StackTraceElement[] stackTrace)
-//  {
-//    int i = stackTrace.length;
-//    StackTraceElement[] st = new StackTraceElement[i];
-//
-//    while (--i >= 0)
-//      {
-//        st[i] = stackTrace[i];
-//        if (st[i] == null)
-//          throw new NullPointerException("Element " + i + " null");
-//      }
-//
-//    this.stackTrace = st;
-//  }
+  public void setStackTrace(StackTraceElement[] stackTrace)
+  {
+    int i = stackTrace.length;
+    StackTraceElement[] st = new StackTraceElement[i];
+
+    while (--i >= 0)
+      {
+        st[i] = stackTrace[i];
+        if (st[i] == null)
+          throw new NullPointerException("Element " + i + " null");
+      }
+
+    this.stackTrace = st;
+  }
 
   /**
    * VM state when fillInStackTrace was called.
    * Used by getStackTrace() to get an array of StackTraceElements.
    * Cleared when no longer needed.
    */
-//  private transient VMThrowable vmState;
+  private transient VMThrowable vmState;
 }
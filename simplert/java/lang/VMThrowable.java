@@ -0,0 +1,57 @@
+package java.lang;
+
+/**
+ * The stack trace of a Throwable. Only the return addresses of the frames
+ * are recorded when the Throwable is created, they are mapped to methods
+ * and source lines when getStackTrace asks for them (see
+ * simplert/c/java_lang_vmthrowable.c).
+ */
+final class VMThrowable {
+	private final long[] addresses;
+
+	private VMThrowable(long[] addresses) {
+		this.addresses = addresses;
+	}
+
+	static VMThrowable fillInStackTrace(Throwable throwable) {
+		return new VMThrowable(captureAddresses());
+	}
+
+	StackTraceElement[] getStackTrace(Throwable throwable) {
+		int first = 0;
+		while (first < addresses.length
+		       && isFillingIn(addresses[first], throwable))
+			++first;
+
+		/* frames of the runtime are left out */
+		StackTraceElement[] elements
+			= new StackTraceElement[addresses.length - first];
+		int n = 0;
+		for (int i = first; i < addresses.length; ++i) {
+			String className = getClassName(addresses[i]);
+			if (className == null)
+				continue;
+			elements[n++] = new StackTraceElement(className,
+				getMethodName(addresses[i]), getFileName(addresses[i]),
+				getLineNumber(addresses[i]));
+		}
+		if (n == elements.length)
+			return elements;
+		StackTraceElement[] result = new StackTraceElement[n];
+		System.arraycopy(elements, 0, result, 0, n);
+		return result;
+	}
+
+	private static native long[] captureAddresses();
+
+	private static native boolean isFillingIn(long address,
+	                                          Throwable throwable);
+
+	private static native String getClassName(long address);
+
+	private static native String getMethodName(long address);
+
+	private static native String getFileName(long address);
+
+	private static native int getLineNumber(long address);
+}
@@ -53,11 +53,10 @@ import java.io.Serializable;
  *
  * Implementations may use their own algorithms, but must obey the general
  * properties; for example, the sort must be stable and n*log(n) complexity.
- * Sun's implementation of sort, and therefore ours, is a tuned quicksort,
- * adapted from Jon L. Bentley and M. Douglas McIlroy's "Engineering a Sort
- * Function", Software-Practice and Experience, Vol. 23(11) P. 1249-1265
- * (November 1993). This algorithm offers n*log(n) performance on many data
- * sets that cause other quicksorts to degrade to quadratic performance.
+ * The primitive sorts are natives: an introsort that falls back to heap
+ * sort, so no input makes them quadratic, and counting sort for large byte
+ * and char arrays. They need not be stable since equal primitives are
+ * indistinguishable.
  *
  * @author Original author unknown
  * @author Bryce McKinlay
@@ -1206,1201 +1205,243 @@ public class Arrays
 //    for (int i = fromIndex; i < toIndex; i++)
 //      a[i] = val;
 //  }
-//
-//
-//// sort
-//  // Thanks to Paul Fisher (rao@gnu.org) for finding this quicksort algorithm
-//  // as specified by Sun and porting it to Java. The algorithm is an optimised
-//  // quicksort, as described in Jon L. Bentley and M. Douglas McIlroy's
-//  // "Engineering a Sort Function", Software-Practice and Experience, Vol.
-//  // 23(11) P. 1249-1265 (November 1993). This algorithm gives n*log(n)
-//  // performance on many arrays that would take quadratic time with a standard
-//  // quicksort.
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the byte array to sort
-//   */
-//  public static void sort(byte[] a)
-//  {
-//    qsort(a, 0, a.length);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the byte array to sort
-//   * @param fromIndex the first index to sort (inclusive)
-//   * @param toIndex the last index to sort (exclusive)
-//   * @throws IllegalArgumentException if fromIndex &gt; toIndex
-//   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
-//   *         || toIndex &gt; a.length
-//   */
-//  public static void sort(byte[] a, int fromIndex, int toIndex)
-//  {
-//    if (fromIndex > toIndex)
-//      throw new IllegalArgumentException();
-//    if (fromIndex < 0)
-//      throw new ArrayIndexOutOfBoundsException();
-//    qsort(a, fromIndex, toIndex - fromIndex);
-//  }
-//
-//  /**
-//   * Finds the index of the median of three array elements.
-//   *
-//   * @param a the first index
-//   * @param b the second index
-//   * @param c the third index
-//   * @param d the array
-//   * @return the index (a, b, or c) which has the middle value of the three
-//   */
-//  private static int med3(int a, int b, int c, byte[] d)
-//  {
-//    return (d[a] < d[b]
-//            ? (d[b] < d[c] ? b : d[a] < d[c] ? c : a)
-//            : (d[b] > d[c] ? b : d[a] > d[c] ? c : a));
-//  }
-//
-//  /**
-//   * Swaps the elements at two locations of an array
-//   *
-//   * @param i the first index
-//   * @param j the second index
-//   * @param a the array
-//   */
-//  private static void swap(int i, int j, byte[] a)
-//  {
-//    byte c = a[i];
-//    a[i] = a[j];
-//    a[j] = c;
-//  }
-//
-//  /**
-//   * Swaps two ranges of an array.
-//   *
-//   * @param i the first range start
-//   * @param j the second range start
-//   * @param n the element count
-//   * @param a the array
-//   */
-//  private static void vecswap(int i, int j, int n, byte[] a)
-//  {
-//    for ( ; n > 0; i++, j++, n--)
-//      swap(i, j, a);
-//  }
-//
-//  /**
-//   * Performs a recursive modified quicksort.
-//   *
-//   * @param array the array to sort
-//   * @param from the start index (inclusive)
-//   * @param count the number of elements to sort
-//   */
-//  private static void qsort(byte[] array, int from, int count)
-//  {
-//    // Use an insertion sort on small arrays.
-//    if (count <= 7)
-//      {
-//        for (int i = from + 1; i < from + count; i++)
-//          for (int j = i; j > from && array[j - 1] > array[j]; j--)
-//            swap(j, j - 1, array);
-//        return;
-//      }
-//
-//    // Determine a good median element.
-//    int mid = from + count / 2;
-//    int lo = from;
-//    int hi = from + count - 1;
-//
-//    if (count > 40)
-//      { // big arrays, pseudomedian of 9
-//        int s = count / 8;
-//        lo = med3(lo, lo + s, lo + 2 * s, array);
-//        mid = med3(mid - s, mid, mid + s, array);
-//        hi = med3(hi - 2 * s, hi - s, hi, array);
-//      }
-//    mid = med3(lo, mid, hi, array);
-//
-//    int a, b, c, d;
-//    int comp;
-//
-//    // Pull the median element out of the fray, and use it as a pivot.
-//    swap(from, mid, array);
-//    a = b = from;
-//    c = d = from + count - 1;
-//
-//    // Repeatedly move b and c to each other, swapping elements so
-//    // that all elements before index b are less than the pivot, and all
-//    // elements after index c are greater than the pivot. a and b track
-//    // the elements equal to the pivot.
-//    while (true)
-//      {
-//        while (b <= c && (comp = array[b] - array[from]) <= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(a, b, array);
-//                a++;
-//              }
-//            b++;
-//          }
-//        while (c >= b && (comp = array[c] - array[from]) >= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(c, d, array);
-//                d--;
-//              }
-//            c--;
-//          }
-//        if (b > c)
-//          break;
-//        swap(b, c, array);
-//        b++;
-//        c--;
-//      }
-//
-//    // Swap pivot(s) back in place, the recurse on left and right sections.
-//    hi = from + count;
-//    int span;
-//    span = Math.min(a - from, b - a);
-//    vecswap(from, b - span, span, array);
-//
-//    span = Math.min(d - c, hi - d - 1);
-//    vecswap(b, hi - span, span, array);
-//
-//    span = b - a;
-//    if (span > 1)
-//      qsort(array, from, span);
-//
-//    span = d - c;
-//    if (span > 1)
-//      qsort(array, hi - span, span);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the char array to sort
-//   */
-//  public static void sort(char[] a)
-//  {
-//    qsort(a, 0, a.length);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the char array to sort
-//   * @param fromIndex the first index to sort (inclusive)
-//   * @param toIndex the last index to sort (exclusive)
-//   * @throws IllegalArgumentException if fromIndex &gt; toIndex
-//   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
-//   *         || toIndex &gt; a.length
-//   */
-//  public static void sort(char[] a, int fromIndex, int toIndex)
-//  {
-//    if (fromIndex > toIndex)
-//      throw new IllegalArgumentException();
-//    if (fromIndex < 0)
-//      throw new ArrayIndexOutOfBoundsException();
-//    qsort(a, fromIndex, toIndex - fromIndex);
-//  }
-//
-//  /**
-//   * Finds the index of the median of three array elements.
-//   *
-//   * @param a the first index
-//   * @param b the second index
-//   * @param c the third index
-//   * @param d the array
-//   * @return the index (a, b, or c) which has the middle value of the three
-//   */
-//  private static int med3(int a, int b, int c, char[] d)
-//  {
-//    return (d[a] < d[b]
-//            ? (d[b] < d[c] ? b : d[a] < d[c] ? c : a)
-//            : (d[b] > d[c] ? b : d[a] > d[c] ? c : a));
-//  }
-//
-//  /**
-//   * Swaps the elements at two locations of an array
-//   *
-//   * @param i the first index
-//   * @param j the second index
-//   * @param a the array
-//   */
-//  private static void swap(int i, int j, char[] a)
-//  {
-//    char c = a[i];
-//    a[i] = a[j];
-//    a[j] = c;
-//  }
-//
-//  /**
-//   * Swaps two ranges of an array.
-//   *
-//   * @param i the first range start
-//   * @param j the second range start
-//   * @param n the element count
-//   * @param a the array
-//   */
-//  private static void vecswap(int i, int j, int n, char[] a)
-//  {
-//    for ( ; n > 0; i++, j++, n--)
-//      swap(i, j, a);
-//  }
-//
-//  /**
-//   * Performs a recursive modified quicksort.
-//   *
-//   * @param array the array to sort
-//   * @param from the start index (inclusive)
-//   * @param count the number of elements to sort
-//   */
-//  private static void qsort(char[] array, int from, int count)
-//  {
-//    // Use an insertion sort on small arrays.
-//    if (count <= 7)
-//      {
-//        for (int i = from + 1; i < from + count; i++)
-//          for (int j = i; j > from && array[j - 1] > array[j]; j--)
-//            swap(j, j - 1, array);
-//        return;
-//      }
-//
-//    // Determine a good median element.
-//    int mid = from + count / 2;
-//    int lo = from;
-//    int hi = from + count - 1;
-//
-//    if (count > 40)
-//      { // big arrays, pseudomedian of 9
-//        int s = count / 8;
-//        lo = med3(lo, lo + s, lo + 2 * s, array);
-//        mid = med3(mid - s, mid, mid + s, array);
-//        hi = med3(hi - 2 * s, hi - s, hi, array);
-//      }
-//    mid = med3(lo, mid, hi, array);
-//
-//    int a, b, c, d;
-//    int comp;
-//
-//    // Pull the median element out of the fray, and use it as a pivot.
-//    swap(from, mid, array);
-//    a = b = from;
-//    c = d = from + count - 1;
-//
-//    // Repeatedly move b and c to each other, swapping elements so
-//    // that all elements before index b are less than the pivot, and all
-//    // elements after index c are greater than the pivot. a and b track
-//    // the elements equal to the pivot.
-//    while (true)
-//      {
-//        while (b <= c && (comp = array[b] - array[from]) <= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(a, b, array);
-//                a++;
-//              }
-//            b++;
-//          }
-//        while (c >= b && (comp = array[c] - array[from]) >= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(c, d, array);
-//                d--;
-//              }
-//            c--;
-//          }
-//        if (b > c)
-//          break;
-//        swap(b, c, array);
-//        b++;
-//        c--;
-//      }
-//
-//    // Swap pivot(s) back in place, the recurse on left and right sections.
-//    hi = from + count;
-//    int span;
-//    span = Math.min(a - from, b - a);
-//    vecswap(from, b - span, span, array);
-//
-//    span = Math.min(d - c, hi - d - 1);
-//    vecswap(b, hi - span, span, array);
-//
-//    span = b - a;
-//    if (span > 1)
-//      qsort(array, from, span);
-//
-//    span = d - c;
-//    if (span > 1)
-//      qsort(array, hi - span, span);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the short array to sort
-//   */
-//  public static void sort(short[] a)
-//  {
-//    qsort(a, 0, a.length);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the short array to sort
-//   * @param fromIndex the first index to sort (inclusive)
-//   * @param toIndex the last index to sort (exclusive)
-//   * @throws IllegalArgumentException if fromIndex &gt; toIndex
-//   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
-//   *         || toIndex &gt; a.length
-//   */
-//  public static void sort(short[] a, int fromIndex, int toIndex)
-//  {
-//    if (fromIndex > toIndex)
-//      throw new IllegalArgumentException();
-//    if (fromIndex < 0)
-//      throw new ArrayIndexOutOfBoundsException();
-//    qsort(a, fromIndex, toIndex - fromIndex);
-//  }
-//
-//  /**
-//   * Finds the index of the median of three array elements.
-//   *
-//   * @param a the first index
-//   * @param b the second index
-//   * @param c the third index
-//   * @param d the array
-//   * @return the index (a, b, or c) which has the middle value of the three
-//   */
-//  private static int med3(int a, int b, int c, short[] d)
-//  {
-//    return (d[a] < d[b]
-//            ? (d[b] < d[c] ? b : d[a] < d[c] ? c : a)
-//            : (d[b] > d[c] ? b : d[a] > d[c] ? c : a));
-//  }
-//
-//  /**
-//   * Swaps the elements at two locations of an array
-//   *
-//   * @param i the first index
-//   * @param j the second index
-//   * @param a the array
-//   */
-//  private static void swap(int i, int j, short[] a)
-//  {
-//    short c = a[i];
-//    a[i] = a[j];
-//    a[j] = c;
-//  }
-//
-//  /**
-//   * Swaps two ranges of an array.
-//   *
-//   * @param i the first range start
-//   * @param j the second range start
-//   * @param n the element count
-//   * @param a the array
-//   */
-//  private static void vecswap(int i, int j, int n, short[] a)
-//  {
-//    for ( ; n > 0; i++, j++, n--)
-//      swap(i, j, a);
-//  }
-//
-//  /**
-//   * Performs a recursive modified quicksort.
-//   *
-//   * @param array the array to sort
-//   * @param from the start index (inclusive)
-//   * @param count the number of elements to sort
-//   */
-//  private static void qsort(short[] array, int from, int count)
-//  {
-//    // Use an insertion sort on small arrays.
-//    if (count <= 7)
-//      {
-//        for (int i = from + 1; i < from + count; i++)
-//          for (int j = i; j > from && array[j - 1] > array[j]; j--)
-//            swap(j, j - 1, array);
-//        return;
-//      }
-//
-//    // Determine a good median element.
-//    int mid = from + count / 2;
-//    int lo = from;
-//    int hi = from + count - 1;
-//
-//    if (count > 40)
-//      { // big arrays, pseudomedian of 9
-//        int s = count / 8;
-//        lo = med3(lo, lo + s, lo + 2 * s, array);
-//        mid = med3(mid - s, mid, mid + s, array);
-//        hi = med3(hi - 2 * s, hi - s, hi, array);
-//      }
-//    mid = med3(lo, mid, hi, array);
-//
-//    int a, b, c, d;
-//    int comp;
-//
-//    // Pull the median element out of the fray, and use it as a pivot.
-//    swap(from, mid, array);
-//    a = b = from;
-//    c = d = from + count - 1;
-//
-//    // Repeatedly move b and c to each other, swapping elements so
-//    // that all elements before index b are less than the pivot, and all
-//    // elements after index c are greater than the pivot. a and b track
-//    // the elements equal to the pivot.
-//    while (true)
-//      {
-//        while (b <= c && (comp = array[b] - array[from]) <= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(a, b, array);
-//                a++;
-//              }
-//            b++;
-//          }
-//        while (c >= b && (comp = array[c] - array[from]) >= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(c, d, array);
-//                d--;
-//              }
-//            c--;
-//          }
-//        if (b > c)
-//          break;
-//        swap(b, c, array);
-//        b++;
-//        c--;
-//      }
-//
-//    // Swap pivot(s) back in place, the recurse on left and right sections.
-//    hi = from + count;
-//    int span;
-//    span = Math.min(a - from, b - a);
-//    vecswap(from, b - span, span, array);
-//
-//    span = Math.min(d - c, hi - d - 1);
-//    vecswap(b, hi - span, span, array);
-//
-//    span = b - a;
-//    if (span > 1)
-//      qsort(array, from, span);
-//
-//    span = d - c;
-//    if (span > 1)
-//      qsort(array, hi - span, span);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the int array to sort
-//   */
-//  public static void sort(int[] a)
-//  {
-//    qsort(a, 0, a.length);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the int array to sort
-//   * @param fromIndex the first index to sort (inclusive)
-//   * @param toIndex the last index to sort (exclusive)
-//   * @throws IllegalArgumentException if fromIndex &gt; toIndex
-//   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
-//   *         || toIndex &gt; a.length
-//   */
-//  public static void sort(int[] a, int fromIndex, int toIndex)
-//  {
-//    if (fromIndex > toIndex)
-//      throw new IllegalArgumentException();
-//    if (fromIndex < 0)
-//      throw new ArrayIndexOutOfBoundsException();
-//    qsort(a, fromIndex, toIndex - fromIndex);
-//  }
-//
-//  /**
-//   * Finds the index of the median of three array elements.
-//   *
-//   * @param a the first index
-//   * @param b the second index
-//   * @param c the third index
-//   * @param d the array
-//   * @return the index (a, b, or c) which has the middle value of the three
-//   */
-//  private static int med3(int a, int b, int c, int[] d)
-//  {
-//    return (d[a] < d[b]
-//            ? (d[b] < d[c] ? b : d[a] < d[c] ? c : a)
-//            : (d[b] > d[c] ? b : d[a] > d[c] ? c : a));
-//  }
-//
-//  /**
-//   * Swaps the elements at two locations of an array
-//   *
-//   * @param i the first index
-//   * @param j the second index
-//   * @param a the array
-//   */
-//  private static void swap(int i, int j, int[] a)
-//  {
-//    int c = a[i];
-//    a[i] = a[j];
-//    a[j] = c;
-//  }
-//
-//  /**
-//   * Swaps two ranges of an array.
-//   *
-//   * @param i the first range start
-//   * @param j the second range start
-//   * @param n the element count
-//   * @param a the array
-//   */
-//  private static void vecswap(int i, int j, int n, int[] a)
-//  {
-//    for ( ; n > 0; i++, j++, n--)
-//      swap(i, j, a);
-//  }
-//
-//  /**
-//   * Compares two integers in natural order, since a - b is inadequate.
-//   *
-//   * @param a the first int
-//   * @param b the second int
-//   * @return &lt; 0, 0, or &gt; 0 accorting to the comparison
-//   */
-//  private static int compare(int a, int b)
-//  {
-//    return a < b ? -1 : a == b ? 0 : 1;
-//  }
-//
-//  /**
-//   * Performs a recursive modified quicksort.
-//   *
-//   * @param array the array to sort
-//   * @param from the start index (inclusive)
-//   * @param count the number of elements to sort
-//   */
-//  private static void qsort(int[] array, int from, int count)
-//  {
-//    // Use an insertion sort on small arrays.
-//    if (count <= 7)
-//      {
-//        for (int i = from + 1; i < from + count; i++)
-//          for (int j = i; j > from && array[j - 1] > array[j]; j--)
-//            swap(j, j - 1, array);
-//        return;
-//      }
-//
-//    // Determine a good median element.
-//    int mid = from + count / 2;
-//    int lo = from;
-//    int hi = from + count - 1;
-//
-//    if (count > 40)
-//      { // big arrays, pseudomedian of 9
-//        int s = count / 8;
-//        lo = med3(lo, lo + s, lo + 2 * s, array);
-//        mid = med3(mid - s, mid, mid + s, array);
-//        hi = med3(hi - 2 * s, hi - s, hi, array);
-//      }
-//    mid = med3(lo, mid, hi, array);
-//
-//    int a, b, c, d;
-//    int comp;
-//
-//    // Pull the median element out of the fray, and use it as a pivot.
-//    swap(from, mid, array);
-//    a = b = from;
-//    c = d = from + count - 1;
-//
-//    // Repeatedly move b and c to each other, swapping elements so
-//    // that all elements before index b are less than the pivot, and all
-//    // elements after index c are greater than the pivot. a and b track
-//    // the elements equal to the pivot.
-//    while (true)
-//      {
-//        while (b <= c && (comp = compare(array[b], array[from])) <= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(a, b, array);
-//                a++;
-//              }
-//            b++;
-//          }
-//        while (c >= b && (comp = compare(array[c], array[from])) >= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(c, d, array);
-//                d--;
-//              }
-//            c--;
-//          }
-//        if (b > c)
-//          break;
-//        swap(b, c, array);
-//        b++;
-//        c--;
-//      }
-//
-//    // Swap pivot(s) back in place, the recurse on left and right sections.
-//    hi = from + count;
-//    int span;
-//    span = Math.min(a - from, b - a);
-//    vecswap(from, b - span, span, array);
-//
-//    span = Math.min(d - c, hi - d - 1);
-//    vecswap(b, hi - span, span, array);
-//
-//    span = b - a;
-//    if (span > 1)
-//      qsort(array, from, span);
-//
-//    span = d - c;
-//    if (span > 1)
-//      qsort(array, hi - span, span);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the long array to sort
-//   */
-//  public static void sort(long[] a)
-//  {
-//    qsort(a, 0, a.length);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the long array to sort
-//   * @param fromIndex the first index to sort (inclusive)
-//   * @param toIndex the last index to sort (exclusive)
-//   * @throws IllegalArgumentException if fromIndex &gt; toIndex
-//   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
-//   *         || toIndex &gt; a.length
-//   */
-//  public static void sort(long[] a, int fromIndex, int toIndex)
-//  {
-//    if (fromIndex > toIndex)
-//      throw new IllegalArgumentException();
-//    if (fromIndex < 0)
-//      throw new ArrayIndexOutOfBoundsException();
-//    qsort(a, fromIndex, toIndex - fromIndex);
-//  }
-//
-//  /**
-//   * Finds the index of the median of three array elements.
-//   *
-//   * @param a the first index
-//   * @param b the second index
-//   * @param c the third index
-//   * @param d the array
-//   * @return the index (a, b, or c) which has the middle value of the three
-//   */
-//  private static int med3(int a, int b, int c, long[] d)
-//  {
-//    return (d[a] < d[b]
-//            ? (d[b] < d[c] ? b : d[a] < d[c] ? c : a)
-//            : (d[b] > d[c] ? b : d[a] > d[c] ? c : a));
-//  }
-//
-//  /**
-//   * Swaps the elements at two locations of an array
-//   *
-//   * @param i the first index
-//   * @param j the second index
-//   * @param a the array
-//   */
-//  private static void swap(int i, int j, long[] a)
-//  {
-//    long c = a[i];
-//    a[i] = a[j];
-//    a[j] = c;
-//  }
-//
-//  /**
-//   * Swaps two ranges of an array.
-//   *
-//   * @param i the first range start
-//   * @param j the second range start
-//   * @param n the element count
-//   * @param a the array
-//   */
-//  private static void vecswap(int i, int j, int n, long[] a)
-//  {
-//    for ( ; n > 0; i++, j++, n--)
-//      swap(i, j, a);
-//  }
-//
-//  /**
-//   * Compares two longs in natural order, since a - b is inadequate.
-//   *
-//   * @param a the first long
-//   * @param b the second long
-//   * @return &lt; 0, 0, or &gt; 0 accorting to the comparison
-//   */
-//  private static int compare(long a, long b)
-//  {
-//    return a < b ? -1 : a == b ? 0 : 1;
-//  }
-//
-//  /**
-//   * Performs a recursive modified quicksort.
-//   *
-//   * @param array the array to sort
-//   * @param from the start index (inclusive)
-//   * @param count the number of elements to sort
-//   */
-//  private static void qsort(long[] array, int from, int count)
-//  {
-//    // Use an insertion sort on small arrays.
-//    if (count <= 7)
-//      {
-//        for (int i = from + 1; i < from + count; i++)
-//          for (int j = i; j > from && array[j - 1] > array[j]; j--)
-//            swap(j, j - 1, array);
-//        return;
-//      }
-//
-//    // Determine a good median element.
-//    int mid = from + count / 2;
-//    int lo = from;
-//    int hi = from + count - 1;
-//
-//    if (count > 40)
-//      { // big arrays, pseudomedian of 9
-//        int s = count / 8;
-//        lo = med3(lo, lo + s, lo + 2 * s, array);
-//        mid = med3(mid - s, mid, mid + s, array);
-//        hi = med3(hi - 2 * s, hi - s, hi, array);
-//      }
-//    mid = med3(lo, mid, hi, array);
-//
-//    int a, b, c, d;
-//    int comp;
-//
-//    // Pull the median element out of the fray, and use it as a pivot.
-//    swap(from, mid, array);
-//    a = b = from;
-//    c = d = from + count - 1;
-//
-//    // Repeatedly move b and c to each other, swapping elements so
-//    // that all elements before index b are less than the pivot, and all
-//    // elements after index c are greater than the pivot. a and b track
-//    // the elements equal to the pivot.
-//    while (true)
-//      {
-//        while (b <= c && (comp = compare(array[b], array[from])) <= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(a, b, array);
-//                a++;
-//              }
-//            b++;
-//          }
-//        while (c >= b && (comp = compare(array[c], array[from])) >= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(c, d, array);
-//                d--;
-//              }
-//            c--;
-//          }
-//        if (b > c)
-//          break;
-//        swap(b, c, array);
-//        b++;
-//        c--;
-//      }
-//
-//    // Swap pivot(s) back in place, the recurse on left and right sections.
-//    hi = from + count;
-//    int span;
-//    span = Math.min(a - from, b - a);
-//    vecswap(from, b - span, span, array);
-//
-//    span = Math.min(d - c, hi - d - 1);
-//    vecswap(b, hi - span, span, array);
-//
-//    span = b - a;
-//    if (span > 1)
-//      qsort(array, from, span);
-//
-//    span = d - c;
-//    if (span > 1)
-//      qsort(array, hi - span, span);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the float array to sort
-//   */
-//  public static void sort(float[] a)
-//  {
-//    qsort(a, 0, a.length);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the float array to sort
-//   * @param fromIndex the first index to sort (inclusive)
-//   * @param toIndex the last index to sort (exclusive)
-//   * @throws IllegalArgumentException if fromIndex &gt; toIndex
-//   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
-//   *         || toIndex &gt; a.length
-//   */
-//  public static void sort(float[] a, int fromIndex, int toIndex)
-//  {
-//    if (fromIndex > toIndex)
-//      throw new IllegalArgumentException();
-//    if (fromIndex < 0)
-//      throw new ArrayIndexOutOfBoundsException();
-//    qsort(a, fromIndex, toIndex - fromIndex);
-//  }
-//
-//  /**
-//   * Finds the index of the median of three array elements.
-//   *
-//   * @param a the first index
-//   * @param b the second index
-//   * @param c the third index
-//   * @param d the array
-//   * @return the index (a, b, or c) which has the middle value of the three
-//   */
-//  private static int med3(int a, int b, int c, float[] d)
-//  {
-//    return (Float.compare(d[a], d[b]) < 0
-//            ? (Float.compare(d[b], d[c]) < 0 ? b
-//               : Float.compare(d[a], d[c]) < 0 ? c : a)
-//            : (Float.compare(d[b], d[c]) > 0 ? b
-//               : Float.compare(d[a], d[c]) > 0 ? c : a));
-//  }
-//
-//  /**
-//   * Swaps the elements at two locations of an array
-//   *
-//   * @param i the first index
-//   * @param j the second index
-//   * @param a the array
-//   */
-//  private static void swap(int i, int j, float[] a)
-//  {
-//    float c = a[i];
-//    a[i] = a[j];
-//    a[j] = c;
-//  }
-//
-//  /**
-//   * Swaps two ranges of an array.
-//   *
-//   * @param i the first range start
-//   * @param j the second range start
-//   * @param n the element count
-//   * @param a the array
-//   */
-//  private static void vecswap(int i, int j, int n, float[] a)
-//  {
-//    for ( ; n > 0; i++, j++, n--)
-//      swap(i, j, a);
-//  }
-//
-//  /**
-//   * Performs a recursive modified quicksort.
-//   *
-//   * @param array the array to sort
-//   * @param from the start index (inclusive)
-//   * @param count the number of elements to sort
-//   */
-//  private static void qsort(float[] array, int from, int count)
-//  {
-//    // Use an insertion sort on small arrays.
-//    if (count <= 7)
-//      {
-//        for (int i = from + 1; i < from + count; i++)
-//          for (int j = i;
-//               j > from && Float.compare(array[j - 1], array[j]) > 0;
-//               j--)
-//            {
-//              swap(j, j - 1, array);
-//            }
-//        return;
-//      }
-//
-//    // Determine a good median element.
-//    int mid = from + count / 2;
-//    int lo = from;
-//    int hi = from + count - 1;
-//
-//    if (count > 40)
-//      { // big arrays, pseudomedian of 9
-//        int s = count / 8;
-//        lo = med3(lo, lo + s, lo + 2 * s, array);
-//        mid = med3(mid - s, mid, mid + s, array);
-//        hi = med3(hi - 2 * s, hi - s, hi, array);
-//      }
-//    mid = med3(lo, mid, hi, array);
-//
-//    int a, b, c, d;
-//    int comp;
-//
-//    // Pull the median element out of the fray, and use it as a pivot.
-//    swap(from, mid, array);
-//    a = b = from;
-//    c = d = from + count - 1;
-//
-//    // Repeatedly move b and c to each other, swapping elements so
-//    // that all elements before index b are less than the pivot, and all
-//    // elements after index c are greater than the pivot. a and b track
-//    // the elements equal to the pivot.
-//    while (true)
-//      {
-//        while (b <= c && (comp = Float.compare(array[b], array[from])) <= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(a, b, array);
-//                a++;
-//              }
-//            b++;
-//          }
-//        while (c >= b && (comp = Float.compare(array[c], array[from])) >= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(c, d, array);
-//                d--;
-//              }
-//            c--;
-//          }
-//        if (b > c)
-//          break;
-//        swap(b, c, array);
-//        b++;
-//        c--;
-//      }
-//
-//    // Swap pivot(s) back in place, the recurse on left and right sections.
-//    hi = from + count;
-//    int span;
-//    span = Math.min(a - from, b - a);
-//    vecswap(from, b - span, span, array);
-//
-//    span = Math.min(d - c, hi - d - 1);
-//    vecswap(b, hi - span, span, array);
-//
-//    span = b - a;
-//    if (span > 1)
-//      qsort(array, from, span);
-//
-//    span = d - c;
-//    if (span > 1)
-//      qsort(array, hi - span, span);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the double array to sort
-//   */
-//  public static void sort(double[] a)
-//  {
-//    qsort(a, 0, a.length);
-//  }
-//
-//  /**
-//   * Performs a stable sort on the elements, arranging them according to their
-//   * natural order.
-//   *
-//   * @param a the double array to sort
-//   * @param fromIndex the first index to sort (inclusive)
-//   * @param toIndex the last index to sort (exclusive)
-//   * @throws IllegalArgumentException if fromIndex &gt; toIndex
-//   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
-//   *         || toIndex &gt; a.length
-//   */
-//  public static void sort(double[] a, int fromIndex, int toIndex)
-//  {
-//    if (fromIndex > toIndex)
-//      throw new IllegalArgumentException();
-//    if (fromIndex < 0)
-//      throw new ArrayIndexOutOfBoundsException();
-//    qsort(a, fromIndex, toIndex - fromIndex);
-//  }
-//
-//  /**
-//   * Finds the index of the median of three array elements.
-//   *
-//   * @param a the first index
-//   * @param b the second index
-//   * @param c the third index
-//   * @param d the array
-//   * @return the index (a, b, or c) which has the middle value of the three
-//   */
-//  private static int med3(int a, int b, int c, double[] d)
-//  {
-//    return (Double.compare(d[a], d[b]) < 0
-//            ? (Double.compare(d[b], d[c]) < 0 ? b
-//               : Double.compare(d[a], d[c]) < 0 ? c : a)
-//            : (Double.compare(d[b], d[c]) > 0 ? b
-//               : Double.compare(d[a], d[c]) > 0 ? c : a));
-//  }
-//
-//  /**
-//   * Swaps the elements at two locations of an array
-//   *
-//   * @param i the first index
-//   * @param j the second index
-//   * @param a the array
-//   */
-//  private static void swap(int i, int j, double[] a)
-//  {
-//    double c = a[i];
-//    a[i] = a[j];
-//    a[j] = c;
-//  }
-//
-//  /**
-//   * Swaps two ranges of an array.
-//   *
-//   * @param i the first range start
-//   * @param j the second range start
-//   * @param n the element count
-//   * @param a the array
-//   */
-//  private static void vecswap(int i, int j, int n, double[] a)
-//  {
-//    for ( ; n > 0; i++, j++, n--)
-//      swap(i, j, a);
-//  }
-//
-//  /**
-//   * Performs a recursive modified quicksort.
-//   *
-//   * @param array the array to sort
-//   * @param from the start index (inclusive)
-//   * @param count the number of elements to sort
-//   */
-//  private static void qsort(double[] array, int from, int count)
-//  {
-//    // Use an insertion sort on small arrays.
-//    if (count <= 7)
-//      {
-//        for (int i = from + 1; i < from + count; i++)
-//          for (int j = i;
-//               j > from && Double.compare(array[j - 1], array[j]) > 0;
-//               j--)
-//            {
-//              swap(j, j - 1, array);
-//            }
-//        return;
-//      }
-//
-//    // Determine a good median element.
-//    int mid = from + count / 2;
-//    int lo = from;
-//    int hi = from + count - 1;
-//
-//    if (count > 40)
-//      { // big arrays, pseudomedian of 9
-//        int s = count / 8;
-//        lo = med3(lo, lo + s, lo + 2 * s, array);
-//        mid = med3(mid - s, mid, mid + s, array);
-//        hi = med3(hi - 2 * s, hi - s, hi, array);
-//      }
-//    mid = med3(lo, mid, hi, array);
-//
-//    int a, b, c, d;
-//    int comp;
-//
-//    // Pull the median element out of the fray, and use it as a pivot.
-//    swap(from, mid, array);
-//    a = b = from;
-//    c = d = from + count - 1;
-//
-//    // Repeatedly move b and c to each other, swapping elements so
-//    // that all elements before index b are less than the pivot, and all
-//    // elements after index c are greater than the pivot. a and b track
-//    // the elements equal to the pivot.
-//    while (true)
-//      {
-//        while (b <= c && (comp = Double.compare(array[b], array[from])) <= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(a, b, array);
-//                a++;
-//              }
-//            b++;
-//          }
-//        while (c >= b && (comp = Double.compare(array[c], array[from])) >= 0)
-//          {
-//            if (comp == 0)
-//              {
-//                swap(c, d, array);
-//                d--;
-//              }
-//            c--;
-//          }
-//        if (b > c)
-//          break;
-//        swap(b, c, array);
-//        b++;
-//        c--;
-//      }
-//
-//    // Swap pivot(s) back in place, the recurse on left and right sections.
-//    hi = from + count;
-//    int span;
-//    span = Math.min(a - from, b - a);
-//    vecswap(from, b - span, span, array);
-//
-//    span = Math.min(d - c, hi - d - 1);
-//    vecswap(b, hi - span, span, array);
-//
-//    span = b - a;
-//    if (span > 1)
-//      qsort(array, from, span);
-//
-//    span = d - c;
-//    if (span > 1)
-//      qsort(array, hi - span, span);
-//  }
-//
+
+
+// sort
+  // The sorts of primitive arrays are natives in java_util_arrays.c, an
+  // introsort with pdqsort's pattern breaking which finishes small
+  // partitions with insertion sort. Bytes and long char arrays are counting
+  // sorted.
+
+  /**
+   * Checks the range arguments of the sort methods.
+   *
+   * @param length the length of the array
+   * @param fromIndex the first index to sort (inclusive)
+   * @param toIndex the last index to sort (exclusive)
+   * @throws IllegalArgumentException if fromIndex &gt; toIndex
+   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
+   *         || toIndex &gt; length
+   */
+  private static void checkSortRange(int length, int fromIndex, int toIndex)
+  {
+    if (fromIndex > toIndex)
+      throw new IllegalArgumentException();
+    if (fromIndex < 0 || toIndex > length)
+      throw new ArrayIndexOutOfBoundsException();
+  }
+
+  /**
+   * Sorts the elements in ascending numerical order.
+   *
+   * @param a the byte array to sort
+   */
+  public static void sort(byte[] a)
+  {
+    nativeSort(a, 0, a.length);
+  }
+
+  /**
+   * Sorts a range of the elements in ascending numerical order.
+   *
+   * @param a the byte array to sort
+   * @param fromIndex the first index to sort (inclusive)
+   * @param toIndex the last index to sort (exclusive)
+   * @throws IllegalArgumentException if fromIndex &gt; toIndex
+   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
+   *         || toIndex &gt; a.length
+   */
+  public static void sort(byte[] a, int fromIndex, int toIndex)
+  {
+    checkSortRange(a.length, fromIndex, toIndex);
+    nativeSort(a, fromIndex, toIndex);
+  }
+
+  private static native void nativeSort(byte[] a, int fromIndex,
+                                        int toIndex);
+
+  /**
+   * Sorts the elements in ascending numerical order.
+   *
+   * @param a the char array to sort
+   */
+  public static void sort(char[] a)
+  {
+    nativeSort(a, 0, a.length);
+  }
+
+  /**
+   * Sorts a range of the elements in ascending numerical order.
+   *
+   * @param a the char array to sort
+   * @param fromIndex the first index to sort (inclusive)
+   * @param toIndex the last index to sort (exclusive)
+   * @throws IllegalArgumentException if fromIndex &gt; toIndex
+   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
+   *         || toIndex &gt; a.length
+   */
+  public static void sort(char[] a, int fromIndex, int toIndex)
+  {
+    checkSortRange(a.length, fromIndex, toIndex);
+    nativeSort(a, fromIndex, toIndex);
+  }
+
+  private static native void nativeSort(char[] a, int fromIndex,
+                                        int toIndex);
+
+  /**
+   * Sorts the elements in ascending numerical order.
+   *
+   * @param a the short array to sort
+   */
+  public static void sort(short[] a)
+  {
+    nativeSort(a, 0, a.length);
+  }
+
+  /**
+   * Sorts a range of the elements in ascending numerical order.
+   *
+   * @param a the short array to sort
+   * @param fromIndex the first index to sort (inclusive)
+   * @param toIndex the last index to sort (exclusive)
+   * @throws IllegalArgumentException if fromIndex &gt; toIndex
+   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
+   *         || toIndex &gt; a.length
+   */
+  public static void sort(short[] a, int fromIndex, int toIndex)
+  {
+    checkSortRange(a.length, fromIndex, toIndex);
+    nativeSort(a, fromIndex, toIndex);
+  }
+
+  private static native void nativeSort(short[] a, int fromIndex,
+                                        int toIndex);
+
+  /**
+   * Sorts the elements in ascending numerical order.
+   *
+   * @param a the int array to sort
+   */
+  public static void sort(int[] a)
+  {
+    nativeSort(a, 0, a.length);
+  }
+
+  /**
+   * Sorts a range of the elements in ascending numerical order.
+   *
+   * @param a the int array to sort
+   * @param fromIndex the first index to sort (inclusive)
+   * @param toIndex the last index to sort (exclusive)
+   * @throws IllegalArgumentException if fromIndex &gt; toIndex
+   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
+   *         || toIndex &gt; a.length
+   */
+  public static void sort(int[] a, int fromIndex, int toIndex)
+  {
+    checkSortRange(a.length, fromIndex, toIndex);
+    nativeSort(a, fromIndex, toIndex);
+  }
+
+  private static native void nativeSort(int[] a, int fromIndex,
+                                        int toIndex);
+
+  /**
+   * Sorts the elements in ascending numerical order.
+   *
+   * @param a the long array to sort
+   */
+  public static void sort(long[] a)
+  {
+    nativeSort(a, 0, a.length);
+  }
+
+  /**
+   * Sorts a range of the elements in ascending numerical order.
+   *
+   * @param a the long array to sort
+   * @param fromIndex the first index to sort (inclusive)
+   * @param toIndex the last index to sort (exclusive)
+   * @throws IllegalArgumentException if fromIndex &gt; toIndex
+   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
+   *         || toIndex &gt; a.length
+   */
+  public static void sort(long[] a, int fromIndex, int toIndex)
+  {
+    checkSortRange(a.length, fromIndex, toIndex);
+    nativeSort(a, fromIndex, toIndex);
+  }
+
+  private static native void nativeSort(long[] a, int fromIndex,
+                                        int toIndex);
+
+  /**
+   * Sorts the elements in ascending numerical order. As with
+   * <code>Float.compareTo</code>, -0.0 comes before 0.0 and NaN after all
+   * other values.
+   *
+   * @param a the float array to sort
+   */
+  public static void sort(float[] a)
+  {
+    nativeSort(a, 0, a.length);
+  }
+
+  /**
+   * Sorts a range of the elements in ascending numerical order. As with
+   * <code>Float.compareTo</code>, -0.0 comes before 0.0 and NaN after all
+   * other values.
+   *
+   * @param a the float array to sort
+   * @param fromIndex the first index to sort (inclusive)
+   * @param toIndex the last index to sort (exclusive)
+   * @throws IllegalArgumentException if fromIndex &gt; toIndex
+   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
+   *         || toIndex &gt; a.length
+   */
+  public static void sort(float[] a, int fromIndex, int toIndex)
+  {
+    checkSortRange(a.length, fromIndex, toIndex);
+    nativeSort(a, fromIndex, toIndex);
+  }
+
+  private static native void nativeSort(float[] a, int fromIndex,
+                                        int toIndex);
+
+  /**
+   * Sorts the elements in ascending numerical order. As with
+   * <code>Double.compareTo</code>, -0.0 comes before 0.0 and NaN after all
+   * other values.
+   *
+   * @param a the double array to sort
+   */
+  public static void sort(double[] a)
+  {
+    nativeSort(a, 0, a.length);
+  }
+
+  /**
+   * Sorts a range of the elements in ascending numerical order. As with
+   * <code>Double.compareTo</code>, -0.0 comes before 0.0 and NaN after all
+   * other values.
+   *
+   * @param a the double array to sort
+   * @param fromIndex the first index to sort (inclusive)
+   * @param toIndex the last index to sort (exclusive)
+   * @throws IllegalArgumentException if fromIndex &gt; toIndex
+   * @throws ArrayIndexOutOfBoundsException if fromIndex &lt; 0
+   *         || toIndex &gt; a.length
+   */
+  public static void sort(double[] a, int fromIndex, int toIndex)
+  {
+    checkSortRange(a.length, fromIndex, toIndex);
+    nativeSort(a, fromIndex, toIndex);
+  }
+
+  private static native void nativeSort(double[] a, int fromIndex,
+                                        int toIndex);
+
 //  /**
 //   * Sort an array of Objects according to their natural ordering. The sort is
 //   * guaranteed to be stable, that is, equal elements will not be reordered.
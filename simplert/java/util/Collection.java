@@ -0,0 +1,15 @@
+package java.util;
+
+public interface Collection<E> extends Iterable<E> {
+	int size();
+
+	boolean isEmpty();
+
+	boolean contains(Object o);
+
+	boolean add(E e);
+
+	boolean remove(Object o);
+
+	void clear();
+}
@@ -0,0 +1,508 @@
+package java.util;
+
+/**
+ * The hash table behind HashMap, LinkedHashMap and IdentityHashMap.
+ *
+ * The entries are stored in flat arrays in insertion order: the hash codes
+ * in one, keys and values interleaved in another. A separate open
+ * addressing table with linear probing maps hash codes to entry positions.
+ * Unlike a chained table there is no object per entry, and a lookup only
+ * looks at a key whose cached hash code matches. Removed entries leave a
+ * REMOVED key behind, which is dropped when the arrays are full and get
+ * rebuilt.
+ *
+ * Fields are package visible, so the nested classes don't need accessors.
+ */
+abstract class CompactHashMap<K, V> implements Map<K, V> {
+	/** Stands for the null key in the entry array. */
+	static final Object NULL_KEY = new Object();
+	/** Key of removed entries. */
+	static final Object REMOVED  = new Object();
+
+	/** Multiplier for Fibonacci hashing, spreads the hash codes. */
+	static final int SPREAD       = 0x9E3779B9;
+	static final int MIN_CAPACITY = 4;
+
+	static final int KEYS    = 0;
+	static final int VALUES  = 1;
+	static final int ENTRIES = 2;
+
+	/** Compare keys and values with == and System.identityHashCode. */
+	final boolean identity;
+	/**
+	 * Entry position + 1 for each slot, 0 marks a free slot. It has twice
+	 * as many slots as there are positions, the load stays below 1/2.
+	 */
+	int[]    slots;
+	/** 32 - log2(slots.length), the top bits of the spread hash pick a slot. */
+	int      shift;
+	int[]    hashes;
+	/** Key of the entry at position p at 2p, its value at 2p+1. */
+	Object[] entries;
+	/** Positions in use, including removed entries. */
+	int      used;
+	/** No live entry is stored before this position. */
+	int      head;
+	/** Number of live entries. */
+	int      count;
+
+	CompactHashMap(int capacity, boolean identity) {
+		if (capacity < 0)
+			throw new IllegalArgumentException("Illegal capacity: " + capacity);
+		this.identity = identity;
+		int size = MIN_CAPACITY;
+		while (size < capacity && size < (1 << 28))
+			size <<= 1;
+		allocate(size);
+	}
+
+	private void allocate(int capacity) {
+		int log = 1;
+		while ((1 << log) < 2 * capacity)
+			++log;
+		slots   = new int[2 * capacity];
+		shift   = 32 - log;
+		hashes  = new int[capacity];
+		entries = new Object[2 * capacity];
+		used    = 0;
+		head    = 0;
+	}
+
+	final int hash(Object object) {
+		if (object == null)
+			return 0;
+		return identity ? System.identityHashCode(object) : object.hashCode();
+	}
+
+	final boolean same(Object a, Object b) {
+		return a == b || (!identity && a != null && a.equals(b));
+	}
+
+	final int home(int hash) {
+		return (hash * SPREAD) >>> shift;
+	}
+
+	static Object unmask(Object key) {
+		return key == NULL_KEY ? null : key;
+	}
+
+	/** Returns the slot referring to the entry for key or -1. */
+	final int findSlot(Object key, int hash) {
+		Object   masked  = key == null ? NULL_KEY : key;
+		int[]    slots   = this.slots;
+		int[]    hashes  = this.hashes;
+		Object[] entries = this.entries;
+		int      mask    = slots.length - 1;
+		for (int slot = home(hash); ; slot = (slot + 1) & mask) {
+			int position = slots[slot] - 1;
+			if (position < 0)
+				return -1;
+			if (hashes[position] != hash)
+				continue;
+			Object other = entries[2 * position];
+			if (other == masked || (!identity && key != null && key.equals(other)))
+				return slot;
+		}
+	}
+
+	/** Appends an entry and returns its position. */
+	final int append(Object maskedKey, Object value, int hash) {
+		if (used == hashes.length)
+			rebuild();
+		int position = used++;
+		hashes[position]           = hash;
+		entries[2 * position]      = maskedKey;
+		entries[2 * position + 1]  = value;
+
+		int[] slots = this.slots;
+		int   mask  = slots.length - 1;
+		int   slot  = home(hash);
+		while (slots[slot] != 0)
+			slot = (slot + 1) & mask;
+		slots[slot] = position + 1;
+		return position;
+	}
+
+	/**
+	 * Makes room for another entry. The arrays are compacted, and doubled
+	 * if more than half of them hold live entries.
+	 */
+	private void rebuild() {
+		int[]    oldHashes  = hashes;
+		Object[] oldEntries = entries;
+		int      oldUsed    = used;
+		int      capacity   = hashes.length;
+		if (count >= capacity / 2)
+			capacity *= 2;
+		allocate(capacity);
+		for (int p = 0; p < oldUsed; ++p) {
+			Object key = oldEntries[2 * p];
+			if (key != REMOVED)
+				append(key, oldEntries[2 * p + 1], oldHashes[p]);
+		}
+	}
+
+	/** Removes the entry referred to by slot and returns its value. */
+	final Object removeSlot(int slot) {
+		int    position = slots[slot] - 1;
+		Object value    = entries[2 * position + 1];
+		entries[2 * position]     = REMOVED;
+		entries[2 * position + 1] = null;
+		--count;
+		if (position == used - 1)
+			--used;
+
+		/* move later entries of the probe sequence back into the hole,
+		 * unless their home slot lies between the hole and them */
+		int[] slots = this.slots;
+		int   mask  = slots.length - 1;
+		int   hole  = slot;
+		for (int i = (hole + 1) & mask; slots[i] != 0; i = (i + 1) & mask) {
+			int home = home(hashes[slots[i] - 1]);
+			if (((i - home) & mask) >= ((i - hole) & mask)) {
+				slots[hole] = slots[i];
+				hole        = i;
+			}
+		}
+		slots[hole] = 0;
+		return value;
+	}
+
+	final int slotOf(int position) {
+		int[] slots = this.slots;
+		int   mask  = slots.length - 1;
+		int   slot  = home(hashes[position]);
+		while (slots[slot] != position + 1)
+			slot = (slot + 1) & mask;
+		return slot;
+	}
+
+	/** Moves the entry referred to by slot behind all other entries. */
+	final void moveToEnd(int slot) {
+		int position = slots[slot] - 1;
+		if (position == used - 1)
+			return;
+		Object key   = entries[2 * position];
+		Object value = entries[2 * position + 1];
+		int    hash  = hashes[position];
+		removeSlot(slot);
+		append(key, value, hash);
+		++count;
+	}
+
+	/** Returns the position of the oldest live entry or -1. */
+	final int eldest() {
+		while (head < used && entries[2 * head] == REMOVED)
+			++head;
+		return head < used ? head : -1;
+	}
+
+	/** Called after a lookup or update found the entry in slot. */
+	void accessed(int slot) {
+	}
+
+	/** Called after a new entry was appended. */
+	void inserted() {
+	}
+
+	public int size() {
+		return count;
+	}
+
+	public boolean isEmpty() {
+		return count == 0;
+	}
+
+	public boolean containsKey(Object key) {
+		return findSlot(key, hash(key)) >= 0;
+	}
+
+	public boolean containsValue(Object value) {
+		for (int p = head; p < used; ++p) {
+			if (entries[2 * p] != REMOVED && same(value, entries[2 * p + 1]))
+				return true;
+		}
+		return false;
+	}
+
+	@SuppressWarnings("unchecked")
+	public V get(Object key) {
+		int slot = findSlot(key, hash(key));
+		if (slot < 0)
+			return null;
+		V value = (V)entries[2 * (slots[slot] - 1) + 1];
+		accessed(slot);
+		return value;
+	}
+
+	@SuppressWarnings("unchecked")
+	public V put(K key, V value) {
+		int hash = hash(key);
+		int slot = findSlot(key, hash);
+		if (slot >= 0) {
+			int index = 2 * (slots[slot] - 1) + 1;
+			V   old   = (V)entries[index];
+			entries[index] = value;
+			accessed(slot);
+			return old;
+		}
+		append(key == null ? NULL_KEY : key, value, hash);
+		++count;
+		inserted();
+		return null;
+	}
+
+	public void putAll(Map<? extends K, ? extends V> map) {
+		for (Map.Entry<? extends K, ? extends V> entry : map.entrySet())
+			put(entry.getKey(), entry.getValue());
+	}
+
+	@SuppressWarnings("unchecked")
+	public V remove(Object key) {
+		int slot = findSlot(key, hash(key));
+		if (slot < 0)
+			return null;
+		return (V)removeSlot(slot);
+	}
+
+	public void clear() {
+		allocate(hashes.length);
+		count = 0;
+	}
+
+	@SuppressWarnings("unchecked")
+	public Set<K> keySet() {
+		return new View(KEYS);
+	}
+
+	@SuppressWarnings("unchecked")
+	public Collection<V> values() {
+		return new View(VALUES);
+	}
+
+	@SuppressWarnings("unchecked")
+	public Set<Map.Entry<K, V>> entrySet() {
+		return new View(ENTRIES);
+	}
+
+	public boolean equals(Object o) {
+		if (o == this)
+			return true;
+		if (!(o instanceof Map))
+			return false;
+		Map<?, ?> other = (Map<?, ?>)o;
+		if (other.size() != count)
+			return false;
+		for (int p = head; p < used; ++p) {
+			Object key = entries[2 * p];
+			if (key == REMOVED)
+				continue;
+			key = unmask(key);
+			Object value = entries[2 * p + 1];
+			if (value == null ? other.get(key) != null || !other.containsKey(key)
+			                  : !same(value, other.get(key)))
+				return false;
+		}
+		return true;
+	}
+
+	public int hashCode() {
+		int result = 0;
+		for (int p = head; p < used; ++p) {
+			Object key = entries[2 * p];
+			if (key != REMOVED)
+				result += hash(unmask(key)) ^ hash(entries[2 * p + 1]);
+		}
+		return result;
+	}
+
+	public String toString() {
+		StringBuilder builder = new StringBuilder("{");
+		boolean       first   = true;
+		for (int p = head; p < used; ++p) {
+			Object key = entries[2 * p];
+			if (key == REMOVED)
+				continue;
+			if (!first)
+				builder.append(", ");
+			first = false;
+			Object value = entries[2 * p + 1];
+			builder.append(key == this ? "(this Map)" : String.valueOf(unmask(key)));
+			builder.append('=');
+			builder.append(value == this ? "(this Map)" : String.valueOf(value));
+		}
+		return builder.append('}').toString();
+	}
+
+	/** The entry at a position, valid until the arrays are rebuilt. */
+	final class PositionEntry implements Map.Entry<K, V> {
+		final int position;
+
+		PositionEntry(int position) {
+			this.position = position;
+		}
+
+		@SuppressWarnings("unchecked")
+		public K getKey() {
+			return (K)unmask(entries[2 * position]);
+		}
+
+		@SuppressWarnings("unchecked")
+		public V getValue() {
+			return (V)entries[2 * position + 1];
+		}
+
+		public V setValue(V value) {
+			V old = getValue();
+			entries[2 * position + 1] = value;
+			return old;
+		}
+
+		public boolean equals(Object o) {
+			if (!(o instanceof Map.Entry))
+				return false;
+			Map.Entry<?, ?> other = (Map.Entry<?, ?>)o;
+			return same(getKey(), other.getKey())
+			    && same(getValue(), other.getValue());
+		}
+
+		public int hashCode() {
+			return hash(getKey()) ^ hash(getValue());
+		}
+
+		public String toString() {
+			return getKey() + "=" + getValue();
+		}
+	}
+
+	/** keySet(), values() and entrySet() */
+	@SuppressWarnings("rawtypes")
+	private final class View implements Set {
+		private final int kind;
+
+		View(int kind) {
+			this.kind = kind;
+		}
+
+		public int size() {
+			return count;
+		}
+
+		public boolean isEmpty() {
+			return count == 0;
+		}
+
+		public boolean contains(Object o) {
+			switch (kind) {
+			case KEYS:
+				return containsKey(o);
+			case VALUES:
+				return containsValue(o);
+			default:
+				return findEntry(o) >= 0;
+			}
+		}
+
+		/** Returns the slot of the entry equal to o or -1. */
+		private int findEntry(Object o) {
+			if (!(o instanceof Map.Entry))
+				return -1;
+			Map.Entry<?, ?> entry = (Map.Entry<?, ?>)o;
+			Object          key   = entry.getKey();
+			int             slot  = findSlot(key, hash(key));
+			if (slot >= 0 && !same(entry.getValue(), entries[2 * (slots[slot] - 1) + 1]))
+				return -1;
+			return slot;
+		}
+
+		public boolean add(Object o) {
+			throw new UnsupportedOperationException();
+		}
+
+		public boolean remove(Object o) {
+			int slot;
+			switch (kind) {
+			case KEYS:
+				slot = findSlot(o, hash(o));
+				break;
+			case VALUES:
+				slot = -1;
+				for (int p = head; p < used; ++p) {
+					if (entries[2 * p] != REMOVED && same(o, entries[2 * p + 1])) {
+						slot = slotOf(p);
+						break;
+					}
+				}
+				break;
+			default:
+				slot = findEntry(o);
+				break;
+			}
+			if (slot < 0)
+				return false;
+			removeSlot(slot);
+			return true;
+		}
+
+		public void clear() {
+			CompactHashMap.this.clear();
+		}
+
+		public Iterator iterator() {
+			return new ViewIterator(kind);
+		}
+
+		public String toString() {
+			StringBuilder builder = new StringBuilder("[");
+			for (Iterator i = iterator(); i.hasNext(); ) {
+				builder.append(String.valueOf(i.next()));
+				if (i.hasNext())
+					builder.append(", ");
+			}
+			return builder.append(']').toString();
+		}
+	}
+
+	/**
+	 * Walks the positions in order. Entries may be removed through the
+	 * iterator, other modifications during the iteration are undefined.
+	 */
+	@SuppressWarnings("rawtypes")
+	private final class ViewIterator implements Iterator {
+		private final int kind;
+		private int       next;
+		private int       last = -1;
+
+		ViewIterator(int kind) {
+			this.kind = kind;
+			this.next = head;
+		}
+
+		public boolean hasNext() {
+			while (next < used && entries[2 * next] == REMOVED)
+				++next;
+			return next < used;
+		}
+
+		public Object next() {
+			if (!hasNext())
+				throw new NoSuchElementException();
+			last = next++;
+			switch (kind) {
+			case KEYS:
+				return unmask(entries[2 * last]);
+			case VALUES:
+				return entries[2 * last + 1];
+			default:
+				return new PositionEntry(last);
+			}
+		}
+
+		public void remove() {
+			if (last < 0)
+				throw new IllegalStateException();
+			removeSlot(slotOf(last));
+			last = -1;
+		}
+	}
+}
@@ -0,0 +1,30 @@
+package java.util;
+
+/**
+ * Hash map without an object per entry, see CompactHashMap. Iteration
+ * follows the insertion order, which HashMap does not promise but
+ * LinkedHashMap relies on.
+ */
+public class HashMap<K, V> extends CompactHashMap<K, V> {
+	static final int DEFAULT_CAPACITY = 16;
+
+	public HashMap() {
+		this(DEFAULT_CAPACITY);
+	}
+
+	public HashMap(int initialCapacity) {
+		super(initialCapacity, false);
+	}
+
+	/** The load factor is checked but the table keeps its own. */
+	public HashMap(int initialCapacity, float loadFactor) {
+		super(initialCapacity, false);
+		if (!(loadFactor > 0))
+			throw new IllegalArgumentException("Illegal load factor: " + loadFactor);
+	}
+
+	public HashMap(Map<? extends K, ? extends V> map) {
+		this(map.size());
+		putAll(map);
+	}
+}
@@ -0,0 +1,82 @@
+package java.util;
+
+/**
+ * Set backed by a HashMap, the elements are its keys.
+ */
+public class HashSet<E> implements Set<E> {
+	private static final Object PRESENT = new Object();
+
+	private final HashMap<E, Object> map;
+
+	public HashSet() {
+		map = new HashMap<E, Object>();
+	}
+
+	public HashSet(int initialCapacity) {
+		map = new HashMap<E, Object>(initialCapacity);
+	}
+
+	public HashSet(int initialCapacity, float loadFactor) {
+		map = new HashMap<E, Object>(initialCapacity, loadFactor);
+	}
+
+	public HashSet(Collection<? extends E> collection) {
+		map = new HashMap<E, Object>(collection.size());
+		for (E element : collection)
+			add(element);
+	}
+
+	public int size() {
+		return map.size();
+	}
+
+	public boolean isEmpty() {
+		return map.isEmpty();
+	}
+
+	public boolean contains(Object o) {
+		return map.containsKey(o);
+	}
+
+	public boolean add(E element) {
+		return map.put(element, PRESENT) == null;
+	}
+
+	public boolean remove(Object o) {
+		return map.remove(o) == PRESENT;
+	}
+
+	public void clear() {
+		map.clear();
+	}
+
+	public Iterator<E> iterator() {
+		return map.keySet().iterator();
+	}
+
+	public boolean equals(Object o) {
+		if (o == this)
+			return true;
+		if (!(o instanceof Set))
+			return false;
+		Set<?> other = (Set<?>)o;
+		if (other.size() != size())
+			return false;
+		for (Object element : other) {
+			if (!contains(element))
+				return false;
+		}
+		return true;
+	}
+
+	public int hashCode() {
+		int result = 0;
+		for (E element : this)
+			result += element == null ? 0 : element.hashCode();
+		return result;
+	}
+
+	public String toString() {
+		return map.keySet().toString();
+	}
+}
@@ -0,0 +1,22 @@
+package java.util;
+
+/**
+ * Map comparing keys and values with == instead of equals. It shares the
+ * table of HashMap, hashed with System.identityHashCode.
+ */
+public class IdentityHashMap<K, V> extends CompactHashMap<K, V> {
+	private static final int DEFAULT_CAPACITY = 32;
+
+	public IdentityHashMap() {
+		this(DEFAULT_CAPACITY);
+	}
+
+	public IdentityHashMap(int expectedMaxSize) {
+		super(expectedMaxSize, true);
+	}
+
+	public IdentityHashMap(Map<? extends K, ? extends V> map) {
+		this(map.size());
+		putAll(map);
+	}
+}
@@ -0,0 +1,10 @@
+package java.util;
+
+public interface Iterator<E> {
+	boolean hasNext();
+
+	E next();
+
+	/** Removes the element last returned by next(). */
+	void remove();
+}
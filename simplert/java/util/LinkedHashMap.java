@@ -0,0 +1,54 @@
+package java.util;
+
+/**
+ * The entries of a HashMap already are in insertion order. In access order
+ * an entry is moved to the end whenever get or put finds it.
+ */
+public class LinkedHashMap<K, V> extends HashMap<K, V> {
+	private final boolean accessOrder;
+
+	public LinkedHashMap() {
+		this(DEFAULT_CAPACITY, 0.75f, false);
+	}
+
+	public LinkedHashMap(int initialCapacity) {
+		this(initialCapacity, 0.75f, false);
+	}
+
+	public LinkedHashMap(int initialCapacity, float loadFactor) {
+		this(initialCapacity, loadFactor, false);
+	}
+
+	public LinkedHashMap(int initialCapacity, float loadFactor,
+	                     boolean accessOrder) {
+		super(initialCapacity, loadFactor);
+		this.accessOrder = accessOrder;
+	}
+
+	public LinkedHashMap(Map<? extends K, ? extends V> map) {
+		this(map.size());
+		putAll(map);
+	}
+
+	/**
+	 * Called after put added an entry. Returning true removes the eldest
+	 * entry, which turns the map into a cache of bounded size.
+	 */
+	protected boolean removeEldestEntry(Map.Entry<K, V> eldest) {
+		return false;
+	}
+
+	void accessed(int slot) {
+		if (accessOrder)
+			moveToEnd(slot);
+	}
+
+	void inserted() {
+		int position = eldest();
+		if (removeEldestEntry(new PositionEntry(position))) {
+			/* removeEldestEntry may have modified the map itself */
+			if (entries[2 * position] != REMOVED)
+				removeSlot(slotOf(position));
+		}
+	}
+}
@@ -0,0 +1,39 @@
+package java.util;
+
+public interface Map<K, V> {
+	int size();
+
+	boolean isEmpty();
+
+	boolean containsKey(Object key);
+
+	boolean containsValue(Object value);
+
+	V get(Object key);
+
+	V put(K key, V value);
+
+	void putAll(Map<? extends K, ? extends V> map);
+
+	V remove(Object key);
+
+	void clear();
+
+	/**
+	 * The views are backed by the map, removing from them removes from the
+	 * map. Adding is not supported.
+	 */
+	Set<K> keySet();
+
+	Collection<V> values();
+
+	Set<Map.Entry<K, V>> entrySet();
+
+	interface Entry<K, V> {
+		K getKey();
+
+		V getValue();
+
+		V setValue(V value);
+	}
+}
@@ -0,0 +1,85 @@
+package java.util.concurrent.atomic;
+
+/**
+ * An int which is updated atomically. The compiler turns calls of get, set,
+ * lazySet, getAndSet, compareAndSet and the add methods into atomic
+ * instructions (see gcji_atomic_intrinsic), the synchronized bodies are
+ * only used without that.
+ */
+public final class AtomicInteger extends Number {
+	private volatile int value;
+
+	public AtomicInteger() {
+	}
+
+	public AtomicInteger(int initialValue) {
+		value = initialValue;
+	}
+
+	public int get() {
+		return value;
+	}
+
+	public synchronized void set(int newValue) {
+		value = newValue;
+	}
+
+	public void lazySet(int newValue) {
+		value = newValue;
+	}
+
+	public synchronized int getAndSet(int newValue) {
+		int old = value;
+		value = newValue;
+		return old;
+	}
+
+	public synchronized boolean compareAndSet(int expect, int update) {
+		if (value != expect)
+			return false;
+		value = update;
+		return true;
+	}
+
+	public boolean weakCompareAndSet(int expect, int update) {
+		return compareAndSet(expect, update);
+	}
+
+	public synchronized int getAndAdd(int delta) {
+		int old = value;
+		value = old + delta;
+		return old;
+	}
+
+	public int addAndGet(int delta) {
+		return getAndAdd(delta) + delta;
+	}
+
+	public int getAndIncrement() {
+		return getAndAdd(1);
+	}
+
+	public int getAndDecrement() {
+		return getAndAdd(-1);
+	}
+
+	public int incrementAndGet() {
+		return getAndAdd(1) + 1;
+	}
+
+	public int decrementAndGet() {
+		return getAndAdd(-1) - 1;
+	}
+
+	public int intValue() {
+		return get();
+	}
+
+	public long longValue() {
+		return get();
+	}
+
+	public String toString() {
+		return Integer.toString(get());
+	}
+}
@@ -0,0 +1,91 @@
+package java.util.concurrent.atomic;
+
+/**
+ * An int array whose elements are updated atomically. The compiler turns
+ * calls of get, set, lazySet, getAndSet, compareAndSet and the add methods
+ * into atomic instructions (see gcji_atomic_intrinsic), the synchronized
+ * bodies are only used without that.
+ */
+public final class AtomicIntegerArray {
+	private final int[] array;
+
+	public AtomicIntegerArray(int length) {
+		array = new int[length];
+	}
+
+	public AtomicIntegerArray(int[] values) {
+		array = new int[values.length];
+		System.arraycopy(values, 0, array, 0, values.length);
+	}
+
+	public int length() {
+		return array.length;
+	}
+
+	public synchronized int get(int i) {
+		return array[i];
+	}
+
+	public synchronized void set(int i, int newValue) {
+		array[i] = newValue;
+	}
+
+	public void lazySet(int i, int newValue) {
+		set(i, newValue);
+	}
+
+	public synchronized int getAndSet(int i, int newValue) {
+		int old = array[i];
+		array[i] = newValue;
+		return old;
+	}
+
+	public synchronized boolean compareAndSet(int i, int expect, int update) {
+		if (array[i] != expect)
+			return false;
+		array[i] = update;
+		return true;
+	}
+
+	public boolean weakCompareAndSet(int i, int expect, int update) {
+		return compareAndSet(i, expect, update);
+	}
+
+	public synchronized int getAndAdd(int i, int delta) {
+		int old = array[i];
+		array[i] = old + delta;
+		return old;
+	}
+
+	public int addAndGet(int i, int delta) {
+		return getAndAdd(i, delta) + delta;
+	}
+
+	public int getAndIncrement(int i) {
+		return getAndAdd(i, 1);
+	}
+
+	public int getAndDecrement(int i) {
+		return getAndAdd(i, -1);
+	}
+
+	public int incrementAndGet(int i) {
+		return getAndAdd(i, 1) + 1;
+	}
+
+	public int decrementAndGet(int i) {
+		return getAndAdd(i, -1) - 1;
+	}
+
+	public String toString() {
+		StringBuilder builder = new StringBuilder();
+		builder.append('[');
+		for (int i = 0; i < array.length; ++i) {
+			if (i > 0)
+				builder.append(", ");
+			builder.append(get(i));
+		}
+		builder.append(']');
+		return builder.toString();
+	}
+}
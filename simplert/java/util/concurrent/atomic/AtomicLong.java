@@ -0,0 +1,85 @@
+package java.util.concurrent.atomic;
+
+/**
+ * A long which is updated atomically. The compiler turns calls of get, set,
+ * lazySet, getAndSet, compareAndSet and the add methods into atomic
+ * instructions (see gcji_atomic_intrinsic), the synchronized bodies are
+ * only used without that.
+ */
+public final class AtomicLong extends Number {
+	private volatile long value;
+
+	public AtomicLong() {
+	}
+
+	public AtomicLong(long initialValue) {
+		value = initialValue;
+	}
+
+	public long get() {
+		return value;
+	}
+
+	public synchronized void set(long newValue) {
+		value = newValue;
+	}
+
+	public void lazySet(long newValue) {
+		value = newValue;
+	}
+
+	public synchronized long getAndSet(long newValue) {
+		long old = value;
+		value = newValue;
+		return old;
+	}
+
+	public synchronized boolean compareAndSet(long expect, long update) {
+		if (value != expect)
+			return false;
+		value = update;
+		return true;
+	}
+
+	public boolean weakCompareAndSet(long expect, long update) {
+		return compareAndSet(expect, update);
+	}
+
+	public synchronized long getAndAdd(long delta) {
+		long old = value;
+		value = old + delta;
+		return old;
+	}
+
+	public long addAndGet(long delta) {
+		return getAndAdd(delta) + delta;
+	}
+
+	public long getAndIncrement() {
+		return getAndAdd(1);
+	}
+
+	public long getAndDecrement() {
+		return getAndAdd(-1);
+	}
+
+	public long incrementAndGet() {
+		return getAndAdd(1) + 1;
+	}
+
+	public long decrementAndGet() {
+		return getAndAdd(-1) - 1;
+	}
+
+	public int intValue() {
+		return (int)get();
+	}
+
+	public long longValue() {
+		return get();
+	}
+
+	public String toString() {
+		return Long.toString(get());
+	}
+}
@@ -0,0 +1,51 @@
+package java.util.concurrent.atomic;
+
+/**
+ * A reference which is updated atomically. The compiler turns calls of get,
+ * set, lazySet, getAndSet and compareAndSet into atomic instructions (see
+ * gcji_atomic_intrinsic), the synchronized bodies are only used without
+ * that. compareAndSet compares references, not equals.
+ */
+public final class AtomicReference<V> {
+	private volatile V value;
+
+	public AtomicReference() {
+	}
+
+	public AtomicReference(V initialValue) {
+		value = initialValue;
+	}
+
+	public V get() {
+		return value;
+	}
+
+	public synchronized void set(V newValue) {
+		value = newValue;
+	}
+
+	public void lazySet(V newValue) {
+		value = newValue;
+	}
+
+	public synchronized V getAndSet(V newValue) {
+		V old = value;
+		value = newValue;
+		return old;
+	}
+
+	public synchronized boolean compareAndSet(V expect, V update) {
+		if (value != expect)
+			return false;
+		value = update;
+		return true;
+	}
+
+	public boolean weakCompareAndSet(V expect, V update) {
+		return compareAndSet(expect, update);
+	}
+
+	public String toString() {
+		return String.valueOf(get());
+	}
+}
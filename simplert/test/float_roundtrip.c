@@ -0,0 +1,90 @@
+/*
+ * Checks that Float.toString output parses back to the same float, for all
+ * 2^32 of them. Both strtof and parse_float read it back, so the test covers
+ * the parser as well. Build and run with "make simplert-float-check", an
+ * optional argument checks only every n-th float.
+ */
+#define _GNU_SOURCE
+#include "double_format.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_THREADS 64
+
+typedef struct range_t {
+	uint64_t begin;
+	uint64_t end;
+	uint64_t step;
+	uint64_t failures;
+} range_t;
+
+static bool same_float(float a, float b)
+{
+	if (isnan(a))
+		return isnan(b);
+	uint32_t bits_a;
+	uint32_t bits_b;
+	memcpy(&bits_a, &a, sizeof(bits_a));
+	memcpy(&bits_b, &b, sizeof(bits_b));
+	return bits_a == bits_b;
+}
+
+static void *check_range(void *data)
+{
+	range_t *range = data;
+	char     buffer[DOUBLE_FORMAT_SIZE + 1];
+	for (uint64_t i = range->begin; i < range->end; i += range->step) {
+		uint32_t bits = (uint32_t)i;
+		float    value;
+		memcpy(&value, &bits, sizeof(value));
+		size_t len = format_float(buffer, value);
+		buffer[len] = '\0';
+
+		float parsed;
+		bool  ok = parse_float(buffer, len, &parsed)
+		           && same_float(parsed, value)
+		           && same_float(strtof(buffer, NULL), value);
+		if (!ok && range->failures++ < 10)
+			fprintf(stderr, "%08" PRIx32 " formatted as %s\n", bits, buffer);
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	uint64_t step = argc > 1 ? strtoull(argv[1], NULL, 10) : 1;
+	if (step == 0)
+		step = 1;
+	long n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (n_threads < 1)
+		n_threads = 1;
+	if (n_threads > MAX_THREADS)
+		n_threads = MAX_THREADS;
+
+	/* ranges start at multiples of step, so all threads see the same grid */
+	uint64_t  total = UINT64_C(1) << 32;
+	uint64_t  chunk = (total / (uint64_t)n_threads + step - 1) / step * step;
+	range_t   ranges[MAX_THREADS];
+	pthread_t threads[MAX_THREADS];
+	for (long t = 0; t < n_threads; ++t) {
+		uint64_t begin = (uint64_t)t * chunk;
+		ranges[t].begin    = begin < total ? begin : total;
+		ranges[t].end      = begin + chunk < total ? begin + chunk : total;
+		ranges[t].step     = step;
+		ranges[t].failures = 0;
+		pthread_create(&threads[t], NULL, check_range, &ranges[t]);
+	}
+	uint64_t failures = 0;
+	for (long t = 0; t < n_threads; ++t) {
+		pthread_join(threads[t], NULL);
+		failures += ranges[t].failures;
+	}
+	printf("%" PRIu64 " floats failed to round-trip\n", failures);
+	return failures != 0;
+}
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Writes the power of 5 tables of simplert/c/double_format.c:
+   python3 simplert/tools/gen_ryu_tables.py > simplert/c/ryu_tables.h"""
+
+DOUBLE_POW5_INV_BITCOUNT = 125
+DOUBLE_POW5_BITCOUNT     = 125
+FLOAT_POW5_INV_BITCOUNT  = 59
+FLOAT_POW5_BITCOUNT      = 61
+
+
+def pow5bits(e):
+	"""ceil(log2(5^e)), 1 for e = 0, as computed by the C code"""
+	return ((e * 1217359) >> 19) + 1
+
+
+def inv_split(i, bits):
+	return (1 << (pow5bits(i) - 1 + bits)) // 5**i + 1
+
+
+def split(i, bits):
+	p = 5**i
+	shift = p.bit_length() - bits
+	return p >> shift if shift >= 0 else p << -shift
+
+
+def table64(name, values):
+	print("static const uint64_t %s[%d] = {" % (name, len(values)))
+	for v in values:
+		print("\tUINT64_C(%d)," % v)
+	print("};")
+
+
+def table128(name, values):
+	mask = (1 << 64) - 1
+	print("static const uint64_t %s[%d][2] = {" % (name, len(values)))
+	for v in values:
+		assert v >> 128 == 0
+		print("\t{ UINT64_C(%d), UINT64_C(%d) }," % (v & mask, v >> 64))
+	print("};")
+
+
+print("/* generated by simplert/tools/gen_ryu_tables.py, do not edit */")
+print("#ifndef RYU_TABLES_H")
+print("#define RYU_TABLES_H")
+print()
+print("#include <stdint.h>")
+print()
+print("#define DOUBLE_POW5_INV_BITCOUNT %d" % DOUBLE_POW5_INV_BITCOUNT)
+print("#define DOUBLE_POW5_BITCOUNT     %d" % DOUBLE_POW5_BITCOUNT)
+print("#define FLOAT_POW5_INV_BITCOUNT  %d" % FLOAT_POW5_INV_BITCOUNT)
+print("#define FLOAT_POW5_BITCOUNT      %d" % FLOAT_POW5_BITCOUNT)
+print()
+print("/** floor(2^(pow5bits(i) - 1 + 125) / 5^i) + 1 */")
+table128("DOUBLE_POW5_INV_SPLIT",
+         [inv_split(i, DOUBLE_POW5_INV_BITCOUNT) for i in range(342)])
+print()
+print("/** 5^i normalized to 125 bits */")
+table128("DOUBLE_POW5_SPLIT",
+         [split(i, DOUBLE_POW5_BITCOUNT) for i in range(326)])
+print()
+print("/** floor(2^(pow5bits(i) - 1 + 59) / 5^i) + 1 */")
+table64("FLOAT_POW5_INV_SPLIT",
+        [inv_split(i, FLOAT_POW5_INV_BITCOUNT) for i in range(31)])
+print()
+print("/** 5^i normalized to 61 bits */")
+table64("FLOAT_POW5_SPLIT", [split(i, FLOAT_POW5_BITCOUNT) for i in range(47)])
+print()
+print("#endif")
@@ -0,0 +1,47 @@
+public class Allocation {
+	int        a;
+	long       b;
+	Allocation next;
+
+	static void testObjects() {
+		Allocation list = null;
+		for (int i = 0; i < 100000; ++i) {
+			Allocation o = new Allocation();
+			if (o.a != 0 || o.b != 0 || o.next != null)
+				System.out.println("object not zeroed");
+			o.a    = i;
+			o.b    = -1;
+			o.next = list;
+			list   = o;
+		}
+		long sum = 0;
+		for (Allocation o = list; o != null; o = o.next) {
+			sum += o.a;
+		}
+		System.out.println(sum);
+	}
+
+	static void testArrays() {
+		/* includes sizes which are too large for the inline fast path */
+		int total = 0;
+		for (int n = 0; n < 20000; n += 97) {
+			int[]    ints  = new int[n];
+			char[]   chars = new char[n];
+			Object[] objs  = new Object[n];
+			for (int i = 0; i < n; ++i) {
+				if (ints[i] != 0 || chars[i] != 0 || objs[i] != null)
+					System.out.println("array not zeroed");
+				ints[i]  = -1;
+				chars[i] = 'x';
+				objs[i]  = objs;
+			}
+			total += ints.length + chars.length + objs.length;
+		}
+		System.out.println(total);
+	}
+
+	public static void main(String[] args) {
+		testObjects();
+		testArrays();
+	}
+}
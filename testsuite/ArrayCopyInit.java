@@ -0,0 +1,184 @@
+public class ArrayCopyInit {
+	/* only the first used elements are copied, the rest must be zero */
+	static int[] grow(int[] data, int used) {
+		int[] result = new int[data.length * 2 + 2];
+		System.arraycopy(data, 0, result, 0, used);
+		return result;
+	}
+
+	static char[] copy(char[] data) {
+		char[] result = new char[data.length];
+		System.arraycopy(data, 0, result, 0, data.length);
+		return result;
+	}
+
+	/* each copy in the loop has to keep what the earlier ones wrote */
+	static int[] gather(int[][] parts, int total) {
+		int[] result = new int[total];
+		int   pos    = 0;
+		for (int i = 0; i < parts.length; ++i) {
+			System.arraycopy(parts[i], 0, result, pos, parts[i].length);
+			pos += parts[i].length;
+		}
+		return result;
+	}
+
+	/* the copy throws before it writes anything, the handler sees zeros */
+	static int dirtyAfterCatch(int[] data) {
+		int[] result = new int[64];
+		try {
+			System.arraycopy(data, 0, result, 0, result.length);
+		} catch (ArrayIndexOutOfBoundsException e) {
+			result[0] = -1;
+		}
+		int dirty = result[0] == -1 ? 0 : 1;
+		for (int i = 1; i < result.length; ++i) {
+			if (result[i] != 0)
+				++dirty;
+		}
+		return dirty;
+	}
+
+	/* counted store loops which fill the whole array */
+	static int[] squares(int n) {
+		int[] result = new int[n];
+		for (int i = 0; i < n; ++i)
+			result[i] = i * i;
+		return result;
+	}
+
+	static long[] ramp(int n) {
+		long[] result = new long[n];
+		for (int i = 0; i < result.length; ++i)
+			result[i] = i + 1;
+		return result;
+	}
+
+	static int countNonZero(int[] data) {
+		int count = 0;
+		for (int i = 0; i < data.length; ++i) {
+			if (data[i] != 0)
+				++count;
+		}
+		return count;
+	}
+
+	/* the array escapes while it is filled, the rest must still be zero */
+	static int escapeWhileFilling(int n) {
+		int[] result = new int[n];
+		int   dirty  = 0;
+		for (int i = 0; i < n; ++i) {
+			result[i] = 1;
+			dirty += countNonZero(result) - (i + 1);
+		}
+		return dirty;
+	}
+
+	/* the loop may end early, the elements after the break stay zero */
+	static int[] fillUntil(int n, int stop) {
+		int[] result = new int[n];
+		for (int i = 0; i < n; ++i) {
+			if (i == stop)
+				break;
+			result[i] = 1;
+		}
+		return result;
+	}
+
+	static int oneUnless(int i, int stop) {
+		if (i == stop)
+			throw new IllegalStateException();
+		return 1;
+	}
+
+	/* the handler sees a partially filled array */
+	static int[] fillCaught(int n, int stop) {
+		int[] result = new int[n];
+		try {
+			for (int i = 0; i < n; ++i)
+				result[i] = oneUnless(i, stop);
+		} catch (IllegalStateException e) {
+		}
+		return result;
+	}
+
+	public static void main(String[] args) {
+		long sum        = 0;
+		int  dirty      = 0;
+		int  mismatches = 0;
+		/* enough rounds to reuse the memory of dead arrays */
+		for (int round = 0; round < 200; ++round) {
+			int[] data = new int[1];
+			int   used = 0;
+			for (int i = 0; i < 5000; ++i) {
+				if (used == data.length)
+					data = grow(data, used);
+				data[used++] = i + round;
+			}
+			for (int i = 0; i < used; ++i)
+				sum += data[i];
+			for (int i = used; i < data.length; ++i) {
+				if (data[i] != 0)
+					++dirty;
+			}
+
+			char[] chars = new char[3000 + round];
+			for (int i = 0; i < chars.length; ++i)
+				chars[i] = (char)('a' + (i + round) % 26);
+			char[] copied = copy(chars);
+			for (int i = 0; i < chars.length; ++i) {
+				if (copied[i] != chars[i])
+					++mismatches;
+			}
+		}
+		System.out.println(sum);
+		System.out.println(dirty);
+		System.out.println(mismatches);
+
+		int[][] parts = new int[10][];
+		int     total = 0;
+		for (int i = 0; i < parts.length; ++i) {
+			parts[i] = new int[i + 1];
+			for (int j = 0; j <= i; ++j)
+				parts[i][j] = i + 1;
+			total += parts[i].length;
+		}
+		long gathered = 0;
+		int  lost     = 0;
+		int  caught   = 0;
+		int[] shorter = new int[10];
+		for (int i = 0; i < shorter.length; ++i)
+			shorter[i] = 7;
+		for (int round = 0; round < 100; ++round) {
+			int[] all = gather(parts, total);
+			for (int i = 0; i < all.length; ++i) {
+				if (all[i] == 0)
+					++lost;
+				gathered += all[i];
+			}
+			caught += dirtyAfterCatch(shorter);
+		}
+		System.out.println(gathered + " " + lost);
+		System.out.println(caught);
+
+		long squareSum = 0;
+		long rampSum   = 0;
+		int  escaped   = 0;
+		int  early     = 0;
+		int  partial   = 0;
+		for (int round = 0; round < 100; ++round) {
+			int   n     = 1000 + round;
+			int[] field = squares(n);
+			for (int i = 0; i < field.length; ++i)
+				squareSum += field[i];
+			long[] longs = ramp(n);
+			for (int i = 0; i < longs.length; ++i)
+				rampSum += longs[i];
+			escaped += escapeWhileFilling(100);
+			early   += countNonZero(fillUntil(n, n / 2));
+			partial += countNonZero(fillCaught(n, 10));
+		}
+		System.out.println(squareSum + " " + rampSum);
+		System.out.println(escaped + " " + early + " " + partial);
+	}
+}
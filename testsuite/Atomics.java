@@ -0,0 +1,120 @@
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicIntegerArray;
+import java.util.concurrent.atomic.AtomicLong;
+import java.util.concurrent.atomic.AtomicReference;
+
+/* lock free stack, the nodes are allocated while other threads collect */
+class Node
+{
+	final int value;
+	Node      next;
+
+	Node(int value)
+	{
+		this.value = value;
+	}
+}
+
+class Counting extends Thread
+{
+	static final int ROUNDS = 100000;
+	static final int PUSHES = 10000;
+
+	private final AtomicInteger         counter;
+	private final AtomicLong            sum;
+	private final AtomicIntegerArray    buckets;
+	private final AtomicReference<Node> stack;
+
+	Counting(AtomicInteger counter, AtomicLong sum, AtomicIntegerArray buckets,
+	         AtomicReference<Node> stack)
+	{
+		this.counter = counter;
+		this.sum     = sum;
+		this.buckets = buckets;
+		this.stack   = stack;
+	}
+
+	public void run()
+	{
+		for (int i = 0; i < ROUNDS; ++i) {
+			counter.incrementAndGet();
+			sum.addAndGet(i);
+			buckets.getAndIncrement(i % buckets.length());
+		}
+		for (int i = 0; i < PUSHES; ++i) {
+			Node node = new Node(i);
+			Node top;
+			do {
+				top       = stack.get();
+				node.next = top;
+			} while (!stack.compareAndSet(top, node));
+		}
+	}
+}
+
+public class Atomics
+{
+	public static void main(String[] args) throws InterruptedException
+	{
+		AtomicInteger i = new AtomicInteger(5);
+		System.out.println(i.getAndIncrement() + " " + i.incrementAndGet() + " "
+		                   + i.addAndGet(10) + " " + i.getAndAdd(-3) + " "
+		                   + i.decrementAndGet() + " " + i.getAndDecrement());
+		System.out.println(i.compareAndSet(12, 100) + " " + i.compareAndSet(12, 1)
+		                   + " " + i.getAndSet(7) + " " + i.get());
+		i.set(42);
+		i.lazySet(i.get() + 1);
+		System.out.println(i);
+
+		AtomicLong l = new AtomicLong(1L << 40);
+		System.out.println(l.incrementAndGet() + " " + l.getAndAdd(-(1L << 41))
+		                   + " " + l.compareAndSet(-(1L << 40) + 1, 3) + " " + l);
+
+		String                  a = "a";
+		AtomicReference<String> r = new AtomicReference<String>(a);
+		System.out.println(r.compareAndSet("b", "c") + " " + r.compareAndSet(a, "b")
+		                   + " " + r.getAndSet(null) + " " + r.get());
+
+		AtomicIntegerArray array = new AtomicIntegerArray(new int[] { 1, 2, 3 });
+		array.addAndGet(1, 40);
+		System.out.println(array.compareAndSet(2, 3, -3) + " " + array);
+
+		/* the intrinsics check the receiver and the index */
+		int failed = 0;
+		for (int index = -1; index <= 3; index += 4) {
+			try {
+				array.incrementAndGet(index);
+			} catch (IndexOutOfBoundsException e) {
+				++failed;
+			}
+		}
+		AtomicLong missing = null;
+		try {
+			missing.addAndGet(1);
+		} catch (NullPointerException e) {
+			++failed;
+		}
+		System.out.println(failed + " " + array);
+
+		AtomicInteger         counter = new AtomicInteger();
+		AtomicLong            sum     = new AtomicLong();
+		AtomicIntegerArray    buckets = new AtomicIntegerArray(8);
+		AtomicReference<Node> stack   = new AtomicReference<Node>();
+		Counting[]            threads = new Counting[4];
+		for (int t = 0; t < threads.length; ++t) {
+			threads[t] = new Counting(counter, sum, buckets, stack);
+			threads[t].start();
+		}
+		for (int t = 0; t < threads.length; ++t)
+			threads[t].join();
+		System.out.println(counter + " " + sum + " " + buckets);
+
+		int  nodes = 0;
+		long total = 0;
+		for (Node node = stack.get(); node != null; node = node.next) {
+			++nodes;
+			total += node.value;
+		}
+		System.out.println(nodes + " " + total);
+	}
+}
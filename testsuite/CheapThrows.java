@@ -0,0 +1,112 @@
+class ParseFailure extends Exception
+{
+	ParseFailure(String message)
+	{
+		super(message);
+	}
+}
+
+public class CheapThrows
+{
+	static int parse(String text) throws ParseFailure
+	{
+		int value = 0;
+		for (int i = 0; i < text.length(); ++i) {
+			char c = text.charAt(i);
+			if (c < '0' || c > '9')
+				throw new ParseFailure(text);
+			value = value * 10 + (c - '0');
+		}
+		return value;
+	}
+
+	/* once parse is inlined, its throw jumps to the handler directly */
+	static int sumValid(int n)
+	{
+		int sum      = 0;
+		int failures = 0;
+		for (int i = 0; i < n; ++i) {
+			try {
+				sum += parse((i & 1) == 0 ? "17" : "1x");
+			} catch (ParseFailure e) {
+				failures++;
+			}
+		}
+		return sum + failures;
+	}
+
+	static int divide(int a, int b)
+	{
+		try {
+			return a / b;
+		} catch (ArithmeticException e) {
+			return -1;
+		}
+	}
+
+	static long remainder(long a, long b)
+	{
+		try {
+			return a % b;
+		} catch (ArithmeticException e) {
+			return -1;
+		}
+	}
+
+	static RuntimeException nullPointer()
+	{
+		try {
+			throw null;
+		} catch (NullPointerException e) {
+			return e;
+		}
+	}
+
+	static RuntimeException badIndex()
+	{
+		int[] array = new int[4];
+		try {
+			System.arraycopy(array, 2, array, 0, 3);
+		} catch (ArrayIndexOutOfBoundsException e) {
+			return e;
+		}
+		return null;
+	}
+
+	static Exception create(int depth)
+	{
+		if (depth == 0)
+			return new Exception("created");
+		return create(depth - 1);
+	}
+
+	public static void main(String[] args)
+	{
+		System.out.println(sumValid(1000));
+
+		try {
+			parse("12z");
+		} catch (ParseFailure e) {
+			System.out.println(e);
+		}
+
+		System.out.println(divide(7, 2));
+		System.out.println(divide(7, args.length));
+		System.out.println(remainder(7, 4));
+		System.out.println(remainder(7, args.length));
+
+		/* implicit exceptions are preallocated and have no stack trace */
+		RuntimeException npe = nullPointer();
+		System.out.println(npe == nullPointer());
+		System.out.println(npe.getStackTrace().length);
+		npe.printStackTrace(System.out);
+		RuntimeException index = badIndex();
+		System.out.println(index instanceof IndexOutOfBoundsException);
+		System.out.println(index == badIndex());
+
+		/* the stack trace is symbolized on demand */
+		StackTraceElement[] trace = create(3).getStackTrace();
+		System.out.println(trace[0].getClassName());
+		System.out.println(trace[trace.length - 1]);
+	}
+}
@@ -0,0 +1,124 @@
+/* a failed static initializer makes its class erroneous */
+class Broken
+{
+	static int value = compute();
+
+	static int compute()
+	{
+		if (value == 0)
+			throw new IllegalStateException("broken");
+		return value;
+	}
+}
+
+class BrokenByError
+{
+	static int value;
+
+	static {
+		if (value == 0)
+			throw new Error("error");
+	}
+}
+
+class BrokenSuper
+{
+	static int value;
+
+	static {
+		if (value == 0)
+			throw new IllegalArgumentException("super");
+	}
+}
+
+class Sub extends BrokenSuper
+{
+	static int other;
+
+	static void touch()
+	{
+		++other;
+	}
+}
+
+/* the initializer fails while another thread waits for it */
+class Slow
+{
+	static int value;
+
+	static {
+		try {
+			Thread.sleep(200);
+		} catch (InterruptedException e) {
+		}
+		if (value == 0)
+			throw new IllegalStateException("slow");
+	}
+}
+
+class Waiter extends Thread
+{
+	String result;
+
+	public void run()
+	{
+		try {
+			Thread.sleep(50);
+		} catch (InterruptedException e) {
+		}
+		try {
+			result = "value " + Slow.value;
+		} catch (NoClassDefFoundError e) {
+			result = "NoClassDefFoundError";
+		}
+	}
+}
+
+public class ClassInitFailure
+{
+	static String describe(Error e)
+	{
+		if (e instanceof ExceptionInInitializerError) {
+			return "ExceptionInInitializerError "
+			       + e.getCause().getMessage();
+		}
+		if (e instanceof NoClassDefFoundError)
+			return "NoClassDefFoundError";
+		return "Error " + e.getMessage();
+	}
+
+	public static void main(String[] args) throws InterruptedException
+	{
+		for (int i = 0; i < 2; ++i) {
+			try {
+				System.out.println(Broken.value);
+			} catch (Error e) {
+				System.out.println(describe(e));
+			}
+		}
+		for (int i = 0; i < 2; ++i) {
+			try {
+				BrokenByError.value = 1;
+			} catch (Error e) {
+				System.out.println(describe(e));
+			}
+		}
+		for (int i = 0; i < 2; ++i) {
+			try {
+				Sub.touch();
+			} catch (Error e) {
+				System.out.println(describe(e));
+			}
+		}
+
+		Waiter waiter = new Waiter();
+		waiter.start();
+		try {
+			System.out.println(Slow.value);
+		} catch (Error e) {
+			System.out.println(describe(e));
+		}
+		waiter.join();
+		System.out.println(waiter.result);
+	}
+}
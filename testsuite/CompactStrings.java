@@ -0,0 +1,37 @@
+public class CompactStrings {
+	static int sum(String s) {
+		int sum = 0;
+		for (int i = 0; i < s.length(); ++i)
+			sum += s.charAt(i);
+		return sum;
+	}
+
+	public static void main(String[] args) {
+		/* not a constant expression, the literal would be UTF-8 encoded */
+		char   acute  = (char)0xe9;
+		String latin1 = "caf" + acute;
+		String wide   = new String(new char[] { 'p', 'r', 'i', 'c', 'e', ' ',
+		                                        (char)0x20ac });
+		System.out.println(latin1.length());
+		System.out.println(sum(latin1));
+		System.out.println(sum(wide));
+
+		/* mixed concatenation widens */
+		String mixed = latin1.concat(wide);
+		System.out.println(mixed.length());
+		System.out.println((int)mixed.charAt(10));
+		System.out.println(sum(mixed) == sum(latin1) + sum(wide));
+
+		/* a Latin-1 substring of a wide string equals the compact one */
+		String price = wide.substring(0, 5);
+		System.out.println(price);
+		System.out.println(price.equals("price"));
+		System.out.println("price".equals(price));
+		System.out.println(price.hashCode() == "price".hashCode());
+
+		char[] chars = new char[7];
+		mixed.getChars(4, 11, chars, 0);
+		System.out.println(new String(chars, 0, 5));
+		System.out.println((int)chars[6]);
+	}
+}
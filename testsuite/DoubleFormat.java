@@ -0,0 +1,51 @@
+public class DoubleFormat {
+	private static void print(double d) {
+		System.out.println(Double.toString(d));
+	}
+
+	private static void print(float f) {
+		System.out.println(Float.toString(f));
+	}
+
+	public static void main(String[] args) {
+		print(4.9E-324);
+		print(1.0E23);
+		print(2.0E23);
+		print(0.001);
+		print(1.0E7);
+		print(9999999.999999998);
+		print(1.0E-5);
+		print(100.0);
+		print(1.7976931348623157E308);
+		print(0.1);
+		print(1.0 / 3);
+		print(1.2345678901234568E17);
+		print(-0.0);
+		print(0.0 / 0.0);
+		print(1.0 / 0.0);
+		print(-1.0 / 0.0);
+		print(-123.456);
+
+		print(1.4E-45f);
+		print(3.4028235E38f);
+		print(1.17549435E-38f);
+		print(1.0E10f);
+		print(16777216.0f);
+		print(0.1f);
+		print(1.0f / 3);
+
+		print(Double.parseDouble("  1.5e3 "));
+		print(Double.parseDouble("-0x1.8p1"));
+		print(Double.parseDouble("1e-400"));
+		print(Double.parseDouble("1e400"));
+		print(Double.parseDouble("+.5"));
+		print(Double.parseDouble("123456789012345678901234567890"));
+		print(Double.parseDouble("7d"));
+		print(Double.parseDouble("NaN"));
+		print(Double.valueOf("-2.25").doubleValue());
+		print(Float.parseFloat("2.5f"));
+		print(Float.parseFloat("0.1"));
+		print(Float.parseFloat("3.4028236E38"));
+		print(Float.parseFloat("1.17549435E-38"));
+	}
+}
@@ -0,0 +1,60 @@
+public class EscapeAnalysis {
+	static EscapeAnalysis kept;
+
+	int x;
+	int y;
+
+	EscapeAnalysis(int x, int y) {
+		this.x = x;
+		this.y = y;
+	}
+
+	EscapeAnalysis add(EscapeAnalysis other) {
+		x += other.x;
+		y += other.y;
+		return this;
+	}
+
+	int dot(EscapeAnalysis other) {
+		return x * other.x + y * other.y;
+	}
+
+	static int sumPoints(int n) {
+		int sum = 0;
+		for (int i = 0; i < n; ++i) {
+			/* neither point leaves the loop body */
+			EscapeAnalysis p = new EscapeAnalysis(i, i + 1);
+			EscapeAnalysis q = new EscapeAnalysis(2, 3);
+			sum += p.add(q).dot(q);
+		}
+		return sum;
+	}
+
+	static int sumArray(int n) {
+		int sum = 0;
+		for (int i = 0; i < n; ++i) {
+			int[] small = new int[4];
+			small[i % 4] = i;
+			for (int j = 0; j < small.length; ++j)
+				sum += small[j];
+		}
+		return sum;
+	}
+
+	public static void main(String[] args) {
+		System.out.println(sumPoints(1000));
+		System.out.println(sumArray(1000));
+
+		/* escapes through the static field */
+		EscapeAnalysis last = null;
+		for (int i = 0; i < 10; ++i) {
+			EscapeAnalysis p = new EscapeAnalysis(i, -i);
+			if (last != null && last.x == p.x)
+				System.out.println("shared");
+			kept = p;
+			last = p;
+		}
+		System.out.println(kept.x + kept.y);
+		System.out.println(last.x);
+	}
+}
@@ -0,0 +1,178 @@
+class ParseError extends Exception
+{
+	final int position;
+
+	ParseError(String message, int position)
+	{
+		super(message);
+		this.position = position;
+	}
+}
+
+class EmptyInput extends ParseError
+{
+	EmptyInput()
+	{
+		super("empty", 0);
+	}
+}
+
+class Account
+{
+	private int balance;
+
+	synchronized void withdraw(int amount)
+	{
+		if (amount > balance)
+			throw new IllegalArgumentException("overdrawn by " + (amount - balance));
+		balance -= amount;
+	}
+
+	synchronized void deposit(int amount)
+	{
+		balance += amount;
+	}
+
+	synchronized int getBalance()
+	{
+		return balance;
+	}
+}
+
+class Depositor extends Thread
+{
+	private final Account account;
+
+	Depositor(Account account)
+	{
+		this.account = account;
+	}
+
+	public void run()
+	{
+		account.deposit(5);
+	}
+}
+
+public class ExceptionHandling
+{
+	static int parseDigits(String text) throws ParseError
+	{
+		if (text.length() == 0)
+			throw new EmptyInput();
+		int value = 0;
+		for (int i = 0; i < text.length(); ++i) {
+			char c = text.charAt(i);
+			if (c < '0' || c > '9')
+				throw new ParseError("not a digit: " + c, i);
+			value = value * 10 + (c - '0');
+		}
+		return value;
+	}
+
+	static int parseNested(String text, int depth) throws ParseError
+	{
+		if (depth == 0)
+			return parseDigits(text);
+		return parseNested(text, depth - 1) + 1;
+	}
+
+	static String classify(String text)
+	{
+		try {
+			return "value " + parseNested(text, 3);
+		} catch (EmptyInput e) {
+			return "empty input";
+		} catch (ParseError e) {
+			return e.getMessage() + " at " + e.position;
+		}
+	}
+
+	static int finallyCount;
+
+	static int withFinally(String text)
+	{
+		try {
+			return parseDigits(text);
+		} catch (ParseError e) {
+			return -1;
+		} finally {
+			finallyCount++;
+		}
+	}
+
+	static String nested(String text)
+	{
+		String result = "";
+		try {
+			try {
+				parseDigits(text);
+				result += "parsed";
+			} catch (EmptyInput e) {
+				result += "inner";
+			}
+		} catch (ParseError e) {
+			result += "outer";
+		}
+		return result;
+	}
+
+	static void rethrow(String text) throws ParseError
+	{
+		try {
+			parseDigits(text);
+		} catch (ParseError e) {
+			System.out.println("rethrowing " + e.getMessage());
+			throw e;
+		}
+	}
+
+	static int countErrors(int n)
+	{
+		int errors = 0;
+		int sum    = 0;
+		for (int i = 0; i < n; ++i) {
+			try {
+				sum += parseDigits((i % 3 == 0) ? "x" : "12");
+			} catch (ParseError e) {
+				errors++;
+			}
+		}
+		return errors * 1000 + sum % 1000;
+	}
+
+	public static void main(String[] args) throws InterruptedException
+	{
+		System.out.println(classify("123"));
+		System.out.println(classify(""));
+		System.out.println(classify("12a4"));
+
+		System.out.println(withFinally("42"));
+		System.out.println(withFinally("4x"));
+		System.out.println("finally ran " + finallyCount + " times");
+
+		System.out.println(nested("7"));
+		System.out.println(nested(""));
+		System.out.println(nested("?"));
+
+		try {
+			rethrow("z");
+		} catch (ParseError e) {
+			System.out.println("caught again at " + e.position);
+		}
+
+		/* the monitor of the synchronized method is released by the throw */
+		Account account = new Account();
+		try {
+			account.withdraw(3);
+		} catch (IllegalArgumentException e) {
+			System.out.println(e.getMessage());
+		}
+		Depositor depositor = new Depositor(account);
+		depositor.start();
+		depositor.join();
+		System.out.println("balance " + account.getBalance());
+
+		System.out.println(countErrors(30000));
+	}
+}
@@ -0,0 +1,101 @@
+import java.io.BufferedReader;
+import java.io.FileInputStream;
+import java.io.FileOutputStream;
+import java.io.IOException;
+import java.io.InputStreamReader;
+import java.io.RandomAccessFile;
+
+public class FileStreams {
+	private static final String NAME = "/tmp/bc2firm-FileStreams.txt";
+
+	private static void writeAscii(FileOutputStream out, String s)
+		throws IOException {
+		for (int i = 0; i < s.length(); ++i)
+			out.write(s.charAt(i));
+	}
+
+	private static void printChars(String s) {
+		for (int i = 0; i < s.length(); ++i) {
+			System.out.print((int) s.charAt(i));
+			System.out.print(' ');
+		}
+		System.out.println();
+	}
+
+	public static void main(String[] args) throws IOException {
+		/* line ends and UTF-8, with a malformed byte */
+		FileOutputStream out = new FileOutputStream(NAME);
+		writeAscii(out, "first\r\nsecond\rthird\n\n");
+		byte[] utf8 = { (byte) 0xC3, (byte) 0xA9, (byte) 0xE2, (byte) 0x82,
+		                (byte) 0xAC, (byte) 0xF0, (byte) 0x9F, (byte) 0x98,
+		                (byte) 0x80, (byte) 0xFF, 'x' };
+		out.write(utf8);
+		out.close();
+
+		BufferedReader reader
+			= new BufferedReader(new InputStreamReader(new FileInputStream(NAME)), 3);
+		String line;
+		while ((line = reader.readLine()) != null) {
+			System.out.print(line.length());
+			System.out.print(": ");
+			printChars(line);
+		}
+		reader.close();
+
+		/* big enough to be mapped */
+		out = new FileOutputStream(NAME);
+		for (int i = 0; i < 100000; ++i)
+			writeAscii(out, "line " + i + "\n");
+		out.close();
+
+		reader = new BufferedReader(new InputStreamReader(new FileInputStream(NAME)));
+		int  count = 0;
+		long sum   = 0;
+		String last = null;
+		while ((line = reader.readLine()) != null) {
+			++count;
+			sum += line.length();
+			last = line;
+		}
+		reader.close();
+		System.out.println(count);
+		System.out.println(sum);
+		System.out.println(last);
+
+		FileInputStream in = new FileInputStream(NAME);
+		System.out.println(in.skip(1000000));
+		byte[] block = new byte[100000];
+		int total = 0;
+		int n;
+		while ((n = in.read(block)) > 0)
+			total += n;
+		System.out.println(total);
+		System.out.println(in.read());
+		in.close();
+
+		/* append, then patch and read back in place */
+		out = new FileOutputStream(NAME, true);
+		writeAscii(out, "end\r\nafter");
+		out.close();
+
+		RandomAccessFile file = new RandomAccessFile(NAME, "rw");
+		long length = file.length();
+		System.out.println(length);
+		file.seek(length - 10);
+		System.out.println(file.readLine());
+		System.out.println(file.readLine());
+		System.out.println(file.readLine());
+		System.out.println(file.getFilePointer());
+		file.seek(0);
+		file.write('L');
+		file.seek(0);
+		byte[] head = new byte[6];
+		file.readFully(head);
+		for (int i = 0; i < head.length; ++i)
+			System.out.print((char) head[i]);
+		System.out.println();
+		System.out.println(file.skipBytes(20));
+		System.out.println(file.readLine());
+		file.close();
+	}
+}
@@ -0,0 +1,47 @@
+public class GarbageCollection {
+	static GarbageCollection survivors;
+
+	GarbageCollection next;
+	int[]             data;
+	String            name;
+
+	GarbageCollection(int n, GarbageCollection next) {
+		this.next = next;
+		this.data = new int[n % 100];
+		for (int i = 0; i < data.length; ++i) {
+			data[i] = n + i;
+		}
+		this.name = "node " + n;
+	}
+
+	static long check(GarbageCollection list) {
+		long sum = 0;
+		for (GarbageCollection o = list; o != null; o = o.next) {
+			for (int i = 0; i < o.data.length; ++i) {
+				sum += o.data[i];
+			}
+			sum += o.name.length();
+		}
+		return sum;
+	}
+
+	public static void main(String[] args) {
+		/* allocates more than a gigabyte while only a small part stays
+		 * reachable from a static field and a local variable */
+		GarbageCollection local = null;
+		for (int round = 0; round < 400; ++round) {
+			GarbageCollection garbage = null;
+			for (int i = 0; i < 10000; ++i) {
+				garbage = new GarbageCollection(i, garbage);
+			}
+			Object[] big = new Object[50000];
+			big[0] = garbage;
+			if (round % 20 == 0) {
+				survivors = new GarbageCollection(round, survivors);
+				local     = new GarbageCollection(round + 1, local);
+			}
+		}
+		System.out.println(check(survivors));
+		System.out.println(check(local));
+	}
+}
@@ -0,0 +1,38 @@
+public class GenerationalGC {
+	GenerationalGC next;
+	int            value;
+
+	GenerationalGC(int value, GenerationalGC next) {
+		this.value = value;
+		this.next  = next;
+	}
+
+	public static void main(String[] args) {
+		/* the table is too big for the nursery, the nodes stored into it are
+		 * only reachable through references from the old generation */
+		GenerationalGC[] table  = new GenerationalGC[4096];
+		Object           hashed = new Object();
+		int              hash   = hashed.hashCode();
+		for (int round = 0; round < 100; ++round) {
+			for (int i = 0; i < table.length; ++i) {
+				table[i] = new GenerationalGC(round + i, table[i]);
+			}
+			for (int i = 0; i < 20000; ++i) {
+				int[] garbage = new int[i % 64 + 1];
+				garbage[0] = i;
+			}
+		}
+
+		int  count = 0;
+		long sum   = 0;
+		for (int i = 0; i < table.length; ++i) {
+			for (GenerationalGC node = table[i]; node != null; node = node.next) {
+				++count;
+				sum += node.value;
+			}
+		}
+		System.out.println(count);
+		System.out.println(sum);
+		System.out.println(hashed.hashCode() == hash);
+	}
+}
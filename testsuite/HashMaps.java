@@ -0,0 +1,104 @@
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.IdentityHashMap;
+import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.Map;
+
+public class HashMaps
+{
+	static class Cache extends LinkedHashMap<String, Integer>
+	{
+		Cache()
+		{
+			super(4, 0.75f, true);
+		}
+
+		protected boolean removeEldestEntry(Map.Entry<String, Integer> eldest)
+		{
+			return size() > 3;
+		}
+	}
+
+	public static void main(String[] args)
+	{
+		HashMap<Integer, Integer> squares = new HashMap<Integer, Integer>();
+		for (int i = 0; i < 10000; ++i) {
+			squares.put(i, i * i);
+		}
+		/* removing every other key leaves holes the table has to skip */
+		for (int i = 0; i < 10000; i += 2) {
+			squares.remove(i);
+		}
+		long sum = 0;
+		for (int i = 0; i < 10000; ++i) {
+			Integer square = squares.get(i);
+			if (square != null)
+				sum += square;
+		}
+		System.out.println(squares.size() + " " + sum);
+		System.out.println(squares.containsKey(4) + " " + squares.containsKey(5)
+		                   + " " + squares.containsValue(81));
+		for (int i = 0; i < 10000; i += 2) {
+			squares.put(i, -i);
+		}
+		System.out.println(squares.size() + " " + squares.get(9998));
+
+		HashMap<String, String> strings = new HashMap<String, String>();
+		System.out.println(strings.put("a", "1") + " " + strings.put("a", "2"));
+		strings.put(null, "null key");
+		strings.put("b", null);
+		System.out.println(strings.get(null) + " " + strings.get("b") + " "
+		                   + strings.containsKey("b") + " " + strings.size());
+		System.out.println(strings.remove(null) + " " + strings.containsKey(null));
+
+		int keys = 0;
+		for (Iterator<String> i = strings.keySet().iterator(); i.hasNext(); ) {
+			String key = i.next();
+			if (key.equals("a"))
+				i.remove();
+			++keys;
+		}
+		System.out.println(keys + " " + strings.size() + " " + strings.get("a"));
+
+		HashMap<String, String> copy = new HashMap<String, String>(strings);
+		System.out.println(copy.equals(strings) + " "
+		                   + (copy.hashCode() == strings.hashCode()));
+
+		LinkedHashMap<String, Integer> ordered = new LinkedHashMap<String, Integer>();
+		ordered.put("one", 1);
+		ordered.put("two", 2);
+		ordered.put("three", 3);
+		ordered.remove("one");
+		ordered.put("four", 4);
+		ordered.put("one", 1);
+		System.out.println(ordered);
+		int total = 0;
+		for (Map.Entry<String, Integer> entry : ordered.entrySet()) {
+			total += entry.getValue();
+			entry.setValue(0);
+		}
+		System.out.println(total + " " + ordered.values());
+
+		Cache cache = new Cache();
+		cache.put("a", 1);
+		cache.put("b", 2);
+		cache.put("c", 3);
+		cache.get("a");
+		cache.put("d", 4);
+		System.out.println(cache.keySet());
+
+		IdentityHashMap<String, Integer> identity = new IdentityHashMap<String, Integer>();
+		String first  = new String("key");
+		String second = new String("key");
+		identity.put(first, 1);
+		identity.put(second, 2);
+		System.out.println(identity.size() + " " + identity.get(first) + " "
+		                   + identity.get(second) + " " + identity.get("other"));
+
+		HashSet<String> set = new HashSet<String>();
+		System.out.println(set.add("x") + " " + set.add("x") + " " + set.add("y"));
+		System.out.println(set.size() + " " + set.contains("y") + " "
+		                   + set.remove("y") + " " + set.contains("y"));
+	}
+}
@@ -0,0 +1,39 @@
+public class InlineStrings {
+	public static void main(String[] args) {
+		/* substrings keep the strings holding their chars alive while those
+		 * are moved by the collector */
+		String[] parts = new String[1000];
+		for (int i = 0; i < parts.length; ++i) {
+			String item = "item".concat(Integer.toString(i, 10)).concat("\u20ac");
+			parts[i] = item.substring(4);
+		}
+
+		String joined = "";
+		for (int round = 0; round < 50; ++round) {
+			StringBuilder builder = new StringBuilder();
+			for (int i = 0; i < 200; ++i)
+				builder.append((char)('a' + (round + i) % 26));
+			joined = builder.toString();
+			for (int i = 0; i < 5000; ++i) {
+				String garbage = "g".concat(joined.substring(i % 100));
+				if (garbage.length() != 201 - i % 100)
+					System.out.println(i);
+			}
+		}
+
+		int sum = 0;
+		for (int i = 0; i < parts.length; ++i) {
+			String part   = parts[i];
+			int    length = part.length();
+			sum += length;
+			if (part.charAt(length - 1) != '\u20ac'
+			    || !part.substring(0, length - 1).equals(Integer.toString(i, 10)))
+				System.out.println(i);
+		}
+		System.out.println(sum);
+		System.out.println(joined.length());
+		System.out.println(joined.substring(0, 4));
+		System.out.println(new String(joined).equals(joined));
+		System.out.println(String.valueOf(new char[] { 'o', 'k' }));
+	}
+}
@@ -0,0 +1,47 @@
+public class IntegerFormat {
+	public static void main(String[] args) {
+		int[] ints = { 0, 7, -7, 10, 99, 100, -100, 12345678, 123456789,
+		               Integer.MAX_VALUE, Integer.MIN_VALUE };
+		for (int i = 0; i < ints.length; ++i) {
+			String s = Integer.toString(ints[i]);
+			System.out.println(s);
+			if (Integer.parseInt(s) != ints[i])
+				System.out.println("parseInt failed: " + s);
+		}
+
+		long[] longs = { 0L, -1L, 99999999L, 100000000L, 4294967295L,
+		                 4294967296L, 1700000000123L, -12345678901234567L,
+		                 Long.MAX_VALUE, Long.MIN_VALUE };
+		for (int i = 0; i < longs.length; ++i) {
+			String s = Long.toString(longs[i]);
+			System.out.println(s);
+			if (Long.parseLong(s) != longs[i])
+				System.out.println("parseLong failed: " + s);
+		}
+
+		System.out.println(Integer.toString(255, 16));
+		System.out.println(Integer.toString(-255, 10));
+		System.out.println(Long.toString(-255L, 2));
+		System.out.println(String.valueOf(-42));
+		System.out.println(String.valueOf(42L));
+
+		System.out.println(Integer.parseInt("+42"));
+		System.out.println(Integer.parseInt("-0"));
+		System.out.println(Integer.parseInt("007"));
+		System.out.println(Integer.parseInt("ff", 16));
+		System.out.println(Integer.parseInt("-Zz", 36));
+		System.out.println(Integer.valueOf("123").intValue());
+		System.out.println(Long.parseLong("-0000000000000000000009223372036854775808"));
+		System.out.println(Long.parseLong("123456789012345678"));
+		System.out.println(Long.parseLong("7fffffffffffffff", 16));
+		System.out.println(Long.valueOf("-5").longValue());
+
+		StringBuilder builder = new StringBuilder(0);
+		builder.append(-123).append(Long.MIN_VALUE).append(7).append(' ');
+		for (int i = 0; i < 12; ++i)
+			builder.append(i * 1000003L);
+		System.out.println(builder.toString());
+		int n = 31;
+		System.out.println("n=" + n + ", n*n=" + (n * n) + ", big=" + (n * 100000000000L));
+	}
+}
@@ -0,0 +1,48 @@
+public class MathIntrinsics
+{
+	static double[] values = { 0.0, -0.0, 1.5, -2.5, Double.NaN,
+	                           Double.POSITIVE_INFINITY, Double.NEGATIVE_INFINITY };
+
+	public static void main(String[] args)
+	{
+		System.out.println(Math.abs(-7) + " " + Math.abs(Integer.MIN_VALUE) + " "
+		                   + Math.abs(-7L) + " " + Math.abs(Long.MIN_VALUE));
+		System.out.println(Math.min(3, -4) + " " + Math.max(3, -4) + " "
+		                   + Math.min(3L, -4L) + " " + Math.max(3L, -4L));
+		System.out.println(Math.abs(-0.0) + " " + Math.abs(-0.0f) + " "
+		                   + Math.abs(Double.NaN) + " " + Math.abs(-1.25f));
+
+		/* NaN wins, -0.0 is less than 0.0 */
+		for (int i = 0; i < values.length; ++i) {
+			StringBuilder line = new StringBuilder();
+			for (int j = 0; j < values.length; ++j) {
+				line.append(Math.min(values[i], values[j]));
+				line.append('/');
+				line.append(Math.max(values[i], values[j]));
+				line.append(' ');
+			}
+			System.out.println(line.toString());
+		}
+		System.out.println(Math.min(0.0f, -0.0f) + " " + Math.max(-0.0f, 0.0f)
+		                   + " " + Math.min(Float.NaN, 1.0f));
+
+		System.out.println(Math.sqrt(2.25) + " " + Math.sqrt(-1.0) + " "
+		                   + Math.sqrt(-0.0));
+		System.out.println(Math.floor(-1.5) + " " + Math.ceil(-0.5) + " "
+		                   + Math.rint(2.5) + " " + Math.rint(3.5));
+		System.out.println(Math.round(2.5) + " " + Math.round(-2.5) + " "
+		                   + Math.round(Double.NaN) + " " + Math.round(1.4f));
+		/* a + 0.5 rounds up for these, the result must not */
+		System.out.println(Math.round(0.49999997f) + " "
+		                   + Math.round(0.49999999999999994) + " "
+		                   + Math.round(4503599627370497.0) + " "
+		                   + Math.round(8388609.0f) + " " + Math.round(-0.5)
+		                   + " " + Math.round(1e20f) + " " + Math.round(-1e300));
+
+		double sum = 0;
+		for (int i = 1; i <= 1000; ++i) {
+			sum += Math.sqrt(i) - Math.floor(Math.sqrt(i));
+		}
+		System.out.println(Math.floor(sum));
+	}
+}
@@ -0,0 +1,54 @@
+interface LookupShape
+{
+	int sides();
+	String name();
+	int scaled(int factor);
+	long scaled(long factor);
+}
+
+class LookupPolygon implements LookupShape
+{
+	static { System.out.println("LookupPolygon::<clinit>"); }
+
+	public int sides() { return 0; }
+	public String name() { return "polygon"; }
+	public int scaled(int factor) { return sides() * factor; }
+	public long scaled(long factor) { return -sides() * factor; }
+	void m0() {} void m1() {} void m2() {} void m3() {} void m4() {}
+	void m5() {} void m6() {} void m7() {} void m8() {} void m9() {}
+}
+
+class LookupTriangle extends LookupPolygon
+{
+	static int created;
+
+	public int sides() { return 3; }
+}
+
+class LookupSquare extends LookupTriangle
+{
+	public int sides() { return 4; }
+	public String name() { return "square"; }
+}
+
+public class MethodLookup
+{
+	public static void main(String[] args)
+	{
+		/* runs the static initializer of LookupPolygon only once */
+		LookupTriangle.created++;
+		LookupShape[] shapes = { new LookupPolygon(), new LookupTriangle(),
+		                         new LookupSquare() };
+		long sum = 0;
+		for (int i = 0; i < 1000; ++i) {
+			for (LookupShape shape : shapes) {
+				sum += shape.scaled(i) + shape.scaled((long) i) * 2;
+			}
+		}
+		System.out.println(sum);
+		for (LookupShape shape : shapes) {
+			System.out.println(shape.name() + " " + shape.sides() + " "
+			                   + shape.scaled(10) + " " + shape.scaled(10L));
+		}
+	}
+}
@@ -0,0 +1,88 @@
+public class MultiArrays
+{
+	static double[][] fill(int n, int factor, int modulus)
+	{
+		double[][] matrix = new double[n][n];
+		for (int i = 0; i < n; ++i) {
+			for (int j = 0; j < n; ++j) {
+				matrix[i][j] = (i * factor + j) % modulus;
+			}
+		}
+		return matrix;
+	}
+
+	static double[][] multiply(double[][] a, double[][] b)
+	{
+		int        n = a.length;
+		double[][] c = new double[n][n];
+		for (int i = 0; i < n; ++i) {
+			for (int j = 0; j < n; ++j) {
+				double sum = 0;
+				for (int k = 0; k < n; ++k) {
+					sum += a[i][k] * b[k][j];
+				}
+				c[i][j] = sum;
+			}
+		}
+		return c;
+	}
+
+	/* only single rows of the matrices stay reachable */
+	static long keepRows(int n, int rounds)
+	{
+		int[][] kept = new int[rounds / 10][];
+		for (int round = 0; round < rounds; ++round) {
+			int[][] matrix = new int[n][n];
+			matrix[round % n][round % n] = round;
+			if (round % 10 == 0)
+				kept[round / 10] = matrix[round % n];
+		}
+		long sum = 0;
+		for (int i = 0; i < kept.length; ++i) {
+			for (int j = 0; j < kept[i].length; ++j) {
+				sum += kept[i][j];
+			}
+		}
+		return sum;
+	}
+
+	public static void main(String[] args)
+	{
+		double[][] a = fill(50, 50, 7);
+		double[][] b = new double[50][50];
+		for (int i = 0; i < 50; ++i) {
+			for (int j = 0; j < 50; ++j) {
+				b[i][j] = (i + 2 * j) % 5;
+			}
+		}
+		double[][] c     = multiply(a, b);
+		long       trace = 0;
+		for (int i = 0; i < 50; ++i) {
+			trace += (long)c[i][i];
+		}
+		System.out.println(trace);
+		System.out.println((long)c[3][7]);
+
+		/* rows lie next to each other but do not overlap */
+		int[][] square = new int[4][4];
+		square[1][3] = 7;
+		System.out.println(square[1][3]);
+		System.out.println(square[2][0]);
+		square[1] = square[2];
+		square[1][0] = 9;
+		System.out.println(square[2][0]);
+
+		int[][] jagged = new int[3][];
+		System.out.println(jagged[1] == null);
+		jagged[1] = new int[4];
+		System.out.println(jagged[1].length);
+
+		int[][][] empty = new int[2][0][5];
+		System.out.println(empty[1].length);
+		long[][] none = new long[0][9];
+		System.out.println(none.length);
+
+		System.out.println(keepRows(4, 200000));
+		System.out.println(keepRows(64, 2000));
+	}
+}
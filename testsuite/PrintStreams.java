@@ -0,0 +1,17 @@
+public class PrintStreams {
+	public static void main(String[] args) {
+		System.out.print(-2147483648);
+		System.out.print(' ');
+		System.out.print(9223372036854775807L);
+		System.out.print(' ');
+		System.out.println(-9223372036854775808L);
+		System.out.println(0);
+		String nothing = null;
+		System.out.println(nothing);
+		System.out.println("caf\u00e9 \u20ac \ud83d\ude00");
+		System.out.print('\u00e9');
+		System.out.print('\u20ac');
+		System.out.println();
+		System.out.flush();
+	}
+}
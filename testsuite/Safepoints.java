@@ -0,0 +1,101 @@
+class Spinner extends Thread
+{
+	private static boolean done;
+
+	final int[] counts = new int[64];
+	long        spins;
+
+	static synchronized boolean isDone()
+	{
+		return done;
+	}
+
+	static synchronized void finish()
+	{
+		done = true;
+	}
+
+	public void run()
+	{
+		/* never allocates, only the poll on the back edge lets the
+		 * collector stop this thread */
+		while (!isDone()) {
+			counts[(int)(spins & 63)]++;
+			++spins;
+		}
+	}
+}
+
+class Cruncher extends Thread
+{
+	private static boolean finished;
+
+	long result;
+
+	static synchronized boolean isFinished()
+	{
+		return finished;
+	}
+
+	static synchronized void finish()
+	{
+		finished = true;
+	}
+
+	public void run()
+	{
+		/* touches no memory at all, yet collections must not wait for the
+		 * whole loop */
+		long x = 0;
+		for (long i = 0; i < 1000000000L; ++i)
+			x = x * 6364136223846793005L + 1;
+		finish();
+		result = x;
+	}
+}
+
+public class Safepoints
+{
+	/* only reachable through static fields while the collector runs */
+	static int[][] table;
+	static int[]   last;
+
+	public static void main(String[] args) throws InterruptedException
+	{
+		table = new int[100][];
+		for (int i = 0; i < table.length; ++i) {
+			table[i]    = new int[i + 1];
+			table[i][i] = i;
+		}
+
+		Spinner spinner = new Spinner();
+		spinner.start();
+		Cruncher cruncher = new Cruncher();
+		cruncher.start();
+
+		/* hundreds of megabytes, every collection has to wait for the
+		 * spinner to reach a safepoint */
+		long sum = 0;
+		for (int round = 0; round < 20000; ++round) {
+			last = new int[4096];
+			last[round % 4096] = round;
+			sum += last[round % 4096];
+		}
+		/* the allocations take a fraction of the cruncher's loop */
+		boolean waited = Cruncher.isFinished();
+		Spinner.finish();
+		spinner.join();
+		cruncher.join();
+
+		long check = 0;
+		for (int i = 0; i < table.length; ++i)
+			check += table[i][i];
+		long counted = 0;
+		for (int i = 0; i < spinner.counts.length; ++i)
+			counted += spinner.counts[i];
+		System.out.println(sum);
+		System.out.println(check);
+		System.out.println(counted == spinner.spins);
+		System.out.println(waited + " " + cruncher.result);
+	}
+}
@@ -0,0 +1,113 @@
+import java.util.Arrays;
+
+public class Sorting
+{
+	static int seed = 12345;
+
+	static int next()
+	{
+		seed = seed * 1103515245 + 12345;
+		return seed;
+	}
+
+	static boolean isSorted(int[] a)
+	{
+		for (int i = 1; i < a.length; ++i) {
+			if (a[i - 1] > a[i])
+				return false;
+		}
+		return true;
+	}
+
+	static boolean isSorted(long[] a)
+	{
+		for (int i = 1; i < a.length; ++i) {
+			if (a[i - 1] > a[i])
+				return false;
+		}
+		return true;
+	}
+
+	static boolean isSorted(char[] a)
+	{
+		for (int i = 1; i < a.length; ++i) {
+			if (a[i - 1] > a[i])
+				return false;
+		}
+		return true;
+	}
+
+	public static void main(String[] args)
+	{
+		int[] small = { 5, -3, 9, 1, 9, 0 };
+		Arrays.sort(small);
+		System.out.println(Arrays.toString(small));
+
+		int[] range = { 9, 8, 7, 6, 5, 4, 3 };
+		Arrays.sort(range, 2, 5);
+		System.out.println(Arrays.toString(range));
+
+		byte[] bytes = new byte[300];
+		for (int i = 0; i < bytes.length; ++i) {
+			bytes[i] = (byte)(i * 7);
+		}
+		Arrays.sort(bytes);
+		System.out.println(bytes[0] + " " + bytes[1] + " " + bytes[299]);
+
+		short[] shorts = { 300, -2, 7, -32768, 32767 };
+		Arrays.sort(shorts);
+		System.out.println(Arrays.toString(shorts));
+
+		double[] doubles = { 1.5, Double.NaN, -0.0, 0.0, Double.NEGATIVE_INFINITY,
+		                     -2.5, Double.POSITIVE_INFINITY, 0.0, -0.0 };
+		Arrays.sort(doubles);
+		System.out.println(Arrays.toString(doubles));
+
+		float[] floats = { Float.NaN, 0.0f, -1.0f, -0.0f, 3.0f };
+		Arrays.sort(floats);
+		System.out.println(Arrays.toString(floats));
+
+		/* large enough for the partitioning and the counting sort */
+		int[]  ints  = new int[100000];
+		long[] longs = new long[100000];
+		char[] chars = new char[100000];
+		long   sum   = 0;
+		for (int i = 0; i < ints.length; ++i) {
+			ints[i]  = next();
+			longs[i] = (long)next() << 20 ^ next();
+			chars[i] = (char)(next() >>> 16);
+			sum     += ints[i];
+		}
+		Arrays.sort(ints);
+		Arrays.sort(longs);
+		Arrays.sort(chars);
+		long sortedSum = 0;
+		for (int i = 0; i < ints.length; ++i) {
+			sortedSum += ints[i];
+		}
+		System.out.println(isSorted(ints) + " " + (sum == sortedSum));
+		System.out.println(isSorted(longs));
+		System.out.println(isSorted(chars));
+
+		/* many equal values and presorted input */
+		int[] equal = new int[50000];
+		for (int i = 0; i < equal.length; ++i) {
+			equal[i] = (i * 31) % 3;
+		}
+		Arrays.sort(equal);
+		System.out.println(isSorted(equal) + " " + equal[16666] + " " + equal[16667]);
+		Arrays.sort(equal);
+		System.out.println(isSorted(equal));
+
+		try {
+			Arrays.sort(small, 3, 2);
+		} catch (IllegalArgumentException e) {
+			System.out.println("illegal range");
+		}
+		try {
+			Arrays.sort(small, 0, 7);
+		} catch (ArrayIndexOutOfBoundsException e) {
+			System.out.println("out of bounds");
+		}
+	}
+}
@@ -0,0 +1,37 @@
+public class StringConcat {
+	int id;
+
+	StringConcat(int id) {
+		this.id = id;
+	}
+
+	public String toString() {
+		return "#" + id;
+	}
+
+	static String describe(String name, int count, char unit) {
+		return name + ": " + count + unit;
+	}
+
+	public static void main(String[] args) {
+		String s = null;
+		Object o = null;
+		System.out.println(describe("apples", 42, 'x'));
+		System.out.println("long " + 12345678901L + " bool " + true + " "
+		                   + false);
+		System.out.println("double " + 2.5 + " float " + 0.25f);
+		System.out.println("null " + s + " " + o);
+		System.out.println("objects " + new StringConcat(1) + new StringConcat(2));
+
+		/* the chain continues after the conditional */
+		for (int i = 0; i < 3; ++i) {
+			System.out.println("i=" + (i % 2 == 0 ? "even" : "odd") + '/' + i);
+		}
+
+		String acc = "";
+		for (int i = 0; i < 100; ++i) {
+			acc = acc + (char)('a' + i % 26);
+		}
+		System.out.println(acc.length() + " " + acc.substring(0, 30));
+	}
+}
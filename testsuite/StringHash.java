@@ -0,0 +1,40 @@
+public class StringHash {
+	static String repeat(String s, int n) {
+		String result = "";
+		for (int i = 0; i < n; ++i)
+			result = result.concat(s);
+		return result;
+	}
+
+	static int classify(String s) {
+		switch (s) {
+		case "Aa":         return 1;
+		case "BB":         return 2;
+		case "hello":      return 3;
+		case "caf\u00e9":  return 4;
+		default:           return 0;
+		}
+	}
+
+	public static void main(String[] args) {
+		/* literals carry the hash computed by the compiler */
+		System.out.println("hello".hashCode());
+		System.out.println("".hashCode());
+		System.out.println("caf\u00e9".hashCode());
+		System.out.println("\ud83d\ude00".hashCode());
+
+		/* computed strings must agree with them */
+		String hello = "hel".concat("lo");
+		System.out.println(hello.hashCode());
+		System.out.println(hello.hashCode());
+		System.out.println(repeat("abcdefghijklmnopqrstuvwxyz", 4).hashCode());
+		System.out.println(repeat("x\u20acy", 20).hashCode());
+
+		System.out.println(classify("A".concat("a")));
+		System.out.println(classify("B".concat("B")));
+		System.out.println(classify(hello));
+		System.out.println(classify(new String(new char[] { 'c', 'a', 'f',
+		                                                    (char)0xe9 })));
+		System.out.println(classify("x"));
+	}
+}
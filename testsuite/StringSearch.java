@@ -0,0 +1,50 @@
+public class StringSearch {
+	static String repeat(String s, int n) {
+		String result = "";
+		for (int i = 0; i < n; ++i)
+			result = result.concat(s);
+		return result;
+	}
+
+	public static void main(String[] args) {
+		String alphabet = repeat("abcdefghijklmnopqrstuvwxyz", 4);
+		System.out.println(alphabet.indexOf('z'));
+		System.out.println(alphabet.indexOf('z', 26));
+		System.out.println(alphabet.indexOf('a', 100));
+		System.out.println(alphabet.indexOf('q', -5));
+		System.out.println(alphabet.indexOf(0x20ac));
+		System.out.println(alphabet.indexOf('a', 200));
+
+		String wide = repeat("x\u20acy", 20).concat("!");
+		System.out.println(wide.indexOf('!'));
+		System.out.println(wide.indexOf(0x20ac, 2));
+		System.out.println(wide.indexOf('y', 59));
+
+		String smiley = "\ud83d\ude00 ok";
+		System.out.println(smiley.length());
+		System.out.println(smiley.indexOf(0x1f600));
+		System.out.println(smiley.indexOf('k'));
+
+		System.out.println("apple".compareTo("apricot"));
+		System.out.println("abc".compareTo("ab"));
+		System.out.println("abc".compareTo("abc"));
+		String longer = alphabet.concat("b");
+		String other  = alphabet.concat("a");
+		System.out.println(longer.compareTo(other));
+		System.out.println("caf\u00e9".compareTo("caf\u20ac"));
+		System.out.println(wide.compareTo(repeat("x\u20acy", 20)));
+
+		String copy = repeat("abcdefghijklmnopqrstuvwxyz", 4);
+		System.out.println(alphabet.equals(copy));
+		System.out.println(alphabet.hashCode() == copy.hashCode());
+		System.out.println(alphabet.equals(other.substring(0, 104)));
+		System.out.println(longer.equals(other));
+
+		/* literals are decoded from (modified) UTF-8 */
+		String cafe = "caf\u00e9";
+		System.out.println(cafe.length());
+		System.out.println((int)cafe.charAt(3));
+		System.out.println(cafe);
+		System.out.println("\u20ac".length());
+	}
+}
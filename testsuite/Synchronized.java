@@ -0,0 +1,88 @@
+class SyncCounter
+{
+	static int instances;
+	private long count;
+
+	SyncCounter()
+	{
+		synchronized (SyncCounter.class) {
+			instances++;
+		}
+	}
+
+	synchronized void add(int n)
+	{
+		count += n;
+	}
+
+	synchronized long get()
+	{
+		return count;
+	}
+
+	/* recursion deeper than a thin lock counts inflates the lock */
+	synchronized int nest(int depth)
+	{
+		if (depth == 0)
+			return 0;
+		return nest(depth - 1) + 1;
+	}
+
+	static synchronized int getInstances()
+	{
+		return instances;
+	}
+}
+
+public class Synchronized
+{
+	static final Object lock = new Object();
+
+	static int firstMultiple(int[] values, int factor)
+	{
+		synchronized (lock) {
+			for (int i = 0; i < values.length; ++i) {
+				if (values[i] % factor == 0)
+					return values[i];
+			}
+		}
+		return -1;
+	}
+
+	public static void main(String[] args)
+	{
+		SyncCounter a = new SyncCounter();
+		SyncCounter b = new SyncCounter();
+		for (int i = 0; i < 1000; ++i) {
+			synchronized (a) {
+				a.add(i);
+				synchronized (b) {
+					b.add(1);
+				}
+			}
+		}
+		System.out.println(a.get() + " " + b.get());
+		System.out.println(SyncCounter.getInstances());
+
+		System.out.println(a.nest(10));
+		System.out.println(a.nest(200));
+		a.add(5);
+		System.out.println(a.get());
+
+		int[] values = { 3, 7, 10, 14, 21 };
+		System.out.println(firstMultiple(values, 7));
+		System.out.println(firstMultiple(values, 5));
+		System.out.println(firstMultiple(values, 11));
+
+		String[] words = { "alpha", "beta", "gamma" };
+		StringBuilder builder = new StringBuilder();
+		for (String word : words) {
+			synchronized (word) {
+				if (word.length() == 4)
+					continue;
+				builder.append(word);
+			}
+		}
+		System.out.println(builder.toString());
+	}
+}
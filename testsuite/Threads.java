@@ -0,0 +1,173 @@
+/* the static initializer is slow, all threads have to see its result */
+class SlowInit
+{
+	static int[] squares;
+	static long  sum;
+
+	static
+	{
+		squares = new int[1000];
+		for (int i = 0; i < squares.length; ++i)
+			squares[i] = i * i;
+		for (int round = 0; round < 100; ++round) {
+			long s = 0;
+			for (int i = 0; i < squares.length; ++i)
+				s += squares[i];
+			sum = s;
+		}
+	}
+}
+
+class SharedCounter
+{
+	private long count;
+
+	synchronized void add(int n)
+	{
+		count += n;
+	}
+
+	synchronized long get()
+	{
+		return count;
+	}
+}
+
+class Mailbox
+{
+	private final int[] items = new int[16];
+	private int         count;
+
+	synchronized void put(int item)
+	{
+		items[count++] = item;
+		notifyAll();
+	}
+
+	synchronized int take() throws InterruptedException
+	{
+		while (count == 0)
+			wait();
+		return items[--count];
+	}
+}
+
+class Worker extends Thread
+{
+	static final int ROUNDS = 50000;
+
+	private final int           id;
+	private final Mailbox       mailbox;
+	private final SharedCounter counter;
+	long                        result;
+	boolean                     sameThread;
+
+	Worker(int id, Mailbox mailbox, SharedCounter counter)
+	{
+		super("worker-" + id);
+		this.id      = id;
+		this.mailbox = mailbox;
+		this.counter = counter;
+	}
+
+	public void run()
+	{
+		long local = 0;
+		for (int round = 0; round < ROUNDS; ++round) {
+			StringBuilder builder = new StringBuilder();
+			for (int i = 0; i < 10; ++i)
+				builder.append(id);
+			local += builder.toString().length();
+			int[] data = new int[16];
+			data[round % 16] = round;
+			local += data[round % 16];
+			counter.add(1);
+		}
+		sameThread = Thread.currentThread() == this;
+		result     = local + SlowInit.sum;
+		mailbox.put(id + 1);
+	}
+}
+
+class Adder implements Runnable
+{
+	private final SharedCounter counter;
+
+	Adder(SharedCounter counter)
+	{
+		this.counter = counter;
+	}
+
+	public void run()
+	{
+		for (int i = 0; i < 1000; ++i)
+			counter.add(1);
+	}
+}
+
+public class Threads
+{
+	public static void main(String[] args) throws InterruptedException
+	{
+		System.out.println(Thread.currentThread().getName());
+
+		Mailbox       mailbox = new Mailbox();
+		SharedCounter counter = new SharedCounter();
+		Worker[]      workers = new Worker[4];
+		for (int i = 0; i < workers.length; ++i) {
+			workers[i] = new Worker(i, mailbox, counter);
+			workers[i].start();
+		}
+		int received = 0;
+		for (int i = 0; i < workers.length; ++i)
+			received += mailbox.take();
+		System.out.println(received);
+
+		for (int i = 0; i < workers.length; ++i)
+			workers[i].join();
+		System.out.println(counter.get());
+		for (int i = 0; i < workers.length; ++i) {
+			Worker worker = workers[i];
+			System.out.println(worker.getName() + " " + worker.result + " "
+			                   + worker.sameThread + " " + worker.isAlive());
+		}
+
+		Thread adder = new Thread(new Adder(counter));
+		adder.start();
+		adder.join();
+		System.out.println(adder.getName() + " " + counter.get());
+
+		Thread.sleep(10);
+		System.out.println(Thread.currentThread() == Thread.currentThread());
+
+		/* only the owner of a monitor may notify and wait on it */
+		Object unlocked = new Object();
+		try {
+			unlocked.notify();
+			System.out.println("notify without lock");
+		} catch (IllegalMonitorStateException e) {
+			System.out.println("notify: " + e.getClass().getName());
+		}
+		try {
+			unlocked.wait();
+			System.out.println("wait without lock");
+		} catch (IllegalMonitorStateException e) {
+			System.out.println("wait: " + e.getClass().getName());
+		}
+
+		try {
+			Thread.sleep(-1);
+			System.out.println("negative sleep");
+		} catch (IllegalArgumentException e) {
+			System.out.println("sleep: " + e.getClass().getName());
+		}
+		synchronized (unlocked) {
+			try {
+				unlocked.wait(0, 1000000);
+				System.out.println("too many nanos");
+			} catch (IllegalArgumentException e) {
+				System.out.println("wait: " + e.getClass().getName());
+			}
+		}
+	}
+}